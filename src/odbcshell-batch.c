@@ -0,0 +1,264 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-batch.c ODBC Shell statement batching
+ */
+#include "odbcshell-batch.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Variables
+#endif
+
+/// @brief statements which do not return result sets and may be batched
+static const char * odbcshell_batch_verbs[] =
+{
+   "ALTER",
+   "CREATE",
+   "DELETE",
+   "DROP",
+   "GRANT",
+   "INSERT",
+   "MERGE",
+   "REVOKE",
+   "TRUNCATE",
+   "UPDATE",
+   NULL
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief determines if a statement may be queued in the current batch
+/// @param cnf      pointer to configuration struct
+/// @param cmd      command being interpreted
+/// @param str      unparsed statement
+int odbcshell_batch_accepts(ODBCShell * cnf, ODBCShellOption * cmd,
+   const char * str)
+{
+   int             i;
+   size_t          len;
+   SQLUINTEGER     support;
+   ODBCShellConn * conn;
+
+   if ( (cnf->batchstatements < 2) || (!(cnf->script)) )
+      return(0);
+   if (cmd->val != ODBCSHELL_CMD_ODBC)
+      return(0);
+   if (!(conn = cnf->current))
+      return(0);
+   if ( ((conn->job)) || (!(conn->stmt)) )
+      return(0);
+
+   for(i = 0; ((odbcshell_batch_verbs[i])); i++)
+      if (!(strcasecmp(odbcshell_batch_verbs[i], cmd->name)))
+         break;
+   if (!(odbcshell_batch_verbs[i]))
+      return(0);
+
+   // statements sent to the background are never batched
+   for(len = strlen(str); ((len > 0) && (strchr(" \t\r\n", str[len-1]))); len--);
+   if ( (len > 0) && (str[len-1] == '&') )
+      return(0);
+
+   // checks driver once per connection for support of explicit batches
+   if (conn->batch_support == -1)
+   {
+      support = 0;
+      if (!(SQL_SUCCEEDED(SQLGetInfo(conn->hdbc, SQL_BATCH_SUPPORT, &support,
+         sizeof(support), NULL))))
+         support = 0;
+      conn->batch_support = support;
+      if (!(support & SQL_BS_ROW_COUNT_EXPLICIT))
+         odbcshell_verbose(cnf, "\"%s\" does not support batches, sending statements individually\n",
+            conn->name);
+   };
+   if (!(conn->batch_support & SQL_BS_ROW_COUNT_EXPLICIT))
+      return(0);
+
+   return(1);
+}
+
+
+/// @brief queues a statement to be sent with the next batch
+/// @param cnf      pointer to configuration struct
+/// @param str      unparsed statement
+int odbcshell_batch_add(ODBCShell * cnf, const char * str)
+{
+   int          code;
+   size_t       len;
+   void       * ptr;
+
+   // batches are sent to a single connection
+   if ( ((cnf->batch_count)) && (cnf->batch_conn != cnf->current) )
+      if ((code = odbcshell_batch_flush(cnf)))
+         return(code);
+
+   len = strlen(str);
+   if (!(ptr = realloc(cnf->batch, cnf->batch_len + len + 3)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   cnf->batch = ptr;
+   if (!(ptr = realloc(cnf->batch_lines, sizeof(long long) * (size_t)(cnf->batch_count+1))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   cnf->batch_lines = ptr;
+
+   memcpy(&cnf->batch[cnf->batch_len], str, len);
+   cnf->batch_len += len;
+   memcpy(&cnf->batch[cnf->batch_len], ";\n", 3);
+   cnf->batch_len += 2;
+
+   cnf->batch_lines[cnf->batch_count] = cnf->script_line;
+   cnf->batch_count++;
+   cnf->batch_conn = cnf->current;
+
+   if (cnf->batch_count < cnf->batchstatements)
+      return(0);
+
+   return(odbcshell_batch_flush(cnf));
+}
+
+
+/// @brief sends queued statements to the data source
+/// @param cnf      pointer to configuration struct
+int odbcshell_batch_flush(ODBCShell * cnf)
+{
+   int             code;
+   long long       idx;
+   SQLLEN          row_count;
+   SQLRETURN       sts;
+   ODBCShellStmt * stmt;
+   char            where[256];
+
+   if (!(cnf->batch_count))
+      return(0);
+
+   code = 0;
+   stmt = cnf->batch_conn->stmt;
+
+   odbcshell_odbc_stmt_timeout(cnf, cnf->batch_conn, stmt);
+
+   odbcshell_verbose(cnf, "sending batch of %lli statements...\n", cnf->batch_count);
+   odbcshell_signal_stmt(stmt->hstmt);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)cnf->batch, SQL_NTS);
+
+   // each statement in the batch produces one result, in order
+   for(idx = 0; ((idx < cnf->batch_count) && (sts != SQL_NO_DATA)); idx++)
+   {
+      if ( (sts == SQL_ERROR) || (sts == SQL_INVALID_HANDLE) )
+      {
+         snprintf(where, sizeof(where), "%s:%lli", cnf->script,
+            cnf->batch_lines[idx]);
+         odbcshell_odbc_stmt_errors(where, cnf, stmt);
+         code = -1;
+         if (sts == SQL_INVALID_HANDLE)
+            break;
+      } else {
+         row_count = 0;
+         SQLRowCount(stmt->hstmt, &row_count);
+         odbcshell_printf(cnf, "Statement executed. %ld rows affected.\n", row_count);
+      };
+      sts = SQLMoreResults(stmt->hstmt);
+   };
+   odbcshell_signal_stmt(NULL);
+
+   // reports statements skipped when the data source aborted the batch
+   if ( ((code)) && (idx < cnf->batch_count) )
+      odbcshell_error(cnf, "%s:%lli: batch aborted, %lli statements not executed\n",
+         cnf->script, cnf->batch_lines[idx], cnf->batch_count - idx);
+
+   SQLFreeStmt(stmt->hstmt, SQL_CLOSE);
+   odbcshell_batch_free(cnf);
+
+   return(code);
+}
+
+
+/// @brief discards queued statements
+/// @param cnf      pointer to configuration struct
+void odbcshell_batch_free(ODBCShell * cnf)
+{
+   if ((cnf->batch))
+      free(cnf->batch);
+   cnf->batch     = NULL;
+   cnf->batch_len = 0;
+
+   if ((cnf->batch_lines))
+      free(cnf->batch_lines);
+   cnf->batch_lines = NULL;
+   cnf->batch_count = 0;
+   cnf->batch_conn  = NULL;
+
+   return;
+}
+
+/* end of source */
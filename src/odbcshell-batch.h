@@ -0,0 +1,76 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-batch.h ODBC Shell statement batching
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_BATCH_H
+#define _ODBCSHELL_SRC_ODBCSHELL_BATCH_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// determines if a statement may be queued in the current batch
+int odbcshell_batch_accepts(ODBCShell * cnf, ODBCShellOption * cmd,
+   const char * str);
+
+// queues a statement to be sent with the next batch
+int odbcshell_batch_add(ODBCShell * cnf, const char * str);
+
+// sends queued statements to the data source
+int odbcshell_batch_flush(ODBCShell * cnf);
+
+// discards queued statements
+void odbcshell_batch_free(ODBCShell * cnf);
+
+#endif
+/* end of header */
@@ -0,0 +1,775 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-bench.c ODBC Shell replays statements to measure latency
+ */
+#include "odbcshell-bench.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-parse.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+#include "odbcshell-variables.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief converts length of load test (I.E. 500ms, 60s, 5m, 1h) into milliseconds
+/// @param str         length of time (seconds unless followed by a unit)
+/// @param[out] msecsp returns length of time in milliseconds
+int odbcshell_bench_duration(const char * str, long long * msecsp)
+{
+   long long   val;
+   char      * end;
+
+   val = strtoll(str, &end, 10);
+   if ( (end == str) || (val < 0) )
+      return(-1);
+
+   if ( (!(end[0])) || (!(strcasecmp(end, "s"))) )
+      *msecsp = val * 1000LL;
+   else if (!(strcasecmp(end, "ms")))
+      *msecsp = val;
+   else if (!(strcasecmp(end, "m")))
+      *msecsp = val * 60000LL;
+   else if (!(strcasecmp(end, "h")))
+      *msecsp = val * 3600000LL;
+   else
+      return(-1);
+
+   return(0);
+}
+
+
+/// @brief writes string as a JSON string literal
+/// @param fs       stream receiving string
+/// @param str      string to write
+void odbcshell_bench_escape(FILE * fs, const char * str)
+{
+   fputc('"', fs);
+   for(; ((*str)); str++)
+   {
+      switch(*str)
+      {
+         case '"':  fputs("\\\"", fs); break;
+         case '\\': fputs("\\\\", fs); break;
+         case '\n': fputs("\\n", fs);  break;
+         case '\r': fputs("\\r", fs);  break;
+         case '\t': fputs("\\t", fs);  break;
+         default:
+            if ((unsigned char)*str < 0x20)
+               fprintf(fs, "\\u%04x", (unsigned)(unsigned char)*str);
+            else
+               fputc(*str, fs);
+            break;
+      };
+   };
+   fputc('"', fs);
+   return;
+}
+
+
+/// @brief frees resources used by load test
+/// @param bench    pointer to load test
+void odbcshell_bench_free(ODBCShellBench * bench)
+{
+   long long l;
+
+   if ((bench->list))
+      for(l = 0; l < bench->sessions; l++)
+      {
+         free(bench->list[l].stats);
+         free(bench->list[l].buff);
+      };
+   for(l = 0; l < bench->count; l++)
+      free(bench->stmts[l]);
+   free(bench->stmts);
+   free(bench->stats);
+   free(bench->list);
+
+   bench->stmts = NULL;
+   bench->stats = NULL;
+   bench->list  = NULL;
+   bench->count = 0;
+
+   return;
+}
+
+
+/// @brief returns the histogram bucket of a latency
+/// @param usecs    latency in microseconds
+long long odbcshell_bench_index(long long usecs)
+{
+   int       bits;
+   long long sub;
+
+   sub = 1LL << ODBCSHELL_BENCH_SUBBITS;
+   if (usecs < 0)
+      usecs = 0;
+
+   // short latencies are recorded exactly
+   if (usecs < (sub << 1))
+      return(usecs);
+
+   // each doubling of latency is divided into buckets of equal width, which
+   // keeps the error of every bucket within the same fraction of its latency
+   for(bits = 1; (usecs >> bits) >= (sub << 1); bits++);
+   if (bits > (ODBCSHELL_BENCH_MAXBITS - ODBCSHELL_BENCH_SUBBITS))
+      return(ODBCSHELL_BENCH_BUCKETS - 1);
+
+   return(((long long)(bits + 1) << ODBCSHELL_BENCH_SUBBITS) + ((usecs >> bits) - sub));
+}
+
+
+/// @brief writes results of load test as JSON
+/// @param cnf      pointer to configuration struct
+/// @param bench    pointer to load test
+/// @param path     file receiving results ("-" for current output)
+int odbcshell_bench_json(ODBCShell * cnf, ODBCShellBench * bench,
+   const char * path)
+{
+   long long            l;
+   double               secs;
+   FILE               * fs;
+   ODBCShellBenchStat * stat;
+
+   if (!(strcmp(path, "-")))
+      fs = ((cnf->output)) ? cnf->output : stdout;
+   else if (!(fs = fopen(path, "w")))
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      return(-1);
+   };
+
+   secs = ((bench->msecs)) ? (double)bench->msecs / 1000.0 : 1.0;
+
+   fprintf(fs, "{\n");
+   fprintf(fs, "  \"sessions\": %lld,\n", bench->sessions);
+   fprintf(fs, "  \"duration_ms\": %lld,\n", bench->msecs);
+   fprintf(fs, "  \"think_ms\": %lld,\n", bench->think);
+   fprintf(fs, "  \"statements\": [");
+   for(l = 0; l < bench->count; l++)
+   {
+      stat = &bench->stats[l];
+      fprintf(fs, "%s\n    {\n      \"sql\": ", ((l)) ? "," : "");
+      odbcshell_bench_escape(fs, bench->stmts[l]);
+      fprintf(fs, ",\n");
+      fprintf(fs, "      \"count\": %lld,\n", stat->count);
+      fprintf(fs, "      \"errors\": %lld,\n", stat->errors);
+      fprintf(fs, "      \"throughput\": %.3f,\n", (double)stat->count / secs);
+      fprintf(fs, "      \"latency_us\": {\n");
+      fprintf(fs, "        \"min\": %lld,\n", stat->min);
+      fprintf(fs, "        \"mean\": %lld,\n", ((stat->count)) ? stat->total / stat->count : 0);
+      fprintf(fs, "        \"p50\": %lld,\n", odbcshell_bench_percentile(stat, 0.50));
+      fprintf(fs, "        \"p95\": %lld,\n", odbcshell_bench_percentile(stat, 0.95));
+      fprintf(fs, "        \"p99\": %lld,\n", odbcshell_bench_percentile(stat, 0.99));
+      fprintf(fs, "        \"p999\": %lld,\n", odbcshell_bench_percentile(stat, 0.999));
+      fprintf(fs, "        \"max\": %lld\n", stat->max);
+      fprintf(fs, "      }\n");
+      fprintf(fs, "    }");
+   };
+   fprintf(fs, "\n  ]\n");
+   fprintf(fs, "}\n");
+
+   if (!(strcmp(path, "-")))
+      return(0);
+   if ((fclose(fs)))
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "wrote results to \"%s\"\n", path);
+
+   return(0);
+}
+
+
+/// @brief reads the statements of a script or history file
+/// @param cnf      pointer to configuration struct
+/// @param bench    pointer to load test
+/// @param path     script or history file
+int odbcshell_bench_load(ODBCShell * cnf, ODBCShellBench * bench,
+   const char * path)
+{
+   int               i;
+   int               err;
+   int               argc;
+   char           ** argv;
+   char            * buff;
+   char            * str;
+   void            * ptr;
+   long              len;
+   size_t            pos;
+   ssize_t           offset;
+   long long         line;
+   FILE            * fs;
+   ODBCShellOption * cmd;
+
+   if (!(fs = fopen(path, "r")))
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      return(-1);
+   };
+   if ( ((fseek(fs, 0L, SEEK_END))) || ((len = ftell(fs)) < 0) || ((fseek(fs, 0L, SEEK_SET))) )
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      fclose(fs);
+      return(-1);
+   };
+   if (!(buff = malloc((size_t)len + 1)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      fclose(fs);
+      return(-2);
+   };
+   len = (long)fread(buff, 1, (size_t)len, fs);
+   buff[len] = '\0';
+   fclose(fs);
+
+   // statements are split the same way scripts are interpreted
+   err  = 0;
+   argc = 0;
+   argv = NULL;
+   pos  = 0;
+   line = cnf->script_line;
+   while(pos < (size_t)len)
+   {
+      if ((err = odbcshell_parse_line(cnf, &buff[pos], &argc, &argv, &offset)))
+         break;
+      if (offset == -1)
+      {
+         odbcshell_error(cnf, "%s: unterminated statement\n", path);
+         err = -1;
+         break;
+      };
+
+      // shell commands within the script are not replayed
+      cmd = ((argc)) ? odbcshell_lookup_opt_by_name(odbcshell_cmd_strings, argv[0]) : NULL;
+      if ( ((argc)) && ( (!(cmd)) || (cmd->val != ODBCSHELL_CMD_ODBC) ) )
+         odbcshell_verbose(cnf, "%s: skipping \"%s\" which is not a SQL statement\n", path, argv[0]);
+      if ( ((cmd)) && (cmd->val == ODBCSHELL_CMD_ODBC) )
+      {
+         for(str = &buff[pos]; (isspace((unsigned char)*str)); str++);
+         if (!(ptr = realloc(bench->stmts, sizeof(char *) * (size_t)(bench->count+1))))
+         {
+            odbcshell_fatal(cnf, "out of virtual memory\n");
+            err = -2;
+            break;
+         };
+         bench->stmts = ptr;
+         if (!(bench->stmts[bench->count] = strndup(str, (size_t)offset - (size_t)(str - &buff[pos]))))
+         {
+            odbcshell_fatal(cnf, "out of virtual memory\n");
+            err = -2;
+            break;
+         };
+         bench->count++;
+      };
+      pos += (size_t)offset + 1;
+   };
+
+   // parser counts continued lines against the running script
+   cnf->script_line = line;
+
+   for(i = 0; i < argc; i++)
+      free(argv[i]);
+   free(argv);
+   free(buff);
+
+   return(err);
+}
+
+
+/// @brief adds latencies of one statement to the latencies of another
+/// @param dst      latencies receiving counts
+/// @param src      latencies being added
+void odbcshell_bench_merge(ODBCShellBenchStat * dst,
+   ODBCShellBenchStat * src)
+{
+   long long l;
+
+   if ( ((src->count)) && ( (!(dst->count)) || (src->min < dst->min) ) )
+      dst->min = src->min;
+   if (src->max > dst->max)
+      dst->max = src->max;
+   dst->count  += src->count;
+   dst->errors += src->errors;
+   dst->total  += src->total;
+   for(l = 0; l < ODBCSHELL_BENCH_BUCKETS; l++)
+      dst->counts[l] += src->counts[l];
+
+   return;
+}
+
+
+/// @brief returns the latency below which a fraction of executions completed
+/// @param stat     latencies of statement
+/// @param fraction fraction of executions (I.E. 0.99)
+long long odbcshell_bench_percentile(ODBCShellBenchStat * stat,
+   double fraction)
+{
+   long long l;
+   long long target;
+   long long seen;
+   long long val;
+
+   if (!(stat->count))
+      return(0);
+
+   target = (long long)(fraction * (double)stat->count + 0.999999);
+   if (target < 1)
+      target = 1;
+
+   seen = 0;
+   for(l = 0; l < ODBCSHELL_BENCH_BUCKETS; l++)
+   {
+      if ((seen += stat->counts[l]) < target)
+         continue;
+      val = odbcshell_bench_value(l);
+      return((val < stat->max) ? val : stat->max);
+   };
+
+   return(stat->max);
+}
+
+
+/// @brief records the latency of one execution
+/// @param stat     latencies of statement
+/// @param usecs    latency in microseconds
+void odbcshell_bench_record(ODBCShellBenchStat * stat, long long usecs)
+{
+   if ( (!(stat->count)) || (usecs < stat->min) )
+      stat->min = usecs;
+   if (usecs > stat->max)
+      stat->max = usecs;
+   stat->count++;
+   stat->total += usecs;
+   stat->counts[odbcshell_bench_index(usecs)]++;
+   return;
+}
+
+
+/// @brief displays throughput and latencies of each statement
+/// @param cnf      pointer to configuration struct
+/// @param bench    pointer to load test
+void odbcshell_bench_report(ODBCShell * cnf, ODBCShellBench * bench)
+{
+   long long            l;
+   long long            p50;
+   long long            p95;
+   long long            p99;
+   long long            p999;
+   double               secs;
+   ODBCShellBenchStat * stat;
+   ODBCShellBenchStat * all;
+   char                 label[40];
+
+   if (!(all = calloc(1, sizeof(ODBCShellBenchStat))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return;
+   };
+
+   secs = ((bench->msecs)) ? (double)bench->msecs / 1000.0 : 1.0;
+
+   odbcshell_fprintf(cnf, "%-36s %10s %8s %10s %9s %9s %9s %9s %9s %9s\n", "statement",
+      "count", "errors", "per sec", "mean ms", "p50 ms", "p95 ms", "p99 ms", "p999 ms", "max ms");
+   for(l = 0; l <= bench->count; l++)
+   {
+      // last line totals every statement
+      if (l == bench->count)
+      {
+         stat = all;
+         snprintf(label, sizeof(label), "all statements");
+      }
+      else
+      {
+         stat = &bench->stats[l];
+         odbcshell_bench_merge(all, stat);
+         if (strlen(bench->stmts[l]) > 36)
+            snprintf(label, sizeof(label), "%.33s...", bench->stmts[l]);
+         else
+            snprintf(label, sizeof(label), "%s", bench->stmts[l]);
+      };
+      p50  = odbcshell_bench_percentile(stat, 0.50);
+      p95  = odbcshell_bench_percentile(stat, 0.95);
+      p99  = odbcshell_bench_percentile(stat, 0.99);
+      p999 = odbcshell_bench_percentile(stat, 0.999);
+      odbcshell_fprintf(cnf, "%-36s %10lld %8lld %10.1f %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+         label, stat->count, stat->errors, (double)stat->count / secs,
+         ((stat->count)) ? (double)stat->total / (double)stat->count / 1000.0 : 0.0,
+         (double)p50 / 1000.0, (double)p95 / 1000.0, (double)p99 / 1000.0,
+         (double)p999 / 1000.0, (double)stat->max / 1000.0);
+   };
+
+   odbcshell_printf(cnf, "replayed %lld statements on %lld sessions in %lld ms (%.1f per second), %lld failed.\n",
+      all->count + all->errors, bench->sessions, bench->msecs,
+      (double)all->count / secs, all->errors);
+
+   free(all);
+
+   return;
+}
+
+
+/// @brief replays statements of a script on several sessions at once
+/// @param cnf      pointer to configuration struct
+/// @param sessions number of sessions replaying statements
+/// @param duration milliseconds statements are replayed
+/// @param think    milliseconds each session pauses between statements
+/// @param script   script or history file containing statements
+/// @param json     file receiving results as JSON (NULL for none)
+int odbcshell_bench_run(ODBCShell * cnf, long long sessions,
+   long long duration, long long think, const char * script,
+   const char * json)
+{
+   int                     err;
+   int                     code;
+   long long               l;
+   long long               s;
+   long long               started;
+   long long               failed;
+   sigset_t                oldset;
+   pthread_t             * tids;
+   struct timespec         end;
+   ODBCShellBench          bench;
+   ODBCShellBenchSession * session;
+   char                    name[64];
+
+   if ( (sessions < 1) || (sessions > ODBCSHELL_BENCH_SESSIONS) )
+   {
+      odbcshell_error(cnf, "number of sessions must be between 1 and %i\n", ODBCSHELL_BENCH_SESSIONS);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_ready(cnf)))
+      return(err);
+
+   memset(&bench, 0, sizeof(ODBCShellBench));
+   bench.dsn      = cnf->current->dsn;
+   bench.duration = duration;
+   bench.think    = think;
+
+   if ((err = odbcshell_bench_load(cnf, &bench, script)))
+   {
+      odbcshell_bench_free(&bench);
+      return(err);
+   };
+   if (!(bench.count))
+   {
+      odbcshell_error(cnf, "%s: no SQL statements to replay\n", script);
+      odbcshell_bench_free(&bench);
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "replaying %lld statements on %lld sessions...\n", bench.count, sessions);
+
+   bench.stats = calloc((size_t)bench.count, sizeof(ODBCShellBenchStat));
+   bench.list  = calloc((size_t)sessions, sizeof(ODBCShellBenchSession));
+   if ( (!(bench.stats)) || (!(bench.list)) )
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_bench_free(&bench);
+      return(-2);
+   };
+   bench.sessions = sessions;
+
+   code = 0;
+   tids = NULL;
+   for(l = 0; l < sessions; l++)
+   {
+      session         = &bench.list[l];
+      session->id     = l + 1;
+      session->bench  = &bench;
+      session->stats  = calloc((size_t)bench.count, sizeof(ODBCShellBenchStat));
+      session->output = open_memstream(&session->buff, &session->bufflen);
+      if ( (!(session->stats)) || (!(session->output)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // idle connections to the data source are handed to sessions
+      snprintf(name, sizeof(name), "bench-%lld", session->id);
+      if ((code = odbcshell_pool_take(cnf, bench.dsn, name, &session->conn)))
+         break;
+
+      // messages of each session are kept apart
+      odbcshell_clone(cnf, &session->cnf, session->output, session->output);
+   };
+
+   if ( (!(code)) && (!(tids = calloc((size_t)sessions, sizeof(pthread_t)))) )
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      code = -2;
+   };
+
+   // each session replays statements with its own worker and connection
+   started = 0;
+   if (!(code))
+   {
+      pthread_mutex_init(&bench.lock, NULL);
+      pthread_cond_init(&bench.cond, NULL);
+      odbcshell_signal_block(&oldset);
+      for(started = 0; started < sessions; started++)
+         if ((pthread_create(&tids[started], NULL, odbcshell_bench_thread, &bench.list[started])))
+            break;
+      odbcshell_signal_restore(&oldset);
+      if (started < sessions)
+         odbcshell_error(cnf, "unable to start %lld of %lld sessions\n", sessions - started, sessions);
+
+      // clock starts once every session is connected
+      pthread_mutex_lock(&bench.lock);
+      while(bench.ready < started)
+         pthread_cond_wait(&bench.cond, &bench.lock);
+      clock_gettime(CLOCK_MONOTONIC, &bench.start);
+      bench.stop.tv_sec  = bench.start.tv_sec + (time_t)(duration / 1000LL);
+      bench.stop.tv_nsec = bench.start.tv_nsec + (long)(duration % 1000LL) * 1000000L;
+      if (bench.stop.tv_nsec >= 1000000000L)
+      {
+         bench.stop.tv_sec++;
+         bench.stop.tv_nsec -= 1000000000L;
+      };
+      bench.go = 1;
+      pthread_cond_broadcast(&bench.cond);
+      pthread_mutex_unlock(&bench.lock);
+
+      for(l = 0; l < started; l++)
+         pthread_join(tids[l], NULL);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      bench.msecs = (long long)(end.tv_sec - bench.start.tv_sec) * 1000LL
+                  + (long long)(end.tv_nsec - bench.start.tv_nsec) / 1000000LL;
+      pthread_cond_destroy(&bench.cond);
+      pthread_mutex_destroy(&bench.lock);
+      free(tids);
+   };
+
+   // reports messages of each session and releases connections
+   failed = 0;
+   for(l = 0; l < sessions; l++)
+   {
+      session = &bench.list[l];
+      if ((session->output))
+         fclose(session->output);
+      session->output = NULL;
+      if ((session->bufflen))
+         fwrite(session->buff, 1, session->bufflen, cnf->errs ? cnf->errs : stderr);
+      if ((session->conn))
+      {
+         if ((session->code))
+            odbcshell_odbc_free(cnf, &session->conn);
+         else
+            odbcshell_pool_put(cnf, &session->conn);
+      };
+      if ((code))
+         continue;
+      if ( (l >= started) || ((session->code)) )
+         failed++;
+      for(s = 0; s < bench.count; s++)
+         odbcshell_bench_merge(&bench.stats[s], &session->stats[s]);
+   };
+
+   if ( (!(code)) && (failed == sessions) )
+   {
+      odbcshell_error(cnf, "none of %lld sessions connected\n", sessions);
+      code = -1;
+   };
+   if (!(code))
+   {
+      if ((failed))
+         odbcshell_error(cnf, "%lld of %lld sessions failed to connect\n", failed, sessions);
+      if ( (!(json)) || ((strcmp(json, "-"))) )
+         odbcshell_bench_report(cnf, &bench);
+      if ((json))
+         code = odbcshell_bench_json(cnf, &bench, json);
+   };
+
+   odbcshell_bench_free(&bench);
+
+   return(code);
+}
+
+
+/// @brief replays statements until the load test ends
+/// @param session  pointer to session
+int odbcshell_bench_session(ODBCShellBenchSession * session)
+{
+   int                  err;
+   long long            l;
+   long long            usecs;
+   struct timespec      start;
+   struct timespec      end;
+   struct timespec      pause;
+   FILE               * discard;
+   ODBCShell          * cnf;
+   ODBCShellBench     * bench;
+   ODBCShellBenchStat * stat;
+   char                 name[64];
+
+   cnf     = &session->cnf;
+   bench   = session->bench;
+   discard = NULL;
+   err     = 0;
+
+   if (!(session->conn))
+   {
+      snprintf(name, sizeof(name), "bench-%lld", session->id);
+      err = odbcshell_odbc_open(cnf, bench->dsn, name, &session->conn);
+   };
+   cnf->current = session->conn;
+
+   // results are formatted the same as the shell, then discarded
+   if ( (!(err)) && (!(discard = fopen("/dev/null", "w"))) )
+   {
+      odbcshell_error(cnf, "/dev/null: %s\n", strerror(errno));
+      err = -1;
+   };
+
+   // sessions start replaying statements together once all are connected
+   pthread_mutex_lock(&bench->lock);
+   bench->ready++;
+   pthread_cond_broadcast(&bench->cond);
+   while(!(bench->go))
+      pthread_cond_wait(&bench->cond, &bench->lock);
+   pthread_mutex_unlock(&bench->lock);
+   if ((err))
+      return(err);
+
+   pause.tv_sec  = (time_t)(bench->think / 1000LL);
+   pause.tv_nsec = (long)(bench->think % 1000LL) * 1000000L;
+
+   // sessions begin with different statements to spread the load
+   l = (session->id - 1) % bench->count;
+   while(1)
+   {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      if ( (start.tv_sec > bench->stop.tv_sec) ||
+           ((start.tv_sec == bench->stop.tv_sec) && (start.tv_nsec >= bench->stop.tv_nsec)) )
+         break;
+
+      // only the first failure of each statement is reported
+      stat        = &session->stats[l];
+      cnf->output = discard;
+      cnf->msgs   = discard;
+      cnf->errs   = ((stat->errors)) ? discard : session->output;
+
+      // statements are sent the same way as from the shell, so that
+      // latency includes retrieving the rows and applying connection settings
+      err = odbcshell_odbc_exec(cnf, bench->stmts[l]);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+
+      if (!(err))
+      {
+         usecs = (long long)(end.tv_sec - start.tv_sec) * 1000000LL
+               + (long long)(end.tv_nsec - start.tv_nsec) / 1000LL;
+         odbcshell_bench_record(stat, usecs);
+      }
+      else if ((stat->errors++) == 0)
+      {
+         odbcshell_error(cnf, "session %lld: statement %lld failed\n", session->id, l + 1);
+      };
+      if (err == -2)
+         break;
+
+      if ((bench->think))
+         nanosleep(&pause, NULL);
+      l = (l + 1) % bench->count;
+   };
+
+   cnf->output = session->output;
+   cnf->msgs   = session->output;
+   cnf->errs   = session->output;
+   fclose(discard);
+
+   return((err == -2) ? err : 0);
+}
+
+
+/// @brief worker thread replaying statements on one session
+/// @param ptr      pointer to session
+void * odbcshell_bench_thread(void * ptr)
+{
+   ODBCShellBenchSession * session;
+
+   session       = ptr;
+   session->code = odbcshell_bench_session(session);
+   fflush(session->output);
+
+   return(NULL);
+}
+
+
+/// @brief returns the highest latency recorded by a histogram bucket
+/// @param index    bucket of histogram
+long long odbcshell_bench_value(long long index)
+{
+   long long bits;
+   long long sub;
+
+   sub = 1LL << ODBCSHELL_BENCH_SUBBITS;
+   if (index < (sub << 1))
+      return(index);
+
+   bits = (index >> ODBCSHELL_BENCH_SUBBITS) - 1;
+   return((((index & (sub - 1)) + sub + 1) << bits) - 1);
+}
+
+/* end of source */
@@ -0,0 +1,111 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-bench.h ODBC Shell replays statements to measure latency
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_BENCH_H
+#define _ODBCSHELL_SRC_ODBCSHELL_BENCH_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// converts length of load test (I.E. 500ms, 60s, 5m, 1h) into milliseconds
+int odbcshell_bench_duration(const char * str, long long * msecsp);
+
+// writes string as a JSON string literal
+void odbcshell_bench_escape(FILE * fs, const char * str);
+
+// frees resources used by load test
+void odbcshell_bench_free(ODBCShellBench * bench);
+
+// returns the histogram bucket of a latency
+long long odbcshell_bench_index(long long usecs);
+
+// writes results of load test as JSON
+int odbcshell_bench_json(ODBCShell * cnf, ODBCShellBench * bench,
+   const char * path);
+
+// reads the statements of a script or history file
+int odbcshell_bench_load(ODBCShell * cnf, ODBCShellBench * bench,
+   const char * path);
+
+// adds latencies of one statement to the latencies of another
+void odbcshell_bench_merge(ODBCShellBenchStat * dst,
+   ODBCShellBenchStat * src);
+
+// returns the latency below which a fraction of executions completed
+long long odbcshell_bench_percentile(ODBCShellBenchStat * stat,
+   double fraction);
+
+// records the latency of one execution
+void odbcshell_bench_record(ODBCShellBenchStat * stat, long long usecs);
+
+// displays throughput and latencies of each statement
+void odbcshell_bench_report(ODBCShell * cnf, ODBCShellBench * bench);
+
+// replays statements of a script on several sessions at once
+int odbcshell_bench_run(ODBCShell * cnf, long long sessions,
+   long long duration, long long think, const char * script,
+   const char * json);
+
+// replays statements until the load test ends
+int odbcshell_bench_session(ODBCShellBenchSession * session);
+
+// worker thread replaying statements on one session
+void * odbcshell_bench_thread(void * ptr);
+
+// returns the highest latency recorded by a histogram bucket
+long long odbcshell_bench_value(long long index);
+
+#endif
+/* end of header */
@@ -0,0 +1,743 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-chunked.c ODBC Shell executes updates and deletes in ranges of keys
+ */
+#include "odbcshell-chunked.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include "odbcshell-export.h"
+#include "odbcshell-odbc.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief tests whether the SET list of an UPDATE assigns the key column
+/// @param sql      statement being divided
+/// @param start    offset of the SET list
+/// @param end      offset following the SET list
+/// @param column   key column dividing statement
+int odbcshell_chunked_assigns(const char * sql, size_t start, size_t end,
+   const char * column)
+{
+   int          depth;
+   char         quote;
+   size_t       pos;
+   size_t       lhs;
+   size_t       len;
+   size_t       clen;
+   const char * name;
+
+   // qualifiers and quotes are ignored when comparing names
+   if ((name = strrchr(column, '.')))
+      column = name + 1;
+   clen = strlen(column);
+   if ( (clen > 1) && ((strchr("\"`[", column[0]))) )
+   {
+      column++;
+      clen -= 2;
+   };
+
+   // each assignment names its column before the first '=' following
+   // SET or a comma
+   depth = 0;
+   quote = '\0';
+   lhs   = start;
+   for(pos = start; pos < end; pos++)
+   {
+      if ((quote))
+      {
+         if (sql[pos] == quote)
+            quote = '\0';
+         continue;
+      };
+      switch(sql[pos])
+      {
+         case '\'': quote = '\''; continue;
+         case '"':  quote = '"';  continue;
+         case '`':  quote = '`';  continue;
+         case '[':  quote = ']';  continue;
+         case '(':  depth++;      continue;
+         case ')':  depth--;      continue;
+         case ',':
+            if (!(depth))
+               lhs = pos + 1;
+            continue;
+         case '=':
+            break;
+         default:
+            continue;
+      };
+      if ( ((depth)) || (lhs == end) )
+         continue;
+
+      while ( (lhs < pos) && ((isspace((unsigned char)sql[lhs]))) )
+         lhs++;
+      len = pos;
+      while ( (len > lhs) && ((isspace((unsigned char)sql[len-1]))) )
+         len--;
+      for(name = &sql[len]; ( (name > &sql[lhs]) && (name[-1] != '.') ); name--);
+      len -= (size_t)(name - sql);
+      if ( (len > 1) && ((strchr("\"`[", name[0]))) )
+      {
+         name++;
+         len -= 2;
+      };
+      if ( (len == clen) && (!(strncasecmp(name, column, clen))) )
+         return(1);
+
+      // '=' within the assigned value does not start another assignment
+      lhs = end;
+   };
+
+   return(0);
+}
+
+
+/// @brief executes and commits statement restricted to one range of keys
+/// @param cnf        pointer to configuration struct
+/// @param chunked    pointer to chunked statement
+/// @param predicate  condition selecting range of keys
+/// @param rowsp      pointer to rows changed by range
+int odbcshell_chunked_exec(ODBCShell * cnf, ODBCShellChunked * chunked,
+   const char * predicate, long long * rowsp)
+{
+   char            * query;
+   size_t            len;
+   SQLLEN            rows;
+   SQLRETURN         sts;
+   struct timespec   ts;
+
+   (*rowsp) = 0;
+
+   // waits between chunks so that other sessions may take locks
+   if ( ((chunked->pause)) && ((chunked->chunks)) )
+   {
+      ts.tv_sec  = chunked->pause / 1000;
+      ts.tv_nsec = (chunked->pause % 1000) * 1000000L;
+      if (nanosleep(&ts, NULL) == -1)
+      {
+         odbcshell_error(cnf, "interrupted after %lld rows in %lld chunks\n",
+            chunked->rows, chunked->chunks);
+         return(-1);
+      };
+   };
+
+   // range of keys is added ahead of the condition of the statement
+   len = strlen(chunked->sql) + strlen(predicate) + 32;
+   if (!(query = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   if ((chunked->where))
+      snprintf(query, len, "%.*s %s AND (%s)", (int)chunked->prefix,
+         chunked->sql, predicate, &chunked->sql[chunked->where]);
+   else
+      snprintf(query, len, "%s WHERE %s", chunked->sql, predicate);
+
+   odbcshell_signal_stmt(chunked->stmt->hstmt);
+   sts = SQLExecDirect(chunked->stmt->hstmt, (SQLTCHAR *)query, SQL_NTS);
+   odbcshell_signal_stmt(NULL);
+   free(query);
+   if ( (!(SQL_SUCCEEDED(sts))) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, chunked->stmt);
+      SQLEndTran(SQL_HANDLE_DBC, chunked->conn->hdbc, SQL_ROLLBACK);
+      odbcshell_error(cnf, "chunk %lld (%s) was rolled back, %lld rows in %lld chunks committed\n",
+         chunked->chunks + 1, predicate, chunked->rows, chunked->chunks);
+      return(-1);
+   };
+   rows = 0;
+   if ( (sts != SQL_NO_DATA) && (!(SQL_SUCCEEDED(SQLRowCount(chunked->stmt->hstmt, &rows)))) )
+      rows = 0;
+   SQLFreeStmt(chunked->stmt->hstmt, SQL_CLOSE);
+
+   sts = SQLEndTran(SQL_HANDLE_DBC, chunked->conn->hdbc, SQL_COMMIT);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_diag("SQLEndTran", cnf, chunked->conn->hdbc, NULL);
+      odbcshell_error(cnf, "chunk %lld (%s) was not committed, %lld rows in %lld chunks committed\n",
+         chunked->chunks + 1, predicate, chunked->rows, chunked->chunks);
+      return(-1);
+   };
+
+   (*rowsp)         = (rows > 0) ? (long long)rows : 0;
+   chunked->rows   += (*rowsp);
+   chunked->chunks++;
+   odbcshell_chunked_progress(cnf, chunked);
+
+   return(0);
+}
+
+
+/// @brief finds keyword outside of quotes and parentheses
+/// @param sql      statement being searched
+/// @param keyword  keyword to find
+/// @return offset of keyword or -1 if not found
+long long odbcshell_chunked_keyword(const char * sql, const char * keyword)
+{
+   int      depth;
+   char     quote;
+   size_t   pos;
+   size_t   len;
+
+   len   = strlen(keyword);
+   depth = 0;
+   quote = '\0';
+   for(pos = 0; ((sql[pos])); pos++)
+   {
+      // doubled quotes close and reopen the quoted text
+      if ((quote))
+      {
+         if (sql[pos] == quote)
+            quote = '\0';
+         continue;
+      };
+      switch(sql[pos])
+      {
+         case '\'': quote = '\''; continue;
+         case '"':  quote = '"';  continue;
+         case '`':  quote = '`';  continue;
+         case '[':  quote = ']';  continue;
+         case '(':  depth++;      continue;
+         case ')':  depth--;      continue;
+         default:
+            break;
+      };
+      if ((depth))
+         continue;
+      if ((strncasecmp(&sql[pos], keyword, len)))
+         continue;
+      if ( (pos > 0) && ( ((isalnum((unsigned char)sql[pos-1]))) || (sql[pos-1] == '_') ) )
+         continue;
+      if ( ((isalnum((unsigned char)sql[pos+len]))) || (sql[pos+len] == '_') )
+         continue;
+      return((long long)pos);
+   };
+
+   return(-1);
+}
+
+
+/// @brief finds table and condition of statement
+/// @param cnf      pointer to configuration struct
+/// @param chunked  pointer to chunked statement
+int odbcshell_chunked_parse(ODBCShell * cnf, ODBCShellChunked * chunked)
+{
+   long long    from;
+   long long    where;
+   long long    set;
+   size_t       start;
+   size_t       end;
+   const char * sql;
+
+   sql   = chunked->sql;
+   start = 0;
+   while ((isspace((unsigned char)sql[start])))
+      start++;
+   where = odbcshell_chunked_keyword(sql, "WHERE");
+   end   = (where != -1) ? (size_t)where : strlen(sql);
+
+   // table is named after FROM, which some dialects omit, or before SET
+   if (odbcshell_chunked_keyword(sql, "DELETE") == (long long)start)
+   {
+      from  = odbcshell_chunked_keyword(sql, "FROM");
+      start = ( (from != -1) && ((size_t)from < end) ) ? (size_t)from + 4 : start + 6;
+   }
+   else if (odbcshell_chunked_keyword(sql, "UPDATE") == (long long)start)
+   {
+      if ( ((set = odbcshell_chunked_keyword(sql, "SET")) == -1) || ((size_t)set > end) )
+      {
+         odbcshell_error(cnf, "update does not set any columns\n");
+         return(-1);
+      };
+      if ((odbcshell_chunked_assigns(sql, (size_t)set + 3, end, chunked->column)))
+      {
+         odbcshell_error(cnf, "update must not change key column \"%s\"\n", chunked->column);
+         return(-1);
+      };
+      start += 6;
+      end    = (size_t)set;
+   }
+   else
+   {
+      odbcshell_error(cnf, "statement must be an UPDATE or DELETE\n");
+      return(-1);
+   };
+
+   while ( (start < end) && ((isspace((unsigned char)sql[start]))) )
+      start++;
+   while ( (end > start) && ((isspace((unsigned char)sql[end-1]))) )
+      end--;
+   if (start == end)
+   {
+      odbcshell_error(cnf, "statement does not name a table\n");
+      return(-1);
+   };
+   if (!(chunked->target = strndup(&sql[start], end - start)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+
+   chunked->prefix = strlen(sql);
+   chunked->where  = 0;
+   if (where != -1)
+   {
+      chunked->prefix = (size_t)where + 5;
+      chunked->where  = (size_t)where + 5;
+      while ((isspace((unsigned char)sql[chunked->where])))
+         chunked->where++;
+   };
+
+   return(0);
+}
+
+
+/// @brief reports progress of statement
+/// @param cnf      pointer to configuration struct
+/// @param chunked  pointer to chunked statement
+void odbcshell_chunked_progress(ODBCShell * cnf, ODBCShellChunked * chunked)
+{
+   long long         msecs;
+   long long         percent;
+   struct timespec   now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   msecs = (long long)(now.tv_sec - chunked->start.tv_sec) * 1000LL
+         + (long long)(now.tv_nsec - chunked->start.tv_nsec) / 1000000LL;
+   if ((msecs - chunked->reported) < (ODBCSHELL_CHUNKED_REPORT * 1000LL))
+      return;
+   chunked->reported = msecs;
+
+   // rows matching the statement may change while it runs
+   percent = ((chunked->total)) ? (chunked->rows * 100LL) / chunked->total : 100LL;
+   if (percent > 100)
+      percent = 100;
+   odbcshell_printf(cnf, "%lld of about %lld rows (%lld%%) in %lld chunks, %lld rows per second...\n",
+      chunked->rows, chunked->total, percent, chunked->chunks,
+      ((msecs)) ? (chunked->rows * 1000LL) / msecs : chunked->rows);
+
+   return;
+}
+
+
+/// @brief executes update or delete in ranges of keys, committing each range
+/// @param cnf      pointer to configuration struct
+/// @param size     rows wanted in each chunk
+/// @param column   key column dividing statement
+/// @param pause    milliseconds waited between chunks
+/// @param sql      update or delete statement
+int odbcshell_chunked_run(ODBCShell * cnf, long long size,
+   const char * column, long long pause, const char * sql)
+{
+   int                err;
+   int                integer;
+   char             * query;
+   char             * predicate;
+   size_t             len;
+   long long          min;
+   long long          max;
+   long long          count;
+   long long          rows;
+   long long          msecs;
+   SQLLEN             ind_min;
+   SQLLEN             ind_max;
+   SQLLEN             ind;
+   SQLSMALLINT        type;
+   SQLRETURN          sts;
+   struct timespec    end;
+   ODBCShellChunked   chunked;
+
+   if ((err = odbcshell_odbc_ready(cnf)))
+      return(err);
+
+   memset(&chunked, 0, sizeof(ODBCShellChunked));
+   chunked.sql    = sql;
+   chunked.column = column;
+   chunked.size   = size;
+   chunked.pause  = pause;
+   chunked.conn   = cnf->current;
+   clock_gettime(CLOCK_MONOTONIC, &chunked.start);
+
+   if ((err = odbcshell_chunked_parse(cnf, &chunked)))
+      return(err);
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, chunked.conn, &chunked.stmt)))
+   {
+      free(chunked.target);
+      return(err);
+   };
+
+   // applies statement timeout to each chunk
+   odbcshell_odbc_stmt_timeout(cnf, chunked.conn, chunked.stmt);
+
+   // lowest and highest keys decide whether keys are divided arithmetically
+   len = strlen(column) * 3 + strlen(chunked.target) + strlen(sql) + 96;
+   if (!(query = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_odbc_stmt_release(cnf, &chunked.stmt);
+      free(chunked.target);
+      return(-2);
+   };
+   snprintf(query, len, "SELECT MIN(%s), MAX(%s), COUNT(*), COUNT(%s) FROM %s%s%s",
+      column, column, column, chunked.target, ((chunked.where)) ? " WHERE " : "",
+      ((chunked.where)) ? &sql[chunked.where] : "");
+   odbcshell_verbose(cnf, "counting rows matching statement...\n");
+   sts = SQLExecDirect(chunked.stmt->hstmt, (SQLTCHAR *)query, SQL_NTS);
+   free(query);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, chunked.stmt);
+      odbcshell_odbc_stmt_release(cnf, &chunked.stmt);
+      free(chunked.target);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_describe(cnf, chunked.stmt)))
+   {
+      SQLCloseCursor(chunked.stmt->hstmt);
+      odbcshell_odbc_stmt_release(cnf, &chunked.stmt);
+      free(chunked.target);
+      return(err);
+   };
+   type    = chunked.stmt->cols[0].type;
+   integer = ( (type == SQL_TINYINT) || (type == SQL_SMALLINT) ||
+               (type == SQL_INTEGER) || (type == SQL_BIGINT) );
+
+   min     = 0;
+   max     = 0;
+   count   = 0;
+   ind_min = SQL_NULL_DATA;
+   ind_max = SQL_NULL_DATA;
+   if ((SQL_SUCCEEDED(sts = SQLFetch(chunked.stmt->hstmt))))
+   {
+      sts = SQLGetData(chunked.stmt->hstmt, 3, SQL_C_SBIGINT, &chunked.total, sizeof(long long), &ind);
+      if ((SQL_SUCCEEDED(sts)))
+         sts = SQLGetData(chunked.stmt->hstmt, 4, SQL_C_SBIGINT, &count, sizeof(count), &ind);
+      if ( (SQL_SUCCEEDED(sts)) && ((integer)) )
+         sts = SQLGetData(chunked.stmt->hstmt, 1, SQL_C_SBIGINT, &min, sizeof(min), &ind_min);
+      if ( (SQL_SUCCEEDED(sts)) && ((integer)) )
+         sts = SQLGetData(chunked.stmt->hstmt, 2, SQL_C_SBIGINT, &max, sizeof(max), &ind_max);
+   };
+   if ( (!(SQL_SUCCEEDED(sts))) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLGetData", cnf, chunked.stmt);
+      SQLCloseCursor(chunked.stmt->hstmt);
+      odbcshell_odbc_stmt_release(cnf, &chunked.stmt);
+      free(chunked.target);
+      return(-1);
+   };
+   SQLCloseCursor(chunked.stmt->hstmt);
+   odbcshell_verbose(cnf, "%lld rows match statement, %lld with a key\n", chunked.total, count);
+
+   // each chunk is committed on its own
+   sts = SQLSetConnectAttr(chunked.conn->hdbc, SQL_ATTR_AUTOCOMMIT,
+      (SQLPOINTER)SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_diag("SQLSetConnectAttr", cnf, chunked.conn->hdbc, NULL);
+      odbcshell_odbc_stmt_release(cnf, &chunked.stmt);
+      free(chunked.target);
+      return(-1);
+   };
+
+   if (!(count))
+      err = 0;
+   else if ( ((integer)) && (ind_min != SQL_NULL_DATA) && (ind_max != SQL_NULL_DATA) )
+      err = odbcshell_chunked_walk(cnf, &chunked, min, max, count);
+   else
+      err = odbcshell_chunked_tiles(cnf, &chunked, type, count);
+
+   // rows without a key fall outside every range
+   if ( (!(err)) && (chunked.total > count) )
+   {
+      len = strlen(column) + 16;
+      if (!(predicate = malloc(len)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+      }
+      else
+      {
+         snprintf(predicate, len, "%s IS NULL", column);
+         err = odbcshell_chunked_exec(cnf, &chunked, predicate, &rows);
+         free(predicate);
+      };
+   };
+
+   SQLSetConnectAttr(chunked.conn->hdbc, SQL_ATTR_AUTOCOMMIT,
+      (SQLPOINTER)SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
+   odbcshell_odbc_stmt_release(cnf, &chunked.stmt);
+   free(chunked.target);
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - chunked.start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - chunked.start.tv_nsec) / 1000000LL;
+   if (!(err))
+      odbcshell_printf(cnf, "changed %lld rows in %lld chunks in %lld ms.\n",
+         chunked.rows, chunked.chunks, msecs);
+
+   return(err);
+}
+
+
+/// @brief executes statement in ranges bounded by tiles of sorted keys
+/// @param cnf      pointer to configuration struct
+/// @param chunked  pointer to chunked statement
+/// @param type     SQL data type of key column
+/// @param count    rows matching statement with a key
+int odbcshell_chunked_tiles(ODBCShell * cnf, ODBCShellChunked * chunked,
+   SQLSMALLINT type, long long count)
+{
+   int          err;
+   char       * query;
+   char       * predicate;
+   char      ** cuts;
+   size_t       len;
+   long long    l;
+   long long    tiles;
+   long long    found;
+   long long    rows;
+   SQLLEN       ind;
+   SQLRETURN    sts;
+   const char * column;
+   char         buff[ODBCSHELL_FETCH_WIDTH];
+   char         prev[ODBCSHELL_FETCH_WIDTH];
+
+   column = chunked->column;
+   tiles  = (count + chunked->size - 1) / chunked->size;
+
+   // statement matching a single chunk of rows is executed once
+   if (tiles < 2)
+   {
+      len = strlen(column) + 16;
+      if (!(predicate = malloc(len)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+      snprintf(predicate, len, "%s IS NOT NULL", column);
+      err = odbcshell_chunked_exec(cnf, chunked, predicate, &rows);
+      free(predicate);
+      return(err);
+   };
+
+   if (!(cuts = calloc((size_t)tiles, sizeof(char *))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+
+   // keys are divided at the highest key of each tile of sorted keys
+   len = strlen(column) * 5 + strlen(chunked->target) + strlen(chunked->sql) + 256;
+   if (!(query = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      free(cuts);
+      return(-2);
+   };
+   snprintf(query, len, "SELECT MAX(%s) FROM (SELECT %s, NTILE(%lld) OVER (ORDER BY %s)"
+      " AS odbcshell_tile FROM %s WHERE %s%s%s%s IS NOT NULL) odbcshell_tiles"
+      " GROUP BY odbcshell_tile ORDER BY 1", column, column, tiles, column,
+      chunked->target, ((chunked->where)) ? "(" : "",
+      ((chunked->where)) ? &chunked->sql[chunked->where] : "",
+      ((chunked->where)) ? ") AND " : "", column);
+   odbcshell_verbose(cnf, "sampling %lld tiles of \"%s\"...\n", tiles, column);
+   sts = SQLExecDirect(chunked->stmt->hstmt, (SQLTCHAR *)query, SQL_NTS);
+   free(query);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, chunked->stmt);
+      free(cuts);
+      return(-1);
+   };
+
+   // keys shared by neighboring tiles produce a single cut point
+   err     = 0;
+   found   = 0;
+   prev[0] = '\0';
+   while ( (found < tiles) && ((SQL_SUCCEEDED(sts = SQLFetch(chunked->stmt->hstmt)))) )
+   {
+      sts = SQLGetData(chunked->stmt->hstmt, 1, SQL_C_CHAR, buff, sizeof(buff), &ind);
+      if (!(SQL_SUCCEEDED(sts)))
+         break;
+      if ( (ind == SQL_NULL_DATA) || ( ((found)) && (!(strcmp(buff, prev))) ) )
+         continue;
+      if (!(cuts[found] = odbcshell_export_literal(type, buff)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+         break;
+      };
+      snprintf(prev, sizeof(prev), "%s", buff);
+      found++;
+   };
+   if ( (!(err)) && (!(SQL_SUCCEEDED(sts))) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLFetch", cnf, chunked->stmt);
+      err = -1;
+   };
+   SQLCloseCursor(chunked->stmt->hstmt);
+
+   // highest key of the last tile is not needed since the last range is open
+   for(l = 0; ( (!(err)) && (l < found) ); l++)
+   {
+      len = strlen(column) * 2 + (((l)) ? strlen(cuts[l-1]) : 0) + strlen(cuts[l]) + 32;
+      if (!(predicate = malloc(len)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+         break;
+      };
+      if (found == 1)
+         snprintf(predicate, len, "%s IS NOT NULL", column);
+      else if (!(l))
+         snprintf(predicate, len, "%s <= %s", column, cuts[l]);
+      else if (l == (found - 1))
+         snprintf(predicate, len, "%s > %s", column, cuts[l-1]);
+      else
+         snprintf(predicate, len, "%s > %s AND %s <= %s", column, cuts[l-1], column, cuts[l]);
+      err = odbcshell_chunked_exec(cnf, chunked, predicate, &rows);
+      free(predicate);
+   };
+
+   for(l = 0; l < tiles; l++)
+      free(cuts[l]);
+   free(cuts);
+
+   return(err);
+}
+
+
+/// @brief executes statement in ranges of integer keys sized by the rows found
+/// @param cnf      pointer to configuration struct
+/// @param chunked  pointer to chunked statement
+/// @param min      lowest key matching statement
+/// @param max      highest key matching statement
+/// @param count    rows matching statement with a key
+int odbcshell_chunked_walk(ODBCShell * cnf, ODBCShellChunked * chunked,
+   long long min, long long max, long long count)
+{
+   int                  err;
+   int                  first;
+   int                  last;
+   long long            lo;
+   long long            hi;
+   long long            rows;
+   long double          next;
+   unsigned long long   span;
+   unsigned long long   width;
+   const char         * column;
+   char                 predicate[ODBCSHELL_FETCH_WIDTH];
+
+   column = chunked->column;
+   if (strlen(column) > (sizeof(predicate) / 2 - 64))
+   {
+      odbcshell_error(cnf, "name of key column is too long\n");
+      return(-1);
+   };
+
+   // first range is as wide as the keys would be if evenly spread
+   span  = (unsigned long long)max - (unsigned long long)min + 1ULL;
+   next  = (long double)(((span)) ? span : ULLONG_MAX) * (long double)chunked->size / (long double)count;
+   width = (next < 1.0L) ? 1ULL : (next >= (long double)ULLONG_MAX) ? ULLONG_MAX : (unsigned long long)next;
+
+   // first and last ranges are open so that keys added while the
+   // statement runs are not missed
+   err   = 0;
+   lo    = min;
+   first = 1;
+   while(!(err))
+   {
+      last = (width > ((unsigned long long)max - (unsigned long long)lo));
+      hi   = (long long)((unsigned long long)lo + width);
+      if ( ((first)) && ((last)) )
+         snprintf(predicate, sizeof(predicate), "%s IS NOT NULL", column);
+      else if ((first))
+         snprintf(predicate, sizeof(predicate), "%s < %lld", column, hi);
+      else if ((last))
+         snprintf(predicate, sizeof(predicate), "%s >= %lld", column, lo);
+      else
+         snprintf(predicate, sizeof(predicate), "%s >= %lld AND %s < %lld", column, lo, column, hi);
+      if ( ((err = odbcshell_chunked_exec(cnf, chunked, predicate, &rows))) || ((last)) )
+         break;
+
+      // next range is resized by the density of keys in this one, within
+      // limits so that a gap or cluster of keys does not overshoot
+      next = (long double)width * 4.0L;
+      if ((rows))
+         next = (long double)width * (long double)chunked->size / (long double)rows;
+      if (next > ((long double)width * 4.0L))
+         next = (long double)width * 4.0L;
+      if (next < ((long double)width / 4.0L))
+         next = (long double)width / 4.0L;
+      width = (next < 1.0L) ? 1ULL : (next >= (long double)ULLONG_MAX) ? ULLONG_MAX : (unsigned long long)next;
+
+      lo    = hi;
+      first = 0;
+   };
+
+   return(err);
+}
+
+/* end of source */
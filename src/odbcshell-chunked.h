@@ -0,0 +1,92 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-chunked.h ODBC Shell executes updates and deletes in ranges of keys
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_CHUNKED_H
+#define _ODBCSHELL_SRC_ODBCSHELL_CHUNKED_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// tests whether the SET list of an UPDATE assigns the key column
+int odbcshell_chunked_assigns(const char * sql, size_t start, size_t end,
+   const char * column);
+
+// executes and commits statement restricted to one range of keys
+int odbcshell_chunked_exec(ODBCShell * cnf, ODBCShellChunked * chunked,
+   const char * predicate, long long * rowsp);
+
+// finds keyword outside of quotes and parentheses
+long long odbcshell_chunked_keyword(const char * sql, const char * keyword);
+
+// finds table and condition of statement
+int odbcshell_chunked_parse(ODBCShell * cnf, ODBCShellChunked * chunked);
+
+// reports progress of statement
+void odbcshell_chunked_progress(ODBCShell * cnf, ODBCShellChunked * chunked);
+
+// executes update or delete in ranges of keys, committing each range
+int odbcshell_chunked_run(ODBCShell * cnf, long long size,
+   const char * column, long long pause, const char * sql);
+
+// executes statement in ranges bounded by tiles of sorted keys
+int odbcshell_chunked_tiles(ODBCShell * cnf, ODBCShellChunked * chunked,
+   SQLSMALLINT type, long long count);
+
+// executes statement in ranges of integer keys sized by the rows found
+int odbcshell_chunked_walk(ODBCShell * cnf, ODBCShellChunked * chunked,
+   long long min, long long max, long long count);
+
+#endif
+/* end of header */
@@ -54,8 +54,11 @@
 #include <readline/history.h>
 
 #include "odbcshell-commands.h"
+#include "odbcshell-connect.h"
+#include "odbcshell-jobs.h"
 #include "odbcshell-odbc.h"
 #include "odbcshell-parse.h"
+#include "odbcshell-signal.h"
 #include "odbcshell-variables.h"
 
 
@@ -108,13 +111,21 @@ int odbcshell_cli_loop(ODBCShell * cnf)
       printf("Type \"help\" for usage information.\n\n");
    };
 
-   if (cnf->dflt_dsn)
-      odbcshell_odbc_connect(cnf, cnf->dflt_dsn, NULL);
+   odbcshell_connect_dflt(cnf);
 
    buffer = strdup("");
 
-   while((input = readline((!(buffer[0])) ? cnf->prompt : "> ")))
+   // Ctrl-C discards the current line instead of exiting
+   odbcshell_signal_prompt(1);
+
+   while(1)
    {
+      // reports background jobs which completed since the last prompt
+      odbcshell_job_notify(cnf);
+
+      if (!(input = readline((!(buffer[0])) ? cnf->prompt : "> ")))
+         break;
+
       if (strlen(input))
       {
          ptr = realloc(buffer, (strlen(buffer) + strlen(input) + 1));
@@ -142,6 +153,7 @@ int odbcshell_cli_loop(ODBCShell * cnf)
             {
                if (cnf->history)
                   write_history(cnf->histfile);
+               odbcshell_signal_prompt(0);
                return(code);
             };
             break;
@@ -158,6 +170,8 @@ int odbcshell_cli_loop(ODBCShell * cnf)
       buffer[0] = '\0';
    };
 
+   odbcshell_signal_prompt(0);
+
    return(0);
 }
 
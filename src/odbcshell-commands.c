@@ -52,10 +52,25 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "odbcshell-bench.h"
+#include "odbcshell-chunked.h"
 #include "odbcshell-commands.h"
+#include "odbcshell-compare.h"
+#include "odbcshell-connect.h"
+#include "odbcshell-copy.h"
+#include "odbcshell-dump.h"
+#include "odbcshell-export.h"
+#include "odbcshell-cursor.h"
+#include "odbcshell-fanout.h"
+#include "odbcshell-generate.h"
+#include "odbcshell-group.h"
+#include "odbcshell-import.h"
+#include "odbcshell-jobs.h"
 #include "odbcshell-options.h"
+#include "odbcshell-parallel.h"
 #include "odbcshell-print.h"
 #include "odbcshell-script.h"
+#include "odbcshell-tune.h"
 #include "odbcshell-variables.h"
 #include "odbcshell-odbc.h"
 
@@ -84,6 +99,129 @@ extern char ** environ;
 #pragma mark Functions
 #endif
 
+/// @brief replays statements of a script on several sessions to measure latency
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_bench(ODBCShell * cnf, int argc, char ** argv)
+{
+   int           i;
+   long long     sessions;
+   long long     duration;
+   long long     think;
+   const char  * json;
+   char        * end;
+
+   sessions = 1;
+   duration = ODBCSHELL_BENCH_SECONDS * 1000LL;
+   think    = 0;
+   json     = NULL;
+
+   for(i = 1; i < (argc - 1); i += 2)
+   {
+      if (!(strcasecmp(argv[i], "-c")))
+      {
+         sessions = strtoll(argv[i+1], &end, 10);
+         if ( ((end[0])) || (sessions < 1) )
+         {
+            odbcshell_error(cnf, "invalid number of sessions \"%s\"\n", argv[i+1]);
+            return(-1);
+         };
+      }
+      else if (!(strcasecmp(argv[i], "-d")))
+      {
+         if ( ((odbcshell_bench_duration(argv[i+1], &duration))) || (duration < 1) )
+         {
+            odbcshell_error(cnf, "invalid duration \"%s\"\n", argv[i+1]);
+            return(-1);
+         };
+      }
+      else if (!(strcasecmp(argv[i], "-t")))
+      {
+         if ((odbcshell_bench_duration(argv[i+1], &think)))
+         {
+            odbcshell_error(cnf, "invalid think time \"%s\"\n", argv[i+1]);
+            return(-1);
+         };
+      }
+      else if (!(strcasecmp(argv[i], "-o")))
+      {
+         json = argv[i+1];
+      }
+      else
+      {
+         break;
+      };
+   };
+   if (i != (argc - 1))
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   return(odbcshell_bench_run(cnf, sessions, duration, think, argv[argc-1], json));
+}
+
+
+/// @brief executes an update or delete in ranges of keys
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @param str      unparsed command string
+/// @return exit code
+int odbcshell_cmd_chunked(ODBCShell * cnf, int argc, char ** argv, char * str)
+{
+   int         skip;
+   size_t      pos;
+   long long   size;
+   long long   pause;
+   char      * end;
+
+   if ((strcasecmp(argv[2], "by")))
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   size = strtoll(argv[1], &end, 10);
+   if ( ((end[0])) || (size < 1) )
+   {
+      odbcshell_error(cnf, "invalid number of rows \"%s\"\n", argv[1]);
+      return(-1);
+   };
+
+   pause = 0;
+   skip  = 4;
+   if ( (!(strcasecmp(argv[4], "pause"))) && (argc > 6) )
+   {
+      if ((odbcshell_bench_duration(argv[5], &pause)))
+      {
+         odbcshell_error(cnf, "invalid duration \"%s\"\n", argv[5]);
+         return(-1);
+      };
+      skip = 6;
+   };
+
+   // passes remainder of line to ODBC unparsed
+   pos = 0;
+   while(skip)
+   {
+      while ((str[pos] == ' ') || (str[pos] == '\t'))
+         pos++;
+      while ((str[pos] != ' ') && (str[pos] != '\t'))
+         pos++;
+      skip--;
+   };
+   while ((str[pos] == ' ') || (str[pos] == '\t'))
+      pos++;
+
+   return(odbcshell_chunked_run(cnf, size, argv[3], pause, &str[pos]));
+}
+
+
 /// @brief clears the screen
 /// @return always returns zero
 int odbcshell_cmd_clear(void)
@@ -102,6 +240,24 @@ int odbcshell_cmd_close(ODBCShell * cnf)
 }
 
 
+/// @brief compares rows of a table on two connections
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_compare(ODBCShell * cnf, int argc, char ** argv)
+{
+   if ( (argc != 4) && (argc != 5) )
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+   return(odbcshell_compare_run(cnf, argv[1], argv[2], argv[3],
+      (argc == 5) ? argv[4] : NULL));
+}
+
+
 /// @brief connects to database
 /// @param cnf      pointer to configuration struct
 /// @param argc     number of arguments passed to command
@@ -109,12 +265,143 @@ int odbcshell_cmd_close(ODBCShell * cnf)
 /// @return exit code
 int odbcshell_cmd_connect(ODBCShell * cnf, int argc, char ** argv)
 {
+   int           i;
+   int           err;
+   const char ** names;
+   const char ** dsns;
+
+   if (!(strcasecmp(argv[1], "-parallel")))
+   {
+      if ( (argc < 4) || ((argc % 2)) )
+      {
+         odbcshell_error(cnf, "expected pairs of names and connection strings\n");
+         return(-1);
+      };
+      names = malloc(sizeof(char *) * (size_t)((argc - 2) / 2));
+      dsns  = malloc(sizeof(char *) * (size_t)((argc - 2) / 2));
+      if ( (!(names)) || (!(dsns)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         free(names);
+         free(dsns);
+         return(-2);
+      };
+      for(i = 2; i < argc; i += 2)
+      {
+         names[(i-2)/2] = argv[i];
+         dsns[(i-2)/2]  = argv[i+1];
+      };
+      err = odbcshell_connect_parallel(cnf, (argc - 2) / 2, names, dsns);
+      free(names);
+      free(dsns);
+      return(err);
+   };
+
+   if (argc > 3)
+   {
+      odbcshell_error(cnf, "too many arguments\n");
+      return(-1);
+   };
    if (argc == 3)
       return(odbcshell_odbc_connect(cnf, argv[2], argv[1]));
    return(odbcshell_odbc_connect(cnf, argv[1], NULL));
 }
 
 
+/// @brief copies rows of a query into a table of another connection
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_copy(ODBCShell * cnf, int argc, char ** argv)
+{
+   long long   batch;
+   char      * end;
+
+   if ( ((argc != 7) && (argc != 9)) ||
+        ((strcasecmp(argv[1], "from"))) ||
+        ((strcasecmp(argv[4], "to"))) ||
+        ((argc == 9) && ((strcasecmp(argv[7], "batch")))) )
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   batch = ODBCSHELL_COPY_BATCH;
+   if (argc == 9)
+   {
+      batch = strtoll(argv[8], &end, 10);
+      if ( ((end[0])) || (batch < 1) )
+      {
+         odbcshell_error(cnf, "invalid number of rows \"%s\"\n", argv[8]);
+         return(-1);
+      };
+   };
+
+   return(odbcshell_copy_run(cnf, argv[2], argv[3], argv[5], argv[6], batch));
+}
+
+
+/// @brief manages named cursors
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @param str      unparsed command string
+/// @return exit code
+int odbcshell_cmd_cursor(ODBCShell * cnf, int argc, char ** argv, char * str)
+{
+   int         skip;
+   long long   rows;
+   size_t      pos;
+   char      * end;
+
+   if (argc < 2)
+      return(odbcshell_cursor_list(cnf));
+
+   if ( (!(strcasecmp(argv[1], "open"))) && (argc >= 4) )
+   {
+      // passes remainder of line to ODBC unparsed
+      pos  = 0;
+      skip = 3;
+      while(skip)
+      {
+         while ((str[pos] == ' ') || (str[pos] == '\t'))
+            pos++;
+         while ((str[pos] != ' ') && (str[pos] != '\t'))
+            pos++;
+         skip--;
+      };
+      while ((str[pos] == ' ') || (str[pos] == '\t'))
+         pos++;
+      return(odbcshell_cursor_open(cnf, argv[2], &str[pos]));
+   };
+
+   if ( (!(strcasecmp(argv[1], "fetch"))) && (argc >= 3) && (argc <= 4) )
+   {
+      rows = ODBCSHELL_CURSOR_ROWS;
+      if (argc == 4)
+      {
+         rows = strtoll(argv[3], &end, 10);
+         if ( ((end[0])) || (rows < 1) )
+         {
+            odbcshell_error(cnf, "invalid number of rows \"%s\"\n", argv[3]);
+            return(-1);
+         };
+      };
+      return(odbcshell_cursor_fetch(cnf, argv[2], rows));
+   };
+
+   if ( (!(strcasecmp(argv[1], "close"))) && (argc == 3) )
+      return(odbcshell_cursor_close(cnf, argv[2]));
+
+   odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+   odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+
+   return(-1);
+}
+
+
 /// @brief disconnects from database
 /// @param cnf      pointer to configuration struct
 /// @param argc     number of arguments passed to command
@@ -128,6 +415,68 @@ int odbcshell_cmd_disconnect(ODBCShell * cnf, int argc, char ** argv)
 }
 
 
+/// @brief writes each table to its own file
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_dump(ODBCShell * cnf, int argc, char ** argv)
+{
+   int          pos;
+   long long    jobs;
+   long long    format;
+   char       * end;
+   const char * dir;
+   const char * schema;
+
+   schema = NULL;
+   format = -1;
+   jobs   = cnf->concurrency;
+
+   pos = 1;
+   if ( (argc > 2) && ((strcasecmp(argv[1], "to"))) )
+      schema = argv[pos++];
+   if ( ((pos + 2) > argc) || ((strcasecmp(argv[pos], "to"))) )
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   dir = argv[pos + 1];
+
+   // format and number of connections may follow in either order
+   for(pos += 2; pos < argc; pos++)
+   {
+      if ( (!(strcmp(argv[pos], "-j"))) && ((pos + 1) < argc) )
+      {
+         jobs = strtoll(argv[++pos], &end, 10);
+         if ( ((end[0])) || (jobs < 1) )
+         {
+            odbcshell_error(cnf, "invalid number of connections \"%s\"\n", argv[pos]);
+            return(-1);
+         };
+      }
+      else if ( (format == -1) && (!(strcasecmp(argv[pos], "csv"))) )
+         format = ODBCSHELL_FORMAT_CSV;
+      else if ( (format == -1) && (!(strcasecmp(argv[pos], "fixed"))) )
+         format = ODBCSHELL_FORMAT_FIXED;
+      else if ( (format == -1) && (!(strcasecmp(argv[pos], "xml"))) )
+         format = ODBCSHELL_FORMAT_XML;
+      else
+      {
+         odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+         odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+         return(-1);
+      };
+   };
+   if (format == -1)
+      format = cnf->format;
+
+   return(odbcshell_dump_run(cnf, schema, dir, format, jobs));
+}
+
+
 /// @brief prints strings to screen
 /// @param cnf      pointer to configuration struct
 /// @param argc     number of arguments passed to command
@@ -156,7 +505,10 @@ int odbcshell_cmd_echo(ODBCShell * cnf, int argc, char ** argv)
 /// @return exit code
 int odbcshell_cmd_exec(ODBCShell * cnf, char * sql, int skip)
 {
+   int    code;
+   char   bg;
    size_t pos;
+   size_t len;
 
    pos = 0;
 
@@ -169,7 +521,158 @@ int odbcshell_cmd_exec(ODBCShell * cnf, char * sql, int skip)
       skip--;
    };
 
-   return(odbcshell_odbc_exec(cnf, &sql[pos]));
+   // checks for trailing '&' requesting background execution
+   for(len = strlen(&sql[pos]); ((len > 0) && (strchr(" \t\r\n", sql[pos+len-1]))); len--);
+   if ( (len < 1) || (sql[pos+len-1] != '&') )
+      return(odbcshell_odbc_exec(cnf, &sql[pos]));
+
+   bg = sql[pos+len-1];
+   sql[pos+len-1] = '\0';
+   code = odbcshell_job_start(cnf, &sql[pos]);
+   sql[pos+len-1] = bg;
+
+   return(code);
+}
+
+
+/// @brief exports a query in ranges of keys over several connections
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_export(ODBCShell * cnf, int argc, char ** argv)
+{
+   long long   parallel;
+   char      * end;
+
+   if ( ((argc != 6) && (argc != 8)) ||
+        ((strcasecmp(argv[1], "parallel"))) ||
+        ((strcasecmp(argv[3], "by"))) ||
+        ((argc == 8) && ((strcasecmp(argv[6], "to")))) )
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   parallel = strtoll(argv[2], &end, 10);
+   if ( ((end[0])) || (parallel < 1) )
+   {
+      odbcshell_error(cnf, "invalid number of connections \"%s\"\n", argv[2]);
+      return(-1);
+   };
+
+   return(odbcshell_export_run(cnf, parallel, argv[4], argv[5],
+      (argc == 8) ? argv[7] : NULL));
+}
+
+
+/// @brief inserts synthetic rows into a table
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_generate(ODBCShell * cnf, int argc, char ** argv)
+{
+   int           i;
+   int           code;
+   int           count;
+   long long     rows;
+   long long     jobs;
+   long long     batch;
+   long long     seed;
+   long long   * valp;
+   char       ** specs;
+   char        * end;
+
+   jobs  = cnf->concurrency;
+   batch = ODBCSHELL_COPY_BATCH;
+   seed  = 1;
+
+   if ((strcasecmp(argv[2], "rows")))
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+   rows = strtoll(argv[3], &end, 10);
+   if ( ((end[0])) || (rows < 1) )
+   {
+      odbcshell_error(cnf, "invalid number of rows \"%s\"\n", argv[3]);
+      return(-1);
+   };
+
+   // each column is given as a name, an equal sign, and a generator
+   if (!(specs = malloc(sizeof(char *) * (size_t)argc)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   count = 0;
+   for(i = 4; i < argc; i++)
+   {
+      valp = NULL;
+      if ( ((i + 2) < argc) && (!(strcmp(argv[i+1], "="))) )
+      {
+         specs[count*2]     = argv[i];
+         specs[(count*2)+1] = argv[i+2];
+         count++;
+         i += 2;
+         continue;
+      }
+      else if ( (!(strcasecmp(argv[i], "-j"))) && ((i + 1) < argc) )
+         valp = &jobs;
+      else if ( (!(strcasecmp(argv[i], "-batch"))) && ((i + 1) < argc) )
+         valp = &batch;
+      else if ( (!(strcasecmp(argv[i], "-seed"))) && ((i + 1) < argc) )
+         valp = &seed;
+      else
+      {
+         odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+         odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+         free(specs);
+         return(-1);
+      };
+      i++;
+      (*valp) = strtoll(argv[i], &end, 10);
+      if ( ((end[0])) || ( (valp != &seed) && ((*valp) < 1) ) )
+      {
+         odbcshell_error(cnf, "invalid value \"%s\" for %s\n", argv[i], argv[i-1]);
+         free(specs);
+         return(-1);
+      };
+   };
+
+   code = odbcshell_generate_run(cnf, argv[1], rows, jobs, batch, seed,
+      count, specs);
+   free(specs);
+
+   return(code);
+}
+
+
+/// @brief declares and displays connection groups
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_group(ODBCShell * cnf, int argc, char ** argv)
+{
+   if (argc == 1)
+      return(odbcshell_group_list(cnf, NULL));
+   if (argc == 2)
+      return(odbcshell_group_list(cnf, argv[1]));
+
+   if (!(strcasecmp(argv[1], "-remove")))
+   {
+      if (argc == 3)
+         return(odbcshell_group_remove(cnf, argv[2]));
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   return(odbcshell_group_set(cnf, argv[1], argc-2, &argv[2]));
 }
 
 
@@ -236,6 +739,81 @@ int odbcshell_cmd_help(ODBCShell * cnf, int argc, char ** argv)
 }
 
 
+/// @brief loads a delimited file into a table
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_import(ODBCShell * cnf, int argc, char ** argv)
+{
+   int           i;
+   int           header;
+   int           delimiter;
+   long long     jobs;
+   long long     commit;
+   long long     batch;
+   long long   * valp;
+   char        * end;
+
+   jobs      = cnf->concurrency;
+   commit    = 0;
+   batch     = ODBCSHELL_COPY_BATCH;
+   delimiter = ',';
+   header    = 0;
+
+   if ((strcasecmp(argv[2], "into")))
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   for(i = 4; i < argc; i++)
+   {
+      valp = NULL;
+      if (!(strcasecmp(argv[i], "-header")))
+      {
+         header = 1;
+         continue;
+      }
+      else if ( (!(strcasecmp(argv[i], "-delimiter"))) && ((i + 1) < argc) )
+      {
+         i++;
+         delimiter = (!(strcasecmp(argv[i], "tab"))) ? '\t' : argv[i][0];
+         if ( ( ((argv[i][0])) && ((argv[i][1])) && (delimiter != '\t') ) ||
+              (!(delimiter)) || ((strchr("\"\r\n", delimiter))) )
+         {
+            odbcshell_error(cnf, "invalid delimiter \"%s\"\n", argv[i]);
+            return(-1);
+         };
+         continue;
+      }
+      else if ( (!(strcasecmp(argv[i], "-j"))) && ((i + 1) < argc) )
+         valp = &jobs;
+      else if ( (!(strcasecmp(argv[i], "-commit"))) && ((i + 1) < argc) )
+         valp = &commit;
+      else if ( (!(strcasecmp(argv[i], "-batch"))) && ((i + 1) < argc) )
+         valp = &batch;
+      else
+      {
+         odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+         odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+         return(-1);
+      };
+      i++;
+      (*valp) = strtoll(argv[i], &end, 10);
+      if ( ((end[0])) || ((*valp) < ((valp == &commit) ? 0 : 1)) )
+      {
+         odbcshell_error(cnf, "invalid value \"%s\" for %s\n", argv[i], argv[i-1]);
+         return(-1);
+      };
+   };
+
+   return(odbcshell_import_run(cnf, argv[1], argv[3], jobs, commit, batch,
+      delimiter, header));
+}
+
+
 /// @brief displays information stating the function is incomplete
 /// @param cnf      pointer to configuration struct
 /// @param argc     number of arguments passed to command
@@ -250,6 +828,52 @@ int odbcshell_cmd_incomplete(ODBCShell * cnf, int argc, char ** argv)
 }
 
 
+/// @brief displays list of background jobs
+/// @param cnf      pointer to configuration struct
+/// @return exit code
+int odbcshell_cmd_jobs(ODBCShell * cnf)
+{
+   odbcshell_job_notify(cnf);
+   return(odbcshell_job_list(cnf));
+}
+
+
+/// @brief executes statement on several connections at once
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @param str      unparsed command string
+/// @return exit code
+int odbcshell_cmd_on(ODBCShell * cnf, int argc, char ** argv, char * str)
+{
+   int         skip;
+   size_t      pos;
+
+   if (argc < 3)
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   // passes remainder of line to ODBC unparsed
+   pos  = 0;
+   skip = 2;
+   while(skip)
+   {
+      while ((str[pos] == ' ') || (str[pos] == '\t'))
+         pos++;
+      while ((str[pos] != ' ') && (str[pos] != '\t'))
+         pos++;
+      skip--;
+   };
+   while ((str[pos] == ' ') || (str[pos] == '\t'))
+      pos++;
+
+   return(odbcshell_fanout_on(cnf, argv[1], &str[pos]));
+}
+
+
 /// @brief opens file for writing results
 /// @param cnf      pointer to configuration struct
 /// @param argc     number of arguments passed to command
@@ -269,6 +893,43 @@ int odbcshell_cmd_open(ODBCShell * cnf, int argc, char ** argv)
 }
 
 
+/// @brief begins and ends blocks of statements which are run at once
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_parallel(ODBCShell * cnf, int argc, char ** argv)
+{
+   long long   max;
+   char      * end;
+
+   if ( (argc == 2) && (!(strcasecmp(argv[1], "end"))) )
+      return(odbcshell_parallel_end(cnf));
+
+   if ( (argc > 3) || ((strcasecmp(argv[1], "begin"))) )
+   {
+      odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+      odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+      return(-1);
+   };
+
+   max = cnf->concurrency;
+   if (argc == 3)
+   {
+      max = strtoll(argv[2], &end, 10);
+      if ( ((end[0])) || (max < 1) )
+      {
+         odbcshell_error(cnf, "invalid number of connections \"%s\"\n", argv[2]);
+         return(-1);
+      };
+   };
+   if (max < 1)
+      max = 1;
+
+   return(odbcshell_parallel_begin(cnf, max));
+}
+
+
 /// @brief reconnects to a database
 /// @param cnf      pointer to configuration struct
 /// @param argc     number of arguments passed to command
@@ -472,6 +1133,32 @@ int odbcshell_cmd_source(ODBCShell * cnf, const char * file)
 }
 
 
+/// @brief displays and declares performance settings of data sources
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_tune(ODBCShell * cnf, int argc, char ** argv)
+{
+   switch(argc)
+   {
+      case 1:
+         return(odbcshell_tune_list(cnf, NULL));
+      case 2:
+         return(odbcshell_tune_list(cnf, argv[1]));
+      case 4:
+         return(odbcshell_tune_set(cnf, argv[1], argv[2], argv[3]));
+      default:
+         break;
+   };
+
+   odbcshell_error(cnf, "%s: unknown arguments\n", argv[0]);
+   odbcshell_error(cnf, "try `help %s;' for more information.\n", argv[0]);
+
+   return(-1);
+}
+
+
 /// @brief unsets internal value of configuration parameter
 /// @param cnf      pointer to configuration struct
 /// @param argv     array of arguments passed to command
@@ -544,6 +1231,30 @@ int odbcshell_cmd_use(ODBCShell * cnf, int argc, char ** argv)
 }
 
 
+/// @brief waits for background jobs to complete
+/// @param cnf      pointer to configuration struct
+/// @param argc     number of arguments passed to command
+/// @param argv     array of arguments passed to command
+/// @return exit code
+int odbcshell_cmd_wait(ODBCShell * cnf, int argc, char ** argv)
+{
+   long long id;
+   char    * end;
+
+   if (argc < 2)
+      return(odbcshell_job_wait(cnf, 0));
+
+   id = strtoll(argv[1], &end, 10);
+   if ( ((end[0])) || (id < 1) )
+   {
+      odbcshell_error(cnf, "invalid job number \"%s\"\n", argv[1]);
+      return(-1);
+   };
+
+   return(odbcshell_job_wait(cnf, id));
+}
+
+
 /// @brief exits from shell
 /// @param cnf      pointer to configuration struct
 /// @return exit code
@@ -59,33 +59,72 @@
 #pragma mark Prototypes
 #endif
 
+// replays statements of a script on several sessions to measure latency
+int odbcshell_cmd_bench(ODBCShell * cnf, int argc, char ** argv);
+
+// executes an update or delete in ranges of keys
+int odbcshell_cmd_chunked(ODBCShell * cnf, int argc, char ** argv, char * str);
+
 // clears the screen
 int odbcshell_cmd_clear(void);
 
 // closes output file
 int odbcshell_cmd_close(ODBCShell * cnf);
 
+// compares rows of a table on two connections
+int odbcshell_cmd_compare(ODBCShell * cnf, int argc, char ** argv);
+
 // prints strings to screen
 int odbcshell_cmd_connect(ODBCShell * cnf, int argc, char ** argv);
 
+// copies rows of a query into a table of another connection
+int odbcshell_cmd_copy(ODBCShell * cnf, int argc, char ** argv);
+
+// manages named cursors
+int odbcshell_cmd_cursor(ODBCShell * cnf, int argc, char ** argv, char * str);
+
 // disconnects from database
 int odbcshell_cmd_disconnect(ODBCShell * cnf, int argc, char ** argv);
 
+// writes each table to its own file
+int odbcshell_cmd_dump(ODBCShell * cnf, int argc, char ** argv);
+
 // prints strings to screen
 int odbcshell_cmd_echo(ODBCShell * cnf, int argc, char ** argv);
 
 // executes SQL statement
 int odbcshell_cmd_exec(ODBCShell * cnf, char * sql, int skip);
 
+// exports a query in ranges of keys over several connections
+int odbcshell_cmd_export(ODBCShell * cnf, int argc, char ** argv);
+
+// inserts synthetic rows into a table
+int odbcshell_cmd_generate(ODBCShell * cnf, int argc, char ** argv);
+
+// declares and displays connection groups
+int odbcshell_cmd_group(ODBCShell * cnf, int argc, char ** argv);
+
 // displays usage information
 int odbcshell_cmd_help(ODBCShell * cnf, int argc, char ** argv);
 
+// loads a delimited file into a table
+int odbcshell_cmd_import(ODBCShell * cnf, int argc, char ** argv);
+
 // displays information stating the function is incomplete
 int odbcshell_cmd_incomplete(ODBCShell * cnf, int argc, char ** argv);
 
+// displays list of background jobs
+int odbcshell_cmd_jobs(ODBCShell * cnf);
+
+// executes statement on several connections at once
+int odbcshell_cmd_on(ODBCShell * cnf, int argc, char ** argv, char * str);
+
 // opens file for writing results
 int odbcshell_cmd_open(ODBCShell * cnf, int argc, char ** argv);
 
+// begins and ends blocks of statements which are run at once
+int odbcshell_cmd_parallel(ODBCShell * cnf, int argc, char ** argv);
+
 // exits from shell
 int odbcshell_cmd_quit(ODBCShell * cnf);
 
@@ -107,6 +146,9 @@ int odbcshell_cmd_show(ODBCShell * cnf, const char * data);
 // imports script into session
 int odbcshell_cmd_source(ODBCShell * cnf, const char * file);
 
+// displays and declares performance settings of data sources
+int odbcshell_cmd_tune(ODBCShell * cnf, int argc, char ** argv);
+
 // unsets internal value of configuration parameter
 int odbcshell_cmd_unset(ODBCShell * cnf, char ** argv);
 
@@ -119,6 +161,9 @@ int odbcshell_cmd_use(ODBCShell * cnf, int argc, char ** argv);
 // displays version information
 int odbcshell_cmd_version(ODBCShell * cnf);
 
+// waits for background jobs to complete
+int odbcshell_cmd_wait(ODBCShell * cnf, int argc, char ** argv);
+
 
 #endif
 /* end of header */
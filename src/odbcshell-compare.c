@@ -0,0 +1,695 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-compare.c ODBC Shell compares a table between connections
+ */
+#include "odbcshell-compare.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-copy.h"
+#include "odbcshell-export.h"
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief hashes a chunk of the table on both connections at once
+/// @param cnf      pointer to configuration struct
+/// @param compare  pointer to compare state
+/// @param where    condition selecting rows of chunk (NULL for all rows)
+/// @param keep     most rows kept for comparing row by row (-1 for all)
+/// @param sides    array of two sides receiving hashes and rows
+int odbcshell_compare_chunk(ODBCShell * cnf, ODBCShellCompare * compare,
+   const char * where, long long keep, ODBCShellCompareSide * sides)
+{
+   int               err;
+   int               l;
+   char            * sql;
+   size_t            len;
+   sigset_t          oldset;
+   pthread_t         tid;
+   ODBCShellCompareSide * side;
+
+   memset(sides, 0, sizeof(ODBCShellCompareSide) * 2);
+
+   len = strlen(compare->table) + (((where)) ? strlen(where) : 0) + 32;
+   if (!(sql = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   if ((where))
+      snprintf(sql, len, "SELECT * FROM %s WHERE %s", compare->table, where);
+   else
+      snprintf(sql, len, "SELECT * FROM %s", compare->table);
+
+   for(l = 0; l < 2; l++)
+   {
+      side       = &sides[l];
+      side->conn = compare->conns[l];
+      side->sql  = sql;
+      side->keep = keep;
+      side->kept = 1;
+      if (!(side->output = open_memstream(&side->buff, &side->bufflen)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         if ((l))
+            fclose(sides[0].output);
+         free(sides[0].buff);
+         free(sql);
+         return(-2);
+      };
+
+      // messages of each connection are reported together
+      odbcshell_clone(cnf, &side->cnf, side->output, side->output);
+   };
+
+   // first connection is read by a worker while the second is read here
+   odbcshell_signal_block(&oldset);
+   err = pthread_create(&tid, NULL, odbcshell_compare_thread, &sides[0]);
+   odbcshell_signal_restore(&oldset);
+   if ((err))
+      odbcshell_compare_thread(&sides[0]);
+   odbcshell_compare_thread(&sides[1]);
+   if (!(err))
+      pthread_join(tid, NULL);
+
+   err = 0;
+   for(l = 0; l < 2; l++)
+   {
+      side = &sides[l];
+      fclose(side->output);
+      side->output = NULL;
+      if ((side->bufflen))
+         fwrite(side->buff, 1, side->bufflen, cnf->errs ? cnf->errs : stderr);
+      free(side->buff);
+      side->buff = NULL;
+      if ( ((side->code)) && ( (!(err)) || (side->code == -2) ) )
+         err = side->code;
+   };
+   free(sql);
+
+   return(err);
+}
+
+
+/// @brief displays rows of a chunk found on only one connection
+/// @param cnf      pointer to configuration struct
+/// @param compare  pointer to compare state
+/// @param sides    array of two sides holding rows of chunk
+int odbcshell_compare_diff(ODBCShell * cnf, ODBCShellCompare * compare,
+   ODBCShellCompareSide * sides)
+{
+   int                   order;
+   size_t                pos1;
+   size_t                pos2;
+   ODBCShellCompareRow * rows1;
+   ODBCShellCompareRow * rows2;
+
+   rows1 = sides[0].rows;
+   rows2 = sides[1].rows;
+   qsort(rows1, sides[0].rows_count, sizeof(ODBCShellCompareRow), odbcshell_compare_order);
+   qsort(rows2, sides[1].rows_count, sizeof(ODBCShellCompareRow), odbcshell_compare_order);
+
+   // rows are listed like diff, "<" for the first connection and ">" for the second
+   pos1 = 0;
+   pos2 = 0;
+   while ( (pos1 < sides[0].rows_count) || (pos2 < sides[1].rows_count) )
+   {
+      if (pos1 >= sides[0].rows_count)
+         order = 1;
+      else if (pos2 >= sides[1].rows_count)
+         order = -1;
+      else
+         order = odbcshell_compare_order(&rows1[pos1], &rows2[pos2]);
+      if (!(order))
+      {
+         pos1++;
+         pos2++;
+         continue;
+      };
+      if (order < 0)
+         odbcshell_fprintf(cnf, "< %s\n", rows1[pos1++].text);
+      else
+         odbcshell_fprintf(cnf, "> %s\n", rows2[pos2++].text);
+      compare->differ++;
+   };
+   compare->rows += sides[0].count;
+
+   return(0);
+}
+
+
+/// @brief frees rows kept by both sides of a chunk
+/// @param sides    array of two sides holding rows of chunk
+void odbcshell_compare_free(ODBCShellCompareSide * sides)
+{
+   int    l;
+   size_t pos;
+
+   for(l = 0; l < 2; l++)
+   {
+      for(pos = 0; pos < sides[l].rows_count; pos++)
+         free(sides[l].rows[pos].text);
+      free(sides[l].rows);
+      sides[l].rows       = NULL;
+      sides[l].rows_count = 0;
+      sides[l].rows_size  = 0;
+   };
+
+   return;
+}
+
+
+/// @brief computes 64-bit hash of data (xxHash64)
+/// @param data     data to hash
+/// @param len      length of data
+/// @param seed     initial value of hash
+uint64_t odbcshell_compare_hash(const void * data, size_t len, uint64_t seed)
+{
+   const unsigned char * ptr;
+   const unsigned char * end;
+   uint64_t              hash;
+   uint64_t              v1;
+   uint64_t              v2;
+   uint64_t              v3;
+   uint64_t              v4;
+   uint64_t              val;
+   uint32_t              val32;
+
+   ptr = data;
+   end = ptr + len;
+
+   // consumes 32 bytes at a time using four independent lanes
+   if (len >= 32)
+   {
+      v1 = seed + ODBCSHELL_HASH_PRIME1 + ODBCSHELL_HASH_PRIME2;
+      v2 = seed + ODBCSHELL_HASH_PRIME2;
+      v3 = seed;
+      v4 = seed - ODBCSHELL_HASH_PRIME1;
+      do
+      {
+         memcpy(&val, ptr,      8); v1 = ODBCSHELL_HASH_ROUND(v1, val);
+         memcpy(&val, ptr + 8,  8); v2 = ODBCSHELL_HASH_ROUND(v2, val);
+         memcpy(&val, ptr + 16, 8); v3 = ODBCSHELL_HASH_ROUND(v3, val);
+         memcpy(&val, ptr + 24, 8); v4 = ODBCSHELL_HASH_ROUND(v4, val);
+         ptr += 32;
+      } while (ptr <= (end - 32));
+
+      hash = ODBCSHELL_HASH_ROTL(v1, 1)  + ODBCSHELL_HASH_ROTL(v2, 7)
+           + ODBCSHELL_HASH_ROTL(v3, 12) + ODBCSHELL_HASH_ROTL(v4, 18);
+      hash = (hash ^ ODBCSHELL_HASH_ROUND(0, v1)) * ODBCSHELL_HASH_PRIME1 + ODBCSHELL_HASH_PRIME4;
+      hash = (hash ^ ODBCSHELL_HASH_ROUND(0, v2)) * ODBCSHELL_HASH_PRIME1 + ODBCSHELL_HASH_PRIME4;
+      hash = (hash ^ ODBCSHELL_HASH_ROUND(0, v3)) * ODBCSHELL_HASH_PRIME1 + ODBCSHELL_HASH_PRIME4;
+      hash = (hash ^ ODBCSHELL_HASH_ROUND(0, v4)) * ODBCSHELL_HASH_PRIME1 + ODBCSHELL_HASH_PRIME4;
+   }
+   else
+   {
+      hash = seed + ODBCSHELL_HASH_PRIME5;
+   };
+   hash += (uint64_t)len;
+
+   // consumes remaining bytes
+   while ((ptr + 8) <= end)
+   {
+      memcpy(&val, ptr, 8);
+      hash ^= ODBCSHELL_HASH_ROUND(0, val);
+      hash  = ODBCSHELL_HASH_ROTL(hash, 27) * ODBCSHELL_HASH_PRIME1 + ODBCSHELL_HASH_PRIME4;
+      ptr  += 8;
+   };
+   if ((ptr + 4) <= end)
+   {
+      memcpy(&val32, ptr, 4);
+      hash ^= (uint64_t)val32 * ODBCSHELL_HASH_PRIME1;
+      hash  = ODBCSHELL_HASH_ROTL(hash, 23) * ODBCSHELL_HASH_PRIME2 + ODBCSHELL_HASH_PRIME3;
+      ptr  += 4;
+   };
+   while (ptr < end)
+   {
+      hash ^= (uint64_t)(*ptr) * ODBCSHELL_HASH_PRIME5;
+      hash  = ODBCSHELL_HASH_ROTL(hash, 11) * ODBCSHELL_HASH_PRIME1;
+      ptr++;
+   };
+
+   // mixes final bits
+   hash ^= hash >> 33;
+   hash *= ODBCSHELL_HASH_PRIME2;
+   hash ^= hash >> 29;
+   hash *= ODBCSHELL_HASH_PRIME3;
+   hash ^= hash >> 32;
+
+   return(hash);
+}
+
+
+/// @brief orders rows by hash and values
+/// @param ptr1     pointer to first row
+/// @param ptr2     pointer to second row
+int odbcshell_compare_order(const void * ptr1, const void * ptr2)
+{
+   const ODBCShellCompareRow * row1;
+   const ODBCShellCompareRow * row2;
+
+   row1 = ptr1;
+   row2 = ptr2;
+
+   if (row1->hash != row2->hash)
+      return((row1->hash < row2->hash) ? -1 : 1);
+
+   return(strcmp(row1->text, row2->text));
+}
+
+
+/// @brief compares a range of keys, dividing it while hashes differ
+/// @param cnf      pointer to configuration struct
+/// @param compare  pointer to compare state
+/// @param where    condition selecting rows of range (NULL for all rows)
+int odbcshell_compare_range(ODBCShell * cnf, ODBCShellCompare * compare,
+   const char * where)
+{
+   int                  err;
+   ODBCShellCompareSide sides[2];
+
+   if ((err = odbcshell_compare_chunk(cnf, compare, where, ODBCSHELL_COMPARE_ROWS, sides)))
+   {
+      odbcshell_compare_free(sides);
+      return(err);
+   };
+   compare->chunks++;
+
+   if ( (sides[0].count == sides[1].count) && (sides[0].sum == sides[1].sum) )
+      compare->rows += sides[0].count;
+   else if ( ((sides[0].kept)) && ((sides[1].kept)) )
+      err = odbcshell_compare_diff(cnf, compare, sides);
+   else
+      err = odbcshell_compare_split(cnf, compare, where);
+
+   odbcshell_compare_free(sides);
+
+   return(err);
+}
+
+
+/// @brief reads and hashes rows of a chunk from one connection
+/// @param side     pointer to one side of chunk
+int odbcshell_compare_read(ODBCShellCompareSide * side)
+{
+   int                   err;
+   char                * line;
+   char                * data;
+   char                * value;
+   char                * str;
+   void                * ptr;
+   size_t                len;
+   size_t                size;
+   size_t                dlen;
+   size_t                dsize;
+   size_t                vlen;
+   size_t                vsize;
+   size_t                pos;
+   int64_t               prefix;
+   uint64_t              hash;
+   long long             col;
+   SQLLEN                ind;
+   SQLRETURN             sts;
+   ODBCShell           * cnf;
+   ODBCShellStmt       * stmt;
+
+   cnf = &side->cnf;
+
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, side->conn, &stmt)))
+      return(err);
+   odbcshell_odbc_stmt_timeout(cnf, side->conn, stmt);
+   odbcshell_verbose(cnf, "hashing \"%s\" on \"%s\"...\n", side->sql, side->conn->name);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)side->sql, SQL_NTS);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_describe(cnf, stmt)))
+   {
+      SQLCloseCursor(stmt->hstmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(err);
+   };
+   if ((err = odbcshell_odbc_bind_exact(cnf, stmt)))
+   {
+      SQLCloseCursor(stmt->hstmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(err);
+   };
+
+   // values of each row are formatted as CSV, NULL values left unquoted
+   line  = NULL;
+   size  = 0;
+   data  = NULL;
+   dsize = 0;
+   value = NULL;
+   vsize = 0;
+   while ((sts = odbcshell_odbc_fetch(cnf, stmt)) == SQL_SUCCESS)
+   {
+      len  = 0;
+      dlen = 0;
+      for(col = 0; col < stmt->col_count; col++)
+      {
+         if ((err = odbcshell_odbc_value_full(cnf, stmt, (SQLUSMALLINT)(col+1), &value, &vsize, &ind)))
+            break;
+         vlen = (ind == SQL_NULL_DATA) ? 0 : (size_t)ind;
+         if ((len + (vlen * 2) + 4) > size)
+         {
+            if (!(ptr = realloc(line, len + (vlen * 2) + 256)))
+            {
+               err = -2;
+               break;
+            };
+            line = ptr;
+            size = len + (vlen * 2) + 256;
+         };
+         if ((dlen + vlen + sizeof(prefix)) > dsize)
+         {
+            if (!(ptr = realloc(data, dlen + vlen + 256)))
+            {
+               err = -2;
+               break;
+            };
+            data  = ptr;
+            dsize = dlen + vlen + 256;
+         };
+
+         // length of each value is hashed so values cannot run together
+         prefix = (ind == SQL_NULL_DATA) ? -1 : (int64_t)vlen;
+         memcpy(&data[dlen], &prefix, sizeof(prefix));
+         dlen += sizeof(prefix);
+         memcpy(&data[dlen], value, vlen);
+         dlen += vlen;
+
+         if ((col))
+            line[len++] = ',';
+         if (ind == SQL_NULL_DATA)
+            continue;
+         line[len++] = '"';
+         for(pos = 0; pos < vlen; pos++)
+         {
+            if (value[pos] == '"')
+               line[len++] = '"';
+            line[len++] = value[pos];
+         };
+         line[len++] = '"';
+      };
+      if ((err))
+         break;
+      if (!(line))
+         continue;
+      line[len] = '\0';
+
+      // sum of hashes does not depend upon order of rows
+      hash = odbcshell_compare_hash(data, dlen, 0);
+      side->sum += hash;
+      side->count++;
+      if (!(side->kept))
+         continue;
+
+      // rows of large chunks are not kept since the chunk is divided instead
+      if ( (side->keep >= 0) && (side->count > side->keep) )
+      {
+         for(pos = 0; pos < side->rows_count; pos++)
+            free(side->rows[pos].text);
+         free(side->rows);
+         side->rows       = NULL;
+         side->rows_count = 0;
+         side->rows_size  = 0;
+         side->kept       = 0;
+         continue;
+      };
+      if (side->rows_count >= side->rows_size)
+      {
+         if (!(ptr = realloc(side->rows, sizeof(ODBCShellCompareRow) * (side->rows_size + 256))))
+         {
+            err = -2;
+            break;
+         };
+         side->rows       = ptr;
+         side->rows_size += 256;
+      };
+      if (!(str = strdup(line)))
+      {
+         err = -2;
+         break;
+      };
+      side->rows[side->rows_count].hash = hash;
+      side->rows[side->rows_count].text = str;
+      side->rows_count++;
+   };
+   free(line);
+   free(data);
+   free(value);
+
+   if (err == -2)
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+   else if ( (!(err)) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLFetchScroll", cnf, stmt);
+      err = -1;
+   };
+   odbcshell_odbc_unbind(stmt);
+   SQLCloseCursor(stmt->hstmt);
+   odbcshell_odbc_stmt_release(cnf, &stmt);
+
+   return(err);
+}
+
+
+/// @brief compares a table between two connections
+/// @param cnf      pointer to configuration struct
+/// @param name1    name of first connection
+/// @param name2    name of second connection
+/// @param table    table to compare
+/// @param key      column dividing rows into chunks (NULL for first column)
+int odbcshell_compare_run(ODBCShell * cnf, const char * name1,
+   const char * name2, const char * table, const char * key)
+{
+   int               err;
+   char            * sql;
+   size_t            len;
+   long long         msecs;
+   SQLRETURN         sts;
+   ODBCShellStmt   * stmt;
+   ODBCShellCompare  compare;
+   struct timespec   start;
+   struct timespec   end;
+   char              column[sizeof(stmt->cols->name)+1];
+
+   memset(&compare, 0, sizeof(ODBCShellCompare));
+   compare.table = table;
+   compare.key   = key;
+
+   if ((err = odbcshell_copy_conn(cnf, name1, &compare.conns[0])))
+      return(err);
+   if ((err = odbcshell_copy_conn(cnf, name2, &compare.conns[1])))
+      return(err);
+   if (compare.conns[0] == compare.conns[1])
+   {
+      odbcshell_error(cnf, "connections compared must be different\n");
+      return(-1);
+   };
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   // first column of the table divides rows unless a key is given
+   if (!(key))
+   {
+      len = strlen(table) + 32;
+      if (!(sql = malloc(len)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+      snprintf(sql, len, "SELECT * FROM %s WHERE 1=0", table);
+      stmt = compare.conns[0]->stmt;
+      sts  = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)sql, SQL_NTS);
+      free(sql);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+         return(-1);
+      };
+      err = odbcshell_odbc_describe(cnf, stmt);
+      SQLCloseCursor(stmt->hstmt);
+      if ((err))
+         return(err);
+      if (!(stmt->col_count))
+      {
+         odbcshell_error(cnf, "table \"%s\" has no columns\n", table);
+         return(-1);
+      };
+      snprintf(column, sizeof(column), "%s", (char *)stmt->cols[0].name);
+      compare.key = column;
+   };
+   odbcshell_verbose(cnf, "comparing \"%s\" by \"%s\"...\n", table, compare.key);
+
+   err = odbcshell_compare_range(cnf, &compare, NULL);
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   if ((err))
+      return(err);
+
+   if ((compare.differ))
+   {
+      odbcshell_error(cnf, "%lld rows of \"%s\" differ between \"%s\" and \"%s\"\n",
+         compare.differ, table, name1, name2);
+      return(-1);
+   };
+   odbcshell_printf(cnf, "\"%s\" matches on \"%s\" and \"%s\" (%lld rows, %lld chunks) in %lld ms.\n",
+      table, name1, name2, compare.rows, compare.chunks, msecs);
+
+   return(0);
+}
+
+
+/// @brief divides a range of keys whose hashes differ into smaller chunks
+/// @param cnf      pointer to configuration struct
+/// @param compare  pointer to compare state
+/// @param where    condition selecting rows of range (NULL for all rows)
+int odbcshell_compare_split(ODBCShell * cnf, ODBCShellCompare * compare,
+   const char * where)
+{
+   int                  err;
+   long long            l;
+   char               * sql;
+   char               * cond;
+   size_t               len;
+   ODBCShellExport      export;
+   ODBCShellCompareSide sides[2];
+
+   len = strlen(compare->table) + (((where)) ? strlen(where) : 0) + 32;
+   if (!(sql = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   if ((where))
+      snprintf(sql, len, "SELECT * FROM %s WHERE %s", compare->table, where);
+   else
+      snprintf(sql, len, "SELECT * FROM %s", compare->table);
+
+   // keys of the first connection are divided the same way as export
+   memset(&export, 0, sizeof(ODBCShellExport));
+   export.sql    = sql;
+   export.column = compare->key;
+   err = odbcshell_export_bounds(cnf, &export, compare->conns[0], ODBCSHELL_COMPARE_CHUNKS);
+   free(sql);
+   if ((err))
+   {
+      odbcshell_export_free(&export);
+      return(err);
+   };
+
+   // keys which cannot be divided further are compared row by row
+   if ( (export.count < 2) || (compare->depth >= ODBCSHELL_COMPARE_DEPTH) )
+   {
+      odbcshell_export_free(&export);
+      if (!(err = odbcshell_compare_chunk(cnf, compare, where, -1, sides)))
+         err = odbcshell_compare_diff(cnf, compare, sides);
+      odbcshell_compare_free(sides);
+      return(err);
+   };
+
+   compare->depth++;
+   for(l = 0; ( (l < export.count) && (!(err)) ); l++)
+   {
+      len = strlen(export.parts[l].where) + (((where)) ? strlen(where) : 0) + 16;
+      if (!(cond = malloc(len)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+         break;
+      };
+      if ((where))
+         snprintf(cond, len, "%s AND %s", where, export.parts[l].where);
+      else
+         snprintf(cond, len, "%s", export.parts[l].where);
+      err = odbcshell_compare_range(cnf, compare, cond);
+      free(cond);
+   };
+   compare->depth--;
+   odbcshell_export_free(&export);
+
+   return(err);
+}
+
+
+/// @brief worker thread reading one side of a chunk
+/// @param ptr      pointer to one side of chunk
+void * odbcshell_compare_thread(void * ptr)
+{
+   ODBCShellCompareSide * side;
+
+   side       = ptr;
+   side->code = odbcshell_compare_read(side);
+   fflush(side->output);
+
+   return(NULL);
+}
+
+/* end of source */
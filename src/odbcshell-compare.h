@@ -0,0 +1,98 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-compare.h ODBC Shell compares a table between connections
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_COMPARE_H
+#define _ODBCSHELL_SRC_ODBCSHELL_COMPARE_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// hashes a chunk of the table on both connections at once
+int odbcshell_compare_chunk(ODBCShell * cnf, ODBCShellCompare * compare,
+   const char * where, long long keep, ODBCShellCompareSide * sides);
+
+// displays rows of a chunk found on only one connection
+int odbcshell_compare_diff(ODBCShell * cnf, ODBCShellCompare * compare,
+   ODBCShellCompareSide * sides);
+
+// frees rows kept by both sides of a chunk
+void odbcshell_compare_free(ODBCShellCompareSide * sides);
+
+// computes 64-bit hash of data
+uint64_t odbcshell_compare_hash(const void * data, size_t len, uint64_t seed);
+
+// orders rows by hash and values
+int odbcshell_compare_order(const void * ptr1, const void * ptr2);
+
+// compares a range of keys, dividing it while hashes differ
+int odbcshell_compare_range(ODBCShell * cnf, ODBCShellCompare * compare,
+   const char * where);
+
+// reads and hashes rows of a chunk from one connection
+int odbcshell_compare_read(ODBCShellCompareSide * side);
+
+// compares a table between two connections
+int odbcshell_compare_run(ODBCShell * cnf, const char * name1,
+   const char * name2, const char * table, const char * key);
+
+// divides a range of keys whose hashes differ into smaller chunks
+int odbcshell_compare_split(ODBCShell * cnf, ODBCShellCompare * compare,
+   const char * where);
+
+// worker thread reading one side of a chunk
+void * odbcshell_compare_thread(void * ptr);
+
+#endif
+/* end of header */
@@ -0,0 +1,329 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-connect.c ODBC Shell parallel connections
+ */
+#include "odbcshell-connect.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief adds DSN passed on the command line
+/// @param cnf      pointer to configuration struct
+/// @param dsn      connection string
+int odbcshell_connect_append(ODBCShell * cnf, const char * dsn)
+{
+   void * ptr;
+
+   if (!(ptr = realloc(cnf->dflt_dsns, sizeof(char *) * (size_t)(cnf->dflt_dsns_count+1))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   cnf->dflt_dsns = ptr;
+   cnf->dflt_dsns[cnf->dflt_dsns_count] = dsn;
+   cnf->dflt_dsns_count++;
+
+   if (!(cnf->dflt_dsn))
+      cnf->dflt_dsn = dsn;
+
+   return(0);
+}
+
+
+/// @brief connects to DSNs passed on the command line
+/// @param cnf      pointer to configuration struct
+int odbcshell_connect_dflt(ODBCShell * cnf)
+{
+   if (!(cnf->dflt_dsn))
+      return(0);
+   if (cnf->dflt_dsns_count < 2)
+      return(odbcshell_odbc_connect(cnf, cnf->dflt_dsn, NULL));
+   return(odbcshell_connect_parallel(cnf, cnf->dflt_dsns_count, NULL, cnf->dflt_dsns));
+}
+
+
+/// @brief derives name of connection from DSN attribute of connection string
+/// @param dsn      connection string
+/// @param num      position of connection used if DSN attribute is missing
+/// @param buff     buffer to hold name
+/// @param size     size of buffer
+const char * odbcshell_connect_name(const char * dsn, long long num,
+   char * buff, size_t size)
+{
+   size_t       len;
+   const char * ptr;
+
+   ptr = dsn;
+   while((ptr))
+   {
+      while((*ptr == ' ') || (*ptr == '\t'))
+         ptr++;
+      if (!(strncasecmp(ptr, "DSN=", 4)))
+      {
+         ptr += 4;
+         if (*ptr == '{')
+            ptr++;
+         for(len = 0; ((ptr[len]) && (!(strchr(";}", ptr[len])))); len++);
+         if ( ((len)) && (len < size) )
+         {
+            memcpy(buff, ptr, len);
+            buff[len] = '\0';
+            return(buff);
+         };
+      };
+      if ((ptr = strchr(ptr, ';')))
+         ptr++;
+   };
+
+   snprintf(buff, size, "conn%lld", num);
+
+   return(buff);
+}
+
+
+/// @brief connects to several data sources concurrently
+/// @param cnf      pointer to configuration struct
+/// @param count    number of connections
+/// @param names    internal names of connections (NULL to derive from DSNs)
+/// @param dsns     connection strings
+int odbcshell_connect_parallel(ODBCShell * cnf, long long count,
+   const char ** names, const char ** dsns)
+{
+   int               code;
+   long long         l;
+   long long         u;
+   long long         pending;
+   long long         failed;
+   long long         threads;
+   long long         started;
+   char              buff[128];
+   const char      * name;
+   sigset_t          oldset;
+   pthread_t         tids[ODBCSHELL_CONNECT_THREADS];
+   ODBCShellDial   * dial;
+   ODBCShellDialer   dialer;
+   ODBCShellConn   * last;
+
+   memset(&dialer, 0, sizeof(ODBCShellDialer));
+   if (!(dialer.dials = calloc((size_t)count, sizeof(ODBCShellDial))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   dialer.count = count;
+   pthread_mutex_init(&dialer.lock, NULL);
+
+   code    = 0;
+   pending = 0;
+
+   // names connections and reuses pooled connections before starting workers
+   for(l = 0; ((l < count) && (!(code))); l++)
+   {
+      dial      = &dialer.dials[l];
+      dial->dsn = dsns[l];
+      name      = ((names)) ? names[l] : NULL;
+      if (!(name))
+         name = odbcshell_connect_name(dsns[l], l+1, buff, sizeof(buff));
+      if (!(dial->name = strdup(name)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+      if (!(dial->output = open_memstream(&dial->buff, &dial->bufflen)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // messages are reported together once all attempts complete
+      odbcshell_clone(cnf, &dial->cnf, dial->output, dial->output);
+      dial->cnf.lazyconnect = cnf->lazyconnect;
+
+      if ((odbcshell_odbc_array_findindex(cnf, dial->name)) >= 0)
+      {
+         odbcshell_error(&dial->cnf, "connection with name \"%s\" already exists\n", dial->name);
+         dial->code = -1;
+         continue;
+      };
+      for(u = 0; ((u < l) && (!(dial->code))); u++)
+      {
+         if (!(strcasecmp(dialer.dials[u].name, dial->name)))
+         {
+            odbcshell_error(&dial->cnf, "connection name \"%s\" is used more than once\n", dial->name);
+            dial->code = -1;
+         };
+      };
+      if ((dial->code))
+         continue;
+
+      if ((dial->code = odbcshell_pool_take(cnf, dial->dsn, dial->name, &dial->conn)))
+         code = dial->code;
+      else if (!(dial->conn))
+         pending++;
+   };
+
+   // establishes remaining connections using a bounded set of workers
+   started = 0;
+   if ( (!(code)) && ((pending)) )
+   {
+      threads = (pending < ODBCSHELL_CONNECT_THREADS) ? pending : ODBCSHELL_CONNECT_THREADS;
+      odbcshell_verbose(cnf, "connecting to %lld data sources using %lld threads...\n",
+         pending, threads);
+      odbcshell_signal_block(&oldset);
+      for(started = 0; started < threads; started++)
+         if ((pthread_create(&tids[started], NULL, odbcshell_connect_thread, &dialer)))
+            break;
+      odbcshell_signal_restore(&oldset);
+      if (!(started))
+         odbcshell_connect_thread(&dialer);
+      for(l = 0; l < started; l++)
+         pthread_join(tids[l], NULL);
+   };
+
+   // reports results in the order connections were requested
+   failed = 0;
+   last   = NULL;
+   for(l = 0; l < count; l++)
+   {
+      dial = &dialer.dials[l];
+      if ((dial->output))
+         fclose(dial->output);
+      dial->output = NULL;
+      if ( (!(dial->code)) && ((dial->conn)) && (!(code)) )
+      {
+         if ((dial->bufflen))
+            fwrite(dial->buff, 1, dial->bufflen, cnf->msgs ? cnf->msgs : stdout);
+         if ((odbcshell_odbc_array_add(cnf, dial->conn)))
+         {
+            odbcshell_odbc_free(cnf, &dial->conn);
+            code = -2;
+            continue;
+         };
+         last       = dial->conn;
+         dial->conn = NULL;
+         continue;
+      };
+      if ((dial->conn))
+         odbcshell_odbc_free(cnf, &dial->conn);
+      if (!(dial->name))
+         continue;
+      failed++;
+      odbcshell_error(cnf, "%s: unable to connect\n", dial->name);
+      if ( ((dial->bufflen)) && (!(cnf->silent)) )
+         fwrite(dial->buff, 1, dial->bufflen, cnf->errs ? cnf->errs : stderr);
+   };
+   if ( ((failed)) && (!(code)) )
+   {
+      odbcshell_error(cnf, "%lld of %lld connections failed\n", failed, count);
+      code = -1;
+   };
+
+   if ((last))
+      odbcshell_odbc_update_current(cnf, last);
+
+   for(l = 0; l < count; l++)
+   {
+      free(dialer.dials[l].name);
+      free(dialer.dials[l].buff);
+   };
+   pthread_mutex_destroy(&dialer.lock);
+   free(dialer.dials);
+
+   return(code);
+}
+
+
+/// @brief worker thread for parallel connect
+/// @param ptr      pointer to dialer struct
+void * odbcshell_connect_thread(void * ptr)
+{
+   long long         l;
+   ODBCShellDial   * dial;
+   ODBCShellDialer * dialer;
+
+   dialer = ptr;
+
+   while(1)
+   {
+      pthread_mutex_lock(&dialer->lock);
+      l = dialer->next++;
+      pthread_mutex_unlock(&dialer->lock);
+
+      if (l >= dialer->count)
+         return(NULL);
+
+      dial = &dialer->dials[l];
+      if ( ((dial->code)) || ((dial->conn)) )
+         continue;
+
+      dial->code = odbcshell_odbc_open(&dial->cnf, dial->dsn, dial->name, &dial->conn);
+      fflush(dial->output);
+   };
+
+   return(NULL);
+}
+
+/* end of source */
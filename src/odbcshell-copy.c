@@ -0,0 +1,628 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-copy.c ODBC Shell copies rows between connections
+ */
+#include "odbcshell-copy.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief binds parameters of insert to a row of a block
+/// @param cnf      pointer to configuration struct
+/// @param copy     pointer to copy state
+/// @param block    pointer to block holding values
+/// @param row      first row bound (0 when binding arrays)
+int odbcshell_copy_bind(ODBCShell * cnf, ODBCShellCopy * copy,
+   ODBCShellCopyBlock * block, SQLULEN row)
+{
+   long long             col;
+   SQLULEN               size;
+   SQLRETURN             sts;
+   ODBCShellCopyColumn * cols;
+
+   cols = copy->cols;
+   for(col = 0; col < copy->col_count; col++)
+   {
+      size = ((cols[col].precision)) ? cols[col].precision : (SQLULEN)cols[col].width;
+      sts  = SQLBindParameter(copy->dst->hstmt, (SQLUSMALLINT)(col+1),
+         SQL_PARAM_INPUT, cols[col].c_type, cols[col].sql_type, size,
+         cols[col].scale,
+         &block->data[cols[col].offset + (row * (SQLULEN)cols[col].width)],
+         cols[col].width, &block->ind[((SQLULEN)col * copy->batch) + row]);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLBindParameter", cnf, copy->dst);
+         return(-1);
+      };
+   };
+
+   return(0);
+}
+
+
+/// @brief derives bound types of columns and allocates blocks
+/// @param cnf      pointer to configuration struct
+/// @param copy     pointer to copy state
+int odbcshell_copy_columns(ODBCShell * cnf, ODBCShellCopy * copy)
+{
+   long long             col;
+   long long             l;
+   size_t                bytes;
+   SQLULEN               max;
+   ODBCShellColumn     * src;
+   ODBCShellCopyColumn * dst;
+
+   copy->col_count = copy->src->col_count;
+   if (!(copy->cols = calloc((size_t)copy->col_count, sizeof(ODBCShellCopyColumn))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+
+   // values keep their native representation; only exact numerics, which
+   // lack a portable C type, are exchanged as characters
+   bytes = 0;
+   for(col = 0; col < copy->col_count; col++)
+   {
+      src = &copy->src->cols[col];
+      dst = &copy->cols[col];
+      dst->sql_type  = src->type;
+      dst->scale     = src->scale;
+      dst->precision = src->precision;
+      switch(src->type)
+      {
+         case SQL_BIT:
+            dst->c_type = SQL_C_BIT;
+            dst->width  = sizeof(SQLCHAR);
+            break;
+         case SQL_TINYINT:
+         case SQL_SMALLINT:
+         case SQL_INTEGER:
+         case SQL_BIGINT:
+            dst->c_type = SQL_C_SBIGINT;
+            dst->width  = sizeof(SQLBIGINT);
+            break;
+         case SQL_REAL:
+         case SQL_FLOAT:
+         case SQL_DOUBLE:
+            dst->c_type = SQL_C_DOUBLE;
+            dst->width  = sizeof(SQLDOUBLE);
+            break;
+         case SQL_DATE:
+         case SQL_TYPE_DATE:
+            dst->c_type = SQL_C_TYPE_DATE;
+            dst->width  = sizeof(SQL_DATE_STRUCT);
+            break;
+         case SQL_TIME:
+         case SQL_TYPE_TIME:
+            dst->c_type = SQL_C_TYPE_TIME;
+            dst->width  = sizeof(SQL_TIME_STRUCT);
+            break;
+         case SQL_TIMESTAMP:
+         case SQL_TYPE_TIMESTAMP:
+            dst->c_type = SQL_C_TYPE_TIMESTAMP;
+            dst->width  = sizeof(SQL_TIMESTAMP_STRUCT);
+            break;
+         case SQL_BINARY:
+         case SQL_VARBINARY:
+         case SQL_LONGVARBINARY:
+            dst->c_type = SQL_C_BINARY;
+            dst->width  = (SQLLEN)src->precision;
+            break;
+         case SQL_WCHAR:
+         case SQL_WVARCHAR:
+         case SQL_WLONGVARCHAR:
+            dst->c_type = SQL_C_WCHAR;
+            dst->width  = (SQLLEN)((src->precision + 1) * sizeof(SQLWCHAR));
+            break;
+         case SQL_DECIMAL:
+         case SQL_NUMERIC:
+            dst->c_type = SQL_C_CHAR;
+            dst->width  = (SQLLEN)(src->precision + 3);
+            break;
+         default:
+            dst->c_type = SQL_C_CHAR;
+            dst->width  = (SQLLEN)(src->precision + 1);
+            break;
+      };
+
+      // values of unknown or unbounded size are limited
+      if ( (dst->width < 1) || (dst->width > ODBCSHELL_COPY_WIDTH) || (!(src->precision)) )
+         if ( (dst->c_type == SQL_C_CHAR) || (dst->c_type == SQL_C_WCHAR) || (dst->c_type == SQL_C_BINARY) )
+            dst->width = ODBCSHELL_COPY_WIDTH;
+      bytes += (size_t)dst->width + sizeof(SQLLEN) + sizeof(SQLBIGINT);
+   };
+
+   // limits memory held by each block
+   max = (SQLULEN)(ODBCSHELL_FETCH_BYTES / bytes);
+   if (copy->batch > max)
+      copy->batch = max;
+   if (copy->batch < 1)
+      copy->batch = 1;
+
+   // columns are aligned so fixed length values may be addressed directly
+   bytes = 0;
+   for(col = 0; col < copy->col_count; col++)
+   {
+      bytes = (bytes + sizeof(SQLBIGINT) - 1) & ~(sizeof(SQLBIGINT) - 1);
+      copy->cols[col].offset = bytes;
+      bytes += (size_t)copy->cols[col].width * copy->batch;
+   };
+   for(l = 0; l < ODBCSHELL_COPY_BLOCKS; l++)
+   {
+      copy->blocks[l].data = malloc(bytes);
+      copy->blocks[l].ind  = malloc(sizeof(SQLLEN) * (size_t)copy->col_count * copy->batch);
+      if ( (!(copy->blocks[l].data)) || (!(copy->blocks[l].ind)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+   };
+
+   return(0);
+}
+
+
+/// @brief finds connection taking part in copy
+/// @param cnf      pointer to configuration struct
+/// @param name     name of connection
+/// @param connp    pointer to pointer to connection struct
+int odbcshell_copy_conn(ODBCShell * cnf, const char * name,
+   ODBCShellConn ** connp)
+{
+   int             idx;
+   ODBCShellConn * conn;
+
+   if ((idx = odbcshell_odbc_array_findindex(cnf, name)) < 0)
+   {
+      odbcshell_error(cnf, "unknown connection \"%s\"\n", name);
+      return(-1);
+   };
+   conn = cnf->conns[idx];
+   if ((conn->job))
+   {
+      odbcshell_error(cnf, "connection \"%s\" is used by job %lld\n",
+         conn->name, conn->job->id);
+      return(-1);
+   };
+   if ((conn->deferred))
+      if ((odbcshell_odbc_dial(cnf, conn)))
+         return(-1);
+
+   (*connp) = conn;
+
+   return(0);
+}
+
+
+/// @brief frees resources used by copy
+/// @param cnf      pointer to configuration struct
+/// @param copy     pointer to copy state
+void odbcshell_copy_free(ODBCShell * cnf, ODBCShellCopy * copy)
+{
+   long long l;
+
+   // statements are released first since they reference the blocks
+   if ((copy->src))
+   {
+      SQLCloseCursor(copy->src->hstmt);
+      odbcshell_odbc_stmt_release(cnf, &copy->src);
+   };
+   if ((copy->dst))
+      odbcshell_odbc_stmt_release(cnf, &copy->dst);
+
+   for(l = 0; l < ODBCSHELL_COPY_BLOCKS; l++)
+   {
+      free(copy->blocks[l].data);
+      free(copy->blocks[l].ind);
+   };
+   free(copy->cols);
+   free(copy->buff);
+
+   return;
+}
+
+
+/// @brief worker thread fetching blocks of rows from the source
+/// @param ptr      pointer to copy state
+void * odbcshell_copy_reader(void * ptr)
+{
+   int                   abort;
+   long long             col;
+   SQLULEN               row;
+   SQLLEN                ind;
+   SQLLEN                limit;
+   SQLRETURN             sts;
+   ODBCShell           * cnf;
+   ODBCShellCopy       * copy;
+   ODBCShellCopyBlock  * block;
+
+   copy = ptr;
+   cnf  = &copy->cnf;
+
+   while(!(copy->code))
+   {
+      // waits for the writer to drain a block
+      pthread_mutex_lock(&copy->lock);
+      while ( ((copy->head - copy->tail) >= ODBCSHELL_COPY_BLOCKS) && (!(copy->abort)) )
+         pthread_cond_wait(&copy->drained, &copy->lock);
+      abort = copy->abort;
+      pthread_mutex_unlock(&copy->lock);
+      if ((abort))
+         break;
+
+      // fetches directly into the block handed to the writer
+      block       = &copy->blocks[copy->head % ODBCSHELL_COPY_BLOCKS];
+      block->rows = 0;
+      sts = SQLSetStmtAttr(copy->src->hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &block->rows, 0);
+      for(col = 0; ((col < copy->col_count) && (SQL_SUCCEEDED(sts))); col++)
+         sts = SQLBindCol(copy->src->hstmt, (SQLUSMALLINT)(col+1),
+            copy->cols[col].c_type, &block->data[copy->cols[col].offset],
+            copy->cols[col].width, &block->ind[(SQLULEN)col * copy->batch]);
+      if ((SQL_SUCCEEDED(sts)))
+         sts = SQLFetchScroll(copy->src->hstmt, SQL_FETCH_NEXT, 0);
+      if (sts == SQL_NO_DATA_FOUND)
+         break;
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLFetchScroll", cnf, copy->src);
+         copy->code = -1;
+         break;
+      };
+
+      // truncated values would silently corrupt the destination
+      for(col = 0; ((col < copy->col_count) && (sts == SQL_SUCCESS_WITH_INFO)); col++)
+      {
+         limit = copy->cols[col].width;
+         if (copy->cols[col].c_type == SQL_C_CHAR)
+            limit -= (SQLLEN)sizeof(SQLCHAR);
+         if (copy->cols[col].c_type == SQL_C_WCHAR)
+            limit -= (SQLLEN)sizeof(SQLWCHAR);
+         for(row = 0; row < block->rows; row++)
+         {
+            ind = block->ind[((SQLULEN)col * copy->batch) + row];
+            if ( (ind == SQL_NO_TOTAL) || (ind > limit) )
+            {
+               odbcshell_error(cnf, "value of column %lld exceeds %ld bytes\n",
+                  col+1, (long)limit);
+               copy->code = -1;
+               break;
+            };
+         };
+      };
+      if ((copy->code))
+         break;
+
+      pthread_mutex_lock(&copy->lock);
+      copy->head++;
+      pthread_cond_signal(&copy->filled);
+      pthread_mutex_unlock(&copy->lock);
+   };
+
+   pthread_mutex_lock(&copy->lock);
+   copy->done = 1;
+   pthread_cond_signal(&copy->filled);
+   pthread_mutex_unlock(&copy->lock);
+
+   fflush(copy->output);
+
+   return(NULL);
+}
+
+
+/// @brief copies rows returned by a query into a table of another connection
+/// @param cnf      pointer to configuration struct
+/// @param from     name of connection executing query
+/// @param sql      query returning rows to copy
+/// @param to       name of connection receiving rows
+/// @param table    table receiving rows, optionally followed by list of columns
+/// @param batch    rows passed in each block
+int odbcshell_copy_run(ODBCShell * cnf, const char * from, char * sql,
+   const char * to, const char * table, long long batch)
+{
+   int                  err;
+   long long            col;
+   long long            msecs;
+   size_t               len;
+   char               * insert;
+   sigset_t             oldset;
+   pthread_t            tid;
+   struct timespec      start;
+   struct timespec      end;
+   SQLRETURN            sts;
+   ODBCShellConn      * src;
+   ODBCShellConn      * dst;
+   ODBCShellCopy      * copy;
+   ODBCShellCopyBlock * block;
+
+   if ((err = odbcshell_copy_conn(cnf, from, &src)))
+      return(err);
+   if ((err = odbcshell_copy_conn(cnf, to, &dst)))
+      return(err);
+   if (src == dst)
+   {
+      odbcshell_error(cnf, "source and destination must be different connections\n");
+      return(-1);
+   };
+
+   // state is shared with the reader, which receives its own configuration
+   if (!(copy = malloc(sizeof(ODBCShellCopy))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   memset(copy, 0, sizeof(ODBCShellCopy));
+   copy->batch = (SQLULEN)batch;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   // starts query on source
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, src, &copy->src)))
+   {
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(err);
+   };
+   odbcshell_odbc_stmt_timeout(cnf, src, copy->src);
+   odbcshell_signal_stmt(copy->src->hstmt);
+   odbcshell_verbose(cnf, "executing SQL statement on \"%s\"...\n", src->name);
+   sts = SQLExecDirect(copy->src->hstmt, (SQLTCHAR *)sql, SQL_NTS);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, copy->src);
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_describe(cnf, copy->src)))
+   {
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(err);
+   };
+   if (!(copy->src->col_count))
+   {
+      odbcshell_error(cnf, "statement did not return rows\n");
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(-1);
+   };
+   if ((err = odbcshell_copy_columns(cnf, copy)))
+   {
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(err);
+   };
+
+   // prepares insert on destination
+   len = strlen("INSERT INTO  VALUES ()") + strlen(table) + (size_t)(copy->col_count * 2) + 1;
+   if (!(insert = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(-2);
+   };
+   snprintf(insert, len, "INSERT INTO %s VALUES (", table);
+   for(col = 0; col < copy->col_count; col++)
+      strcat(insert, ((col)) ? ",?" : "?");
+   strcat(insert, ")");
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, dst, &copy->dst)))
+   {
+      free(insert);
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(err);
+   };
+   odbcshell_odbc_stmt_timeout(cnf, dst, copy->dst);
+   odbcshell_verbose(cnf, "preparing \"%s\" on \"%s\"...\n", insert, dst->name);
+   sts = SQLPrepare(copy->dst->hstmt, (SQLTCHAR *)insert, SQL_NTS);
+   free(insert);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLPrepare", cnf, copy->dst);
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(-1);
+   };
+
+   // reader fetches and writer inserts whole blocks; drivers without
+   // arrays of parameters receive one row at a time
+   sts = SQLSetStmtAttr(copy->src->hstmt, SQL_ATTR_ROW_BIND_TYPE,
+      (SQLPOINTER)SQL_BIND_BY_COLUMN, SQL_IS_UINTEGER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(copy->src->hstmt, SQL_ATTR_ROW_ARRAY_SIZE,
+         (SQLPOINTER)copy->batch, SQL_IS_UINTEGER);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLSetStmtAttr", cnf, copy->src);
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(-1);
+   };
+   sts = SQLSetStmtAttr(copy->dst->hstmt, SQL_ATTR_PARAM_BIND_TYPE,
+      (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, SQL_IS_UINTEGER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(copy->dst->hstmt, SQL_ATTR_PARAMSET_SIZE,
+         (SQLPOINTER)copy->batch, SQL_IS_UINTEGER);
+   copy->arrays = ((SQL_SUCCEEDED(sts))) ? 1 : 0;
+   odbcshell_verbose(cnf, "copying %lu rows per block%s...\n",
+      (unsigned long)copy->batch, ((copy->arrays)) ? "" : ", inserting one row at a time");
+
+   if (!(copy->output = open_memstream(&copy->buff, &copy->bufflen)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_copy_free(cnf, copy);
+      free(copy);
+      return(-2);
+   };
+   odbcshell_clone(cnf, &copy->cnf, copy->output, copy->output);
+
+   pthread_mutex_init(&copy->lock, NULL);
+   pthread_cond_init(&copy->filled, NULL);
+   pthread_cond_init(&copy->drained, NULL);
+
+   odbcshell_signal_block(&oldset);
+   err = pthread_create(&tid, NULL, odbcshell_copy_reader, copy);
+   odbcshell_signal_restore(&oldset);
+   if ((err))
+   {
+      odbcshell_error(cnf, "unable to start reader: %s\n", strerror(err));
+      err = -1;
+   }
+   else
+   {
+      // inserts blocks as the reader fills them
+      while(!(err))
+      {
+         pthread_mutex_lock(&copy->lock);
+         while ( (copy->head == copy->tail) && (!(copy->done)) )
+            pthread_cond_wait(&copy->filled, &copy->lock);
+         if (copy->head == copy->tail)
+         {
+            pthread_mutex_unlock(&copy->lock);
+            break;
+         };
+         pthread_mutex_unlock(&copy->lock);
+
+         block = &copy->blocks[copy->tail % ODBCSHELL_COPY_BLOCKS];
+         err   = odbcshell_copy_write(cnf, copy, block);
+
+         pthread_mutex_lock(&copy->lock);
+         copy->tail++;
+         if ((err))
+            copy->abort = 1;
+         pthread_cond_signal(&copy->drained);
+         pthread_mutex_unlock(&copy->lock);
+      };
+      pthread_join(tid, NULL);
+   };
+   fclose(copy->output);
+   copy->output = NULL;
+
+   pthread_cond_destroy(&copy->drained);
+   pthread_cond_destroy(&copy->filled);
+   pthread_mutex_destroy(&copy->lock);
+
+   if ((copy->bufflen))
+      fwrite(copy->buff, 1, copy->bufflen, cnf->errs ? cnf->errs : stderr);
+   if (!(err))
+      err = copy->code;
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   if (!(err))
+      odbcshell_printf(cnf, "copied %lld rows from \"%s\" to \"%s\" in %lld ms.\n",
+         copy->rows, src->name, dst->name, msecs);
+   else
+      odbcshell_error(cnf, "stopped after %lld rows in %lld ms\n", copy->rows, msecs);
+
+   odbcshell_copy_free(cnf, copy);
+   free(copy);
+
+   return(err);
+}
+
+
+/// @brief inserts rows of a block into the destination
+/// @param cnf      pointer to configuration struct
+/// @param copy     pointer to copy state
+/// @param block    pointer to block holding values
+int odbcshell_copy_write(ODBCShell * cnf, ODBCShellCopy * copy,
+   ODBCShellCopyBlock * block)
+{
+   int       err;
+   SQLULEN   row;
+   SQLULEN   done;
+   SQLRETURN sts;
+
+   if (!(block->rows))
+      return(0);
+
+   if ((copy->arrays))
+   {
+      if ((err = odbcshell_copy_bind(cnf, copy, block, 0)))
+         return(err);
+      err = odbcshell_odbc_params_exec(cnf, copy->dst, block->rows, &done, &row);
+      copy->rows += (long long)done;
+      return(err);
+   };
+
+   for(row = 0; row < block->rows; row++)
+   {
+      if ((err = odbcshell_copy_bind(cnf, copy, block, row)))
+         return(err);
+      sts = SQLExecute(copy->dst->hstmt);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLExecute", cnf, copy->dst);
+         return(-1);
+      };
+      copy->rows++;
+   };
+
+   return(0);
+}
+
+/* end of source */
@@ -0,0 +1,88 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-copy.h ODBC Shell copies rows between connections
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_COPY_H
+#define _ODBCSHELL_SRC_ODBCSHELL_COPY_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// binds parameters of insert to a row of a block
+int odbcshell_copy_bind(ODBCShell * cnf, ODBCShellCopy * copy,
+   ODBCShellCopyBlock * block, SQLULEN row);
+
+// derives bound types of columns and allocates blocks
+int odbcshell_copy_columns(ODBCShell * cnf, ODBCShellCopy * copy);
+
+// finds connection taking part in copy
+int odbcshell_copy_conn(ODBCShell * cnf, const char * name,
+   ODBCShellConn ** connp);
+
+// frees resources used by copy
+void odbcshell_copy_free(ODBCShell * cnf, ODBCShellCopy * copy);
+
+// worker thread fetching blocks of rows from the source
+void * odbcshell_copy_reader(void * ptr);
+
+// copies rows returned by a query into a table of another connection
+int odbcshell_copy_run(ODBCShell * cnf, const char * from, char * sql,
+   const char * to, const char * table, long long batch);
+
+// inserts rows of a block into the destination
+int odbcshell_copy_write(ODBCShell * cnf, ODBCShellCopy * copy,
+   ODBCShellCopyBlock * block);
+
+#endif
+/* end of header */
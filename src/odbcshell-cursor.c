@@ -0,0 +1,284 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-cursor.c ODBC Shell named cursors
+ */
+#include "odbcshell-cursor.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief closes a named cursor and returns its statement to the pool
+/// @param cnf      pointer to configuration struct
+/// @param name     name of cursor
+int odbcshell_cursor_close(ODBCShell * cnf, const char * name)
+{
+   long long       idx;
+   ODBCShellConn * conn;
+   ODBCShellStmt * stmt;
+
+   if (!(stmt = odbcshell_cursor_find(cnf, name, &idx)))
+   {
+      odbcshell_error(cnf, "unknown cursor \"%s\"\n", name);
+      return(-1);
+   };
+   conn = stmt->conn;
+
+   if ( ((conn->job)) && (conn->job->cnf != cnf) )
+   {
+      odbcshell_error(cnf, "connection \"%s\" is in use by job %lld\n",
+         conn->name, conn->job->id);
+      return(-1);
+   };
+
+   // removes cursor from list while preserving order of remaining cursors
+   conn->cursors_count--;
+   memmove(&conn->cursors[idx], &conn->cursors[idx+1],
+      sizeof(ODBCShellStmt *) * (size_t)(conn->cursors_count - idx));
+
+   odbcshell_verbose(cnf, "closing cursor \"%s\"...\n", stmt->name);
+   odbcshell_odbc_stmt_release(cnf, &stmt);
+
+   return(0);
+}
+
+
+/// @brief displays the next rows from a named cursor
+/// @param cnf      pointer to configuration struct
+/// @param name     name of cursor
+/// @param rows     maximum number of rows to display
+int odbcshell_cursor_fetch(ODBCShell * cnf, const char * name, long long rows)
+{
+   int             err;
+   SQLLEN          row_count;
+   ODBCShellConn * conn;
+   ODBCShellStmt * stmt;
+
+   if (!(stmt = odbcshell_cursor_find(cnf, name, NULL)))
+   {
+      odbcshell_error(cnf, "unknown cursor \"%s\"\n", name);
+      return(-1);
+   };
+   conn = stmt->conn;
+
+   if ( ((conn->job)) && (conn->job->cnf != cnf) )
+   {
+      odbcshell_error(cnf, "connection \"%s\" is in use by job %lld\n",
+         conn->name, conn->job->id);
+      return(-1);
+   };
+
+   if (stmt->col_count == 0)
+   {
+      odbcshell_printf(cnf, "cursor \"%s\" has no more rows.\n", stmt->name);
+      return(0);
+   };
+
+   odbcshell_signal_stmt(stmt->hstmt);
+
+   row_count = 0;
+   if ((err = odbcshell_odbc_rows(cnf, stmt, (SQLLEN)rows, &row_count)))
+      return(err);
+   stmt->row_count += row_count;
+
+   // the cursor is exhausted once a fetch returns fewer rows than requested
+   if (row_count < rows)
+   {
+      SQLCloseCursor(stmt->hstmt);
+      stmt->col_count = 0;
+      odbcshell_printf(cnf, "\ncursor \"%s\" returned %lli rows, end of cursor.\n\n",
+         stmt->name, stmt->row_count);
+      return(0);
+   };
+
+   odbcshell_printf(cnf, "\ncursor \"%s\" returned %lli rows.\n\n",
+      stmt->name, stmt->row_count);
+
+   return(0);
+}
+
+
+/// @brief locates a named cursor on any connection
+/// @param cnf      pointer to configuration struct
+/// @param name     name of cursor
+/// @param indexp   stores position of cursor in connection's list
+ODBCShellStmt * odbcshell_cursor_find(ODBCShell * cnf, const char * name,
+   long long * indexp)
+{
+   long long i;
+   long long u;
+
+   for(i = 0; i < cnf->conns_count; i++)
+   {
+      for(u = 0; u < cnf->conns[i]->cursors_count; u++)
+      {
+         if (!(strcasecmp(name, cnf->conns[i]->cursors[u]->name)))
+         {
+            if ((indexp))
+               (*indexp) = u;
+            return(cnf->conns[i]->cursors[u]);
+         };
+      };
+   };
+
+   return(NULL);
+}
+
+
+/// @brief displays list of open cursors
+/// @param cnf      pointer to configuration struct
+int odbcshell_cursor_list(ODBCShell * cnf)
+{
+   long long       i;
+   long long       u;
+   ODBCShellStmt * stmt;
+
+   printf("  Cursor:    Connection: Rows:\n");
+   for(i = 0; i < cnf->conns_count; i++)
+   {
+      for(u = 0; u < cnf->conns[i]->cursors_count; u++)
+      {
+         stmt = cnf->conns[i]->cursors[u];
+         printf("  %-10s %-11s %lli%s\n", stmt->name, cnf->conns[i]->name,
+            stmt->row_count, ((stmt->col_count)) ? "" : " (end)");
+      };
+   };
+
+   return(0);
+}
+
+
+/// @brief opens a named cursor on the current connection
+/// @param cnf      pointer to configuration struct
+/// @param name     name of cursor
+/// @param sql      SQL query producing result set
+int odbcshell_cursor_open(ODBCShell * cnf, const char * name, char * sql)
+{
+   int             err;
+   size_t          size;
+   SQLRETURN       sts;
+   ODBCShellConn * conn;
+   ODBCShellStmt * stmt;
+   ODBCShellStmt ** cursors;
+
+   if ((odbcshell_cursor_find(cnf, name, NULL)))
+   {
+      odbcshell_error(cnf, "cursor with name \"%s\" already exists\n", name);
+      return(-1);
+   };
+
+   if ((odbcshell_odbc_ready(cnf)))
+      return(-1);
+   conn = cnf->current;
+
+   // resizes list of cursors before the statement is allocated
+   size = sizeof(ODBCShellStmt *) * (size_t)(conn->cursors_count + 1);
+   if (!(cursors = realloc(conn->cursors, size)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   conn->cursors = cursors;
+
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, conn, &stmt)))
+      return(err);
+   if (!(stmt->name = strdup(name)))
+   {
+      odbcshell_odbc_stmt_free(&stmt);
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+
+   odbcshell_odbc_stmt_timeout(cnf, conn, stmt);
+
+   // executes query on its own statement handle
+   odbcshell_verbose(cnf, "opening cursor \"%s\"...\n", name);
+   odbcshell_signal_stmt(stmt->hstmt);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)sql, SQL_NTS);
+   odbcshell_signal_stmt(NULL);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+
+   if ((err = odbcshell_odbc_describe(cnf, stmt)))
+   {
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(err);
+   };
+   if (stmt->col_count == 0)
+   {
+      odbcshell_error(cnf, "cursor \"%s\": statement did not return a result set\n", name);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+
+   conn->cursors[conn->cursors_count] = stmt;
+   conn->cursors_count++;
+
+   odbcshell_printf(cnf, "opened cursor \"%s\" on \"%s\"\n", name, conn->name);
+
+   return(0);
+}
+
+/* end of source */
@@ -0,0 +1,1214 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-daemon.c ODBC Shell connection daemon
+ */
+#include "odbcshell-daemon.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
+#include "odbcshell-exec.h"
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Variables
+#endif
+
+// write end of pipe used by signal handler to wake the event loop
+static int odbcshell_daemon_signal_fd = -1;
+
+// set once the daemon has been asked to exit
+static volatile sig_atomic_t odbcshell_daemon_stop = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief accepts pending clients
+/// @param d        pointer to daemon struct
+int odbcshell_daemon_accept(ODBCShellDaemon * d)
+{
+   int               fd;
+   void            * ptr;
+   ODBCShellClient * client;
+
+   while((fd = accept(d->sock, NULL, NULL)) != -1)
+   {
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+      fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+      if (!(client = malloc(sizeof(ODBCShellClient))))
+      {
+         odbcshell_fatal(d->cnf, "out of virtual memory\n");
+         close(fd);
+         return(-2);
+      };
+      memset(client, 0, sizeof(ODBCShellClient));
+      client->fd     = fd;
+      client->memfd  = -1;
+      client->state  = ODBCSHELL_DAEMON_READ;
+      client->daemon = d;
+
+      if (!(ptr = realloc(d->clients, sizeof(ODBCShellClient *) * (size_t)(d->clients_count+1))))
+      {
+         odbcshell_fatal(d->cnf, "out of virtual memory\n");
+         close(fd);
+         free(client);
+         return(-2);
+      };
+      d->clients = ptr;
+      d->clients[d->clients_count] = client;
+      d->clients_count++;
+
+      odbcshell_daemon_watch(d, client);
+   };
+
+   return(0);
+}
+
+
+/// @brief disconnects client and frees its resources
+/// @param d        pointer to daemon struct
+/// @param client   pointer to client struct
+void odbcshell_daemon_close(ODBCShellDaemon * d, ODBCShellClient * client)
+{
+   long long l;
+
+   for(l = 0; l < d->clients_count; l++)
+   {
+      if (d->clients[l] != client)
+         continue;
+      d->clients[l] = d->clients[d->clients_count-1];
+      d->clients_count--;
+      break;
+   };
+
+   if ((client->joinable))
+      pthread_join(client->thread, NULL);
+
+   close(client->fd);
+   if (client->memfd != -1)
+      close(client->memfd);
+   if ((client->outs))
+      fclose(client->outs);
+   if ((client->errs))
+      fclose(client->errs);
+   free(client->req);
+   free(client->out);
+   free(client->err);
+   free(client->cnf.exec_strs);
+   free(client->cnf.exec_indeps);
+   free(client);
+
+   return;
+}
+
+
+/// @brief sends -e statements to a connection daemon
+/// @param cnf      pointer to configuration struct
+/// @param codep    stores exit code returned by daemon
+/// @return 0 if daemon handled the request, -1 if the request should run locally
+int odbcshell_daemon_exec(ODBCShell * cnf, int * codep)
+{
+   int                  fd;
+   int                  shmfd;
+   long long            l;
+   char               * req;
+   char                 hdr[5];
+   char                 buff[4096];
+   size_t               req_len;
+   size_t               len;
+   size_t               chunk;
+   uint32_t             code;
+   FILE               * fs;
+   struct sockaddr_un   sa;
+
+   if ( (!(cnf->sockfile)) || (!(cnf->dflt_dsn)) || (cnf->dflt_dsns_count > 1) )
+      return(-1);
+   if (strlen(cnf->sockfile) >= sizeof(sa.sun_path))
+      return(-1);
+
+   memset(&sa, 0, sizeof(sa));
+   sa.sun_family = AF_UNIX;
+   strncpy(sa.sun_path, cnf->sockfile, sizeof(sa.sun_path)-1);
+
+   if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+      return(-1);
+   if ((connect(fd, (struct sockaddr *)&sa, sizeof(sa))))
+   {
+      odbcshell_verbose(cnf, "%s: %s, running locally\n", cnf->sockfile, strerror(errno));
+      close(fd);
+      return(-1);
+   };
+
+   // encodes request
+   req     = NULL;
+   req_len = 0;
+   if (!(fs = open_memstream(&req, &req_len)))
+   {
+      close(fd);
+      return(-1);
+   };
+   odbcshell_daemon_frame(fs, ODBCSHELL_FRAME_DSN, cnf->dflt_dsn, strlen(cnf->dflt_dsn)+1);
+   if ((cnf->continues))
+      odbcshell_daemon_frame(fs, ODBCSHELL_FRAME_CONTINUE, NULL, 0);
+   if ((cnf->silent))
+      odbcshell_daemon_frame(fs, ODBCSHELL_FRAME_SILENT, NULL, 0);
+   if ((cnf->verbose))
+      odbcshell_daemon_frame(fs, ODBCSHELL_FRAME_VERBOSE, NULL, 0);
+#ifdef HAVE_MEMFD_CREATE
+   odbcshell_daemon_frame(fs, ODBCSHELL_FRAME_SHM, NULL, 0);
+#endif
+   for(l = 0; l < cnf->exec_count; l++)
+      odbcshell_daemon_frame(fs,
+         (cnf->exec_indeps[l]) ? ODBCSHELL_FRAME_INDEP : ODBCSHELL_FRAME_EXEC,
+         cnf->exec_strs[l], strlen(cnf->exec_strs[l])+1);
+   odbcshell_daemon_frame(fs, ODBCSHELL_FRAME_END, NULL, 0);
+   fclose(fs);
+
+   // nothing has executed until the daemon receives the complete request
+   if ((odbcshell_daemon_send(fd, req, req_len)))
+   {
+      odbcshell_verbose(cnf, "%s: %s, running locally\n", cnf->sockfile, strerror(errno));
+      free(req);
+      close(fd);
+      return(-1);
+   };
+   free(req);
+
+   // relays reply until the exit code is received
+   (*codep) = -1;
+   shmfd    = -1;
+   while(!(odbcshell_daemon_recv(fd, hdr, sizeof(hdr), &shmfd)))
+   {
+      memcpy(&code, &hdr[1], 4);
+      len = ntohl(code);
+      if (hdr[0] == ODBCSHELL_FRAME_EXIT)
+      {
+         if ( (len != 4) || ((odbcshell_daemon_recv(fd, &code, 4, NULL))) )
+            break;
+         (*codep) = (int)(int32_t)ntohl(code);
+         close(fd);
+         return(0);
+      };
+      fs = (hdr[0] == ODBCSHELL_FRAME_STDERR) ? stderr : (cnf->output ? cnf->output : stdout);
+      if (hdr[0] == ODBCSHELL_FRAME_SHM)
+      {
+         if ( (len != 8) || ((odbcshell_daemon_recv(fd, buff, 8, &shmfd))) )
+            break;
+         // output which could not be written fails the request
+         if ((odbcshell_daemon_shm(cnf, shmfd, buff, fs)))
+         {
+            if (shmfd != -1)
+               close(shmfd);
+            close(fd);
+            return(0);
+         };
+         close(shmfd);
+         shmfd = -1;
+         continue;
+      };
+      for(; len > 0; len -= chunk)
+      {
+         chunk = (len < sizeof(buff)) ? len : sizeof(buff);
+         if ((odbcshell_daemon_recv(fd, buff, chunk, NULL)))
+            break;
+         fwrite(buff, 1, chunk, fs);
+      };
+      if (len > 0)
+         break;
+   };
+
+   odbcshell_error(cnf, "%s: connection to daemon lost\n", cnf->sockfile);
+   if (shmfd != -1)
+      close(shmfd);
+   close(fd);
+
+   return(0);
+}
+
+
+/// @brief queues reply once worker has finished executing request
+/// @param d        pointer to daemon struct
+/// @param client   pointer to client struct
+void odbcshell_daemon_finish(ODBCShellDaemon * d, ODBCShellClient * client)
+{
+   uint32_t      code;
+   uint32_t      n;
+   struct stat   sb;
+
+   if ((client->joinable))
+      pthread_join(client->thread, NULL);
+   client->joinable = 0;
+
+   if ((client->outs))
+      fclose(client->outs);
+   client->outs = NULL;
+   if ((client->errs))
+      fclose(client->errs);
+   client->errs = NULL;
+
+   code = htonl((uint32_t)(int32_t)client->code);
+   odbcshell_daemon_header(&client->hdrs[0],  ODBCSHELL_FRAME_STDOUT, client->out_len);
+   odbcshell_daemon_header(&client->hdrs[16], ODBCSHELL_FRAME_STDERR, client->err_len);
+   odbcshell_daemon_header(&client->hdrs[24], ODBCSHELL_FRAME_EXIT,   4);
+   memcpy(&client->hdrs[29], &code, 4);
+
+   client->iov[0].iov_base = &client->hdrs[0];
+   client->iov[0].iov_len  = 5;
+   client->iov[1].iov_base = client->out;
+   client->iov[1].iov_len  = client->out_len;
+   client->iov[2].iov_base = &client->hdrs[16];
+   client->iov[2].iov_len  = 5;
+   client->iov[3].iov_base = client->err;
+   client->iov[3].iov_len  = client->err_len;
+   client->iov[4].iov_base = &client->hdrs[24];
+   client->iov[4].iov_len  = 9;
+
+   // results written to shared memory are described by size, and the
+   // descriptor is attached to the first byte of the reply
+   if (client->memfd != -1)
+   {
+      memset(&sb, 0, sizeof(sb));
+      fstat(client->memfd, &sb);
+      odbcshell_daemon_header(&client->hdrs[0], ODBCSHELL_FRAME_SHM, 8);
+      n = htonl((uint32_t)((uint64_t)sb.st_size >> 32));
+      memcpy(&client->hdrs[5], &n, 4);
+      n = htonl((uint32_t)((uint64_t)sb.st_size & 0xFFFFFFFFU));
+      memcpy(&client->hdrs[9], &n, 4);
+      client->iov[0].iov_len = 13;
+      client->iov[1].iov_len = 0;
+   };
+   client->iov_count       = 5;
+   client->iov_next        = 0;
+
+   client->state = ODBCSHELL_DAEMON_WRITE;
+   odbcshell_daemon_watch(d, client);
+
+   return;
+}
+
+
+/// @brief appends frame to stream
+/// @param fs       stream to write
+/// @param type     frame type
+/// @param data     frame payload
+/// @param len      length of payload
+void odbcshell_daemon_frame(FILE * fs, int type, const void * data, size_t len)
+{
+   char hdr[5];
+   odbcshell_daemon_header(hdr, type, len);
+   fwrite(hdr, 1, sizeof(hdr), fs);
+   if ((len))
+      fwrite(data, 1, len, fs);
+   return;
+}
+
+
+/// @brief encodes frame header
+/// @param hdr      buffer of at least 5 bytes
+/// @param type     frame type
+/// @param len      length of payload
+void odbcshell_daemon_header(char * hdr, int type, size_t len)
+{
+   uint32_t n;
+   n      = htonl((uint32_t)len);
+   hdr[0] = (char)type;
+   memcpy(&hdr[1], &n, 4);
+   return;
+}
+
+
+/// @brief creates listening socket of daemon
+/// @param d        pointer to daemon struct
+int odbcshell_daemon_listen(ODBCShellDaemon * d)
+{
+   int                  fd;
+   mode_t               mask;
+   struct stat          sb;
+   struct sockaddr_un   sa;
+
+   if (strlen(d->cnf->sockfile) >= sizeof(sa.sun_path))
+   {
+      odbcshell_error(d->cnf, "%s: socket path is too long\n", d->cnf->sockfile);
+      return(-1);
+   };
+   memset(&sa, 0, sizeof(sa));
+   sa.sun_family = AF_UNIX;
+   strncpy(sa.sun_path, d->cnf->sockfile, sizeof(sa.sun_path)-1);
+
+   // removes socket left behind by a daemon which is no longer running
+   if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+   {
+      odbcshell_error(d->cnf, "socket(): %s\n", strerror(errno));
+      return(-1);
+   };
+   if (!(connect(fd, (struct sockaddr *)&sa, sizeof(sa))))
+   {
+      odbcshell_error(d->cnf, "%s: daemon is already running\n", d->cnf->sockfile);
+      close(fd);
+      return(-1);
+   };
+   close(fd);
+   if (!(lstat(d->cnf->sockfile, &sb)))
+      if (S_ISSOCK(sb.st_mode))
+         unlink(d->cnf->sockfile);
+
+   if ((d->sock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+   {
+      odbcshell_error(d->cnf, "socket(): %s\n", strerror(errno));
+      return(-1);
+   };
+   fcntl(d->sock, F_SETFL, fcntl(d->sock, F_GETFL) | O_NONBLOCK);
+   fcntl(d->sock, F_SETFD, FD_CLOEXEC);
+
+   // socket is only accessible by the user running the daemon
+   mask = umask(077);
+   if ((bind(d->sock, (struct sockaddr *)&sa, sizeof(sa))))
+   {
+      umask(mask);
+      odbcshell_error(d->cnf, "%s: %s\n", d->cnf->sockfile, strerror(errno));
+      return(-1);
+   };
+   umask(mask);
+
+   if ((listen(d->sock, SOMAXCONN)))
+   {
+      odbcshell_error(d->cnf, "%s: %s\n", d->cnf->sockfile, strerror(errno));
+      unlink(d->cnf->sockfile);
+      return(-1);
+   };
+
+   return(0);
+}
+
+
+/// @brief serves requests from odbcshell clients using warm connections
+/// @param cnf      pointer to configuration struct
+int odbcshell_daemon_loop(ODBCShell * cnf)
+{
+   int                i;
+   int                n;
+   int                code;
+   int                state;
+   char               buff[64];
+   long long          l;
+   void             * ready[ODBCSHELL_DAEMON_EVENTS];
+   ODBCShellConn    * conn;
+   ODBCShellDaemon    d;
+   struct sigaction   sa;
+#ifdef HAVE_SYS_EPOLL_H
+   struct epoll_event ev;
+#endif
+
+   if (!(cnf->sockfile))
+   {
+      fprintf(stderr, "%s: missing socket (use -S or ODBCSHELL_SOCKET)\n", PROGRAM_NAME);
+      fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+      return(-1);
+   };
+
+   memset(&d, 0, sizeof(ODBCShellDaemon));
+   d.cnf     = cnf;
+   d.sock    = -1;
+   d.epfd    = -1;
+   d.wake[0] = -1;
+   d.wake[1] = -1;
+   pthread_mutex_init(&d.lock, NULL);
+
+   // daemon owns its warm connections whatever poolsize is, otherwise
+   // every request would dial a new session
+   if (cnf->poolsize < ODBCSHELL_POOL_DAEMON)
+      cnf->poolsize = ODBCSHELL_POOL_DAEMON;
+   if (cnf->poolsize < cnf->dflt_dsns_count)
+      cnf->poolsize = cnf->dflt_dsns_count;
+
+   // establishes connections named with -D before accepting requests
+   for(l = 0; l < cnf->dflt_dsns_count; l++)
+   {
+      if ((odbcshell_odbc_open(cnf, cnf->dflt_dsns[l], "default", &conn)))
+         continue;
+      odbcshell_pool_put(cnf, &conn);
+   };
+
+   if ((odbcshell_daemon_listen(&d)))
+   {
+      if (d.sock != -1)
+         close(d.sock);
+      pthread_mutex_destroy(&d.lock);
+      return(-1);
+   };
+
+   // workers and the signal handler wake the event loop through a pipe
+   if ((pipe(d.wake)))
+   {
+      odbcshell_error(cnf, "pipe(): %s\n", strerror(errno));
+      close(d.sock);
+      unlink(cnf->sockfile);
+      pthread_mutex_destroy(&d.lock);
+      return(-1);
+   };
+   fcntl(d.wake[0], F_SETFL, fcntl(d.wake[0], F_GETFL) | O_NONBLOCK);
+   fcntl(d.wake[1], F_SETFL, fcntl(d.wake[1], F_GETFL) | O_NONBLOCK);
+   odbcshell_daemon_signal_fd = d.wake[1];
+   odbcshell_daemon_stop      = 0;
+
+   memset(&sa, 0, sizeof(sa));
+   sa.sa_handler = odbcshell_daemon_signal;
+   sigemptyset(&sa.sa_mask);
+   sigaction(SIGINT,  &sa, NULL);
+   sigaction(SIGTERM, &sa, NULL);
+   sigaction(SIGHUP,  &sa, NULL);
+
+#ifdef HAVE_SYS_EPOLL_H
+   // falls back to poll() if the kernel does not provide epoll
+   if ((d.epfd = epoll_create(ODBCSHELL_DAEMON_EVENTS)) != -1)
+   {
+      fcntl(d.epfd, F_SETFD, FD_CLOEXEC);
+      memset(&ev, 0, sizeof(ev));
+      ev.events   = EPOLLIN;
+      ev.data.ptr = &d;
+      epoll_ctl(d.epfd, EPOLL_CTL_ADD, d.sock, &ev);
+      ev.data.ptr = d.wake;
+      epoll_ctl(d.epfd, EPOLL_CTL_ADD, d.wake[0], &ev);
+   };
+#endif
+
+   odbcshell_verbose(cnf, "listening on %s using %s...\n", cnf->sockfile,
+      (d.epfd != -1) ? "epoll" : "poll");
+
+   code = 0;
+   while(!(odbcshell_daemon_stop))
+   {
+      if ((n = odbcshell_daemon_wait(&d, 1000, ready, ODBCSHELL_DAEMON_EVENTS)) == -1)
+      {
+         if (errno == EINTR)
+            continue;
+         odbcshell_error(cnf, "%s\n", strerror(errno));
+         code = -1;
+         break;
+      };
+
+      for(i = 0; i < n; i++)
+      {
+         if (ready[i] == &d)
+         {
+            if ((code = odbcshell_daemon_accept(&d)))
+               break;
+         }
+         else if (ready[i] == d.wake)
+         {
+            while(read(d.wake[0], buff, sizeof(buff)) > 0);
+         }
+         else if (((ODBCShellClient *)ready[i])->state == ODBCSHELL_DAEMON_READ)
+         {
+            odbcshell_daemon_read(&d, ready[i]);
+         }
+         else if (((ODBCShellClient *)ready[i])->state == ODBCSHELL_DAEMON_WRITE)
+         {
+            odbcshell_daemon_write(&d, ready[i]);
+         };
+      };
+      if ((code))
+         break;
+
+      // sends replies of requests which finished executing
+      for(l = 0; l < d.clients_count; l++)
+      {
+         pthread_mutex_lock(&d.lock);
+         state = d.clients[l]->state;
+         pthread_mutex_unlock(&d.lock);
+         if (state == ODBCSHELL_DAEMON_DONE)
+            odbcshell_daemon_finish(&d, d.clients[l]);
+      };
+
+      pthread_mutex_lock(&d.lock);
+      odbcshell_pool_trim(cnf);
+      pthread_mutex_unlock(&d.lock);
+   };
+
+   odbcshell_verbose(cnf, "shutting down...\n");
+
+   // stops accepting requests and waits for running requests to complete
+   close(d.sock);
+   unlink(cnf->sockfile);
+   while((d.clients_count))
+      odbcshell_daemon_close(&d, d.clients[0]);
+
+   odbcshell_daemon_signal_fd = -1;
+   close(d.wake[0]);
+   close(d.wake[1]);
+   if (d.epfd != -1)
+      close(d.epfd);
+   free(d.clients);
+   free(d.pfds);
+   free(d.pmap);
+   pthread_mutex_destroy(&d.lock);
+
+   return(code);
+}
+
+
+/// @brief reads request from client and starts executing it once complete
+/// @param d        pointer to daemon struct
+/// @param client   pointer to client struct
+int odbcshell_daemon_read(ODBCShellDaemon * d, ODBCShellClient * client)
+{
+   int       err;
+   ssize_t   n;
+   size_t    size;
+   void    * ptr;
+
+   while(1)
+   {
+      if ((client->req_size - client->req_len) < 4096)
+      {
+         size = (client->req_size) ? (client->req_size * 2) : 8192;
+         if ( (size > ODBCSHELL_DAEMON_MAXREQ) || (!(ptr = realloc(client->req, size))) )
+         {
+            odbcshell_error(d->cnf, "discarding oversized request\n");
+            odbcshell_daemon_close(d, client);
+            return(-1);
+         };
+         client->req      = ptr;
+         client->req_size = size;
+      };
+
+      if ((n = read(client->fd, &client->req[client->req_len], client->req_size - client->req_len)) > 0)
+      {
+         client->req_len += (size_t)n;
+         continue;
+      };
+      if ( (n == -1) && (errno == EINTR) )
+         continue;
+      if ( (n == -1) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)) )
+         break;
+
+      // client went away before completing the request
+      odbcshell_daemon_close(d, client);
+      return(-1);
+   };
+
+   if ((err = odbcshell_daemon_request(d, client)) == -1)
+   {
+      odbcshell_error(d->cnf, "discarding malformed request\n");
+      odbcshell_daemon_close(d, client);
+      return(-1);
+   };
+
+   return(0);
+}
+
+
+/// @brief receives exactly len bytes
+/// @param fd       socket
+/// @param buff     buffer to fill
+/// @param len      number of bytes to receive
+/// @param fdp      stores descriptor passed with SCM_RIGHTS (NULL to discard)
+int odbcshell_daemon_recv(int fd, void * buff, size_t len, int * fdp)
+{
+   int              flags;
+   int              rfd;
+   ssize_t          n;
+   struct iovec     iov;
+   struct msghdr    msg;
+   struct cmsghdr * cmsg;
+   union
+   {
+      struct cmsghdr hdr;
+      char           buff[CMSG_SPACE(sizeof(int))];
+   } ctl;
+
+   flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+   flags = MSG_CMSG_CLOEXEC;
+#endif
+
+   while(len > 0)
+   {
+      iov.iov_base = buff;
+      iov.iov_len  = len;
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_iov        = &iov;
+      msg.msg_iovlen     = 1;
+      msg.msg_control    = ctl.buff;
+      msg.msg_controllen = sizeof(ctl.buff);
+      if ((n = recvmsg(fd, &msg, flags)) > 0)
+      {
+         for(cmsg = CMSG_FIRSTHDR(&msg); ((cmsg)); cmsg = CMSG_NXTHDR(&msg, cmsg))
+         {
+            if ( (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS) )
+               continue;
+            memcpy(&rfd, CMSG_DATA(cmsg), sizeof(int));
+            if ( ((fdp)) && ((*fdp) == -1) )
+               (*fdp) = rfd;
+            else
+               close(rfd);
+         };
+         buff  = (char *)buff + n;
+         len  -= (size_t)n;
+         continue;
+      };
+      if ( (n == -1) && (errno == EINTR) )
+         continue;
+      return(-1);
+   };
+   return(0);
+}
+
+
+/// @brief decodes a complete request and starts a worker to execute it
+/// @param d        pointer to daemon struct
+/// @param client   pointer to client struct
+/// @return 0 if started, 1 if request is incomplete, -1 if request is malformed
+int odbcshell_daemon_request(ODBCShellDaemon * d, ODBCShellClient * client)
+{
+   int          fd;
+   int          err;
+   int          type;
+   int          complete;
+   char       * data;
+   size_t       off;
+   size_t       len;
+   sigset_t     oldset;
+   ODBCShell  * cnf;
+
+   // waits for the end of the request before decoding it in place
+   off      = 0;
+   complete = 0;
+   while((odbcshell_daemon_unframe(client->req, client->req_len, &off, &type, &data, &len)))
+      if ((complete = (type == ODBCSHELL_FRAME_END)))
+         break;
+   if (!(complete))
+      return(1);
+
+   // results and errors are buffered for the client
+   cnf = &client->cnf;
+   odbcshell_clone(d->cnf, cnf, NULL, NULL);
+   cnf->mode            = ODBCSHELL_MODE_EXEC;
+   cnf->silent          = 0;
+   cnf->verbose         = 0;
+   cnf->lazyconnect     = d->cnf->lazyconnect;
+   cnf->outputfile      = NULL;
+   cnf->exec_strs       = NULL;
+   cnf->exec_indeps     = NULL;
+   cnf->exec_count      = 0;
+   cnf->dflt_dsn        = NULL;
+   cnf->dflt_dsns       = NULL;
+   cnf->dflt_dsns_count = 0;
+
+   off = 0;
+   while((odbcshell_daemon_unframe(client->req, client->req_len, &off, &type, &data, &len)))
+   {
+      if (type == ODBCSHELL_FRAME_END)
+         break;
+      switch(type)
+      {
+         case ODBCSHELL_FRAME_CONTINUE:
+            cnf->continues = 1;
+            break;
+         case ODBCSHELL_FRAME_SILENT:
+            cnf->silent = 1;
+            break;
+         case ODBCSHELL_FRAME_VERBOSE:
+            cnf->verbose = 1;
+            break;
+         case ODBCSHELL_FRAME_SHM:
+#ifdef HAVE_MEMFD_CREATE
+            if (client->memfd == -1)
+               client->memfd = memfd_create(PROGRAM_NAME, MFD_CLOEXEC);
+#endif
+            break;
+         case ODBCSHELL_FRAME_DSN:
+            if ( (!(len)) || ((data[len-1])) )
+               return(-1);
+            cnf->dflt_dsn = data;
+            break;
+         case ODBCSHELL_FRAME_EXEC:
+         case ODBCSHELL_FRAME_INDEP:
+            if ( (!(len)) || ((data[len-1])) )
+               return(-1);
+            if ((odbcshell_exec_append_str(cnf, data, (type == ODBCSHELL_FRAME_INDEP))))
+               return(-1);
+            break;
+         default:
+            return(-1);
+      };
+   };
+   if ( (!(cnf->dflt_dsn)) || (!(cnf->exec_count)) )
+      return(-1);
+
+   // results are written directly into shared memory when client maps it
+   if (client->memfd != -1)
+   {
+      if ((fd = dup(client->memfd)) != -1)
+         if (!(client->outs = fdopen(fd, "w")))
+            close(fd);
+   } else {
+      client->outs = open_memstream(&client->out, &client->out_len);
+   };
+   client->errs = open_memstream(&client->err, &client->err_len);
+   if ( (!(client->outs)) || (!(client->errs)) )
+      return(-1);
+   cnf->output = client->outs;
+   cnf->msgs   = client->outs;
+   cnf->errs   = client->errs;
+
+   client->state = ODBCSHELL_DAEMON_RUN;
+   odbcshell_daemon_watch(d, client);
+
+   odbcshell_signal_block(&oldset);
+   err = pthread_create(&client->thread, NULL, odbcshell_daemon_thread, client);
+   odbcshell_signal_restore(&oldset);
+   if ((err))
+   {
+      odbcshell_error(cnf, "unable to start worker: %s\n", strerror(err));
+      client->code  = -1;
+      client->state = ODBCSHELL_DAEMON_DONE;
+      return(0);
+   };
+   client->joinable = 1;
+
+   return(0);
+}
+
+
+/// @brief sends exactly len bytes
+/// @param fd       socket
+/// @param buff     data to send
+/// @param len      number of bytes to send
+int odbcshell_daemon_send(int fd, const void * buff, size_t len)
+{
+   ssize_t n;
+   while(len > 0)
+   {
+      if ((n = write(fd, buff, len)) > 0)
+      {
+         buff  = (const char *)buff + n;
+         len  -= (size_t)n;
+         continue;
+      };
+      if ( (n == -1) && (errno == EINTR) )
+         continue;
+      return(-1);
+   };
+   return(0);
+}
+
+
+/// @brief writes results passed in shared memory
+/// @param cnf      pointer to configuration struct
+/// @param shmfd    descriptor of shared memory
+/// @param size     encoded size of results
+/// @param fs       stream receiving results
+int odbcshell_daemon_shm(ODBCShell * cnf, int shmfd, const char * size,
+   FILE * fs)
+{
+   char     * map;
+   ssize_t    n;
+   size_t     off;
+   size_t     len;
+   uint32_t   hi;
+   uint32_t   lo;
+
+   if (shmfd == -1)
+      return(-1);
+
+   memcpy(&hi, &size[0], 4);
+   memcpy(&lo, &size[4], 4);
+   len = (size_t)(((uint64_t)ntohl(hi) << 32) | (uint64_t)ntohl(lo));
+   if (!(len))
+      return(0);
+
+   if ((map = mmap(NULL, len, PROT_READ, MAP_SHARED, shmfd, 0)) == MAP_FAILED)
+   {
+      odbcshell_error(cnf, "mmap(): %s\n", strerror(errno));
+      return(-1);
+   };
+
+   // writes from the mapping instead of copying through stdio
+   fflush(fs);
+   for(off = 0; off < len; off += (size_t)n)
+   {
+      if ((n = write(fileno(fs), &map[off], len - off)) > 0)
+         continue;
+      if ( (n == -1) && (errno == EINTR) )
+      {
+         n = 0;
+         continue;
+      };
+      odbcshell_error(cnf, "%s\n", (n == -1) ? strerror(errno) : "short write");
+      munmap(map, len);
+      return(-1);
+   };
+
+   munmap(map, len);
+
+   return(0);
+}
+
+
+/// @brief requests daemon to exit
+/// @param sig      signal number
+void odbcshell_daemon_signal(int sig)
+{
+   char c;
+   odbcshell_daemon_stop = 1;
+   if (odbcshell_daemon_signal_fd != -1)
+   {
+      c = (char)sig;
+      if (write(odbcshell_daemon_signal_fd, &c, 1) == -1)
+         return;
+   };
+   return;
+}
+
+
+/// @brief worker thread executing a client request
+/// @param ptr      pointer to client struct
+void * odbcshell_daemon_thread(void * ptr)
+{
+   int               code;
+   int               conn_index;
+   long long         l;
+   ODBCShell       * cnf;
+   ODBCShellConn   * conn;
+   ODBCShellClient * client;
+   ODBCShellDaemon * d;
+
+   client = ptr;
+   d      = client->daemon;
+   cnf    = &client->cnf;
+   conn   = NULL;
+
+   // reuses a warm connection held by the daemon
+   pthread_mutex_lock(&d->lock);
+   code = odbcshell_pool_take(d->cnf, cnf->dflt_dsn, "default", &conn);
+   pthread_mutex_unlock(&d->lock);
+   if ( (!(code)) && (!(conn)) )
+      code = odbcshell_odbc_open(cnf, cnf->dflt_dsn, "default", &conn);
+   if (!(code))
+      if ((code = odbcshell_odbc_array_add(cnf, conn)))
+         odbcshell_odbc_free(cnf, &conn);
+   if (!(code))
+   {
+      cnf->current = conn;
+      code = odbcshell_exec_run(cnf);
+   };
+   fflush(client->outs);
+   fflush(client->errs);
+
+   // keeps the default connection warm and discards any others
+   conn = NULL;
+   if ((conn_index = odbcshell_odbc_array_findindex(cnf, "default")) != -1)
+      conn = cnf->conns[conn_index];
+   for(l = 0; l < cnf->conns_count; l++)
+      if (cnf->conns[l] != conn)
+         odbcshell_odbc_free(cnf, &cnf->conns[l]);
+   free(cnf->conns);
+   free(cnf->conns_hash);
+   cnf->conns           = NULL;
+   cnf->conns_count     = 0;
+   cnf->conns_hash      = NULL;
+   cnf->conns_hash_size = 0;
+   cnf->current         = NULL;
+
+   pthread_mutex_lock(&d->lock);
+   if ((conn))
+      odbcshell_pool_put(d->cnf, &conn);
+   client->code  = (code) ? -1 : 0;
+   client->state = ODBCSHELL_DAEMON_DONE;
+   pthread_mutex_unlock(&d->lock);
+
+   if (write(d->wake[1], "", 1) == -1)
+      return(NULL);
+
+   return(NULL);
+}
+
+
+/// @brief decodes next frame from buffer
+/// @param buff     buffer holding frames
+/// @param len      length of buffer
+/// @param offp     offset of next frame, advanced past the decoded frame
+/// @param typep    stores frame type
+/// @param datap    stores pointer to payload
+/// @param lenp     stores length of payload
+/// @return 1 if a frame was decoded, 0 if buffer does not hold a complete frame
+int odbcshell_daemon_unframe(char * buff, size_t len, size_t * offp,
+   int * typep, char ** datap, size_t * lenp)
+{
+   uint32_t n;
+
+   if ((len - (*offp)) < 5)
+      return(0);
+   memcpy(&n, &buff[(*offp)+1], 4);
+   n = ntohl(n);
+   if ((len - (*offp) - 5) < n)
+      return(0);
+
+   (*typep)  = (unsigned char)buff[*offp];
+   (*datap)  = &buff[(*offp)+5];
+   (*lenp)   = n;
+   (*offp)  += 5 + n;
+
+   return(1);
+}
+
+
+/// @brief waits for sockets to become ready
+/// @param d        pointer to daemon struct
+/// @param timeout  milliseconds to wait
+/// @param ready    stores owners of ready sockets
+/// @param max      maximum number of owners to store
+int odbcshell_daemon_wait(ODBCShellDaemon * d, int timeout, void ** ready,
+   int max)
+{
+   int                i;
+   int                n;
+   nfds_t             nfds;
+   void             * ptr;
+   long long          l;
+   ODBCShellClient  * client;
+#ifdef HAVE_SYS_EPOLL_H
+   struct epoll_event events[ODBCSHELL_DAEMON_EVENTS];
+
+   if (d->epfd != -1)
+   {
+      if (max > ODBCSHELL_DAEMON_EVENTS)
+         max = ODBCSHELL_DAEMON_EVENTS;
+      if ((n = epoll_wait(d->epfd, events, max, timeout)) == -1)
+         return(-1);
+      for(i = 0; i < n; i++)
+         ready[i] = events[i].data.ptr;
+      return(n);
+   };
+#endif
+
+   // rebuilds descriptor list for poll() from client states
+   if (d->pfds_size < (size_t)(d->clients_count + 2))
+   {
+      if (!(ptr = realloc(d->pfds, sizeof(struct pollfd) * (size_t)(d->clients_count + 2))))
+         return(-1);
+      d->pfds = ptr;
+      if (!(ptr = realloc(d->pmap, sizeof(void *) * (size_t)(d->clients_count + 2))))
+         return(-1);
+      d->pmap      = ptr;
+      d->pfds_size = (size_t)(d->clients_count + 2);
+   };
+   d->pfds[0].fd     = d->sock;
+   d->pfds[0].events = POLLIN;
+   d->pmap[0]        = d;
+   d->pfds[1].fd     = d->wake[0];
+   d->pfds[1].events = POLLIN;
+   d->pmap[1]        = d->wake;
+   nfds              = 2;
+   for(l = 0; l < d->clients_count; l++)
+   {
+      client = d->clients[l];
+      if (client->state == ODBCSHELL_DAEMON_READ)
+         d->pfds[nfds].events = POLLIN;
+      else if (client->state == ODBCSHELL_DAEMON_WRITE)
+         d->pfds[nfds].events = POLLOUT;
+      else
+         continue;
+      d->pfds[nfds].fd = client->fd;
+      d->pmap[nfds]    = client;
+      nfds++;
+   };
+
+   if ((n = poll(d->pfds, nfds, timeout)) == -1)
+      return(-1);
+
+   for(i = 0, l = 0; ((l < (long long)nfds) && (i < max)); l++)
+      if ((d->pfds[l].revents))
+         ready[i++] = d->pmap[l];
+
+   return(i);
+}
+
+
+/// @brief registers interest in socket events matching client state
+/// @param d        pointer to daemon struct
+/// @param client   pointer to client struct
+void odbcshell_daemon_watch(ODBCShellDaemon * d, ODBCShellClient * client)
+{
+#ifdef HAVE_SYS_EPOLL_H
+   struct epoll_event ev;
+#endif
+
+   // poll() rebuilds its descriptor list from client states on every call
+   if (d->epfd == -1)
+   {
+      client->watched = 0;
+      return;
+   };
+
+#ifdef HAVE_SYS_EPOLL_H
+   memset(&ev, 0, sizeof(ev));
+   ev.data.ptr = client;
+   if (client->state == ODBCSHELL_DAEMON_READ)
+      ev.events = EPOLLIN;
+   else if (client->state == ODBCSHELL_DAEMON_WRITE)
+      ev.events = EPOLLOUT;
+
+   // hang ups are always reported, so sockets are removed while idle
+   if (!(ev.events))
+   {
+      if ((client->watched))
+         epoll_ctl(d->epfd, EPOLL_CTL_DEL, client->fd, &ev);
+      client->watched = 0;
+      return;
+   };
+   epoll_ctl(d->epfd, (client->watched) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, client->fd, &ev);
+   client->watched = 1;
+#endif
+   return;
+}
+
+
+/// @brief sends reply to client
+/// @param d        pointer to daemon struct
+/// @param client   pointer to client struct
+int odbcshell_daemon_write(ODBCShellDaemon * d, ODBCShellClient * client)
+{
+   ssize_t          n;
+   struct iovec   * iov;
+   struct msghdr    msg;
+   struct cmsghdr * cmsg;
+   union
+   {
+      struct cmsghdr hdr;
+      char           buff[CMSG_SPACE(sizeof(int))];
+   } ctl;
+
+   while(client->iov_next < client->iov_count)
+   {
+      iov = &client->iov[client->iov_next];
+
+      // passes shared memory with the first bytes of the reply
+      if (client->memfd != -1)
+      {
+         memset(&msg, 0, sizeof(msg));
+         memset(&ctl, 0, sizeof(ctl));
+         msg.msg_iov        = iov;
+         msg.msg_iovlen     = (size_t)(client->iov_count - client->iov_next);
+         msg.msg_control    = ctl.buff;
+         msg.msg_controllen = sizeof(ctl.buff);
+         cmsg               = CMSG_FIRSTHDR(&msg);
+         cmsg->cmsg_level   = SOL_SOCKET;
+         cmsg->cmsg_type    = SCM_RIGHTS;
+         cmsg->cmsg_len     = CMSG_LEN(sizeof(int));
+         memcpy(CMSG_DATA(cmsg), &client->memfd, sizeof(int));
+         if ((n = sendmsg(client->fd, &msg, 0)) != -1)
+         {
+            close(client->memfd);
+            client->memfd = -1;
+         };
+      } else {
+         n = writev(client->fd, iov, client->iov_count - client->iov_next);
+      };
+      if (n == -1)
+      {
+         if (errno == EINTR)
+            continue;
+         if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+            return(0);
+         odbcshell_daemon_close(d, client);
+         return(-1);
+      };
+
+      // advances past segments which were sent completely
+      while( (client->iov_next < client->iov_count) && ((size_t)n >= client->iov[client->iov_next].iov_len) )
+      {
+         n -= (ssize_t)client->iov[client->iov_next].iov_len;
+         client->iov_next++;
+      };
+      if (n > 0)
+      {
+         iov            = &client->iov[client->iov_next];
+         iov->iov_base  = (char *)iov->iov_base + n;
+         iov->iov_len  -= (size_t)n;
+      };
+   };
+
+   odbcshell_daemon_close(d, client);
+
+   return(0);
+}
+
+/* end of source */
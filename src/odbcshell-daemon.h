@@ -0,0 +1,123 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-daemon.h ODBC Shell connection daemon
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_DAEMON_H
+#define _ODBCSHELL_SRC_ODBCSHELL_DAEMON_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// accepts pending clients
+int odbcshell_daemon_accept(ODBCShellDaemon * d);
+
+// disconnects client and frees its resources
+void odbcshell_daemon_close(ODBCShellDaemon * d, ODBCShellClient * client);
+
+// sends -e statements to a connection daemon
+int odbcshell_daemon_exec(ODBCShell * cnf, int * codep);
+
+// queues reply once worker has finished executing request
+void odbcshell_daemon_finish(ODBCShellDaemon * d, ODBCShellClient * client);
+
+// appends frame to stream
+void odbcshell_daemon_frame(FILE * fs, int type, const void * data, size_t len);
+
+// encodes frame header
+void odbcshell_daemon_header(char * hdr, int type, size_t len);
+
+// creates listening socket of daemon
+int odbcshell_daemon_listen(ODBCShellDaemon * d);
+
+// serves requests from odbcshell clients using warm connections
+int odbcshell_daemon_loop(ODBCShell * cnf);
+
+// reads request from client and starts executing it once complete
+int odbcshell_daemon_read(ODBCShellDaemon * d, ODBCShellClient * client);
+
+// receives exactly len bytes
+int odbcshell_daemon_recv(int fd, void * buff, size_t len, int * fdp);
+
+// decodes a complete request and starts a worker to execute it
+int odbcshell_daemon_request(ODBCShellDaemon * d, ODBCShellClient * client);
+
+// sends exactly len bytes
+int odbcshell_daemon_send(int fd, const void * buff, size_t len);
+
+// writes results passed in shared memory
+int odbcshell_daemon_shm(ODBCShell * cnf, int shmfd, const char * size,
+   FILE * fs);
+
+// requests daemon to exit
+void odbcshell_daemon_signal(int sig);
+
+// worker thread executing a client request
+void * odbcshell_daemon_thread(void * ptr);
+
+// decodes next frame from buffer
+int odbcshell_daemon_unframe(char * buff, size_t len, size_t * offp,
+   int * typep, char ** datap, size_t * lenp);
+
+// waits for sockets to become ready
+int odbcshell_daemon_wait(ODBCShellDaemon * d, int timeout, void ** ready,
+   int max);
+
+// registers interest in socket events matching client state
+void odbcshell_daemon_watch(ODBCShellDaemon * d, ODBCShellClient * client);
+
+// sends reply to client
+int odbcshell_daemon_write(ODBCShellDaemon * d, ODBCShellClient * client);
+
+#endif
+/* end of header */
@@ -0,0 +1,926 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-dump.c ODBC Shell writes each table to its own file
+ */
+#include "odbcshell-dump.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief adds bytes to a CRC-32
+/// @param dump     pointer to dump state
+/// @param crc      CRC-32 of preceding bytes (zero for none)
+/// @param buff     bytes to add
+/// @param len      number of bytes
+uint32_t odbcshell_dump_crc(ODBCShellDump * dump, uint32_t crc,
+   const char * buff, size_t len)
+{
+   size_t pos;
+
+   crc = ~crc;
+   for(pos = 0; pos < len; pos++)
+      crc = dump->crcs[(crc ^ (unsigned char)buff[pos]) & 0xFF] ^ (crc >> 8);
+
+   return(~crc);
+}
+
+
+/// @brief writes a value with the characters special to the format escaped
+/// @param cnf      pointer to configuration struct
+/// @param value    value to write
+void odbcshell_dump_escape(ODBCShell * cnf, const char * value)
+{
+   FILE * fs;
+
+   fs = ((cnf->output)) ? cnf->output : stdout;
+
+   for(; ((*value)); value++)
+   {
+      if ( (cnf->format == ODBCSHELL_FORMAT_XML) && (*value == '&') )
+         fputs("&amp;", fs);
+      else if ( (cnf->format == ODBCSHELL_FORMAT_XML) && (*value == '<') )
+         fputs("&lt;", fs);
+      else if ( (cnf->format == ODBCSHELL_FORMAT_XML) && (*value == '>') )
+         fputs("&gt;", fs);
+      else
+      {
+         // quotes within CSV values are doubled
+         if ( (cnf->format == ODBCSHELL_FORMAT_CSV) && (*value == '"') )
+            fputc('"', fs);
+         fputc(*value, fs);
+      };
+   };
+
+   return;
+}
+
+
+/// @brief reads the number of rows of each table from driver statistics
+/// @param cnf      pointer to configuration struct
+/// @param dump     pointer to dump state
+/// @param conn     connection used to read statistics
+int odbcshell_dump_estimate(ODBCShell * cnf, ODBCShellDump * dump,
+   ODBCShellConn * conn)
+{
+   long long            l;
+   long long            type;
+   long long            rows;
+   SQLLEN               ind;
+   SQLRETURN            sts;
+   ODBCShellStmt      * stmt;
+   ODBCShellDumpTable * table;
+
+   stmt = conn->stmt;
+
+   // statistics the driver already holds are requested so that estimating
+   // sizes does not scan any table
+   odbcshell_verbose(cnf, "reading statistics of %lld tables...\n", dump->count);
+   for(l = 0; l < dump->count; l++)
+   {
+      table           = &dump->tables[l];
+      table->estimate = -1;
+      sts = SQLStatistics(stmt->hstmt, NULL, 0,
+         (SQLCHAR *)table->schema, ((table->schema)) ? SQL_NTS : 0,
+         (SQLCHAR *)table->name, SQL_NTS, SQL_INDEX_ALL, SQL_QUICK);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_verbose(cnf, "statistics of \"%s\" are unavailable\n", table->name);
+         SQLFreeStmt(stmt->hstmt, SQL_CLOSE);
+         continue;
+      };
+      while ((SQL_SUCCEEDED(SQLFetch(stmt->hstmt))))
+      {
+         sts = SQLGetData(stmt->hstmt, 7, SQL_C_SBIGINT, &type, sizeof(type), &ind);
+         if ( (!(SQL_SUCCEEDED(sts))) || (ind == SQL_NULL_DATA) || (type != SQL_TABLE_STAT) )
+            continue;
+         sts = SQLGetData(stmt->hstmt, 11, SQL_C_SBIGINT, &rows, sizeof(rows), &ind);
+         if ( (SQL_SUCCEEDED(sts)) && (ind != SQL_NULL_DATA) && (rows >= 0) )
+            table->estimate = rows;
+         break;
+      };
+      SQLFreeStmt(stmt->hstmt, SQL_CLOSE);
+   };
+
+   return(0);
+}
+
+
+/// @brief writes rows buffered by a worker to the file of a table
+/// @param worker   pointer to worker
+/// @param table    table being dumped
+/// @param fs       file of table
+void odbcshell_dump_flush(ODBCShellDumpWorker * worker,
+   ODBCShellDumpTable * table, FILE * fs)
+{
+   fflush(worker->output);
+   if (!(worker->bufflen))
+      return;
+
+   table->crc    = odbcshell_dump_crc(worker->dump, table->crc, worker->buff, worker->bufflen);
+   table->bytes += (long long)worker->bufflen;
+   fwrite(worker->buff, 1, worker->bufflen, fs);
+
+   // buffer is reused for the next block of rows
+   rewind(worker->output);
+   fflush(worker->output);
+
+   return;
+}
+
+
+/// @brief frees resources used by dump
+/// @param dump     pointer to dump state
+void odbcshell_dump_free(ODBCShellDump * dump)
+{
+   long long            l;
+   ODBCShellDumpTable * table;
+
+   for(l = 0; l < dump->count; l++)
+   {
+      table = &dump->tables[l];
+      if ((table->errs))
+         fclose(table->errs);
+      free(table->schema);
+      free(table->name);
+      free(table->path);
+      free(table->err);
+   };
+   free(dump->tables);
+   free(dump->order);
+   dump->tables = NULL;
+   dump->order  = NULL;
+   dump->count  = 0;
+
+   return;
+}
+
+
+/// @brief lists tables of a schema
+/// @param cnf      pointer to configuration struct
+/// @param dump     pointer to dump state
+/// @param conn     connection used to list tables
+/// @param schema   schema of tables (NULL for all)
+int odbcshell_dump_list(ODBCShell * cnf, ODBCShellDump * dump,
+   ODBCShellConn * conn, const char * schema)
+{
+   int                  err;
+   void               * ptr;
+   SQLLEN               ind_schema;
+   SQLLEN               ind_name;
+   SQLRETURN            sts;
+   ODBCShellStmt      * stmt;
+   ODBCShellDumpTable * table;
+   unsigned char        strwild[2];
+   unsigned char        strtype[6];
+   char                 buff_schema[ODBCSHELL_FETCH_WIDTH];
+   char                 buff_name[ODBCSHELL_FETCH_WIDTH];
+
+   stmt = conn->stmt;
+
+   strncpy((char *)strwild, "%",     sizeof(strwild));
+   strncpy((char *)strtype, "TABLE", sizeof(strtype));
+   if ((schema))
+      snprintf(buff_schema, sizeof(buff_schema), "%s", schema);
+
+   odbcshell_verbose(cnf, "listing tables...\n");
+   sts = SQLTables(stmt->hstmt, NULL, 0, ((schema)) ? (SQLCHAR *)buff_schema : NULL,
+      ((schema)) ? SQL_NTS : 0, strwild, SQL_NTS, strtype, SQL_NTS);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLTables", cnf, stmt);
+      return(-1);
+   };
+
+   err = 0;
+   while ( (!(err)) && ((SQL_SUCCEEDED(sts = SQLFetch(stmt->hstmt)))) )
+   {
+      sts = SQLGetData(stmt->hstmt, 2, SQL_C_CHAR, buff_schema, sizeof(buff_schema), &ind_schema);
+      if ((SQL_SUCCEEDED(sts)))
+         sts = SQLGetData(stmt->hstmt, 3, SQL_C_CHAR, buff_name, sizeof(buff_name), &ind_name);
+      if (!(SQL_SUCCEEDED(sts)))
+         break;
+      if (ind_name == SQL_NULL_DATA)
+         continue;
+
+      if (!(ptr = realloc(dump->tables, sizeof(ODBCShellDumpTable) * (size_t)(dump->count+1))))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+         break;
+      };
+      dump->tables = ptr;
+      table = &dump->tables[dump->count];
+      memset(table, 0, sizeof(ODBCShellDumpTable));
+      dump->count++;
+
+      if ( (!(table->name = strdup(buff_name))) ||
+           ( (ind_schema != SQL_NULL_DATA) && ((buff_schema[0])) && (!(table->schema = strdup(buff_schema))) ) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+      };
+   };
+   if ( (!(err)) && (!(SQL_SUCCEEDED(sts))) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLFetch", cnf, stmt);
+      err = -1;
+   };
+   SQLFreeStmt(stmt->hstmt, SQL_CLOSE);
+
+   return(err);
+}
+
+
+/// @brief writes the row counts and checksums of each file
+/// @param cnf      pointer to configuration struct
+/// @param dump     pointer to dump state
+int odbcshell_dump_manifest(ODBCShell * cnf, ODBCShellDump * dump)
+{
+   long long            l;
+   size_t               len;
+   char               * path;
+   const char         * str;
+   const char         * file;
+   FILE               * fs;
+   ODBCShellDumpTable * table;
+
+   len = strlen(dump->dir) + 16;
+   if (!(path = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   snprintf(path, len, "%s/manifest.csv", dump->dir);
+   if (!(fs = fopen(path, "w")))
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      free(path);
+      return(-1);
+   };
+
+   // checksum is the CRC-32 of each file as written
+   fprintf(fs, "\"schema\",\"table\",\"file\",\"rows\",\"bytes\",\"crc32\"\n");
+   for(l = 0; l < dump->count; l++)
+   {
+      table = &dump->tables[l];
+      if ((table->code))
+         continue;
+      fputc('"', fs);
+      for(str = ((table->schema)) ? table->schema : ""; ((*str)); str++)
+      {
+         if (*str == '"')
+            fputc('"', fs);
+         fputc(*str, fs);
+      };
+      fprintf(fs, "\",\"");
+      for(str = table->name; ((*str)); str++)
+      {
+         if (*str == '"')
+            fputc('"', fs);
+         fputc(*str, fs);
+      };
+      file = ((file = strrchr(table->path, '/'))) ? file + 1 : table->path;
+      fprintf(fs, "\",\"%s\",%lld,%lld,\"%08x\"\n", file, table->rows, table->bytes,
+         (unsigned)table->crc);
+   };
+
+   if ((fclose(fs)))
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      free(path);
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "wrote manifest to \"%s\"\n", path);
+   free(path);
+
+   return(0);
+}
+
+
+/// @brief orders tables largest first
+/// @param ptr1     pointer to first table
+/// @param ptr2     pointer to second table
+int odbcshell_dump_order(const void * ptr1, const void * ptr2)
+{
+   const ODBCShellDumpTable * table1;
+   const ODBCShellDumpTable * table2;
+
+   table1 = *((ODBCShellDumpTable * const *)ptr1);
+   table2 = *((ODBCShellDumpTable * const *)ptr2);
+
+   // tables of unknown size are started first so that a large one is not
+   // left running alone at the end
+   if (table1->estimate != table2->estimate)
+   {
+      if (table1->estimate == -1)
+         return(-1);
+      if (table2->estimate == -1)
+         return(1);
+      return((table1->estimate > table2->estimate) ? -1 : 1);
+   };
+
+   // tables of equal size keep the order listed by the driver
+   return((table1 < table2) ? -1 : (table1 > table2) ? 1 : 0);
+}
+
+
+/// @brief builds statement selecting every row of a table
+/// @param dump     pointer to dump state
+/// @param table    table being dumped
+char * odbcshell_dump_query(ODBCShellDump * dump, ODBCShellDumpTable * table)
+{
+   int          i;
+   char       * sql;
+   size_t       len;
+   size_t       pos;
+   size_t       qlen;
+   const char * names[2];
+
+   names[0] = table->schema;
+   names[1] = table->name;
+   qlen     = strlen(dump->quote);
+
+   len = 32 + strlen(table->name) * (qlen + 1) + 2 * qlen;
+   if ((table->schema))
+      len += strlen(table->schema) * (qlen + 1) + 2 * qlen;
+   if (!(sql = malloc(len)))
+      return(NULL);
+
+   // quote characters within names are doubled
+   pos = (size_t)snprintf(sql, len, "SELECT * FROM ");
+   for(i = ((table->schema)) ? 0 : 1; i < 2; i++)
+   {
+      memcpy(&sql[pos], dump->quote, qlen);
+      pos += qlen;
+      for(; ((*names[i])); names[i]++)
+      {
+         if ( ((qlen)) && (!(strncmp(names[i], dump->quote, qlen))) )
+         {
+            memcpy(&sql[pos], dump->quote, qlen);
+            pos += qlen;
+         };
+         sql[pos++] = *names[i];
+      };
+      memcpy(&sql[pos], dump->quote, qlen);
+      pos += qlen;
+      if (i == 0)
+         sql[pos++] = '.';
+   };
+   sql[pos] = '\0';
+
+   return(sql);
+}
+
+
+/// @brief writes rows of the pending result set without truncating values
+/// @param worker   pointer to worker
+/// @param stmt     pointer to statement struct
+/// @param max      maximum number of rows to write
+/// @param rowsp    pointer to number of rows written
+int odbcshell_dump_rows(ODBCShellDumpWorker * worker, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * rowsp)
+{
+   int               err;
+   SQLLEN            ind;
+   SQLRETURN         sts;
+   SQLSMALLINT       col;
+   ODBCShell       * cnf;
+   const char      * value;
+
+   cnf = &worker->cnf;
+
+   while ((*rowsp) < max)
+   {
+      sts = odbcshell_odbc_fetch(cnf, stmt);
+      if (sts == SQL_NO_DATA_FOUND)
+         return(0);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLFetchScroll", cnf, stmt);
+         return(-1);
+      };
+
+      if (cnf->format == ODBCSHELL_FORMAT_XML)
+         odbcshell_fprintf(cnf, "\t<row>\n");
+      for(col = 0; col < stmt->col_count; col++)
+      {
+         // a value which cannot be read whole fails the table
+         if ((err = odbcshell_odbc_value_full(cnf, stmt, (SQLUSMALLINT)(col+1),
+            &worker->value, &worker->valuesize, &ind)))
+            return(err);
+         value = (ind == SQL_NULL_DATA) ? "" : worker->value;
+
+         // NULL is an empty unquoted CSV value or an omitted XML element
+         switch(cnf->format)
+         {
+            case ODBCSHELL_FORMAT_FIXED:
+               odbcshell_fprintf(cnf, "%-*s", (int)stmt->cols[col].width, value);
+               if (col < (stmt->col_count-1))
+                  odbcshell_fprintf(cnf, "|");
+               break;
+
+            case ODBCSHELL_FORMAT_XML:
+               if (ind == SQL_NULL_DATA)
+                  break;
+               odbcshell_fprintf(cnf, "\t\t<%s>", stmt->cols[col].name);
+               odbcshell_dump_escape(cnf, value);
+               odbcshell_fprintf(cnf, "</%s>\n", stmt->cols[col].name);
+               break;
+
+            default:
+               if (ind != SQL_NULL_DATA)
+               {
+                  odbcshell_fprintf(cnf, "\"");
+                  odbcshell_dump_escape(cnf, value);
+                  odbcshell_fprintf(cnf, "\"");
+               };
+               if (col < (stmt->col_count-1))
+                  odbcshell_fprintf(cnf, ",");
+               break;
+         };
+      };
+      if (cnf->format == ODBCSHELL_FORMAT_XML)
+         odbcshell_fprintf(cnf, "\t</row>\n");
+      else
+         odbcshell_fprintf(cnf, "\n");
+      (*rowsp)++;
+   };
+
+   return(0);
+}
+
+
+/// @brief writes every table of a schema to its own file over several connections
+/// @param cnf      pointer to configuration struct
+/// @param schema   schema of tables (NULL for all)
+/// @param dir      directory receiving files
+/// @param format   format of files
+/// @param jobs     most tables dumped at once
+int odbcshell_dump_run(ODBCShell * cnf, const char * schema,
+   const char * dir, long long format, long long jobs)
+{
+   int                   err;
+   int                   code;
+   uint32_t              crc;
+   long long             l;
+   long long             u;
+   long long             dup;
+   long long             threads;
+   long long             started;
+   long long             rows;
+   long long             failed;
+   long long             msecs;
+   size_t                len;
+   size_t                pos;
+   sigset_t              oldset;
+   pthread_t           * tids;
+   struct timespec       start;
+   struct timespec       end;
+   ODBCShellDump         dump;
+   ODBCShellDumpTable  * table;
+   ODBCShellDumpWorker * workers;
+   ODBCShellDumpWorker * worker;
+   SQLSMALLINT           qlen;
+   char                  name[64];
+
+   if ( (jobs < 1) || (jobs > ODBCSHELL_DUMP_JOBS) )
+   {
+      odbcshell_error(cnf, "number of connections must be between 1 and %i\n", ODBCSHELL_DUMP_JOBS);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_ready(cnf)))
+      return(err);
+   if ( ((mkdir(dir, 0777))) && (errno != EEXIST) )
+   {
+      odbcshell_error(cnf, "%s: %s\n", dir, strerror(errno));
+      return(-1);
+   };
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   memset(&dump, 0, sizeof(ODBCShellDump));
+   dump.dir      = dir;
+   dump.dsn      = cnf->current->dsn;
+   dump.format   = format;
+   dump.noheader = (int)cnf->noheader;
+   switch(format)
+   {
+      case ODBCSHELL_FORMAT_FIXED: dump.ext = "txt"; break;
+      case ODBCSHELL_FORMAT_XML:   dump.ext = "xml"; break;
+      default:                     dump.ext = "csv"; break;
+   };
+   for(l = 0; l < 256; l++)
+   {
+      crc = (uint32_t)l;
+      for(u = 0; u < 8; u++)
+         crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320U : (crc >> 1);
+      dump.crcs[l] = crc;
+   };
+
+   // names are quoted with the character used by the data source
+   qlen = 0;
+   if (!(SQL_SUCCEEDED(SQLGetInfo(cnf->current->hdbc, SQL_IDENTIFIER_QUOTE_CHAR,
+      dump.quote, sizeof(dump.quote), &qlen))))
+      dump.quote[0] = '\0';
+   if (dump.quote[0] == ' ')
+      dump.quote[0] = '\0';
+
+   if ((err = odbcshell_dump_list(cnf, &dump, cnf->current, schema)))
+   {
+      odbcshell_dump_free(&dump);
+      return(err);
+   };
+   if (!(dump.count))
+   {
+      odbcshell_error(cnf, "no tables found\n");
+      odbcshell_dump_free(&dump);
+      return(-1);
+   };
+   odbcshell_dump_estimate(cnf, &dump, cnf->current);
+
+   if (!(dump.order = calloc((size_t)dump.count, sizeof(ODBCShellDumpTable *))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_dump_free(&dump);
+      return(-2);
+   };
+   for(l = 0; l < dump.count; l++)
+      dump.order[l] = &dump.tables[l];
+   qsort(dump.order, (size_t)dump.count, sizeof(ODBCShellDumpTable *), odbcshell_dump_order);
+
+   // names of files are limited to characters safe on any file system
+   code = 0;
+   for(l = 0; l < dump.count; l++)
+   {
+      table       = &dump.tables[l];
+      len         = strlen(dir) + strlen(table->name) + 40;
+      if ((table->schema))
+         len += strlen(table->schema);
+      table->errs = open_memstream(&table->err, &table->errlen);
+      if ( (!(table->errs)) || (!(table->path = malloc(len))) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+      pos = strlen(dir) + 1;
+      if ((table->schema))
+         snprintf(table->path, len, "%s/%s.%s.%s", dir, table->schema, table->name, dump.ext);
+      else
+         snprintf(table->path, len, "%s/%s.%s", dir, table->name, dump.ext);
+      for(; ((table->path[pos])); pos++)
+         if ( (!(isalnum((unsigned char)table->path[pos]))) && (!(strchr("._-", table->path[pos]))) )
+            table->path[pos] = '_';
+
+      // names made equal by the above are told apart by a numeric suffix
+      pos = strlen(table->path) - strlen(dump.ext) - 1;
+      for(u = 0, dup = 1; u < l; u++)
+      {
+         if (!(strcmp(dump.tables[u].path, table->path)))
+         {
+            snprintf(&table->path[pos], len - pos, "-%lld.%s", ++dup, dump.ext);
+            u = -1;
+         };
+      };
+   };
+
+   threads = (dump.count < jobs) ? dump.count : jobs;
+   workers = NULL;
+   tids    = NULL;
+   if ( (!(code)) && ( (!(workers = calloc((size_t)threads, sizeof(ODBCShellDumpWorker)))) ||
+                       (!(tids = calloc((size_t)threads, sizeof(pthread_t)))) ) )
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      code = -2;
+   };
+
+   for(l = 0; ( (!(code)) && (l < threads) ); l++)
+   {
+      worker         = &workers[l];
+      worker->id     = l + 1;
+      worker->dump   = &dump;
+      worker->output = open_memstream(&worker->buff, &worker->bufflen);
+      worker->errs   = open_memstream(&worker->err, &worker->errlen);
+      if ( (!(worker->output)) || (!(worker->errs)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // idle connections to the data source are handed to workers
+      snprintf(name, sizeof(name), "dump-%lld", worker->id);
+      if ((code = odbcshell_pool_take(cnf, dump.dsn, name, &worker->conn)))
+         break;
+
+      // rows and messages of each table are kept apart
+      odbcshell_clone(cnf, &worker->cnf, worker->output, worker->errs);
+      worker->cnf.format   = format;
+      worker->cnf.noheader = 1;
+   };
+
+   // largest tables are started first so that connections finish together
+   if (!(code))
+   {
+      odbcshell_verbose(cnf, "dumping %lld tables using %lld connections...\n",
+         dump.count, threads);
+      pthread_mutex_init(&dump.lock, NULL);
+      odbcshell_signal_block(&oldset);
+      for(started = 0; started < threads; started++)
+         if ((pthread_create(&tids[started], NULL, odbcshell_dump_thread, &workers[started])))
+            break;
+      odbcshell_signal_restore(&oldset);
+      if (!(started))
+         odbcshell_dump_thread(&workers[0]);
+      for(l = 0; l < started; l++)
+         pthread_join(tids[l], NULL);
+      pthread_mutex_destroy(&dump.lock);
+   };
+
+   // reports errors of each worker and releases connections
+   for(l = 0; ( ((workers)) && (l < threads) ); l++)
+   {
+      worker = &workers[l];
+      if ((worker->output))
+         fclose(worker->output);
+      if ((worker->errs))
+         fclose(worker->errs);
+      if ((worker->errlen))
+         fwrite(worker->err, 1, worker->errlen, ((cnf->errs)) ? cnf->errs : stderr);
+      free(worker->buff);
+      free(worker->err);
+      free(worker->value);
+      if ((worker->conn))
+      {
+         if ((worker->code))
+            odbcshell_odbc_free(cnf, &worker->conn);
+         else
+            odbcshell_pool_put(cnf, &worker->conn);
+      };
+   };
+   free(workers);
+   free(tids);
+
+   // reports messages of each table in the order listed by the driver
+   rows   = 0;
+   failed = 0;
+   for(l = 0; ( (!(code)) && (l < dump.count) ); l++)
+   {
+      if (l >= dump.next)
+         dump.order[l]->code = -1;
+   };
+   for(l = 0; l < dump.count; l++)
+   {
+      table = &dump.tables[l];
+      if ((table->errs))
+         fclose(table->errs);
+      table->errs = NULL;
+      if ((table->errlen))
+         fwrite(table->err, 1, table->errlen, ((cnf->errs)) ? cnf->errs : stderr);
+      if ((code))
+         continue;
+      if ((table->code))
+      {
+         odbcshell_error(cnf, "%s: table was not dumped\n", table->name);
+         failed++;
+         continue;
+      };
+      odbcshell_verbose(cnf, "%s: %lld rows in %lld ms\n", table->name, table->rows, table->msecs);
+      rows += table->rows;
+   };
+
+   if ( (!(code)) && (failed < dump.count) )
+      code = odbcshell_dump_manifest(cnf, &dump);
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   if ( (!(code)) && (!(failed)) )
+      odbcshell_printf(cnf, "dumped %lld tables (%lld rows) to \"%s\" in %lld ms.\n",
+         dump.count, rows, dir, msecs);
+   else if (!(code))
+   {
+      odbcshell_error(cnf, "%lld of %lld tables failed\n", failed, dump.count);
+      code = -1;
+   };
+
+   odbcshell_dump_free(&dump);
+
+   return(code);
+}
+
+
+/// @brief writes rows of a table to its file
+/// @param worker   pointer to worker
+/// @param table    table being dumped
+int odbcshell_dump_table(ODBCShellDumpWorker * worker,
+   ODBCShellDumpTable * table)
+{
+   int               err;
+   char            * query;
+   SQLLEN            rows;
+   SQLRETURN         sts;
+   FILE            * fs;
+   ODBCShell       * cnf;
+   ODBCShellStmt   * stmt;
+
+   cnf       = &worker->cnf;
+   cnf->msgs = table->errs;
+   cnf->errs = table->errs;
+
+   if (!(query = odbcshell_dump_query(worker->dump, table)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   if (!(fs = fopen(table->path, "w")))
+   {
+      odbcshell_error(cnf, "%s: %s\n", table->path, strerror(errno));
+      free(query);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, worker->conn, &stmt)))
+   {
+      fclose(fs);
+      free(query);
+      return(err);
+   };
+
+   odbcshell_odbc_stmt_timeout(cnf, worker->conn, stmt);
+
+   odbcshell_verbose(cnf, "dumping \"%s\" to \"%s\"...\n", table->name, table->path);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)query, SQL_NTS);
+   free(query);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      fclose(fs);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_describe(cnf, stmt)))
+   {
+      SQLCloseCursor(stmt->hstmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      fclose(fs);
+      return(err);
+   };
+
+   if (cnf->format == ODBCSHELL_FORMAT_XML)
+   {
+      odbcshell_fprintf(cnf, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n");
+      odbcshell_fprintf(cnf, "<result>\n");
+   };
+   if (!(worker->dump->noheader))
+      odbcshell_odbc_result_header(cnf, stmt);
+
+   // rows pass through the buffer in blocks which are added to the checksum
+   // as they are written, columns which may not fit the bound buffers are
+   // read in pieces
+   err = odbcshell_odbc_bind_exact(cnf, stmt);
+   while(!(err))
+   {
+      rows = 0;
+      err  = odbcshell_dump_rows(worker, stmt, ODBCSHELL_DUMP_ROWS, &rows);
+      table->rows += (long long)rows;
+      odbcshell_dump_flush(worker, table, fs);
+      if (rows < ODBCSHELL_DUMP_ROWS)
+         break;
+   };
+   odbcshell_odbc_unbind(stmt);
+   SQLCloseCursor(stmt->hstmt);
+   odbcshell_odbc_stmt_release(cnf, &stmt);
+
+   if ( (!(err)) && (cnf->format == ODBCSHELL_FORMAT_XML) )
+      odbcshell_fprintf(cnf, "</result>\n");
+   odbcshell_dump_flush(worker, table, fs);
+
+   if ( ((fclose(fs))) && (!(err)) )
+   {
+      odbcshell_error(cnf, "%s: %s\n", table->path, strerror(errno));
+      err = -1;
+   };
+
+   return(err);
+}
+
+
+/// @brief worker thread dumping tables until none remain
+/// @param ptr      pointer to worker
+void * odbcshell_dump_thread(void * ptr)
+{
+   long long             l;
+   struct timespec       start;
+   struct timespec       end;
+   ODBCShellDumpWorker * worker;
+   ODBCShellDumpTable  * table;
+   ODBCShellDump       * dump;
+   char                  name[64];
+
+   worker = ptr;
+   dump   = worker->dump;
+
+   if (!(worker->conn))
+   {
+      snprintf(name, sizeof(name), "dump-%lld", worker->id);
+      if ((worker->code = odbcshell_odbc_open(&worker->cnf, dump->dsn, name, &worker->conn)))
+      {
+         fflush(worker->errs);
+         return(NULL);
+      };
+   };
+
+   while(1)
+   {
+      pthread_mutex_lock(&dump->lock);
+      l = dump->next++;
+      pthread_mutex_unlock(&dump->lock);
+
+      if (l >= dump->count)
+         break;
+
+      table = dump->order[l];
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      table->code  = odbcshell_dump_table(worker, table);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      table->msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+                   + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+      fflush(table->errs);
+
+      // rows left in the buffer by a failed table are discarded
+      rewind(worker->output);
+      fflush(worker->output);
+   };
+
+   fflush(worker->errs);
+
+   return(NULL);
+}
+
+/* end of source */
@@ -0,0 +1,109 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-dump.h ODBC Shell writes each table to its own file
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_DUMP_H
+#define _ODBCSHELL_SRC_ODBCSHELL_DUMP_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// adds bytes to a CRC-32
+uint32_t odbcshell_dump_crc(ODBCShellDump * dump, uint32_t crc,
+   const char * buff, size_t len);
+
+// writes a value with the characters special to the format escaped
+void odbcshell_dump_escape(ODBCShell * cnf, const char * value);
+
+// reads the number of rows of each table from driver statistics
+int odbcshell_dump_estimate(ODBCShell * cnf, ODBCShellDump * dump,
+   ODBCShellConn * conn);
+
+// writes rows buffered by a worker to the file of a table
+void odbcshell_dump_flush(ODBCShellDumpWorker * worker,
+   ODBCShellDumpTable * table, FILE * fs);
+
+// frees resources used by dump
+void odbcshell_dump_free(ODBCShellDump * dump);
+
+// lists tables of a schema
+int odbcshell_dump_list(ODBCShell * cnf, ODBCShellDump * dump,
+   ODBCShellConn * conn, const char * schema);
+
+// writes the row counts and checksums of each file
+int odbcshell_dump_manifest(ODBCShell * cnf, ODBCShellDump * dump);
+
+// orders tables largest first
+int odbcshell_dump_order(const void * ptr1, const void * ptr2);
+
+// builds statement selecting every row of a table
+char * odbcshell_dump_query(ODBCShellDump * dump, ODBCShellDumpTable * table);
+
+// writes rows of the pending result set without truncating values
+int odbcshell_dump_rows(ODBCShellDumpWorker * worker, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * rowsp);
+
+// writes every table of a schema to its own file over several connections
+int odbcshell_dump_run(ODBCShell * cnf, const char * schema,
+   const char * dir, long long format, long long jobs);
+
+// writes rows of a table to its file
+int odbcshell_dump_table(ODBCShellDumpWorker * worker,
+   ODBCShellDumpTable * table);
+
+// worker thread dumping tables until none remain
+void * odbcshell_dump_thread(void * ptr);
+
+#endif
+/* end of header */
@@ -54,9 +54,14 @@
 #include <readline/history.h>
 
 #include "odbcshell-commands.h"
+#include "odbcshell-connect.h"
+#include "odbcshell-fanout.h"
+#include "odbcshell-group.h"
 #include "odbcshell-odbc.h"
 #include "odbcshell-parse.h"
 #include "odbcshell-print.h"
+#include "odbcshell-retry.h"
+#include "odbcshell-signal.h"
 #include "odbcshell-variables.h"
 
 
@@ -73,17 +78,25 @@
 /// @brief append exec string to list
 /// @param cnf      pointer to configuration struct
 /// @param str      string to execute
-int odbcshell_exec_append_str(ODBCShell * cnf, char * str)
+/// @param indep    toggle marking statement as independent of the others
+int odbcshell_exec_append_str(ODBCShell * cnf, char * str, int indep)
 {
    void * ptr;
 
-   if (!(ptr = realloc(cnf->exec_strs, sizeof(char *) * cnf->exec_count)))
+   if (!(ptr = realloc(cnf->exec_strs, sizeof(char *) * (cnf->exec_count+1))))
    {
       fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
       return(1);
    };
    cnf->exec_strs = ptr;
-   cnf->exec_strs[cnf->exec_count] = str;
+   if (!(ptr = realloc(cnf->exec_indeps, sizeof(long long) * (cnf->exec_count+1))))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(1);
+   };
+   cnf->exec_indeps = ptr;
+   cnf->exec_strs[cnf->exec_count]   = str;
+   cnf->exec_indeps[cnf->exec_count] = indep;
    cnf->exec_count++;
    return(0);
 }
@@ -93,19 +106,303 @@ int odbcshell_exec_append_str(ODBCShell * cnf, char * str)
 /// @param cnf      pointer to configuration struct
 int odbcshell_exec_loop(ODBCShell * cnf)
 {
-   long long l;
+   if ((cnf->inventory))
+      return(odbcshell_fanout_inventory(cnf));
    if (!(cnf->dflt_dsn))
    {
       fprintf(stderr, "%s: missing required argument\n", PROGRAM_NAME);
       fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
       return(-1);
    };
-   if (odbcshell_odbc_connect(cnf, cnf->dflt_dsn, NULL))
+   if (odbcshell_connect_dflt(cnf))
       return(-1);
+
+   return(odbcshell_exec_run(cnf));
+}
+
+
+/// @brief executes statements on the current connection
+/// @param cnf      pointer to configuration struct
+int odbcshell_exec_run(ODBCShell * cnf)
+{
+   int       code;
+   long long l;
+   size_t    len;
+
+   // statements are pipelined unless one is sent to the background
+   for(l = 0; ((l < cnf->exec_count) && (cnf->exec_count > 1)); l++)
+   {
+      for(len = strlen(cnf->exec_strs[l]); ((len > 0) && (strchr(" \t\r\n", cnf->exec_strs[l][len-1]))); len--);
+      if ( (len > 0) && (cnf->exec_strs[l][len-1] == '&') )
+         break;
+   };
+   if ( (cnf->exec_count > 1) && (l == cnf->exec_count) )
+      return(odbcshell_exec_pipeline(cnf));
+
+   for(l = 0; l < cnf->exec_count; l++)
+   {
+      code = odbcshell_cmd_exec(cnf, cnf->exec_strs[l], 0);
+      odbcshell_signal_stmt(NULL);
+      if ((code))
+         return(-1);
+   };
+   return(0);
+}
+
+
+/// @brief executes statements while results of the previous statement are displayed
+/// @param cnf      pointer to configuration struct
+int odbcshell_exec_pipeline(ODBCShell * cnf)
+{
+   int             code;
+   int             started;
+   long long       l;
+   ODBCShellConn * indep;
+   ODBCShellPipe   pipes[2];
+   ODBCShellPipe * cur;
+   ODBCShellPipe * next;
+
+   code  = 0;
+   indep = NULL;
+   memset(pipes, 0, sizeof(pipes));
+
+   if ((code = odbcshell_exec_start(cnf, &pipes[0], 0, &indep)))
+      return(code);
+
    for(l = 0; l < cnf->exec_count; l++)
-      if (odbcshell_cmd_exec(cnf, cnf->exec_strs[l], 0))
+   {
+      cur  = &pipes[l % 2];
+      next = &pipes[(l+1) % 2];
+
+      // waits for statement to finish executing
+      odbcshell_signal_stmt(cur->stmt->hstmt);
+      pthread_join(cur->thread, NULL);
+      cur->joinable = 0;
+
+      // only a lost session is worth another attempt
+      if ( (!(SQL_SUCCEEDED(cur->sts))) && (cnf->autoreconnect > 0) &&
+           ((odbcshell_retry_lost(cur->stmt->conn, cur->stmt->hstmt))) )
+      {
+         if ((code = odbcshell_exec_retry(cnf, cur, l, &indep)))
+            break;
+      };
+
+      if (cur->sts != SQL_SUCCESS)
+      {
+         odbcshell_odbc_stmt_errors("SQLExecute", cnf, cur->stmt);
+         if (cur->sts != SQL_SUCCESS_WITH_INFO)
+         {
+            code = -1;
+            break;
+         };
+      };
+
+      // starts next statement early when its connection allows it
+      started = 0;
+      if ( ((l+1) < cnf->exec_count) && ((odbcshell_exec_overlaps(cnf, l+1, cur, indep))) )
+      {
+         if ((code = odbcshell_exec_start(cnf, next, l+1, &indep)))
+            break;
+         started = 1;
+      };
+
+      // displays results while next statement executes
+      if (cur->sts == SQL_SUCCESS)
+         code = odbcshell_odbc_result(cnf, cur->stmt);
+      odbcshell_signal_stmt(NULL);
+      odbcshell_odbc_stmt_release(cnf, &cur->stmt);
+      if ((code))
+         break;
+
+      if ( ((l+1) < cnf->exec_count) && (!(started)) )
+         if ((code = odbcshell_exec_start(cnf, next, l+1, &indep)))
+            break;
+   };
+
+   // stops any statement still running after an error
+   for(l = 0; l < 2; l++)
+   {
+      if ((pipes[l].joinable))
+      {
+         SQLCancel(pipes[l].stmt->hstmt);
+         pthread_join(pipes[l].thread, NULL);
+      };
+      odbcshell_odbc_stmt_release(cnf, &pipes[l].stmt);
+   };
+   odbcshell_signal_stmt(NULL);
+
+   if ((indep))
+      odbcshell_odbc_free(cnf, &indep);
+
+   return(code ? -1 : 0);
+}
+
+
+/// @brief determines if a statement may execute while results are displayed
+/// @param cnf      pointer to configuration struct
+/// @param index    index of statement to execute
+/// @param cur      statement whose results are being displayed
+/// @param indep    connection used for independent statements
+int odbcshell_exec_overlaps(ODBCShell * cnf, long long index,
+   ODBCShellPipe * cur, ODBCShellConn * indep)
+{
+   SQLUSMALLINT    max;
+   ODBCShellConn * conn;
+
+   // independent statements use their own connection
+   if ((cnf->exec_indeps[index]))
+   {
+      if (!(indep))
+         return(1);
+      conn = indep;
+   } else {
+      conn = cnf->current;
+   };
+   if (conn != cur->stmt->conn)
+      return(1);
+
+   // the next statement may replace a cached statement whose results are displayed
+   if ((cur->stmt->sql))
+      return(0);
+
+   // checks once if the driver allows a second active statement
+   if (conn->max_activities == -1)
+   {
+      max = 0;
+      if (!(SQL_SUCCEEDED(SQLGetInfo(conn->hdbc, SQL_MAX_CONCURRENT_ACTIVITIES,
+         &max, sizeof(max), NULL))))
+         max = 1;
+      conn->max_activities = max;
+      if (max == 1)
+         odbcshell_verbose(cnf, "\"%s\" allows one active statement, pipelining disabled\n",
+            conn->name);
+   };
+
+   return(conn->max_activities != 1);
+}
+
+
+/// @brief re-establishes the session lost by a pipelined statement and runs it again
+/// @param cnf      pointer to configuration struct
+/// @param pipe     pipeline slot whose statement failed
+/// @param index    index of statement which failed
+/// @param indepp   pointer to connection used for independent statements
+int odbcshell_exec_retry(ODBCShell * cnf, ODBCShellPipe * pipe,
+   long long index, ODBCShellConn ** indepp)
+{
+   int             err;
+   ODBCShellConn * conn;
+
+   conn = pipe->stmt->conn;
+   odbcshell_odbc_stmt_errors("SQLExecute", cnf, pipe->stmt);
+   odbcshell_signal_stmt(NULL);
+   odbcshell_odbc_stmt_release(cnf, &pipe->stmt);
+
+   // statements prepared on the lost session are prepared again
+   if ((odbcshell_retry_reconnect(cnf, conn)))
+      return(-1);
+
+   // statements which may have changed data are never sent twice
+   if ( (!(cnf->retryreads)) || (!(odbcshell_retry_idempotent(pipe->sql))) )
+   {
+      odbcshell_error(cnf, "connection re-established, statement was not retried\n");
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "retrying statement...\n");
+
+   if ((err = odbcshell_exec_start(cnf, pipe, index, indepp)))
+      return(err);
+   odbcshell_signal_stmt(pipe->stmt->hstmt);
+   pthread_join(pipe->thread, NULL);
+   pipe->joinable = 0;
+
+   return(0);
+}
+
+
+/// @brief starts executing a statement in a worker thread
+/// @param cnf      pointer to configuration struct
+/// @param pipe     pipeline slot used for statement
+/// @param index    index of statement to execute
+/// @param indepp   pointer to connection used for independent statements
+int odbcshell_exec_start(ODBCShell * cnf, ODBCShellPipe * pipe,
+   long long index, ODBCShellConn ** indepp)
+{
+   int             err;
+   char          * sql;
+   sigset_t        oldset;
+   SQLRETURN       sts;
+   ODBCShellConn * conn;
+
+   sql = cnf->exec_strs[index];
+
+   // statements sent to a group are routed to one of its members
+   if ( ((cnf->group)) && (!(cnf->exec_indeps[index])) )
+      if ((odbcshell_group_route(cnf, sql)))
          return(-1);
+
+   conn = cnf->current;
+   if ((cnf->exec_indeps[index]))
+   {
+      if (!(*indepp))
+         if ((err = odbcshell_odbc_open(cnf, cnf->dflt_dsn, "independent", indepp)))
+            return(err);
+      conn = (*indepp);
+   };
+   if ((conn->deferred))
+      if ((err = odbcshell_odbc_dial(cnf, conn)))
+         return(err);
+
+   // replaces a session the driver already knows to be dead
+   if ( (cnf->autoreconnect > 0) && ((odbcshell_retry_lost(conn, NULL))) )
+      if ((odbcshell_retry_reconnect(cnf, conn)))
+         return(-1);
+
+   // reuses a statement prepared earlier on this connection
+   if (conn->tune.stmtcache > 0)
+      err = odbcshell_odbc_stmt_cache(cnf, conn, sql, &pipe->stmt);
+   else
+      err = odbcshell_odbc_stmt_alloc(cnf, conn, &pipe->stmt);
+   if ((err))
+      return(err);
+   pipe->sql = sql;
+   pipe->sts = SQL_ERROR;
+
+   if ((sts = odbcshell_odbc_prepare(cnf, conn, pipe->stmt, sql)) != SQL_SUCCESS)
+   {
+      odbcshell_odbc_stmt_errors("SQLPrepare", cnf, pipe->stmt);
+      odbcshell_odbc_stmt_release(cnf, &pipe->stmt);
+      return(-1);
+   };
+
+   odbcshell_verbose(cnf, "executing statement %lli on \"%s\"...\n", index+1,
+      conn->name);
+   odbcshell_signal_block(&oldset);
+   err = pthread_create(&pipe->thread, NULL, odbcshell_exec_thread, pipe);
+   odbcshell_signal_restore(&oldset);
+   if ((err))
+   {
+      odbcshell_error(cnf, "unable to start statement: %s\n", strerror(err));
+      odbcshell_odbc_stmt_release(cnf, &pipe->stmt);
+      return(-1);
+   };
+   pipe->joinable = 1;
+
    return(0);
 }
 
+
+/// @brief worker thread executing a pipelined statement
+/// @param ptr      pointer to pipeline slot
+void * odbcshell_exec_thread(void * ptr)
+{
+   ODBCShellPipe * pipe;
+
+   pipe = ptr;
+
+   pipe->sts = SQLExecute(pipe->stmt->hstmt);
+
+   return(NULL);
+}
+
 /* end of source */
@@ -60,10 +60,31 @@
 #endif
 
 // append exec string to list
-int odbcshell_exec_append_str(ODBCShell * cnf, char * str);
+int odbcshell_exec_append_str(ODBCShell * cnf, char * str, int indep);
 
 // master loop for interactive shell
 int odbcshell_exec_loop(ODBCShell * cnf);
 
+// determines if a statement may execute while results are displayed
+int odbcshell_exec_overlaps(ODBCShell * cnf, long long index,
+   ODBCShellPipe * cur, ODBCShellConn * indep);
+
+// executes statements while results of the previous statement are displayed
+int odbcshell_exec_pipeline(ODBCShell * cnf);
+
+// re-establishes the session lost by a pipelined statement and runs it again
+int odbcshell_exec_retry(ODBCShell * cnf, ODBCShellPipe * pipe,
+   long long index, ODBCShellConn ** indepp);
+
+// executes statements on the current connection
+int odbcshell_exec_run(ODBCShell * cnf);
+
+// starts executing a statement in a worker thread
+int odbcshell_exec_start(ODBCShell * cnf, ODBCShellPipe * pipe,
+   long long index, ODBCShellConn ** indepp);
+
+// worker thread executing a pipelined statement
+void * odbcshell_exec_thread(void * ptr);
+
 #endif
 /* end of header */
@@ -0,0 +1,718 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-export.c ODBC Shell exports a query in ranges of keys
+ */
+#include "odbcshell-export.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief divides keys of the query into ranges
+/// @param cnf      pointer to configuration struct
+/// @param export   pointer to export state
+/// @param conn     connection used to sample keys
+/// @param parallel number of ranges requested
+int odbcshell_export_bounds(ODBCShell * cnf, ODBCShellExport * export,
+   ODBCShellConn * conn, long long parallel)
+{
+   int                  err;
+   int                  integer;
+   char               * query;
+   char              ** cuts;
+   size_t               len;
+   long long            l;
+   long long            count;
+   long long            min;
+   long long            max;
+   unsigned long long   span;
+   unsigned long long   step;
+   unsigned long long   rem;
+   SQLLEN               ind_min;
+   SQLLEN               ind_max;
+   SQLLEN               ind;
+   SQLSMALLINT          type;
+   SQLRETURN            sts;
+   ODBCShellStmt      * stmt;
+   char                 buff[ODBCSHELL_FETCH_WIDTH];
+   char                 prev[ODBCSHELL_FETCH_WIDTH];
+
+   stmt = conn->stmt;
+
+   // lowest and highest keys decide whether keys are divided arithmetically
+   len = strlen(export->column) * 2 + strlen(export->sql) + 64;
+   if (!(query = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   snprintf(query, len, "SELECT MIN(%s), MAX(%s) FROM (%s) odbcshell_export",
+      export->column, export->column, export->sql);
+   odbcshell_verbose(cnf, "finding range of \"%s\"...\n", export->column);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)query, SQL_NTS);
+   free(query);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_describe(cnf, stmt)))
+   {
+      SQLCloseCursor(stmt->hstmt);
+      return(err);
+   };
+   type    = stmt->cols[0].type;
+   integer = ( (type == SQL_TINYINT) || (type == SQL_SMALLINT) ||
+               (type == SQL_INTEGER) || (type == SQL_BIGINT) );
+
+   min     = 0;
+   max     = 0;
+   ind_min = SQL_NULL_DATA;
+   ind_max = SQL_NULL_DATA;
+   if ((SQL_SUCCEEDED(sts = SQLFetch(stmt->hstmt))))
+   {
+      if ((integer))
+      {
+         sts = SQLGetData(stmt->hstmt, 1, SQL_C_SBIGINT, &min, sizeof(min), &ind_min);
+         if ((SQL_SUCCEEDED(sts)))
+            sts = SQLGetData(stmt->hstmt, 2, SQL_C_SBIGINT, &max, sizeof(max), &ind_max);
+      }
+      else
+      {
+         sts = SQLGetData(stmt->hstmt, 1, SQL_C_CHAR, buff, sizeof(buff), &ind_min);
+         if ((SQL_SUCCEEDED(sts)))
+            sts = SQLGetData(stmt->hstmt, 2, SQL_C_CHAR, buff, sizeof(buff), &ind_max);
+      };
+   };
+   if ( (!(SQL_SUCCEEDED(sts))) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLGetData", cnf, stmt);
+      SQLCloseCursor(stmt->hstmt);
+      return(-1);
+   };
+   SQLCloseCursor(stmt->hstmt);
+
+   // query without keys is exported as a single range
+   if ( (ind_min == SQL_NULL_DATA) || (ind_max == SQL_NULL_DATA) || (parallel < 2) )
+      return(odbcshell_export_ranges(cnf, export, NULL, 0, NULL, NULL));
+
+   if (!(cuts = calloc((size_t)parallel, sizeof(char *))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+
+   // integer keys are divided into ranges of equal width
+   if ((integer))
+   {
+      span  = (unsigned long long)max - (unsigned long long)min + 1ULL;
+      count = parallel;
+      if ( ((span)) && (span < (unsigned long long)count) )
+         count = (long long)span;
+      step  = ((span)) ? span / (unsigned long long)count : ULLONG_MAX / (unsigned long long)count;
+      rem   = ((span)) ? span % (unsigned long long)count : 0;
+      for(l = 1; l < count; l++)
+      {
+         snprintf(buff, sizeof(buff), "%lld", (long long)((unsigned long long)min
+            + (unsigned long long)l * step + (((unsigned long long)l < rem) ? (unsigned long long)l : rem)));
+         if (!(cuts[l-1] = strdup(buff)))
+         {
+            odbcshell_fatal(cnf, "out of virtual memory\n");
+            err = -2;
+            break;
+         };
+      };
+      if (!(err))
+         err = odbcshell_export_ranges(cnf, export, cuts, count-1, ">=", "<");
+      for(l = 0; l < parallel; l++)
+         free(cuts[l]);
+      free(cuts);
+      return(err);
+   };
+
+   // other keys are divided at the highest key of each tile of sorted keys
+   len = strlen(export->column) * 5 + strlen(export->sql) + 256;
+   if (!(query = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      free(cuts);
+      return(-2);
+   };
+   snprintf(query, len, "SELECT MAX(%s) FROM (SELECT %s, NTILE(%lld) OVER (ORDER BY %s)"
+      " AS odbcshell_tile FROM (%s) odbcshell_export WHERE %s IS NOT NULL) odbcshell_tiles"
+      " GROUP BY odbcshell_tile ORDER BY 1", export->column, export->column, parallel,
+      export->column, export->sql, export->column);
+   odbcshell_verbose(cnf, "sampling %lld tiles of \"%s\"...\n", parallel, export->column);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)query, SQL_NTS);
+   free(query);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      free(cuts);
+      return(-1);
+   };
+
+   // keys shared by neighboring tiles produce a single cut point
+   count   = 0;
+   prev[0] = '\0';
+   while ( (count < parallel) && ((SQL_SUCCEEDED(sts = SQLFetch(stmt->hstmt)))) )
+   {
+      sts = SQLGetData(stmt->hstmt, 1, SQL_C_CHAR, buff, sizeof(buff), &ind);
+      if (!(SQL_SUCCEEDED(sts)))
+         break;
+      if ( (ind == SQL_NULL_DATA) || ( ((count)) && (!(strcmp(buff, prev))) ) )
+         continue;
+      if (!(cuts[count] = odbcshell_export_literal(type, buff)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+         break;
+      };
+      snprintf(prev, sizeof(prev), "%s", buff);
+      count++;
+   };
+   if ( (!(err)) && (!(SQL_SUCCEEDED(sts))) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLFetch", cnf, stmt);
+      err = -1;
+   };
+   SQLCloseCursor(stmt->hstmt);
+
+   // highest key of the last tile is not needed since the last range is open
+   if (!(err))
+      err = odbcshell_export_ranges(cnf, export, cuts, ((count)) ? count-1 : 0, ">", "<=");
+   for(l = 0; l < parallel; l++)
+      free(cuts[l]);
+   free(cuts);
+
+   return(err);
+}
+
+
+/// @brief writes rows buffered by a range to the merged output
+/// @param part     pointer to range of keys
+void odbcshell_export_flush(ODBCShellExportPart * part)
+{
+   fflush(part->output);
+   if (!(part->bufflen))
+      return;
+
+   pthread_mutex_lock(&part->export->lock);
+   fwrite(part->buff, 1, part->bufflen, part->export->output);
+   pthread_mutex_unlock(&part->export->lock);
+
+   // buffer is reused for the next block of rows
+   rewind(part->output);
+
+   return;
+}
+
+
+/// @brief frees resources used by export
+/// @param export   pointer to export state
+void odbcshell_export_free(ODBCShellExport * export)
+{
+   long long             l;
+   ODBCShellExportPart * part;
+
+   for(l = 0; l < export->count; l++)
+   {
+      part = &export->parts[l];
+      free(part->where);
+      free(part->path);
+      free(part->buff);
+      free(part->err);
+   };
+   free(export->parts);
+   export->parts = NULL;
+   export->count = 0;
+
+   return;
+}
+
+
+/// @brief formats value of key as a SQL literal
+/// @param type     SQL data type of key
+/// @param value    value of key
+char * odbcshell_export_literal(SQLSMALLINT type, const char * value)
+{
+   char   * str;
+   size_t   pos;
+
+   switch(type)
+   {
+      case SQL_TINYINT:
+      case SQL_SMALLINT:
+      case SQL_INTEGER:
+      case SQL_BIGINT:
+      case SQL_DECIMAL:
+      case SQL_NUMERIC:
+      case SQL_REAL:
+      case SQL_FLOAT:
+      case SQL_DOUBLE:
+         return(strdup(value));
+
+      default:
+         break;
+   };
+
+   // single quotes within value are doubled
+   if (!(str = malloc(strlen(value) * 2 + 3)))
+      return(NULL);
+   pos = 0;
+   str[pos++] = '\'';
+   for(; ((*value)); value++)
+   {
+      if (*value == '\'')
+         str[pos++] = '\'';
+      str[pos++] = *value;
+   };
+   str[pos++] = '\'';
+   str[pos]   = '\0';
+
+   return(str);
+}
+
+
+/// @brief exports rows of a single range
+/// @param part     pointer to range of keys
+int odbcshell_export_part(ODBCShellExportPart * part)
+{
+   int               err;
+   char            * query;
+   size_t            len;
+   SQLLEN            rows;
+   SQLLEN            max;
+   SQLRETURN         sts;
+   ODBCShell       * cnf;
+   ODBCShellStmt   * stmt;
+   ODBCShellExport * export;
+   char              name[64];
+
+   cnf    = &part->cnf;
+   export = part->export;
+
+   // files of ranges are opened by their workers
+   if ((part->path))
+   {
+      if (!(part->output = fopen(part->path, "w")))
+      {
+         odbcshell_error(cnf, "%s: %s\n", part->path, strerror(errno));
+         return(-1);
+      };
+      cnf->output = part->output;
+   };
+
+   if (!(part->conn))
+   {
+      snprintf(name, sizeof(name), "export-%lld", part->id);
+      if ((err = odbcshell_odbc_open(cnf, export->dsn, name, &part->conn)))
+         return(err);
+   };
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, part->conn, &stmt)))
+      return(err);
+
+   odbcshell_odbc_stmt_timeout(cnf, part->conn, stmt);
+
+   query = export->sql;
+   if ((part->where))
+   {
+      len = strlen(export->sql) + strlen(part->where) + 64;
+      if (!(query = malloc(len)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         odbcshell_odbc_stmt_release(cnf, &stmt);
+         return(-2);
+      };
+      snprintf(query, len, "SELECT * FROM (%s) odbcshell_export WHERE %s",
+         export->sql, part->where);
+   };
+   odbcshell_verbose(cnf, "exporting range %lld...\n", part->id);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)query, SQL_NTS);
+   if ((part->where))
+      free(query);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_describe(cnf, stmt)))
+   {
+      SQLCloseCursor(stmt->hstmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(err);
+   };
+   if (!(stmt->col_count))
+   {
+      odbcshell_error(cnf, "statement did not return rows\n");
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+
+   // names of columns are written atop each file or once to merged output
+   if ((part->path))
+   {
+      if (cnf->format == ODBCSHELL_FORMAT_XML)
+      {
+         odbcshell_fprintf(cnf, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n");
+         odbcshell_fprintf(cnf, "<result>\n");
+      };
+      if (!(export->noheader))
+         odbcshell_odbc_result_header(cnf, stmt);
+   }
+   else
+   {
+      pthread_mutex_lock(&export->lock);
+      if (!(export->header))
+      {
+         cnf->output = export->output;
+         odbcshell_odbc_result_header(cnf, stmt);
+         cnf->output = part->output;
+         export->header = 1;
+      };
+      pthread_mutex_unlock(&export->lock);
+   };
+
+   // merged output receives whole blocks of rows from each range
+   max = ((part->path)) ? 0 : ODBCSHELL_EXPORT_ROWS;
+   err = odbcshell_odbc_bind(cnf, stmt);
+   while(!(err))
+   {
+      rows = 0;
+      err  = odbcshell_odbc_rows(cnf, stmt, max, &rows);
+      part->rows += (long long)rows;
+      if (!(part->path))
+         odbcshell_export_flush(part);
+      if ( (!(max)) || (rows < max) )
+         break;
+   };
+   odbcshell_odbc_unbind(stmt);
+   SQLCloseCursor(stmt->hstmt);
+   odbcshell_odbc_stmt_release(cnf, &stmt);
+
+   if ( (!(err)) && ((part->path)) && (cnf->format == ODBCSHELL_FORMAT_XML) )
+      odbcshell_fprintf(cnf, "</result>\n");
+
+   return(err);
+}
+
+
+/// @brief assigns conditions to ranges separated by cut points
+/// @param cnf      pointer to configuration struct
+/// @param export   pointer to export state
+/// @param cuts     SQL literals separating ranges
+/// @param count    number of cut points
+/// @param lower    operator comparing keys with the cut point below range
+/// @param upper    operator comparing keys with the cut point above range
+int odbcshell_export_ranges(ODBCShell * cnf, ODBCShellExport * export,
+   char ** cuts, long long count, const char * lower, const char * upper)
+{
+   long long             l;
+   size_t                len;
+   ODBCShellExportPart * part;
+
+   if (!(export->parts = calloc((size_t)(count+1), sizeof(ODBCShellExportPart))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   export->count = count + 1;
+
+   for(l = 0; l <= count; l++)
+   {
+      part         = &export->parts[l];
+      part->id     = l + 1;
+      part->export = export;
+
+      // a single range exports the query unchanged
+      if (!(count))
+         continue;
+
+      len = strlen(export->column) * 2 + 32;
+      if (l > 0)
+         len += strlen(cuts[l-1]);
+      if (l < count)
+         len += strlen(cuts[l]);
+      if (!(part->where = malloc(len)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+
+      // keys which are NULL belong to the first range
+      if (l == 0)
+         snprintf(part->where, len, "(%s %s %s OR %s IS NULL)", export->column,
+            upper, cuts[l], export->column);
+      else if (l == count)
+         snprintf(part->where, len, "%s %s %s", export->column, lower, cuts[l-1]);
+      else
+         snprintf(part->where, len, "%s %s %s AND %s %s %s", export->column,
+            lower, cuts[l-1], export->column, upper, cuts[l]);
+   };
+
+   return(0);
+}
+
+
+/// @brief exports rows of a query over several connections
+/// @param cnf      pointer to configuration struct
+/// @param parallel number of ranges exported at once
+/// @param column   column partitioning rows
+/// @param sql      SQL statement to export
+/// @param path     prefix of files receiving each range (NULL for merged output)
+int odbcshell_export_run(ODBCShell * cnf, long long parallel,
+   const char * column, char * sql, const char * path)
+{
+   int                   err;
+   int                   code;
+   long long             l;
+   long long             started;
+   long long             rows;
+   long long             failed;
+   long long             msecs;
+   size_t                len;
+   sigset_t              oldset;
+   pthread_t           * tids;
+   struct timespec       start;
+   struct timespec       end;
+   ODBCShellExport       export;
+   ODBCShellExportPart * part;
+   char                  name[64];
+
+   if ( (parallel < 1) || (parallel > ODBCSHELL_EXPORT_PARTS) )
+   {
+      odbcshell_error(cnf, "number of ranges must be between 1 and %i\n", ODBCSHELL_EXPORT_PARTS);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_ready(cnf)))
+      return(err);
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   memset(&export, 0, sizeof(ODBCShellExport));
+   export.sql      = sql;
+   export.column   = column;
+   export.dsn      = cnf->current->dsn;
+   export.noheader = (int)cnf->noheader;
+   export.header   = (int)cnf->noheader;
+   export.output   = ((path)) ? NULL : ((cnf->output)) ? cnf->output : stdout;
+
+   if ((err = odbcshell_export_bounds(cnf, &export, cnf->current, parallel)))
+   {
+      odbcshell_export_free(&export);
+      return(err);
+   };
+
+   code = 0;
+   for(l = 0; l < export.count; l++)
+   {
+      part = &export.parts[l];
+      odbcshell_verbose(cnf, "range %lld: %s\n", part->id,
+         ((part->where)) ? part->where : "all rows");
+
+      if ((path))
+      {
+         len = strlen(path) + 32;
+         if ((part->path = malloc(len)))
+            snprintf(part->path, len, "%s.%lld", path, part->id);
+      }
+      else
+      {
+         part->output = open_memstream(&part->buff, &part->bufflen);
+      };
+      part->errs = open_memstream(&part->err, &part->errlen);
+      if ( (!(part->errs)) || ( ((path)) && (!(part->path)) ) ||
+           ( (!(path)) && (!(part->output)) ) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // idle connections to the data source are handed to workers
+      snprintf(name, sizeof(name), "export-%lld", part->id);
+      if ((code = odbcshell_pool_take(cnf, export.dsn, name, &part->conn)))
+         break;
+
+      // rows and messages of each range are kept apart
+      odbcshell_clone(cnf, &part->cnf, part->output, part->errs);
+      part->cnf.noheader = 1;
+   };
+
+   // each range is exported by its own worker and connection
+   if (!(code))
+   {
+      if (!(tids = calloc((size_t)export.count, sizeof(pthread_t))))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+      }
+      else
+      {
+         if ( (!(path)) && (cnf->format == ODBCSHELL_FORMAT_XML) )
+         {
+            odbcshell_fprintf(cnf, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n");
+            odbcshell_fprintf(cnf, "<result>\n");
+         };
+         odbcshell_verbose(cnf, "exporting %lld ranges...\n", export.count);
+         pthread_mutex_init(&export.lock, NULL);
+         odbcshell_signal_block(&oldset);
+         for(started = 0; started < export.count; started++)
+            if ((pthread_create(&tids[started], NULL, odbcshell_export_thread, &export.parts[started])))
+               break;
+         odbcshell_signal_restore(&oldset);
+         for(l = started; l < export.count; l++)
+            odbcshell_export_thread(&export.parts[l]);
+         for(l = 0; l < started; l++)
+            pthread_join(tids[l], NULL);
+         pthread_mutex_destroy(&export.lock);
+         free(tids);
+         if ( (!(path)) && (cnf->format == ODBCSHELL_FORMAT_XML) )
+            odbcshell_fprintf(cnf, "</result>\n");
+      };
+   };
+
+   // reports messages of each range and releases connections
+   rows   = 0;
+   failed = 0;
+   for(l = 0; l < export.count; l++)
+   {
+      part = &export.parts[l];
+      if ((part->output))
+         fclose(part->output);
+      if ((part->errs))
+         fclose(part->errs);
+      part->output = NULL;
+      part->errs   = NULL;
+      if ((part->errlen))
+         fwrite(part->err, 1, part->errlen, cnf->errs ? cnf->errs : stderr);
+      if ((part->conn))
+      {
+         if ((part->code))
+            odbcshell_odbc_free(cnf, &part->conn);
+         else
+            odbcshell_pool_put(cnf, &part->conn);
+      };
+      if ((code))
+         continue;
+      odbcshell_verbose(cnf, "range %lld: %lld rows in %lld ms\n", part->id,
+         part->rows, part->msecs);
+      rows += part->rows;
+      if ((part->code))
+         failed++;
+   };
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   if ( (!(code)) && (!(failed)) )
+      odbcshell_printf(cnf, "exported %lld rows in %lld ranges in %lld ms.\n",
+         rows, export.count, msecs);
+   else if (!(code))
+   {
+      odbcshell_error(cnf, "%lld of %lld ranges failed\n", failed, export.count);
+      code = -1;
+   };
+
+   odbcshell_export_free(&export);
+
+   return(code);
+}
+
+
+/// @brief worker thread exporting a range of keys
+/// @param ptr      pointer to range of keys
+void * odbcshell_export_thread(void * ptr)
+{
+   struct timespec       start;
+   struct timespec       end;
+   ODBCShellExportPart * part;
+
+   part = ptr;
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   part->code  = odbcshell_export_part(part);
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   part->msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+               + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+
+   // files of ranges are closed by their workers
+   if ((part->path))
+   {
+      if ( ((part->output)) && ((fclose(part->output))) && (!(part->code)) )
+      {
+         odbcshell_error(&part->cnf, "%s: %s\n", part->path, strerror(errno));
+         part->code = -1;
+      };
+      part->output = NULL;
+   };
+   fflush(part->errs);
+
+   return(NULL);
+}
+
+/* end of source */
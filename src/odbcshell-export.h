@@ -0,0 +1,90 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-export.h ODBC Shell exports a query in ranges of keys
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_EXPORT_H
+#define _ODBCSHELL_SRC_ODBCSHELL_EXPORT_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// divides keys of the query into ranges
+int odbcshell_export_bounds(ODBCShell * cnf, ODBCShellExport * export,
+   ODBCShellConn * conn, long long parallel);
+
+// writes rows buffered by a range to the merged output
+void odbcshell_export_flush(ODBCShellExportPart * part);
+
+// frees resources used by export
+void odbcshell_export_free(ODBCShellExport * export);
+
+// formats value of key as a SQL literal
+char * odbcshell_export_literal(SQLSMALLINT type, const char * value);
+
+// exports rows of a single range
+int odbcshell_export_part(ODBCShellExportPart * part);
+
+// assigns conditions to ranges separated by cut points
+int odbcshell_export_ranges(ODBCShell * cnf, ODBCShellExport * export,
+   char ** cuts, long long count, const char * lower, const char * upper);
+
+// exports rows of a query over several connections
+int odbcshell_export_run(ODBCShell * cnf, long long parallel,
+   const char * column, char * sql, const char * path);
+
+// worker thread exporting a range of keys
+void * odbcshell_export_thread(void * ptr);
+
+#endif
+/* end of header */
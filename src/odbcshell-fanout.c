@@ -0,0 +1,668 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-fanout.c ODBC Shell statements sent to several data sources
+ */
+#include "odbcshell-fanout.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-connect.h"
+#include "odbcshell-group.h"
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief adds data source to the list of targets
+/// @param cnf      pointer to configuration struct
+/// @param fanout   pointer to list of targets
+/// @param name     name displayed in leading column
+/// @param dsn      connection string opened by worker (NULL if conn is set)
+/// @param conn     established connection (NULL if dsn is set)
+int odbcshell_fanout_add(ODBCShell * cnf, ODBCShellFanout * fanout,
+   const char * name, const char * dsn, ODBCShellConn * conn)
+{
+   void            * ptr;
+   ODBCShellTarget * target;
+
+   ptr = realloc(fanout->targets, sizeof(ODBCShellTarget) * (size_t)(fanout->count+1));
+   if (!(ptr))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   fanout->targets = ptr;
+
+   target = &fanout->targets[fanout->count];
+   memset(target, 0, sizeof(ODBCShellTarget));
+   target->conn = conn;
+   if (!(target->name = strdup(name)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   if ( ((dsn)) && (!(target->dsn = strdup(dsn))) )
+   {
+      free(target->name);
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   fanout->count++;
+
+   return(0);
+}
+
+
+/// @brief executes statement on a single target
+/// @param target   pointer to target struct
+/// @param sql      SQL statement to execute
+int odbcshell_fanout_exec(ODBCShellTarget * target, char * sql)
+{
+   int             err;
+   SQLLEN          rows;
+   SQLRETURN       sts;
+   ODBCShell     * cnf;
+   ODBCShellConn * conn;
+   ODBCShellStmt * stmt;
+
+   cnf = &target->cnf;
+
+   // data sources listed in an inventory are opened by the worker
+   if (!(target->conn))
+      if ((err = odbcshell_odbc_open(cnf, target->dsn, target->name, &target->conn)))
+         return(err);
+   conn = target->conn;
+   if ((conn->deferred))
+      if ((err = odbcshell_odbc_dial(cnf, conn)))
+         return(err);
+
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, conn, &stmt)))
+      return(err);
+
+   odbcshell_odbc_stmt_timeout(cnf, conn, stmt);
+
+   odbcshell_verbose(cnf, "executing SQL statement on \"%s\"...\n", target->name);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)sql, SQL_NTS);
+   if (sts == SQL_NO_DATA_FOUND)
+   {
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(0);
+   };
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+   if (sts == SQL_SUCCESS_WITH_INFO)
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+
+   // rows of every result set are buffered without names of columns, which
+   // are buffered separately so they are displayed once for all targets
+   err = 0;
+   sts = SQL_SUCCESS;
+   while ( (!(err)) && (SQL_SUCCEEDED(sts)) )
+   {
+      if ((err = odbcshell_odbc_describe(cnf, stmt)))
+         break;
+      rows = 0;
+      if (!(stmt->col_count))
+      {
+         SQLRowCount(stmt->hstmt, &rows);
+         target->rows += (long long)rows;
+         sts = SQLMoreResults(stmt->hstmt);
+         continue;
+      };
+      if (!(target->headlen))
+      {
+         cnf->output = target->heads;
+         odbcshell_odbc_result_header(cnf, stmt);
+         fflush(target->heads);
+         cnf->output = target->output;
+      };
+      if (!(err = odbcshell_odbc_bind(cnf, stmt)))
+         err = odbcshell_odbc_rows(cnf, stmt, 0, &rows);
+      odbcshell_odbc_unbind(stmt);
+      target->rows += (long long)rows;
+      if (!(err))
+         sts = SQLMoreResults(stmt->hstmt);
+   };
+   if ( (!(err)) && (sts == SQL_ERROR) )
+   {
+      odbcshell_odbc_stmt_errors("SQLMoreResults", cnf, stmt);
+      err = -1;
+   };
+
+   SQLCloseCursor(stmt->hstmt);
+   odbcshell_odbc_stmt_release(cnf, &stmt);
+
+   return(err);
+}
+
+
+/// @brief frees resources used by list of targets
+/// @param cnf      pointer to configuration struct
+/// @param fanout   pointer to list of targets
+void odbcshell_fanout_free(ODBCShell * cnf, ODBCShellFanout * fanout)
+{
+   long long         l;
+   ODBCShellTarget * target;
+
+   for(l = 0; l < fanout->count; l++)
+   {
+      target = &fanout->targets[l];
+      // only connections opened by workers belong to the target
+      if ( ((target->dsn)) && ((target->conn)) )
+         odbcshell_odbc_free(cnf, &target->conn);
+      free(target->name);
+      free(target->dsn);
+   };
+   free(fanout->targets);
+   fanout->targets = NULL;
+   fanout->count   = 0;
+
+   return;
+}
+
+
+/// @brief executes statements passed with -e on each data source of the inventory
+/// @param cnf      pointer to configuration struct
+int odbcshell_fanout_inventory(ODBCShell * cnf)
+{
+   int               err;
+   int               code;
+   long long         l;
+   ODBCShellFanout   fanout;
+
+   memset(&fanout, 0, sizeof(ODBCShellFanout));
+   if ((err = odbcshell_fanout_load(cnf, &fanout, cnf->inventory)))
+   {
+      odbcshell_fanout_free(cnf, &fanout);
+      return(err);
+   };
+
+   // connections to the data sources are kept between statements
+   code = 0;
+   for(l = 0; l < cnf->exec_count; l++)
+   {
+      if (!(err = odbcshell_fanout_run(cnf, &fanout, cnf->exec_strs[l])))
+         continue;
+      code = -1;
+      if ( (err == -2) || (!(cnf->continues)) )
+         break;
+   };
+
+   odbcshell_fanout_free(cnf, &fanout);
+
+   return(code);
+}
+
+
+/// @brief reads list of data sources from inventory file
+/// @param cnf      pointer to configuration struct
+/// @param fanout   pointer to list of targets
+/// @param path     file listing one "name connection_string" or
+///                 "connection_string" per line
+int odbcshell_fanout_load(ODBCShell * cnf, ODBCShellFanout * fanout,
+   const char * path)
+{
+   int          err;
+   FILE       * fs;
+   char       * line;
+   char       * dsn;
+   char       * end;
+   const char * name;
+   size_t       size;
+   size_t       len;
+   long long    num;
+   char         buff[128];
+
+   if (!(fs = fopen(path, "r")))
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      return(-1);
+   };
+
+   err  = 0;
+   num  = 0;
+   line = NULL;
+   size = 0;
+   while ( (!(err)) && (getline(&line, &size, fs) != -1) )
+   {
+      for(len = strlen(line); ((len > 0) && (strchr(" \t\r\n", line[len-1]))); len--)
+         line[len-1] = '\0';
+      for(dsn = line; ((*dsn == ' ') || (*dsn == '\t')); dsn++);
+      if ( (!(dsn[0])) || (dsn[0] == '#') )
+         continue;
+      num++;
+
+      // a leading word without an attribute names the data source
+      name = NULL;
+      for(end = dsn; ((*end) && (!(strchr(" \t=", *end)))); end++);
+      if ( (*end == ' ') || (*end == '\t') )
+      {
+         name = dsn;
+         for(*end++ = '\0'; ((*end == ' ') || (*end == '\t')); end++);
+         dsn = end;
+      };
+      if (!(dsn[0]))
+      {
+         odbcshell_error(cnf, "%s: missing connection string for \"%s\"\n", path, name);
+         err = -1;
+         continue;
+      };
+      if (!(name))
+         name = odbcshell_connect_name(dsn, num, buff, sizeof(buff));
+      err = odbcshell_fanout_add(cnf, fanout, name, dsn, NULL);
+   };
+   free(line);
+   fclose(fs);
+
+   if ( (!(err)) && (!(fanout->count)) )
+   {
+      odbcshell_error(cnf, "%s: no data sources listed\n", path);
+      err = -1;
+   };
+
+   return(err);
+}
+
+
+/// @brief executes statement on the named connections at once
+/// @param cnf      pointer to configuration struct
+/// @param names    "all" or comma separated list of connection names
+/// @param sql      SQL statement to execute
+int odbcshell_fanout_on(ODBCShell * cnf, const char * names, char * sql)
+{
+   int               err;
+   ODBCShellFanout   fanout;
+
+   memset(&fanout, 0, sizeof(ODBCShellFanout));
+   if (!(err = odbcshell_fanout_select(cnf, &fanout, names)))
+      err = odbcshell_fanout_run(cnf, &fanout, sql);
+   odbcshell_fanout_free(cnf, &fanout);
+
+   return(err);
+}
+
+
+/// @brief displays merged results, timings, and errors of each target
+/// @param cnf      pointer to configuration struct
+/// @param fanout   pointer to list of targets
+int odbcshell_fanout_report(ODBCShell * cnf, ODBCShellFanout * fanout)
+{
+   int               code;
+   long long         l;
+   long long         failed;
+   FILE            * fs;
+   ODBCShellTarget * target;
+
+   // names of columns are displayed once using the first target with rows
+   fs = cnf->output ? cnf->output : stdout;
+   if (cnf->format == ODBCSHELL_FORMAT_XML)
+   {
+      odbcshell_fprintf(cnf, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n");
+      odbcshell_fprintf(cnf, "<result>\n");
+   };
+   for(l = 0; l < fanout->count; l++)
+   {
+      if (!(fanout->targets[l].headlen))
+         continue;
+      fwrite(fanout->targets[l].head, 1, fanout->targets[l].headlen, fs);
+      break;
+   };
+   for(l = 0; l < fanout->count; l++)
+      if ((fanout->targets[l].bufflen))
+         fwrite(fanout->targets[l].buff, 1, fanout->targets[l].bufflen, fs);
+   if (cnf->format == ODBCSHELL_FORMAT_XML)
+      odbcshell_fprintf(cnf, "</result>\n");
+
+   // summarizes each target in the order requested
+   odbcshell_printf(cnf, "\n%-*s %12s %10s  %s\n", (int)cnf->label_width,
+      "connection", "rows", "msecs", "status");
+   for(l = 0; l < fanout->count; l++)
+   {
+      target = &fanout->targets[l];
+      odbcshell_printf(cnf, "%-*s %12lld %10lld  %s\n", (int)cnf->label_width,
+         target->name, target->rows, target->msecs,
+         ((target->code)) ? "failed" : "ok");
+   };
+   odbcshell_printf(cnf, "\n");
+
+   // displays buffered messages alongside the target which raised them
+   code   = 0;
+   failed = 0;
+   for(l = 0; l < fanout->count; l++)
+   {
+      target = &fanout->targets[l];
+      if (!(target->code))
+      {
+         if ( ((target->errlen)) && (!(cnf->silent)) )
+            fwrite(target->err, 1, target->errlen, cnf->msgs ? cnf->msgs : stdout);
+         continue;
+      };
+      failed++;
+      if (target->code == -2)
+         code = -2;
+      odbcshell_error(cnf, "%s: statement failed\n", target->name);
+      if ( ((target->errlen)) && (!(cnf->silent)) )
+         fwrite(target->err, 1, target->errlen, cnf->errs ? cnf->errs : stderr);
+   };
+   if ((failed))
+   {
+      odbcshell_error(cnf, "%lld of %lld data sources failed\n", failed, fanout->count);
+      if (!(code))
+         code = -1;
+   };
+
+   return(code);
+}
+
+
+/// @brief executes statement on every target using a bounded set of workers
+/// @param cnf      pointer to configuration struct
+/// @param fanout   pointer to list of targets
+/// @param sql      SQL statement to execute
+int odbcshell_fanout_run(ODBCShell * cnf, ODBCShellFanout * fanout,
+   char * sql)
+{
+   int               code;
+   long long         l;
+   long long         threads;
+   long long         started;
+   size_t            len;
+   sigset_t          oldset;
+   pthread_t       * tids;
+   ODBCShellTarget * target;
+
+   fanout->sql  = sql;
+   fanout->next = 0;
+
+   // leading column is wide enough for the longest name
+   cnf->label_width = strlen("connection");
+   for(l = 0; l < fanout->count; l++)
+      if ((len = strlen(fanout->targets[l].name)) > cnf->label_width)
+         cnf->label_width = len;
+
+   code = 0;
+   for(l = 0; l < fanout->count; l++)
+   {
+      target          = &fanout->targets[l];
+      target->code    = 0;
+      target->rows    = 0;
+      target->msecs   = 0;
+      target->output  = open_memstream(&target->buff, &target->bufflen);
+      target->heads   = open_memstream(&target->head, &target->headlen);
+      target->errs    = open_memstream(&target->err,  &target->errlen);
+      if ( (!(target->output)) || (!(target->heads)) || (!(target->errs)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // rows are labeled with the target and messages are reported together
+      odbcshell_clone(cnf, &target->cnf, target->output, target->errs);
+      target->cnf.label    = target->name;
+      target->cnf.noheader = 1;
+   };
+
+   // queries data sources using a bounded set of workers
+   if ( (!(code)) && ((fanout->count)) )
+   {
+      threads = (fanout->count < cnf->concurrency) ? fanout->count : cnf->concurrency;
+      if (threads < 1)
+         threads = 1;
+      if (!(tids = calloc((size_t)threads, sizeof(pthread_t))))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+      }
+      else
+      {
+         odbcshell_verbose(cnf, "querying %lld data sources using %lld threads...\n",
+            fanout->count, threads);
+         pthread_mutex_init(&fanout->lock, NULL);
+         odbcshell_signal_block(&oldset);
+         for(started = 0; started < threads; started++)
+            if ((pthread_create(&tids[started], NULL, odbcshell_fanout_thread, fanout)))
+               break;
+         odbcshell_signal_restore(&oldset);
+         if (!(started))
+            odbcshell_fanout_thread(fanout);
+         for(l = 0; l < started; l++)
+            pthread_join(tids[l], NULL);
+         pthread_mutex_destroy(&fanout->lock);
+         free(tids);
+      };
+   };
+
+   for(l = 0; l < fanout->count; l++)
+   {
+      target = &fanout->targets[l];
+      if ((target->output))
+         fclose(target->output);
+      if ((target->heads))
+         fclose(target->heads);
+      if ((target->errs))
+         fclose(target->errs);
+      target->output = NULL;
+      target->heads  = NULL;
+      target->errs   = NULL;
+   };
+
+   if (!(code))
+      code = odbcshell_fanout_report(cnf, fanout);
+   cnf->label_width = 0;
+
+   for(l = 0; l < fanout->count; l++)
+   {
+      target = &fanout->targets[l];
+      free(target->buff);
+      free(target->head);
+      free(target->err);
+      target->buff    = NULL;
+      target->head    = NULL;
+      target->err     = NULL;
+      target->bufflen = 0;
+      target->headlen = 0;
+      target->errlen  = 0;
+   };
+
+   return(code);
+}
+
+
+/// @brief adds open connections matching list of names to the list of targets
+/// @param cnf      pointer to configuration struct
+/// @param fanout   pointer to list of targets
+/// @param names    "all" or comma separated list of connection names
+int odbcshell_fanout_select(ODBCShell * cnf, ODBCShellFanout * fanout,
+   const char * names)
+{
+   int               err;
+   long long         l;
+   long long         u;
+   size_t            len;
+   int               idx;
+   char              name[128];
+   const char      * ptr;
+   ODBCShellConn   * conn;
+   ODBCShellGroup  * group;
+
+   if (!(strcasecmp(names, "all")))
+   {
+      for(l = 0; l < cnf->conns_count; l++)
+      {
+         conn = cnf->conns[l];
+         if ((conn->job))
+         {
+            odbcshell_verbose(cnf, "skipping \"%s\", connection is used by job %lld\n",
+               conn->name, conn->job->id);
+            continue;
+         };
+         if ((err = odbcshell_fanout_add(cnf, fanout, conn->name, NULL, conn)))
+            return(err);
+      };
+      if (!(fanout->count))
+      {
+         odbcshell_error(cnf, "no connections available\n");
+         return(-1);
+      };
+      return(0);
+   };
+
+   for(ptr = names; ((ptr)) && ((ptr[0])); ptr = ((ptr = strchr(ptr, ','))) ? ptr+1 : NULL)
+   {
+      len = strcspn(ptr, ",");
+      if (!(len))
+         continue;
+      if (len >= sizeof(name))
+      {
+         odbcshell_error(cnf, "connection name \"%.*s\" is too long\n", (int)len, ptr);
+         return(-1);
+      };
+      memcpy(name, ptr, len);
+      name[len] = '\0';
+
+      // a group names every connected member
+      group = NULL;
+      if ((idx = odbcshell_odbc_array_findindex(cnf, name)) < 0)
+      {
+         if (!(group = odbcshell_group_lookup(cnf, name)))
+         {
+            odbcshell_error(cnf, "unknown connection \"%s\"\n", name);
+            return(-1);
+         };
+      };
+      for(l = 0; ( ((group)) ? (l < group->members_count) : (l < 1) ); l++)
+      {
+         if ((group))
+         {
+            if ((idx = odbcshell_odbc_array_findindex(cnf, group->members[l])) < 0)
+            {
+               odbcshell_verbose(cnf, "skipping \"%s\", connection is closed\n",
+                  group->members[l]);
+               continue;
+            };
+         };
+         conn = cnf->conns[idx];
+         if ((conn->job))
+         {
+            odbcshell_error(cnf, "connection \"%s\" is used by job %lld\n",
+               conn->name, conn->job->id);
+            return(-1);
+         };
+
+         // connections named more than once are only queried once
+         for(u = 0; ((u < fanout->count) && (fanout->targets[u].conn != conn)); u++);
+         if (u < fanout->count)
+            continue;
+         if ((err = odbcshell_fanout_add(cnf, fanout, conn->name, NULL, conn)))
+            return(err);
+      };
+   };
+
+   if (!(fanout->count))
+   {
+      odbcshell_error(cnf, "no connections named\n");
+      return(-1);
+   };
+
+   return(0);
+}
+
+
+/// @brief worker thread for statements sent to several data sources
+/// @param ptr      pointer to list of targets
+void * odbcshell_fanout_thread(void * ptr)
+{
+   long long         l;
+   struct timespec   start;
+   struct timespec   end;
+   ODBCShellTarget * target;
+   ODBCShellFanout * fanout;
+
+   fanout = ptr;
+
+   while(1)
+   {
+      pthread_mutex_lock(&fanout->lock);
+      l = fanout->next++;
+      pthread_mutex_unlock(&fanout->lock);
+
+      if (l >= fanout->count)
+         return(NULL);
+
+      target = &fanout->targets[l];
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      target->code  = odbcshell_fanout_exec(target, fanout->sql);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      target->msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+                    + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+      fflush(target->output);
+      fflush(target->errs);
+   };
+
+   return(NULL);
+}
+
+/* end of source */
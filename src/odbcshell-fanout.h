@@ -0,0 +1,97 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-fanout.h ODBC Shell statements sent to several data sources
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_FANOUT_H
+#define _ODBCSHELL_SRC_ODBCSHELL_FANOUT_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// adds data source to the list of targets
+int odbcshell_fanout_add(ODBCShell * cnf, ODBCShellFanout * fanout,
+   const char * name, const char * dsn, ODBCShellConn * conn);
+
+// executes statement on a single target
+int odbcshell_fanout_exec(ODBCShellTarget * target, char * sql);
+
+// frees resources used by list of targets
+void odbcshell_fanout_free(ODBCShell * cnf, ODBCShellFanout * fanout);
+
+// executes statements passed with -e on each data source of the inventory
+int odbcshell_fanout_inventory(ODBCShell * cnf);
+
+// reads list of data sources from inventory file
+int odbcshell_fanout_load(ODBCShell * cnf, ODBCShellFanout * fanout,
+   const char * path);
+
+// executes statement on the named connections at once
+int odbcshell_fanout_on(ODBCShell * cnf, const char * names, char * sql);
+
+// displays merged results, timings, and errors of each target
+int odbcshell_fanout_report(ODBCShell * cnf, ODBCShellFanout * fanout);
+
+// executes statement on every target using a bounded set of workers
+int odbcshell_fanout_run(ODBCShell * cnf, ODBCShellFanout * fanout,
+   char * sql);
+
+// adds open connections matching list of names to the list of targets
+int odbcshell_fanout_select(ODBCShell * cnf, ODBCShellFanout * fanout,
+   const char * names);
+
+// worker thread for statements sent to several data sources
+void * odbcshell_fanout_thread(void * ptr);
+
+#endif
+/* end of header */
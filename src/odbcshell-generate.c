@@ -0,0 +1,1197 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-generate.c ODBC Shell inserts synthetic rows over several connections
+ */
+#include "odbcshell-generate.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief binds parameters of insert to a row of a block
+/// @param worker   pointer to worker
+/// @param row      first row bound (0 when binding arrays)
+int odbcshell_generate_bind(ODBCShellGenerateWorker * worker, SQLULEN row)
+{
+   long long                 l;
+   SQLRETURN                 sts;
+   ODBCShellGenerate       * generate;
+   ODBCShellGenerateColumn * col;
+
+   generate = worker->generate;
+   for(l = 0; l < generate->col_count; l++)
+   {
+      col = &generate->cols[l];
+      sts = SQLBindParameter(worker->stmt->hstmt, (SQLUSMALLINT)(l+1),
+         SQL_PARAM_INPUT, col->c_type, col->sql_type, col->size, 0,
+         &worker->data[col->offset + (row * col->width)], (SQLLEN)col->width,
+         &worker->ind[((SQLULEN)l * generate->batch) + row]);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLBindParameter", &worker->cnf, worker->stmt);
+         return(-1);
+      };
+   };
+
+   return(0);
+}
+
+
+/// @brief converts days since 1970-01-01 to a date
+/// @param days     days since 1970-01-01
+/// @param date     pointer to date
+void odbcshell_generate_civil(long long days, SQL_DATE_STRUCT * date)
+{
+   long long era;
+   long long doe;
+   long long yoe;
+   long long doy;
+   long long mp;
+   long long year;
+
+   // proleptic Gregorian calendar in eras of 400 years
+   days += 719468;
+   era   = ((days >= 0) ? days : (days - 146096)) / 146097;
+   doe   = days - (era * 146097);
+   yoe   = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+   doy   = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));
+   mp    = ((5 * doy) + 2) / 153;
+   year  = yoe + (era * 400);
+
+   date->day   = (SQLUSMALLINT)(doy - (((153 * mp) + 2) / 5) + 1);
+   date->month = (SQLUSMALLINT)((mp < 10) ? (mp + 3) : (mp - 9));
+   date->year  = (SQLSMALLINT)((date->month <= 2) ? (year + 1) : year);
+
+   return;
+}
+
+
+/// @brief parses the generator of a column
+/// @param cnf      pointer to configuration struct
+/// @param generate pointer to generate state
+/// @param col      column receiving values, named by caller
+/// @param spec     generator and its arguments
+int odbcshell_generate_column(ODBCShell * cnf, ODBCShellGenerate * generate,
+   ODBCShellGenerateColumn * col, const char * spec)
+{
+   int          err;
+   long long    l;
+   long long    argc;
+   size_t       len;
+   size_t       longest;
+   char       * args;
+   char       * ptr;
+   char       * end;
+   char       * argv[2];
+   const char * names[] = { "seq", "int", "float", "normal", "zipf",
+                            "string", "date", "pick", "ref", NULL };
+
+   // generator is named before its optional list of arguments
+   len       = strcspn(spec, "(");
+   col->kind = 0;
+   for(l = 0; ((names[l])); l++)
+      if ( (strlen(names[l]) == len) && (!(strncasecmp(spec, names[l], len))) )
+         col->kind = (int)(l + 1);
+
+   args    = NULL;
+   argc    = 0;
+   argv[0] = NULL;
+   argv[1] = NULL;
+   if (spec[len] == '(')
+   {
+      if (spec[strlen(spec)-1] != ')')
+         col->kind = 0;
+      if (!(args = strdup(&spec[len+1])))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+      args[strlen(args)-1] = '\0';
+      argc = ((args[0])) ? 1 : 0;
+      for(ptr = args; ( ((argc)) && ((ptr = strchr(ptr, ','))) ); ptr++)
+      {
+         if (argc < 2)
+            argv[argc] = &ptr[1];
+         argc++;
+         ptr[0] = '\0';
+      };
+      if ((argc))
+         argv[0] = args;
+   };
+
+   err = 0;
+   switch(col->kind)
+   {
+      case ODBCSHELL_GENERATE_SEQ:
+      col->lo = 1;
+      col->hi = 1;
+      if (argc == 2)
+      {
+         col->lo = strtoll(argv[0], &end, 10);
+         err    |= ((end[0])) ? 1 : 0;
+         col->hi = strtoll(argv[1], &end, 10);
+         err    |= ((end[0])) ? 1 : 0;
+      }
+      else if ((argc))
+         err = 1;
+      break;
+
+      case ODBCSHELL_GENERATE_INT:
+      case ODBCSHELL_GENERATE_STRING:
+      if ( (argc != 2) || (!(argv[0][0])) || (!(argv[1][0])) )
+      {
+         err = 1;
+         break;
+      };
+      col->lo = strtoll(argv[0], &end, 10);
+      err    |= ((end[0])) ? 1 : 0;
+      col->hi = strtoll(argv[1], &end, 10);
+      err    |= ((end[0])) ? 1 : 0;
+      err    |= (col->lo > col->hi) ? 1 : 0;
+      if (col->kind == ODBCSHELL_GENERATE_STRING)
+         err |= ( (col->lo < 0) || (col->hi >= ODBCSHELL_GENERATE_WIDTH) ) ? 1 : 0;
+      break;
+
+      case ODBCSHELL_GENERATE_FLOAT:
+      case ODBCSHELL_GENERATE_NORMAL:
+      case ODBCSHELL_GENERATE_ZIPF:
+      if ( (argc != 2) || (!(argv[0][0])) || (!(argv[1][0])) )
+      {
+         err = 1;
+         break;
+      };
+      col->dlo = strtod(argv[0], &end);
+      err     |= ((end[0])) ? 1 : 0;
+      col->dhi = strtod(argv[1], &end);
+      err     |= ((end[0])) ? 1 : 0;
+      if (col->kind == ODBCSHELL_GENERATE_FLOAT)
+         err |= (!(col->dlo <= col->dhi)) ? 1 : 0;
+      if (col->kind == ODBCSHELL_GENERATE_NORMAL)
+         err |= (!(col->dhi >= 0.0)) ? 1 : 0;
+      if (col->kind != ODBCSHELL_GENERATE_ZIPF)
+         break;
+
+      // Zipf takes a number of items and an exponent
+      col->lo  = strtoll(argv[0], &end, 10);
+      err     |= ( ((end[0])) || (col->lo < 1) || (!(col->dhi > 0.0)) ) ? 1 : 0;
+      if ((err))
+         break;
+      col->zipf_x1 = odbcshell_generate_hintegral(1.5, col->dhi) - 1.0;
+      col->zipf_n  = odbcshell_generate_hintegral(col->dlo + 0.5, col->dhi);
+      col->zipf_s  = 2.0 - odbcshell_generate_hinverse(odbcshell_generate_hintegral(2.5, col->dhi)
+                   - exp(-col->dhi * log(2.0)), col->dhi);
+      break;
+
+      case ODBCSHELL_GENERATE_DATE:
+      if ( (argc != 2) || ((odbcshell_generate_days(argv[0], &col->lo))) ||
+           ((odbcshell_generate_days(argv[1], &col->hi))) || (col->lo > col->hi) )
+         err = 1;
+      break;
+
+      case ODBCSHELL_GENERATE_PICK:
+      if (!(argc))
+      {
+         err = 1;
+         break;
+      };
+      // arguments already separated by the parser become the pool
+      if (!(col->values = malloc(sizeof(size_t) * (size_t)argc)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         free(args);
+         return(-2);
+      };
+      col->pool        = args;
+      col->value_count = argc;
+      ptr              = args;
+      for(l = 0; l < argc; l++)
+      {
+         col->values[l] = (size_t)(ptr - args);
+         ptr            = &ptr[strlen(ptr) + 1];
+      };
+      args = NULL;
+      break;
+
+      case ODBCSHELL_GENERATE_REF:
+      if (argc != 1)
+      {
+         err = 1;
+         break;
+      };
+      if ((err = odbcshell_generate_refs(cnf, col, argv[0])))
+      {
+         free(args);
+         return(err);
+      };
+      break;
+
+      default:
+      err = 1;
+      break;
+   };
+   free(args);
+   if ((err))
+   {
+      odbcshell_error(cnf, "invalid generator \"%s\" for column \"%s\"\n", spec, col->name);
+      return(-1);
+   };
+
+   // values are bound in their native C types
+   switch(col->kind)
+   {
+      case ODBCSHELL_GENERATE_SEQ:
+      case ODBCSHELL_GENERATE_INT:
+      case ODBCSHELL_GENERATE_ZIPF:
+      col->c_type   = SQL_C_SBIGINT;
+      col->sql_type = SQL_BIGINT;
+      col->size     = 19;
+      col->width    = sizeof(long long);
+      break;
+
+      case ODBCSHELL_GENERATE_FLOAT:
+      case ODBCSHELL_GENERATE_NORMAL:
+      col->c_type   = SQL_C_DOUBLE;
+      col->sql_type = SQL_DOUBLE;
+      col->size     = 15;
+      col->width    = sizeof(double);
+      break;
+
+      case ODBCSHELL_GENERATE_DATE:
+      col->c_type   = SQL_C_TYPE_DATE;
+      col->sql_type = SQL_TYPE_DATE;
+      col->size     = 10;
+      col->width    = sizeof(SQL_DATE_STRUCT);
+      break;
+
+      case ODBCSHELL_GENERATE_STRING:
+      col->c_type   = SQL_C_CHAR;
+      col->sql_type = SQL_VARCHAR;
+      col->size     = ((col->hi)) ? (SQLULEN)col->hi : 1;
+      col->width    = (size_t)col->hi + 1;
+      break;
+
+      default:
+      longest = 0;
+      for(l = 0; l < col->value_count; l++)
+         if ((len = strlen(&col->pool[col->values[l]])) > longest)
+            longest = len;
+      col->c_type   = SQL_C_CHAR;
+      col->sql_type = SQL_VARCHAR;
+      col->size     = ((longest)) ? (SQLULEN)longest : 1;
+      col->width    = longest + 1;
+      break;
+   };
+
+   generate->bytes += col->width;
+
+   return(0);
+}
+
+
+/// @brief converts a date written as YYYY-MM-DD to days since 1970-01-01
+/// @param str      date being converted
+/// @param daysp    pointer to days since 1970-01-01
+/// @return 0 on success, -1 if date is invalid
+int odbcshell_generate_days(const char * str, long long * daysp)
+{
+   int              year;
+   int              month;
+   int              day;
+   char             c;
+   long long        era;
+   long long        yoe;
+   long long        doy;
+   long long        y;
+   SQL_DATE_STRUCT  date;
+
+   if (sscanf(str, "%d-%d-%d%c", &year, &month, &day, &c) != 3)
+      return(-1);
+   if ( (month < 1) || (month > 12) || (day < 1) || (day > 31) )
+      return(-1);
+
+   y   = (month <= 2) ? (year - 1) : year;
+   era = ((y >= 0) ? y : (y - 399)) / 400;
+   yoe = y - (era * 400);
+   doy = (((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5) + day - 1;
+   (*daysp) = (era * 146097) + (yoe * 365) + (yoe / 4) - (yoe / 100) + doy - 719468;
+
+   // days past the end of a month do not survive the round trip
+   odbcshell_generate_civil((*daysp), &date);
+   if ( (date.year != year) || (date.month != month) || (date.day != day) )
+      return(-1);
+
+   return(0);
+}
+
+
+/// @brief chooses generators of every column of a table from its types
+/// @param cnf      pointer to configuration struct
+/// @param generate pointer to generate state
+int odbcshell_generate_defaults(ODBCShell * cnf, ODBCShellGenerate * generate)
+{
+   int                       err;
+   int                       seq;
+   long long                 l;
+   long long                 max;
+   SQLULEN                   prec;
+   size_t                    len;
+   char                    * sql;
+   SQLRETURN                 sts;
+   ODBCShellStmt           * stmt;
+   ODBCShellColumn         * desc;
+   ODBCShellGenerateColumn * col;
+   char                      spec[64];
+
+   len = strlen(generate->table) + 32;
+   if (!(sql = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   snprintf(sql, len, "SELECT * FROM %s WHERE 1=0", generate->table);
+
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, cnf->current, &stmt)))
+   {
+      free(sql);
+      return(err);
+   };
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)sql, SQL_NTS);
+   free(sql);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+   err = odbcshell_odbc_describe(cnf, stmt);
+   SQLCloseCursor(stmt->hstmt);
+   if ( (!(err)) && (!(stmt->col_count)) )
+   {
+      odbcshell_error(cnf, "table \"%s\" has no columns\n", generate->table);
+      err = -1;
+   };
+   if ( (!(err)) && (!(generate->cols = calloc((size_t)stmt->col_count, sizeof(ODBCShellGenerateColumn)))) )
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      err = -2;
+   };
+
+   // first integer column is numbered in sequence, other columns receive
+   // random values fitting their types
+   seq = 0;
+   for(l = 0; ( (!(err)) && (l < stmt->col_count) ); l++)
+   {
+      desc = &stmt->cols[l];
+      col  = &generate->cols[l];
+      if (!(col->name = strdup((char *)desc->name)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+         break;
+      };
+      generate->col_count++;
+
+      prec = desc->precision;
+      switch(desc->type)
+      {
+         case SQL_TINYINT:
+         case SQL_SMALLINT:
+         case SQL_INTEGER:
+         case SQL_BIGINT:
+         max = (desc->type == SQL_TINYINT)  ? 127LL :
+               (desc->type == SQL_SMALLINT) ? 32767LL : 2147483647LL;
+         if (!(seq++))
+            snprintf(spec, sizeof(spec), "seq");
+         else
+            snprintf(spec, sizeof(spec), "int(0,%lld)", max);
+         break;
+
+         case SQL_BIT:
+         snprintf(spec, sizeof(spec), "int(0,1)");
+         break;
+
+         case SQL_DECIMAL:
+         case SQL_NUMERIC:
+         for(max = 1; ( (prec > (SQLULEN)desc->scale) && (max < 1000000000LL) ); prec--)
+            max *= 10;
+         if (!(desc->scale))
+            snprintf(spec, sizeof(spec), "int(0,%lld)", max - 1);
+         else
+            snprintf(spec, sizeof(spec), "float(0,%lld)", max);
+         break;
+
+         case SQL_REAL:
+         case SQL_FLOAT:
+         case SQL_DOUBLE:
+         snprintf(spec, sizeof(spec), "float(0,1000)");
+         break;
+
+         case SQL_DATE:
+         case SQL_TIMESTAMP:
+         case SQL_TYPE_DATE:
+         case SQL_TYPE_TIMESTAMP:
+         snprintf(spec, sizeof(spec), "date(2000-01-01,2029-12-31)");
+         break;
+
+         default:
+         snprintf(spec, sizeof(spec), "string(1,%lu)",
+            (unsigned long)( ( (!(prec)) || (prec > 32) ) ? 32 : prec ));
+         break;
+      };
+      odbcshell_verbose(cnf, "generating \"%s\" with %s\n", col->name, spec);
+      err = odbcshell_generate_column(cnf, generate, col, spec);
+   };
+   odbcshell_odbc_stmt_release(cnf, &stmt);
+
+   return(err);
+}
+
+
+/// @brief frees resources used by generate
+/// @param generate pointer to generate state
+void odbcshell_generate_free(ODBCShellGenerate * generate)
+{
+   long long                 l;
+   ODBCShellGenerateColumn * col;
+   ODBCShellGenerateWorker * worker;
+
+   for(l = 0; ( ((generate->workers)) && (l < generate->count) ); l++)
+   {
+      worker = &generate->workers[l];
+      if ((worker->errs))
+         fclose(worker->errs);
+      free(worker->err);
+      free(worker->data);
+      free(worker->ind);
+   };
+   for(l = 0; ( ((generate->cols)) && (l < generate->col_count) ); l++)
+   {
+      col = &generate->cols[l];
+      free(col->name);
+      free(col->pool);
+      free(col->values);
+   };
+   free(generate->workers);
+   free(generate->cols);
+   free(generate->insert);
+   generate->workers   = NULL;
+   generate->cols      = NULL;
+   generate->insert    = NULL;
+   generate->count     = 0;
+   generate->col_count = 0;
+
+   return;
+}
+
+
+/// @brief integral of the Zipf hat function
+/// @param x        upper bound of integral
+/// @param s        exponent of distribution
+double odbcshell_generate_hintegral(double x, double s)
+{
+   double lx;
+   double t;
+
+   // (exp(t) - 1) / t is expanded near zero to keep its precision
+   lx = log(x);
+   t  = (1.0 - s) * lx;
+   if (fabs(t) > 1e-8)
+      return((expm1(t) / t) * lx);
+   return((1.0 + (t * 0.5 * (1.0 + ((t / 3.0) * (1.0 + (0.25 * t)))))) * lx);
+}
+
+
+/// @brief inverse of the integral of the Zipf hat function
+/// @param x        value of integral
+/// @param s        exponent of distribution
+double odbcshell_generate_hinverse(double x, double s)
+{
+   double t;
+
+   // log(1 + t) / t is expanded near zero to keep its precision
+   t = x * (1.0 - s);
+   if (t < -1.0)
+      t = -1.0;
+   if (fabs(t) > 1e-8)
+      return(exp((log1p(t) / t) * x));
+   return(exp((1.0 - (t * (0.5 - (t * ((1.0 / 3.0) - (0.25 * t)))))) * x));
+}
+
+
+/// @brief generates and inserts every row of a slice
+/// @param worker   pointer to worker
+int odbcshell_generate_load(ODBCShellGenerateWorker * worker)
+{
+   int                 err;
+   long long           row;
+   SQLRETURN           sts;
+   ODBCShell         * cnf;
+   ODBCShellGenerate * generate;
+   char                name[64];
+
+   cnf      = &worker->cnf;
+   generate = worker->generate;
+
+   if (!(worker->conn))
+   {
+      snprintf(name, sizeof(name), "generate-%lld", worker->id);
+      if ((err = odbcshell_odbc_open(cnf, generate->dsn, name, &worker->conn)))
+         return(err);
+   };
+
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, worker->conn, &worker->stmt)))
+      return(err);
+   odbcshell_odbc_stmt_timeout(cnf, worker->conn, worker->stmt);
+   sts = SQLPrepare(worker->stmt->hstmt, (SQLTCHAR *)generate->insert, SQL_NTS);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLPrepare", cnf, worker->stmt);
+      odbcshell_odbc_stmt_release(cnf, &worker->stmt);
+      return(-1);
+   };
+
+   // drivers without arrays of parameters receive one row at a time
+   sts = SQLSetStmtAttr(worker->stmt->hstmt, SQL_ATTR_PARAM_BIND_TYPE,
+      (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, SQL_IS_UINTEGER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(worker->stmt->hstmt, SQL_ATTR_PARAMSET_SIZE,
+         (SQLPOINTER)generate->batch, SQL_IS_UINTEGER);
+   worker->arrays = ((SQL_SUCCEEDED(sts))) ? 1 : 0;
+
+   // each block is committed once inserted
+   sts = SQLSetConnectAttr(worker->conn->hdbc, SQL_ATTR_AUTOCOMMIT,
+      (SQLPOINTER)SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_diag("SQLSetConnectAttr", cnf, worker->conn->hdbc, NULL);
+      odbcshell_odbc_stmt_release(cnf, &worker->stmt);
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "generating rows %lld-%lld of \"%s\"...\n",
+      worker->first + 1, worker->first + worker->count, generate->table);
+
+   for(row = 0; ( (!(err)) && (row < worker->count) ); row++)
+   {
+      odbcshell_generate_row(worker, worker->first + row);
+      if (worker->block == generate->batch)
+         err = odbcshell_generate_write(worker);
+   };
+   if (!(err))
+      err = odbcshell_generate_write(worker);
+   if ((err))
+      SQLEndTran(SQL_HANDLE_DBC, worker->conn->hdbc, SQL_ROLLBACK);
+
+   SQLSetConnectAttr(worker->conn->hdbc, SQL_ATTR_AUTOCOMMIT,
+      (SQLPOINTER)SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
+   odbcshell_odbc_stmt_release(cnf, &worker->stmt);
+
+   return(err);
+}
+
+
+/// @brief returns next random number of a worker (SplitMix64)
+/// @param worker   pointer to worker
+uint64_t odbcshell_generate_random(ODBCShellGenerateWorker * worker)
+{
+   uint64_t z;
+
+   z = (worker->state += 0x9E3779B97F4A7C15ULL);
+   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+   return(z ^ (z >> 31));
+}
+
+
+/// @brief loads values of a referenced column
+/// @param cnf      pointer to configuration struct
+/// @param col      column receiving referenced values
+/// @param ref      referenced column written as table.column
+int odbcshell_generate_refs(ODBCShell * cnf, ODBCShellGenerateColumn * col,
+   const char * ref)
+{
+   int             err;
+   size_t          len;
+   size_t          used;
+   size_t          size;
+   size_t          max;
+   void          * ptr;
+   char          * sql;
+   const char    * dot;
+   SQLLEN          ind;
+   SQLRETURN       sts;
+   ODBCShellStmt * stmt;
+   char            value[ODBCSHELL_GENERATE_WIDTH];
+
+   if ( (!(dot = strrchr(ref, '.'))) || (dot == ref) || (!(dot[1])) )
+   {
+      odbcshell_error(cnf, "invalid reference \"%s\"\n", ref);
+      return(-1);
+   };
+
+   len = strlen(ref) + 16;
+   if (!(sql = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   snprintf(sql, len, "SELECT %s FROM %.*s", &dot[1], (int)(dot - ref), ref);
+
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, cnf->current, &stmt)))
+   {
+      free(sql);
+      return(err);
+   };
+   odbcshell_verbose(cnf, "loading values of \"%s\"...\n", ref);
+   sts = SQLExecDirect(stmt->hstmt, (SQLTCHAR *)sql, SQL_NTS);
+   free(sql);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLBindCol(stmt->hstmt, 1, SQL_C_CHAR, value, sizeof(value), &ind);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLExecDirect", cnf, stmt);
+      odbcshell_odbc_stmt_release(cnf, &stmt);
+      return(-1);
+   };
+
+   // values are packed into a pool which grows as rows are fetched
+   used = 0;
+   size = 0;
+   max  = 0;
+   while ( (!(err)) && (col->value_count < ODBCSHELL_GENERATE_REFS) &&
+           ((SQL_SUCCEEDED(sts = SQLFetch(stmt->hstmt)))) )
+   {
+      if (ind == SQL_NULL_DATA)
+         continue;
+      len = strlen(value) + 1;
+      if ((used + len) > size)
+      {
+         size = ((size)) ? (size * 2) : (64 * 1024);
+         if ((ptr = realloc(col->pool, size)))
+            col->pool = ptr;
+         else
+            err = -2;
+      };
+      if ( (!(err)) && ((size_t)col->value_count == max) )
+      {
+         max = ((max)) ? (max * 2) : 1024;
+         if ((ptr = realloc(col->values, sizeof(size_t) * max)))
+            col->values = ptr;
+         else
+            err = -2;
+      };
+      if ((err))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         break;
+      };
+      memcpy(&col->pool[used], value, len);
+      col->values[col->value_count++] = used;
+      used += len;
+   };
+   if ( (!(err)) && (col->value_count < ODBCSHELL_GENERATE_REFS) && (sts != SQL_NO_DATA) )
+   {
+      odbcshell_odbc_stmt_errors("SQLFetch", cnf, stmt);
+      err = -1;
+   };
+   SQLCloseCursor(stmt->hstmt);
+   odbcshell_odbc_stmt_release(cnf, &stmt);
+   if ((err))
+      return(err);
+
+   if (!(col->value_count))
+   {
+      odbcshell_error(cnf, "\"%s\" has no values to reference\n", ref);
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "loaded %lld values of \"%s\"\n", col->value_count, ref);
+
+   return(0);
+}
+
+
+/// @brief fills one row of a block
+/// @param worker   pointer to worker
+/// @param row      number of row within table (starting with 0)
+void odbcshell_generate_row(ODBCShellGenerateWorker * worker, long long row)
+{
+   long long                 l;
+   long long                 len;
+   long long                 pos;
+   uint64_t                  r;
+   uint64_t                  span;
+   double                    u;
+   double                    v;
+   char                    * dst;
+   SQLLEN                  * ind;
+   const char              * str;
+   ODBCShellGenerate       * generate;
+   ODBCShellGenerateColumn * col;
+   const char              * chars = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+   generate = worker->generate;
+
+   // random values depend only on the seed and the number of the row so
+   // that rows are the same however they are divided between workers
+   worker->state = generate->seed ^ ((uint64_t)row * ODBCSHELL_HASH_PRIME1);
+
+   for(l = 0; l < generate->col_count; l++)
+   {
+      col    = &generate->cols[l];
+      dst    = &worker->data[col->offset + (worker->block * col->width)];
+      ind    = &worker->ind[((SQLULEN)l * generate->batch) + worker->block];
+      (*ind) = 0;
+      switch(col->kind)
+      {
+         case ODBCSHELL_GENERATE_SEQ:
+         (*(long long *)dst) = col->lo + (col->hi * row);
+         break;
+
+         case ODBCSHELL_GENERATE_INT:
+         span = (uint64_t)col->hi - (uint64_t)col->lo + 1;
+         r    = odbcshell_generate_random(worker);
+         (*(long long *)dst) = (long long)((uint64_t)col->lo + (((span)) ? (r % span) : r));
+         break;
+
+         case ODBCSHELL_GENERATE_FLOAT:
+         u = (double)(odbcshell_generate_random(worker) >> 11) * 0x1.0p-53;
+         (*(double *)dst) = col->dlo + ((col->dhi - col->dlo) * u);
+         break;
+
+         case ODBCSHELL_GENERATE_NORMAL:
+         // Box-Muller transform; u is never zero
+         u = (double)((odbcshell_generate_random(worker) >> 11) + 1) * 0x1.0p-53;
+         v = (double)(odbcshell_generate_random(worker) >> 11) * 0x1.0p-53;
+         (*(double *)dst) = col->dlo + (col->dhi * sqrt(-2.0 * log(u)) * cos(6.283185307179586 * v));
+         break;
+
+         case ODBCSHELL_GENERATE_ZIPF:
+         (*(long long *)dst) = odbcshell_generate_zipf(worker, col);
+         break;
+
+         case ODBCSHELL_GENERATE_STRING:
+         len = col->lo;
+         if (col->hi > col->lo)
+            len += (long long)(odbcshell_generate_random(worker) % (uint64_t)(col->hi - col->lo + 1));
+         // each random number yields ten characters
+         r = 0;
+         for(pos = 0; pos < len; pos++)
+         {
+            if (!(pos % 10))
+               r = odbcshell_generate_random(worker);
+            dst[pos] = chars[r % 62];
+            r       /= 62;
+         };
+         dst[len] = '\0';
+         (*ind)   = (SQLLEN)len;
+         break;
+
+         case ODBCSHELL_GENERATE_DATE:
+         span = (uint64_t)(col->hi - col->lo) + 1;
+         odbcshell_generate_civil(col->lo + (long long)(odbcshell_generate_random(worker) % span),
+            (SQL_DATE_STRUCT *)dst);
+         break;
+
+         default:
+         str    = &col->pool[col->values[odbcshell_generate_random(worker) % (uint64_t)col->value_count]];
+         len    = (long long)strlen(str);
+         memcpy(dst, str, (size_t)len + 1);
+         (*ind) = (SQLLEN)len;
+         break;
+      };
+   };
+   worker->block++;
+
+   return;
+}
+
+
+/// @brief inserts synthetic rows into a table over several connections
+/// @param cnf      pointer to configuration struct
+/// @param table    table receiving rows
+/// @param rows     rows generated
+/// @param jobs     most connections inserting rows at once
+/// @param batch    rows passed in each block
+/// @param seed     seed of random values
+/// @param argc     number of columns given generators
+/// @param argv     name and generator of each column
+int odbcshell_generate_run(ODBCShell * cnf, const char * table,
+   long long rows, long long jobs, long long batch, long long seed,
+   int argc, char ** argv)
+{
+   int                       err;
+   int                       code;
+   long long                 l;
+   long long                 started;
+   long long                 done;
+   long long                 failed;
+   long long                 msecs;
+   size_t                    len;
+   SQLULEN                   max;
+   sigset_t                  oldset;
+   pthread_t               * tids;
+   struct timespec           start;
+   struct timespec           end;
+   ODBCShellGenerate         generate;
+   ODBCShellGenerateColumn * col;
+   ODBCShellGenerateWorker * worker;
+   char                      name[64];
+
+   if ( (jobs < 1) || (jobs > ODBCSHELL_GENERATE_WORKERS) )
+   {
+      odbcshell_error(cnf, "number of connections must be between 1 and %i\n", ODBCSHELL_GENERATE_WORKERS);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_ready(cnf)))
+      return(err);
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   memset(&generate, 0, sizeof(ODBCShellGenerate));
+   generate.table = table;
+   generate.dsn   = cnf->current->dsn;
+   generate.rows  = rows;
+   generate.seed  = (uint64_t)seed;
+
+   // columns without generators are chosen from the table
+   if (!(argc))
+      err = odbcshell_generate_defaults(cnf, &generate);
+   else if (!(generate.cols = calloc((size_t)argc, sizeof(ODBCShellGenerateColumn))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      err = -2;
+   };
+   for(l = 0; ( (!(err)) && (l < (long long)argc) ); l++)
+   {
+      col = &generate.cols[l];
+      if (!(col->name = strdup(argv[l*2])))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         err = -2;
+         break;
+      };
+      generate.col_count++;
+      err = odbcshell_generate_column(cnf, &generate, col, argv[(l*2)+1]);
+   };
+   if ((err))
+   {
+      odbcshell_generate_free(&generate);
+      return(err);
+   };
+
+   len = strlen("INSERT INTO  () VALUES ()") + strlen(table) + 1;
+   for(l = 0; l < generate.col_count; l++)
+      len += strlen(generate.cols[l].name) + 3;
+   if (!(generate.insert = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_generate_free(&generate);
+      return(-2);
+   };
+   snprintf(generate.insert, len, "INSERT INTO %s (", table);
+   for(l = 0; l < generate.col_count; l++)
+   {
+      if ((l))
+         strcat(generate.insert, ",");
+      strcat(generate.insert, generate.cols[l].name);
+   };
+   strcat(generate.insert, ") VALUES (");
+   for(l = 0; l < generate.col_count; l++)
+      strcat(generate.insert, ((l)) ? ",?" : "?");
+   strcat(generate.insert, ")");
+
+   // rows are divided evenly between workers
+   generate.count = (rows < jobs) ? rows : jobs;
+
+   // limits memory held by each block; blocks never exceed a slice
+   max = (SQLULEN)(ODBCSHELL_FETCH_BYTES / (generate.bytes +
+         ((size_t)generate.col_count * sizeof(SQLLEN))));
+   generate.batch = (SQLULEN)batch;
+   if (generate.batch > max)
+      generate.batch = max;
+   if (generate.batch > (SQLULEN)((rows + generate.count - 1) / generate.count))
+      generate.batch = (SQLULEN)((rows + generate.count - 1) / generate.count);
+   if (generate.batch < 1)
+      generate.batch = 1;
+
+   // values of each column are kept together and aligned for their type
+   generate.bytes = 0;
+   for(l = 0; l < generate.col_count; l++)
+   {
+      col             = &generate.cols[l];
+      col->offset     = generate.bytes;
+      generate.bytes += ((col->width * generate.batch) + 7) & ~((size_t)7);
+   };
+
+   if (!(generate.workers = calloc((size_t)generate.count, sizeof(ODBCShellGenerateWorker))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_generate_free(&generate);
+      return(-2);
+   };
+   code = 0;
+   for(l = 0; l < generate.count; l++)
+   {
+      worker           = &generate.workers[l];
+      worker->id       = l + 1;
+      worker->first    = (rows * l) / generate.count;
+      worker->count    = ((rows * (l + 1)) / generate.count) - worker->first;
+      worker->generate = &generate;
+      worker->data     = malloc(generate.bytes);
+      worker->ind      = malloc(sizeof(SQLLEN) * (size_t)generate.col_count * generate.batch);
+      worker->errs     = open_memstream(&worker->err, &worker->errlen);
+      if ( (!(worker->data)) || (!(worker->ind)) || (!(worker->errs)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // idle connections to the data source are handed to workers
+      snprintf(name, sizeof(name), "generate-%lld", worker->id);
+      if ((code = odbcshell_pool_take(cnf, generate.dsn, name, &worker->conn)))
+         break;
+
+      // messages of each worker are reported together once all finish
+      odbcshell_clone(cnf, &worker->cnf, worker->errs, worker->errs);
+   };
+
+   tids = NULL;
+   if ( (!(code)) && (!(tids = calloc((size_t)generate.count, sizeof(pthread_t)))) )
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      code = -2;
+   };
+   if (!(code))
+   {
+      odbcshell_verbose(cnf, "generating %lld rows of %lld columns on %lld connections, %lu rows per block...\n",
+         rows, generate.col_count, generate.count, (unsigned long)generate.batch);
+      odbcshell_signal_block(&oldset);
+      for(started = 0; started < generate.count; started++)
+         if ((pthread_create(&tids[started], NULL, odbcshell_generate_thread, &generate.workers[started])))
+            break;
+      odbcshell_signal_restore(&oldset);
+
+      // workers which could not be given a thread are run in turn
+      for(l = started; l < generate.count; l++)
+         odbcshell_generate_thread(&generate.workers[l]);
+      for(l = 0; l < started; l++)
+         pthread_join(tids[l], NULL);
+   };
+   free(tids);
+
+   // messages of each worker are reported in the order of its rows
+   done   = 0;
+   failed = 0;
+   for(l = 0; l < generate.count; l++)
+   {
+      worker = &generate.workers[l];
+      if ((worker->errs))
+         fclose(worker->errs);
+      worker->errs = NULL;
+      if ((worker->errlen))
+         fwrite(worker->err, 1, worker->errlen, ((cnf->errs)) ? cnf->errs : stderr);
+      if ((worker->conn))
+      {
+         if ((worker->code))
+            odbcshell_odbc_free(cnf, &worker->conn);
+         else
+            odbcshell_pool_put(cnf, &worker->conn);
+      };
+      if ((code))
+         continue;
+      done += worker->rows;
+      if (!(worker->code))
+      {
+         odbcshell_verbose(cnf, "worker %lld (rows %lld-%lld): %lld rows in %lld ms\n",
+            worker->id, worker->first + 1, worker->first + worker->count, worker->rows, worker->msecs);
+         continue;
+      };
+      failed++;
+      odbcshell_error(cnf, "worker %lld (rows %lld-%lld) failed, %lld rows committed\n",
+         worker->id, worker->first + 1, worker->first + worker->count, worker->rows);
+   };
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   if ( (!(code)) && (!(failed)) )
+      odbcshell_printf(cnf, "generated %lld rows into \"%s\" over %lld connections in %lld ms (%lld rows per second).\n",
+         done, table, generate.count, msecs, (done * 1000LL) / (((msecs)) ? msecs : 1));
+   else if (!(code))
+   {
+      odbcshell_error(cnf, "%lld of %lld connections failed, %lld rows committed\n",
+         failed, generate.count, done);
+      code = -1;
+   };
+
+   odbcshell_generate_free(&generate);
+
+   return(code);
+}
+
+
+/// @brief worker thread inserting one slice
+/// @param ptr      pointer to worker
+void * odbcshell_generate_thread(void * ptr)
+{
+   struct timespec           start;
+   struct timespec           end;
+   ODBCShellGenerateWorker * worker;
+
+   worker = ptr;
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   worker->code  = odbcshell_generate_load(worker);
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   worker->msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+                 + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   fflush(worker->errs);
+
+   return(NULL);
+}
+
+
+/// @brief inserts rows held in block
+/// @param worker   pointer to worker
+int odbcshell_generate_write(ODBCShellGenerateWorker * worker)
+{
+   int       err;
+   SQLULEN   row;
+   SQLULEN   done;
+   SQLRETURN sts;
+
+   if (!(worker->block))
+      return(0);
+
+   // a block with rejected rows is not committed
+   if ((worker->arrays))
+   {
+      if ((err = odbcshell_generate_bind(worker, 0)))
+         return(err);
+      if ((err = odbcshell_odbc_params_exec(&worker->cnf, worker->stmt,
+         worker->block, &done, &row)))
+         return(err);
+   }
+   else
+   {
+      for(done = 0; done < worker->block; done++)
+      {
+         if ((err = odbcshell_generate_bind(worker, done)))
+            return(err);
+         sts = SQLExecute(worker->stmt->hstmt);
+         if (!(SQL_SUCCEEDED(sts)))
+         {
+            odbcshell_odbc_stmt_errors("SQLExecute", &worker->cnf, worker->stmt);
+            return(-1);
+         };
+      };
+   };
+
+   sts = SQLEndTran(SQL_HANDLE_DBC, worker->conn->hdbc, SQL_COMMIT);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_diag("SQLEndTran", &worker->cnf, worker->conn->hdbc, NULL);
+      return(-1);
+   };
+   worker->rows += (long long)done;
+   worker->block = 0;
+
+   return(0);
+}
+
+
+/// @brief draws a Zipf distributed integer by rejection-inversion
+/// @param worker   pointer to worker
+/// @param col      column receiving value
+long long odbcshell_generate_zipf(ODBCShellGenerateWorker * worker,
+   ODBCShellGenerateColumn * col)
+{
+   long long k;
+   double    u;
+   double    x;
+
+   // Hormann and Derflinger's method draws in constant time however
+   // many items the distribution has
+   while(1)
+   {
+      u = (double)(odbcshell_generate_random(worker) >> 11) * 0x1.0p-53;
+      u = col->zipf_n + (u * (col->zipf_x1 - col->zipf_n));
+      x = odbcshell_generate_hinverse(u, col->dhi);
+      k = (long long)(x + 0.5);
+      if (k < 1)
+         k = 1;
+      else if (k > col->lo)
+         k = col->lo;
+      if ( (((double)k - x) <= col->zipf_s) ||
+           (u >= (odbcshell_generate_hintegral((double)k + 0.5, col->dhi) - exp(-col->dhi * log((double)k)))) )
+         return(k);
+   };
+
+   return(1);
+}
+
+/* end of source */
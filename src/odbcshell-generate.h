@@ -0,0 +1,116 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-generate.h ODBC Shell inserts synthetic rows over several connections
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_GENERATE_H
+#define _ODBCSHELL_SRC_ODBCSHELL_GENERATE_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// binds parameters of insert to a row of a block
+int odbcshell_generate_bind(ODBCShellGenerateWorker * worker, SQLULEN row);
+
+// converts days since 1970-01-01 to a date
+void odbcshell_generate_civil(long long days, SQL_DATE_STRUCT * date);
+
+// parses the generator of a column
+int odbcshell_generate_column(ODBCShell * cnf, ODBCShellGenerate * generate,
+   ODBCShellGenerateColumn * col, const char * spec);
+
+// converts a date written as YYYY-MM-DD to days since 1970-01-01
+int odbcshell_generate_days(const char * str, long long * daysp);
+
+// chooses generators of every column of a table from its types
+int odbcshell_generate_defaults(ODBCShell * cnf, ODBCShellGenerate * generate);
+
+// frees resources used by generate
+void odbcshell_generate_free(ODBCShellGenerate * generate);
+
+// integral of the Zipf hat function
+double odbcshell_generate_hintegral(double x, double s);
+
+// inverse of the integral of the Zipf hat function
+double odbcshell_generate_hinverse(double x, double s);
+
+// generates and inserts every row of a slice
+int odbcshell_generate_load(ODBCShellGenerateWorker * worker);
+
+// returns next random number of a worker (SplitMix64)
+uint64_t odbcshell_generate_random(ODBCShellGenerateWorker * worker);
+
+// loads values of a referenced column
+int odbcshell_generate_refs(ODBCShell * cnf, ODBCShellGenerateColumn * col,
+   const char * ref);
+
+// fills one row of a block
+void odbcshell_generate_row(ODBCShellGenerateWorker * worker, long long row);
+
+// inserts synthetic rows into a table over several connections
+int odbcshell_generate_run(ODBCShell * cnf, const char * table,
+   long long rows, long long jobs, long long batch, long long seed,
+   int argc, char ** argv);
+
+// worker thread inserting one slice
+void * odbcshell_generate_thread(void * ptr);
+
+// inserts rows held in block
+int odbcshell_generate_write(ODBCShellGenerateWorker * worker);
+
+// draws a Zipf distributed integer by rejection-inversion
+long long odbcshell_generate_zipf(ODBCShellGenerateWorker * worker,
+   ODBCShellGenerateColumn * col);
+
+#endif
+/* end of header */
@@ -0,0 +1,480 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-group.c ODBC Shell connection groups
+ */
+#include "odbcshell-group.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-print.h"
+#include "odbcshell-retry.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief frees connection groups
+/// @param cnf      pointer to configuration struct
+void odbcshell_group_free(ODBCShell * cnf)
+{
+   long long        l;
+   ODBCShellGroup * group;
+
+   while (cnf->groups_count > 0)
+   {
+      cnf->groups_count--;
+      group = cnf->groups[cnf->groups_count];
+      for(l = 0; l < group->members_count; l++)
+         free(group->members[l]);
+      free(group->members);
+      free(group->name);
+      free(group);
+   };
+   if ((cnf->groups))
+      free(cnf->groups);
+   cnf->groups = NULL;
+   cnf->group  = NULL;
+
+   return;
+}
+
+
+/// @brief displays connection groups
+/// @param cnf      pointer to configuration struct
+/// @param name     group to display (NULL for all)
+int odbcshell_group_list(ODBCShell * cnf, const char * name)
+{
+   int              idx;
+   long long        i;
+   long long        l;
+   char             rtt[32];
+   const char     * state;
+   ODBCShellConn  * conn;
+   ODBCShellGroup * group;
+
+   if ( ((name)) && (!(odbcshell_group_lookup(cnf, name))) )
+   {
+      odbcshell_error(cnf, "unknown connection group \"%s\"\n", name);
+      return(-1);
+   };
+
+   printf("  Group:     Member:    Role:     RTT (ms):\n");
+   for(i = 0; i < cnf->groups_count; i++)
+   {
+      group = cnf->groups[i];
+      if ( ((name)) && ((strcasecmp(name, group->name))) )
+         continue;
+      for(l = 0; l < group->members_count; l++)
+      {
+         conn  = NULL;
+         state = "-";
+         if ((idx = odbcshell_odbc_array_findindex(cnf, group->members[l])) >= 0)
+            conn = cnf->conns[idx];
+         if (!(conn))
+            state = "closed";
+         else if ((conn->rtt_at))
+         {
+            snprintf(rtt, sizeof(rtt), "%.3f", (double)conn->rtt / 1000.0);
+            state = rtt;
+         };
+         printf("%c %-10s %-10s %-9s %s\n",
+            ((l == 0) && (cnf->group == group)) ? '*' : ' ',
+            (l == 0) ? group->name : "", group->members[l],
+            (l == 0) ? "primary" : "replica", state);
+      };
+   };
+
+   return(0);
+}
+
+
+/// @brief finds connection group by name
+/// @param cnf      pointer to configuration struct
+/// @param name     name of group
+ODBCShellGroup * odbcshell_group_lookup(ODBCShell * cnf, const char * name)
+{
+   long long i;
+
+   for(i = 0; i < cnf->groups_count; i++)
+      if (!(strcasecmp(cnf->groups[i]->name, name)))
+         return(cnf->groups[i]);
+
+   return(NULL);
+}
+
+
+/// @brief measures round trip to a connection without sending a statement
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+int odbcshell_group_probe(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   long long         usecs;
+   SQLRETURN         sts;
+   SQLSMALLINT       len;
+   struct timespec   start;
+   struct timespec   end;
+   char              name[128];
+
+   if ((odbcshell_retry_lost(conn, NULL)))
+   {
+      odbcshell_verbose(cnf, "\"%s\" is not reachable, skipping it\n", conn->name);
+      return(-1);
+   };
+
+   // the catalog name is asked of the server, so the reply measures the link
+   // rather than the cost of the statements previously routed there
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   sts = SQLGetInfo(conn->hdbc, SQL_DATABASE_NAME, name, sizeof(name), &len);
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_verbose(cnf, "unable to measure \"%s\", skipping it\n", conn->name);
+      return(-1);
+   };
+   usecs = (long long)(end.tv_sec - start.tv_sec) * 1000000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000LL;
+   if (usecs < 1)
+      usecs = 1;
+
+   // smooths samples so a single slow reply does not dominate
+   if (!(conn->rtt_at))
+      conn->rtt = usecs;
+   else
+      conn->rtt = ((conn->rtt * 3) + usecs) / 4;
+   conn->rtt_at = time(NULL);
+   odbcshell_verbose(cnf, "round trip to \"%s\" is %.3f ms\n", conn->name,
+      (double)conn->rtt / 1000.0);
+
+   return(0);
+}
+
+
+/// @brief removes connection group
+/// @param cnf      pointer to configuration struct
+/// @param name     name of group
+int odbcshell_group_remove(ODBCShell * cnf, const char * name)
+{
+   long long        i;
+   long long        l;
+   ODBCShellGroup * group;
+
+   for(i = 0; i < cnf->groups_count; i++)
+      if (!(strcasecmp(cnf->groups[i]->name, name)))
+         break;
+   if (i >= cnf->groups_count)
+   {
+      odbcshell_error(cnf, "unknown connection group \"%s\"\n", name);
+      return(-1);
+   };
+
+   group = cnf->groups[i];
+   if (cnf->group == group)
+      cnf->group = NULL;
+   for(l = 0; l < group->members_count; l++)
+      free(group->members[l]);
+   free(group->members);
+   free(group->name);
+   free(group);
+
+   cnf->groups_count--;
+   for(; i < cnf->groups_count; i++)
+      cnf->groups[i] = cnf->groups[i+1];
+
+   return(0);
+}
+
+
+/// @brief selects member of the active group which receives a statement
+/// @param cnf      pointer to configuration struct
+/// @param sql      SQL statement to execute
+int odbcshell_group_route(ODBCShell * cnf, const char * sql)
+{
+   int              idx;
+   long long        l;
+   long long        n;
+   time_t           now;
+   ODBCShellConn  * conn;
+   ODBCShellConn  * best;
+   ODBCShellGroup * group;
+
+   group = cnf->group;
+   odbcshell_group_txn(group, sql);
+
+   // replicas only receive statements which read data outside of a transaction
+   best = NULL;
+   if ( (!(group->txn)) && (group->members_count > 1) &&
+        ((odbcshell_retry_idempotent(sql))) )
+   {
+      now = time(NULL);
+      n   = group->members_count - 1;
+      for(l = 0; l < n; l++)
+      {
+         idx = odbcshell_odbc_array_findindex(cnf, group->members[1 + ((group->next + l) % n)]);
+         if (idx < 0)
+            continue;
+         conn = cnf->conns[idx];
+         if ((conn->job))
+            continue;
+         if (cnf->routing == ODBCSHELL_ROUTING_ROUNDROBIN)
+         {
+            best        = conn;
+            group->next = (group->next + l + 1) % n;
+            break;
+         };
+
+         // members not measured recently are probed before comparing them,
+         // except those not yet dialed which are tried as soon as possible
+         if ( (!(conn->deferred)) &&
+              ( (!(conn->rtt_at)) || ((now - conn->rtt_at) >= ODBCSHELL_RTT_STALE) ) )
+            if ((odbcshell_group_probe(cnf, conn)))
+               continue;
+         if ( (!(best)) || (conn->rtt < best->rtt) )
+            best = conn;
+      };
+   };
+
+   if (!(best))
+   {
+      if ((idx = odbcshell_odbc_array_findindex(cnf, group->members[0])) < 0)
+      {
+         odbcshell_error(cnf, "primary \"%s\" of group \"%s\" is not connected\n",
+            group->members[0], group->name);
+         return(-1);
+      };
+      best = cnf->conns[idx];
+   };
+
+   if (cnf->current != best)
+      odbcshell_verbose(cnf, "routing statement to \"%s\"...\n", best->name);
+   cnf->current = best;
+
+   return(0);
+}
+
+
+/// @brief declares connection group
+/// @param cnf      pointer to configuration struct
+/// @param name     name of group
+/// @param argc     number of connections
+/// @param argv     names of connections (primary first)
+int odbcshell_group_set(ODBCShell * cnf, const char * name, int argc,
+   char ** argv)
+{
+   int              i;
+   int              u;
+   void           * ptr;
+   ODBCShellGroup * group;
+   ODBCShellGroup * old;
+
+   if ((odbcshell_odbc_array_findindex(cnf, name)) >= 0)
+   {
+      odbcshell_error(cnf, "connection with name \"%s\" already exists\n", name);
+      return(-1);
+   };
+   for(i = 0; i < argc; i++)
+   {
+      for(u = 0; u < i; u++)
+      {
+         if (!(strcasecmp(argv[i], argv[u])))
+         {
+            odbcshell_error(cnf, "connection \"%s\" is listed more than once\n", argv[i]);
+            return(-1);
+         };
+      };
+      if ((odbcshell_group_lookup(cnf, argv[i])))
+      {
+         odbcshell_error(cnf, "group \"%s\" may not be a member of a group\n", argv[i]);
+         return(-1);
+      };
+   };
+
+   if (!(group = malloc(sizeof(ODBCShellGroup))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   memset(group, 0, sizeof(ODBCShellGroup));
+   if (!(group->name = strdup(name)))
+   {
+      free(group);
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   if (!(group->members = calloc((size_t)argc, sizeof(char *))))
+   {
+      free(group->name);
+      free(group);
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   for(i = 0; i < argc; i++)
+   {
+      if (!(group->members[i] = strdup(argv[i])))
+      {
+         while(i > 0)
+            free(group->members[--i]);
+         free(group->members);
+         free(group->name);
+         free(group);
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+   };
+   group->members_count = argc;
+
+   // replaces an existing group of the same name
+   if ((old = odbcshell_group_lookup(cnf, name)))
+   {
+      for(i = 0; ((cnf->groups[i] != old)); i++);
+      if (cnf->group == old)
+         cnf->group = group;
+      cnf->groups[i] = group;
+      for(i = 0; i < old->members_count; i++)
+         free(old->members[i]);
+      free(old->members);
+      free(old->name);
+      free(old);
+      return(0);
+   };
+
+   if (!(ptr = realloc(cnf->groups, sizeof(ODBCShellGroup *) * (size_t)(cnf->groups_count+1))))
+   {
+      for(i = 0; i < argc; i++)
+         free(group->members[i]);
+      free(group->members);
+      free(group->name);
+      free(group);
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   cnf->groups = ptr;
+   cnf->groups[cnf->groups_count] = group;
+   cnf->groups_count++;
+
+   return(0);
+}
+
+
+/// @brief tracks transactions which pin statements to the primary
+/// @param group    pointer to connection group
+/// @param sql      SQL statement to execute
+void odbcshell_group_txn(ODBCShellGroup * group, const char * sql)
+{
+   size_t len;
+
+   while (isspace((unsigned char)sql[0]))
+      sql++;
+   for(len = 0; (isalpha((unsigned char)sql[len])); len++);
+
+   if ( ((len == 5) && (!(strncasecmp(sql, "BEGIN", 5)))) ||
+        ((len == 5) && (!(strncasecmp(sql, "START", 5)))) )
+   {
+      group->txn = 1;
+      return;
+   };
+
+   if ( ((len == 6) && (!(strncasecmp(sql, "COMMIT", 6)))) ||
+        ((len == 3) && (!(strncasecmp(sql, "END", 3)))) )
+   {
+      group->txn = 0;
+      return;
+   };
+
+   // rolling back to a savepoint leaves the transaction open
+   if ( (len == 8) && (!(strncasecmp(sql, "ROLLBACK", 8))) )
+   {
+      for(sql += len; (isspace((unsigned char)sql[0])); sql++);
+      for(len = 0; (isalpha((unsigned char)sql[len])); len++);
+      if ( (len == 4) && (!(strncasecmp(sql, "WORK", 4))) )
+         for(sql += len; (isspace((unsigned char)sql[0])); sql++);
+      if (strncasecmp(sql, "TO", 2))
+         group->txn = 0;
+   };
+
+   return;
+}
+
+
+/// @brief switches to connection group
+/// @param cnf      pointer to configuration struct
+/// @param name     name of group
+int odbcshell_group_use(ODBCShell * cnf, const char * name)
+{
+   int              idx;
+   ODBCShellGroup * group;
+
+   if (!(group = odbcshell_group_lookup(cnf, name)))
+   {
+      odbcshell_error(cnf, "use: unknown connection handle\n");
+      return(-1);
+   };
+   if ((idx = odbcshell_odbc_array_findindex(cnf, group->members[0])) < 0)
+   {
+      odbcshell_error(cnf, "primary \"%s\" of group \"%s\" is not connected\n",
+         group->members[0], group->name);
+      return(-1);
+   };
+
+   cnf->group   = group;
+   cnf->current = cnf->conns[idx];
+   odbcshell_printf(cnf, "using group \"%s\"\n", group->name);
+
+   return(0);
+}
+
+/* end of source */
@@ -0,0 +1,91 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-group.h ODBC Shell connection groups
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_GROUP_H
+#define _ODBCSHELL_SRC_ODBCSHELL_GROUP_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// frees connection groups
+void odbcshell_group_free(ODBCShell * cnf);
+
+// displays connection groups
+int odbcshell_group_list(ODBCShell * cnf, const char * name);
+
+// finds connection group by name
+ODBCShellGroup * odbcshell_group_lookup(ODBCShell * cnf, const char * name);
+
+// measures round trip to a connection without sending a statement
+int odbcshell_group_probe(ODBCShell * cnf, ODBCShellConn * conn);
+
+// removes connection group
+int odbcshell_group_remove(ODBCShell * cnf, const char * name);
+
+// selects member of the active group which receives a statement
+int odbcshell_group_route(ODBCShell * cnf, const char * sql);
+
+// declares connection group
+int odbcshell_group_set(ODBCShell * cnf, const char * name, int argc,
+   char ** argv);
+
+// tracks transactions which pin statements to the primary
+void odbcshell_group_txn(ODBCShellGroup * group, const char * sql);
+
+// switches to connection group
+int odbcshell_group_use(ODBCShell * cnf, const char * name);
+
+#endif
+/* end of header */
@@ -0,0 +1,777 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-import.c ODBC Shell loads a delimited file in byte ranges
+ */
+#include "odbcshell-import.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief finds the first record starting at or after an offset
+/// @param cnf      pointer to configuration struct
+/// @param import   pointer to import state
+/// @param fs       stream reading file
+/// @param offset   offset within file
+/// @param startp   pointer to offset of record
+int odbcshell_import_align(ODBCShell * cnf, ODBCShellImport * import,
+   FILE * fs, long long offset, long long * startp)
+{
+   int          c;
+   int          fields;
+   long long    l;
+   long long    start;
+   const char * msg;
+
+   if (!(offset))
+   {
+      (*startp) = 0;
+      return(0);
+   };
+
+   // offset is a boundary if the preceding character ends a record
+   if ((fseeko(fs, (off_t)(offset - 1), SEEK_SET)))
+   {
+      odbcshell_error(cnf, "%s: %s\n", import->path, strerror(errno));
+      return(-1);
+   };
+
+   while(1)
+   {
+      while ( ((c = getc_unlocked(fs)) != EOF) && (c != '\n') );
+      if (c == EOF)
+      {
+         (*startp) = import->size;
+         return(0);
+      };
+      start = (long long)ftello(fs);
+
+      // a line break within a quoted value is not followed by records of
+      // the expected number of values, so the next line break is tried
+      fields = 0;
+      for(l = 0; l < ODBCSHELL_IMPORT_PROBE; l++)
+      {
+         if ((fields = odbcshell_import_parse(import, fs, NULL, &msg)) < 1)
+            break;
+         if ((long long)fields != import->col_count)
+            break;
+      };
+      if ( (l == ODBCSHELL_IMPORT_PROBE) || (!(fields)) )
+      {
+         (*startp) = start;
+         return(0);
+      };
+
+      if ((fseeko(fs, (off_t)start, SEEK_SET)))
+      {
+         odbcshell_error(cnf, "%s: %s\n", import->path, strerror(errno));
+         return(-1);
+      };
+   };
+
+   return(0);
+}
+
+
+/// @brief binds parameters of insert to a record of a block
+/// @param shard    pointer to range
+/// @param row      first record bound (0 when binding arrays)
+int odbcshell_import_bind(ODBCShellImportShard * shard, SQLULEN row)
+{
+   long long         col;
+   SQLULEN           idx;
+   SQLRETURN         sts;
+   ODBCShellImport * import;
+
+   import = shard->import;
+   for(col = 0; col < import->col_count; col++)
+   {
+      idx = ((SQLULEN)col * import->batch) + row;
+      sts = SQLBindParameter(shard->stmt->hstmt, (SQLUSMALLINT)(col+1),
+         SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, ODBCSHELL_IMPORT_WIDTH - 1, 0,
+         &shard->data[idx * ODBCSHELL_IMPORT_WIDTH], ODBCSHELL_IMPORT_WIDTH,
+         &shard->ind[idx]);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLBindParameter", &shard->cnf, shard->stmt);
+         return(-1);
+      };
+   };
+
+   return(0);
+}
+
+
+/// @brief commits or rolls back rows inserted by a range
+/// @param shard       pointer to range
+/// @param completion  SQL_COMMIT or SQL_ROLLBACK
+int odbcshell_import_end(ODBCShellImportShard * shard, SQLSMALLINT completion)
+{
+   SQLRETURN sts;
+
+   sts = SQLEndTran(SQL_HANDLE_DBC, shard->conn->hdbc, completion);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_diag("SQLEndTran", &shard->cnf, shard->conn->hdbc, NULL);
+      return(-1);
+   };
+   if (completion == SQL_COMMIT)
+      shard->committed = shard->rows;
+
+   return(0);
+}
+
+
+/// @brief frees resources used by import
+/// @param import   pointer to import state
+void odbcshell_import_free(ODBCShellImport * import)
+{
+   long long              l;
+   ODBCShellImportShard * shard;
+
+   for(l = 0; ( ((import->shards)) && (l < import->count) ); l++)
+   {
+      shard = &import->shards[l];
+      if ((shard->errs))
+         fclose(shard->errs);
+      free(shard->err);
+      free(shard->data);
+      free(shard->ind);
+      free(shard->offsets);
+   };
+   free(import->shards);
+   free(import->insert);
+   import->shards = NULL;
+   import->insert = NULL;
+   import->count  = 0;
+
+   return;
+}
+
+
+/// @brief inserts every record of a range
+/// @param shard    pointer to range
+int odbcshell_import_load(ODBCShellImportShard * shard)
+{
+   int               err;
+   int               fields;
+   long long         pos;
+   long long         pending;
+   const char      * msg;
+   SQLRETURN         sts;
+   FILE            * fs;
+   ODBCShell       * cnf;
+   ODBCShellImport * import;
+   char              name[64];
+
+   cnf    = &shard->cnf;
+   import = shard->import;
+
+   if (!(shard->conn))
+   {
+      snprintf(name, sizeof(name), "import-%lld", shard->id);
+      if ((err = odbcshell_odbc_open(cnf, import->dsn, name, &shard->conn)))
+         return(err);
+   };
+
+   // each range reads the file through its own stream
+   if (!(fs = fopen(import->path, "r")))
+   {
+      odbcshell_error(cnf, "%s: %s\n", import->path, strerror(errno));
+      return(-1);
+   };
+   if ((fseeko(fs, (off_t)shard->start, SEEK_SET)))
+   {
+      odbcshell_error(cnf, "%s: %s\n", import->path, strerror(errno));
+      fclose(fs);
+      return(-1);
+   };
+
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, shard->conn, &shard->stmt)))
+   {
+      fclose(fs);
+      return(err);
+   };
+   odbcshell_odbc_stmt_timeout(cnf, shard->conn, shard->stmt);
+   sts = SQLPrepare(shard->stmt->hstmt, (SQLTCHAR *)import->insert, SQL_NTS);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_stmt_errors("SQLPrepare", cnf, shard->stmt);
+      odbcshell_odbc_stmt_release(cnf, &shard->stmt);
+      fclose(fs);
+      return(-1);
+   };
+
+   // drivers without arrays of parameters receive one row at a time
+   sts = SQLSetStmtAttr(shard->stmt->hstmt, SQL_ATTR_PARAM_BIND_TYPE,
+      (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, SQL_IS_UINTEGER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(shard->stmt->hstmt, SQL_ATTR_PARAMSET_SIZE,
+         (SQLPOINTER)import->batch, SQL_IS_UINTEGER);
+   shard->arrays = ((SQL_SUCCEEDED(sts))) ? 1 : 0;
+
+   // rows of a range are committed together unless an interval was given
+   sts = SQLSetConnectAttr(shard->conn->hdbc, SQL_ATTR_AUTOCOMMIT,
+      (SQLPOINTER)SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_odbc_diag("SQLSetConnectAttr", cnf, shard->conn->hdbc, NULL);
+      odbcshell_odbc_stmt_release(cnf, &shard->stmt);
+      fclose(fs);
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "loading bytes %lld-%lld of \"%s\"...\n",
+      shard->start, shard->end, import->path);
+
+   pos = shard->start;
+   if ( (!(pos)) && ((import->header)) )
+   {
+      odbcshell_import_parse(import, fs, NULL, &msg);
+      pos = (long long)ftello(fs);
+   };
+
+   // blocks are written when full or when they complete a commit interval
+   while ( (!(err)) && (pos < shard->end) )
+   {
+      shard->offsets[shard->count] = pos;
+      if (!(fields = odbcshell_import_parse(import, fs, shard, &msg)))
+         break;
+      if (fields < 0)
+      {
+         odbcshell_error(cnf, "%s: %s at byte %lld\n", import->path, msg, pos);
+         shard->failed = pos;
+         err = -1;
+         break;
+      };
+      if ((long long)fields != import->col_count)
+      {
+         odbcshell_error(cnf, "%s: record at byte %lld has %i values instead of %lld\n",
+            import->path, pos, fields, import->col_count);
+         shard->failed = pos;
+         err = -1;
+         break;
+      };
+      shard->count++;
+      pos = (long long)ftello(fs);
+
+      pending = shard->rows + (long long)shard->count - shard->committed;
+      if ( (shard->count == import->batch) || ( ((import->commit)) && (pending >= import->commit) ) )
+         err = odbcshell_import_write(shard);
+      if ( (!(err)) && ((import->commit)) && ((shard->rows - shard->committed) >= import->commit) )
+         err = odbcshell_import_end(shard, SQL_COMMIT);
+   };
+   if ( (!(err)) && ((ferror(fs))) )
+   {
+      odbcshell_error(cnf, "%s: %s\n", import->path, strerror(errno));
+      err = -1;
+   };
+   fclose(fs);
+
+   if (!(err))
+      err = odbcshell_import_write(shard);
+   if (!(err))
+      err = odbcshell_import_end(shard, SQL_COMMIT);
+   if ((err))
+      odbcshell_import_end(shard, SQL_ROLLBACK);
+
+   SQLSetConnectAttr(shard->conn->hdbc, SQL_ATTR_AUTOCOMMIT,
+      (SQLPOINTER)SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
+   odbcshell_odbc_stmt_release(cnf, &shard->stmt);
+
+   return(err);
+}
+
+
+/// @brief reads one record, storing its values in the next row of a block
+/// @param import   pointer to import state
+/// @param fs       stream reading file
+/// @param shard    range receiving values (NULL to only count values)
+/// @param errp     pointer to description of malformed record
+/// @return number of values, 0 at end of file, or -1 if record is malformed
+int odbcshell_import_parse(ODBCShellImport * import, FILE * fs,
+   ODBCShellImportShard * shard, const char ** errp)
+{
+   int       c;
+   int       quoted;
+   int       fields;
+   SQLLEN    len;
+   SQLULEN   idx;
+   char    * value;
+
+   // stream is private to the calling thread
+   if ((c = getc_unlocked(fs)) == EOF)
+      return(0);
+
+   fields = 0;
+   while(1)
+   {
+      value = NULL;
+      idx   = 0;
+      if ((shard))
+      {
+         if ((long long)fields >= import->col_count)
+         {
+            (*errp) = "record has too many values";
+            return(-1);
+         };
+         idx   = ((SQLULEN)fields * import->batch) + shard->count;
+         value = &shard->data[idx * ODBCSHELL_IMPORT_WIDTH];
+      };
+      fields++;
+      len    = 0;
+      quoted = (c == '"') ? 1 : 0;
+      if ((quoted))
+         c = getc_unlocked(fs);
+
+      while(1)
+      {
+         if ((quoted))
+         {
+            if (c == EOF)
+            {
+               (*errp) = "quoted value is not terminated";
+               return(-1);
+            };
+            // doubled quotes stand for one quote within a quoted value
+            if ( (c == '"') && ((c = getc_unlocked(fs)) != '"') )
+               break;
+         }
+         else
+         {
+            if ( (c == EOF) || (c == '\n') || (c == import->delimiter) )
+               break;
+            if (c == '"')
+            {
+               (*errp) = "quote within unquoted value";
+               return(-1);
+            };
+            if (c == '\r')
+            {
+               if ((c = getc_unlocked(fs)) == '\n')
+                  break;
+               ungetc(c, fs);
+               c = '\r';
+            };
+         };
+         if (len >= (ODBCSHELL_IMPORT_WIDTH - 1))
+         {
+            (*errp) = "value is too long";
+            return(-1);
+         };
+         if ((value))
+            value[len] = (char)c;
+         len++;
+         c = getc_unlocked(fs);
+      };
+
+      // closing quote must end the value
+      if ( ((quoted)) && (c == '\r') )
+         c = getc_unlocked(fs);
+      if ( ((quoted)) && (c != EOF) && (c != '\n') && (c != import->delimiter) )
+      {
+         (*errp) = "unexpected character after quoted value";
+         return(-1);
+      };
+
+      // empty values are loaded as NULL unless quoted
+      if ((value))
+      {
+         value[len]      = '\0';
+         shard->ind[idx] = ( ((quoted)) || ((len)) ) ? len : SQL_NULL_DATA;
+      };
+
+      if (c != import->delimiter)
+         break;
+      c = getc_unlocked(fs);
+   };
+
+   return(fields);
+}
+
+
+/// @brief loads a delimited file into a table over several connections
+/// @param cnf       pointer to configuration struct
+/// @param path      file being loaded
+/// @param table     table receiving rows, optionally followed by list of columns
+/// @param jobs      most ranges loaded at once
+/// @param commit    rows inserted between commits (0 for once per range)
+/// @param batch     records passed in each block
+/// @param delimiter character separating values
+/// @param header    toggle set if first record names columns
+int odbcshell_import_run(ODBCShell * cnf, const char * path,
+   const char * table, long long jobs, long long commit, long long batch,
+   int delimiter, int header)
+{
+   int                    err;
+   int                    code;
+   int                    fields;
+   long long              l;
+   long long              count;
+   long long              started;
+   long long              rows;
+   long long              failed;
+   long long              msecs;
+   long long            * starts;
+   size_t                 len;
+   SQLULEN                max;
+   const char           * msg;
+   sigset_t               oldset;
+   pthread_t            * tids;
+   struct timespec        start;
+   struct timespec        end;
+   FILE                 * fs;
+   ODBCShellImport        import;
+   ODBCShellImportShard * shard;
+   char                   name[64];
+
+   if ( (jobs < 1) || (jobs > ODBCSHELL_IMPORT_SHARDS) )
+   {
+      odbcshell_error(cnf, "number of connections must be between 1 and %i\n", ODBCSHELL_IMPORT_SHARDS);
+      return(-1);
+   };
+   if ((err = odbcshell_odbc_ready(cnf)))
+      return(err);
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   memset(&import, 0, sizeof(ODBCShellImport));
+   import.path      = path;
+   import.dsn       = cnf->current->dsn;
+   import.delimiter = delimiter;
+   import.header    = header;
+   import.commit    = commit;
+
+   if (!(fs = fopen(path, "r")))
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      return(-1);
+   };
+   if ( ((fseeko(fs, 0, SEEK_END))) || ((import.size = (long long)ftello(fs)) < 0) ||
+        ((fseeko(fs, 0, SEEK_SET))) )
+   {
+      odbcshell_error(cnf, "%s: %s\n", path, strerror(errno));
+      fclose(fs);
+      return(-1);
+   };
+
+   // values in each record are counted in the first record
+   if ((fields = odbcshell_import_parse(&import, fs, NULL, &msg)) < 1)
+   {
+      if (fields < 0)
+         odbcshell_error(cnf, "%s: %s at byte 0\n", path, msg);
+      else
+         odbcshell_error(cnf, "%s: file is empty\n", path);
+      fclose(fs);
+      return(-1);
+   };
+   import.col_count = fields;
+
+   // limits memory held by each block; blocks never span a commit
+   max = (SQLULEN)(ODBCSHELL_FETCH_BYTES / ((size_t)import.col_count *
+         (ODBCSHELL_IMPORT_WIDTH + sizeof(SQLLEN)) + sizeof(long long)));
+   import.batch = (SQLULEN)batch;
+   if (import.batch > max)
+      import.batch = max;
+   if ( ((commit)) && (import.batch > (SQLULEN)commit) )
+      import.batch = (SQLULEN)commit;
+   if (import.batch < 1)
+      import.batch = 1;
+
+   len = strlen("INSERT INTO  VALUES ()") + strlen(table) + (size_t)(import.col_count * 2) + 1;
+   if (!(import.insert = malloc(len)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      fclose(fs);
+      return(-2);
+   };
+   snprintf(import.insert, len, "INSERT INTO %s VALUES (", table);
+   for(l = 0; l < import.col_count; l++)
+      strcat(import.insert, ((l)) ? ",?" : "?");
+   strcat(import.insert, ")");
+
+   // file is divided into ranges of equal size whose starts are moved
+   // forward to the next record
+   count = import.size / ODBCSHELL_IMPORT_BYTES;
+   if (count > jobs)
+      count = jobs;
+   if (count < 1)
+      count = 1;
+   if (!(starts = calloc((size_t)count + 1, sizeof(long long))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_import_free(&import);
+      fclose(fs);
+      return(-2);
+   };
+   code = 0;
+   for(l = 0; ( (!(code)) && (l < count) ); l++)
+   {
+      code = odbcshell_import_align(cnf, &import, fs, (import.size / count) * l, &starts[l]);
+      if ( (l > 0) && (starts[l] < starts[l-1]) )
+         starts[l] = starts[l-1];
+   };
+   starts[count] = import.size;
+   fclose(fs);
+   if ((code))
+   {
+      free(starts);
+      odbcshell_import_free(&import);
+      return(code);
+   };
+
+   // ranges left empty by long records are dropped
+   if (!(import.shards = calloc((size_t)count, sizeof(ODBCShellImportShard))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      free(starts);
+      odbcshell_import_free(&import);
+      return(-2);
+   };
+   for(l = 0; l < count; l++)
+   {
+      if (starts[l] == starts[l+1])
+         continue;
+      shard         = &import.shards[import.count];
+      shard->id     = import.count + 1;
+      shard->start  = starts[l];
+      shard->end    = starts[l+1];
+      shard->failed = -1;
+      shard->import = &import;
+      import.count++;
+   };
+   free(starts);
+
+   for(l = 0; ( (!(code)) && (l < import.count) ); l++)
+   {
+      shard          = &import.shards[l];
+      shard->data    = malloc((size_t)import.col_count * import.batch * ODBCSHELL_IMPORT_WIDTH);
+      shard->ind     = malloc(sizeof(SQLLEN) * (size_t)import.col_count * import.batch);
+      shard->offsets = malloc(sizeof(long long) * import.batch);
+      shard->errs    = open_memstream(&shard->err, &shard->errlen);
+      if ( (!(shard->data)) || (!(shard->ind)) || (!(shard->offsets)) || (!(shard->errs)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // idle connections to the data source are handed to ranges
+      snprintf(name, sizeof(name), "import-%lld", shard->id);
+      if ((code = odbcshell_pool_take(cnf, import.dsn, name, &shard->conn)))
+         break;
+
+      // messages of each range are reported together once all finish
+      odbcshell_clone(cnf, &shard->cnf, shard->errs, shard->errs);
+   };
+
+   tids = NULL;
+   if ( (!(code)) && (!(tids = calloc((size_t)import.count, sizeof(pthread_t)))) )
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      code = -2;
+   };
+   if (!(code))
+   {
+      odbcshell_verbose(cnf, "loading %lld values per record in %lld ranges, %lu records per block...\n",
+         import.col_count, import.count, (unsigned long)import.batch);
+      odbcshell_signal_block(&oldset);
+      for(started = 0; started < import.count; started++)
+         if ((pthread_create(&tids[started], NULL, odbcshell_import_thread, &import.shards[started])))
+            break;
+      odbcshell_signal_restore(&oldset);
+
+      // ranges which could not be given a thread are loaded in turn
+      for(l = started; l < import.count; l++)
+         odbcshell_import_thread(&import.shards[l]);
+      for(l = 0; l < started; l++)
+         pthread_join(tids[l], NULL);
+   };
+   free(tids);
+
+   // messages of each range are reported in the order of the file
+   rows   = 0;
+   failed = 0;
+   for(l = 0; l < import.count; l++)
+   {
+      shard = &import.shards[l];
+      if ((shard->errs))
+         fclose(shard->errs);
+      shard->errs = NULL;
+      if ((shard->errlen))
+         fwrite(shard->err, 1, shard->errlen, ((cnf->errs)) ? cnf->errs : stderr);
+      if ((shard->conn))
+      {
+         if ((shard->code))
+            odbcshell_odbc_free(cnf, &shard->conn);
+         else
+            odbcshell_pool_put(cnf, &shard->conn);
+      };
+      if ((code))
+         continue;
+      rows += shard->committed;
+      if (!(shard->code))
+      {
+         odbcshell_verbose(cnf, "range %lld (bytes %lld-%lld): %lld rows in %lld ms\n",
+            shard->id, shard->start, shard->end, shard->rows, shard->msecs);
+         continue;
+      };
+      failed++;
+      if (shard->failed != -1)
+         odbcshell_error(cnf, "range %lld (bytes %lld-%lld) failed at byte %lld, %lld rows committed\n",
+            shard->id, shard->start, shard->end, shard->failed, shard->committed);
+      else
+         odbcshell_error(cnf, "range %lld (bytes %lld-%lld) failed, %lld rows committed\n",
+            shard->id, shard->start, shard->end, shard->committed);
+   };
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   if ( (!(code)) && (!(failed)) )
+      odbcshell_printf(cnf, "imported %lld rows from \"%s\" over %lld connections in %lld ms.\n",
+         rows, path, import.count, msecs);
+   else if (!(code))
+   {
+      odbcshell_error(cnf, "%lld of %lld ranges failed, %lld rows committed\n",
+         failed, import.count, rows);
+      code = -1;
+   };
+
+   odbcshell_import_free(&import);
+
+   return(code);
+}
+
+
+/// @brief worker thread loading one range
+/// @param ptr      pointer to range
+void * odbcshell_import_thread(void * ptr)
+{
+   struct timespec        start;
+   struct timespec        end;
+   ODBCShellImportShard * shard;
+
+   shard = ptr;
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   shard->code  = odbcshell_import_load(shard);
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   shard->msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+                + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   fflush(shard->errs);
+
+   return(NULL);
+}
+
+
+/// @brief inserts records held in block
+/// @param shard    pointer to range
+int odbcshell_import_write(ODBCShellImportShard * shard)
+{
+   int       err;
+   SQLULEN   row;
+   SQLULEN   done;
+   SQLRETURN sts;
+
+   if (!(shard->count))
+      return(0);
+
+   // only rows accepted by the driver are counted, the first rejected row
+   // is reported with its offset in the file
+   if ((shard->arrays))
+   {
+      if ((err = odbcshell_import_bind(shard, 0)))
+         return(err);
+      err = odbcshell_odbc_params_exec(&shard->cnf, shard->stmt,
+         shard->count, &done, &row);
+      shard->rows += (long long)done;
+      if ((err))
+      {
+         shard->failed = shard->offsets[row];
+         return(err);
+      };
+      shard->count = 0;
+      return(0);
+   };
+
+   for(row = 0; row < shard->count; row++)
+   {
+      if ((err = odbcshell_import_bind(shard, row)))
+         return(err);
+      sts = SQLExecute(shard->stmt->hstmt);
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLExecute", &shard->cnf, shard->stmt);
+         shard->failed = shard->offsets[row];
+         return(-1);
+      };
+      shard->rows++;
+   };
+   shard->count = 0;
+
+   return(0);
+}
+
+/* end of source */
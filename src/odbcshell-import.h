@@ -0,0 +1,94 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-import.h ODBC Shell loads a delimited file in byte ranges
+ */
+#ifndef _ODBCSHELL_SRC_ODBCSHELL_IMPORT_H
+#define _ODBCSHELL_SRC_ODBCSHELL_IMPORT_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// finds the first record starting at or after an offset
+int odbcshell_import_align(ODBCShell * cnf, ODBCShellImport * import,
+   FILE * fs, long long offset, long long * startp);
+
+// binds parameters of insert to a record of a block
+int odbcshell_import_bind(ODBCShellImportShard * shard, SQLULEN row);
+
+// commits or rolls back rows inserted by a range
+int odbcshell_import_end(ODBCShellImportShard * shard, SQLSMALLINT completion);
+
+// frees resources used by import
+void odbcshell_import_free(ODBCShellImport * import);
+
+// inserts every record of a range
+int odbcshell_import_load(ODBCShellImportShard * shard);
+
+// reads one record, storing its values in the next row of a block
+int odbcshell_import_parse(ODBCShellImport * import, FILE * fs,
+   ODBCShellImportShard * shard, const char ** errp);
+
+// loads a delimited file into a table over several connections
+int odbcshell_import_run(ODBCShell * cnf, const char * path,
+   const char * table, long long jobs, long long commit, long long batch,
+   int delimiter, int header);
+
+// worker thread loading one range
+void * odbcshell_import_thread(void * ptr);
+
+// inserts records held in block
+int odbcshell_import_write(ODBCShellImportShard * shard);
+
+#endif
+/* end of header */
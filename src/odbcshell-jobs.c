@@ -0,0 +1,403 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-jobs.c ODBC Shell background jobs
+ */
+#include "odbcshell-jobs.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// tests if a background job has completed
+int odbcshell_job_isdone(ODBCShellJob * job);
+
+// removes background job from list
+int odbcshell_job_remove(ODBCShell * cnf, ODBCShellJob * job);
+
+// displays results and status of a completed background job
+void odbcshell_job_report(ODBCShell * cnf, ODBCShellJob * job);
+
+// worker thread for background job
+void * odbcshell_job_thread(void * ptr);
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief cancels and frees all background jobs
+/// @param cnf      pointer to configuration struct
+int odbcshell_job_close(ODBCShell * cnf)
+{
+   long long l;
+
+   for(l = 0; l < cnf->jobs_count; l++)
+   {
+      if (!(odbcshell_job_isdone(cnf->jobs[l])))
+      {
+         odbcshell_verbose(cnf, "cancelling job %lld...\n", cnf->jobs[l]->id);
+         SQLCancel(cnf->jobs[l]->conn->stmt->hstmt);
+      };
+      odbcshell_job_free(cnf, &cnf->jobs[l]);
+   };
+   free(cnf->jobs);
+   cnf->jobs       = NULL;
+   cnf->jobs_count = 0;
+
+   return(0);
+}
+
+
+/// @brief frees resources from a background job
+/// @param cnf      pointer to configuration struct
+/// @param jobp     pointer to pointer to job struct
+void odbcshell_job_free(ODBCShell * cnf, ODBCShellJob ** jobp)
+{
+   if ( (!(jobp)) || (!(*jobp)) )
+      return;
+
+   odbcshell_verbose(cnf, "freeing job %lld...\n", (*jobp)->id);
+
+   // worker thread still references the job until it exits
+   if ((*jobp)->joinable)
+      pthread_join((*jobp)->thread, NULL);
+   (*jobp)->joinable = 0;
+   pthread_mutex_destroy(&(*jobp)->lock);
+
+   if ((*jobp)->conn)
+      (*jobp)->conn->job = NULL;
+   (*jobp)->conn = NULL;
+
+   if ((*jobp)->output)
+      fclose((*jobp)->output);
+   (*jobp)->output = NULL;
+
+   if ((*jobp)->buff)
+      free((*jobp)->buff);
+   (*jobp)->buff = NULL;
+
+   if ((*jobp)->sql)
+      free((*jobp)->sql);
+   (*jobp)->sql = NULL;
+
+   if ((*jobp)->cnf)
+      free((*jobp)->cnf);
+   (*jobp)->cnf = NULL;
+
+   free(*jobp);
+   (*jobp) = NULL;
+
+   return;
+}
+
+
+/// @brief tests if a background job has completed
+/// @param job      pointer to job struct
+int odbcshell_job_isdone(ODBCShellJob * job)
+{
+   int done;
+   pthread_mutex_lock(&job->lock);
+   done = job->done;
+   pthread_mutex_unlock(&job->lock);
+   return(done);
+}
+
+
+/// @brief displays list of background jobs
+/// @param cnf      pointer to configuration struct
+int odbcshell_job_list(ODBCShell * cnf)
+{
+   long long      l;
+   time_t         finished;
+   const char   * state;
+   ODBCShellJob * job;
+
+   if (!(cnf->jobs_count))
+   {
+      printf("no background jobs\n");
+      return(0);
+   };
+
+   printf("  Job:  State:     Time:  Name:      SQL:\n");
+   for(l = 0; l < cnf->jobs_count; l++)
+   {
+      job = cnf->jobs[l];
+      pthread_mutex_lock(&job->lock);
+      state    = (!(job->done)) ? "running" : ((job->code) ? "failed" : "done");
+      finished = (!(job->done)) ? time(NULL) : job->finished;
+      pthread_mutex_unlock(&job->lock);
+      printf("  [%lld]   %-10s %5lds  %-10s %s\n", job->id, state,
+         (long)(finished - job->started), job->conn->name, job->sql);
+   };
+
+   return(0);
+}
+
+
+/// @brief reports and removes background jobs which have completed
+/// @param cnf      pointer to configuration struct
+int odbcshell_job_notify(ODBCShell * cnf)
+{
+   long long      l;
+   ODBCShellJob * job;
+
+   for(l = 0; l < cnf->jobs_count; l++)
+   {
+      if (!(odbcshell_job_isdone(cnf->jobs[l])))
+         continue;
+      job = cnf->jobs[l];
+      odbcshell_job_report(cnf, job);
+      odbcshell_job_remove(cnf, job);
+      odbcshell_job_free(cnf, &job);
+      l--;
+   };
+
+   return(0);
+}
+
+
+/// @brief removes background job from list
+/// @param cnf      pointer to configuration struct
+/// @param job      pointer to job struct
+int odbcshell_job_remove(ODBCShell * cnf, ODBCShellJob * job)
+{
+   long long l;
+
+   for(l = 0; l < cnf->jobs_count; l++)
+      if (cnf->jobs[l] == job)
+         break;
+   if (l >= cnf->jobs_count)
+      return(0);
+
+   for(l = l+1; l < cnf->jobs_count; l++)
+      cnf->jobs[l-1] = cnf->jobs[l];
+
+   cnf->jobs_count--;
+
+   return(0);
+}
+
+
+/// @brief displays results and status of a completed background job
+/// @param cnf      pointer to configuration struct
+/// @param job      pointer to job struct
+void odbcshell_job_report(ODBCShell * cnf, ODBCShellJob * job)
+{
+   fflush(job->output);
+   if ((job->bufflen))
+      fwrite(job->buff, 1, job->bufflen, cnf->output ? cnf->output : stdout);
+   odbcshell_printf(cnf, "[%lld] %s (%lds) %s\n", job->id,
+      (job->code) ? "failed" : "done",
+      (long)(job->finished - job->started), job->sql);
+   return;
+}
+
+
+/// @brief executes SQL statement in the background on the current connection
+/// @param cnf      pointer to configuration struct
+/// @param sql      SQL statement to execute
+int odbcshell_job_start(ODBCShell * cnf, const char * sql)
+{
+   int            err;
+   void         * ptr;
+   size_t         len;
+   sigset_t       oldset;
+   ODBCShellJob * job;
+
+   if ((err = odbcshell_odbc_ready(cnf)))
+      return(err);
+
+   // allocates memory for storing job information
+   if (!(job = malloc(sizeof(ODBCShellJob))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   memset(job, 0, sizeof(ODBCShellJob));
+   pthread_mutex_init(&job->lock, NULL);
+   if (!(job->sql = strdup(sql)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_job_free(cnf, &job);
+      return(-2);
+   };
+   for(len = strlen(job->sql); ((len > 0) && (strchr(" \t\r\n", job->sql[len-1]))); len--)
+      job->sql[len-1] = '\0';
+   if (!(job->output = open_memstream(&job->buff, &job->bufflen)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_job_free(cnf, &job);
+      return(-2);
+   };
+
+   // results and messages are captured instead of interleaving with the
+   // prompt; the job keeps the connection it was started on
+   if (!(job->cnf = malloc(sizeof(ODBCShell))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_job_free(cnf, &job);
+      return(-2);
+   };
+   odbcshell_clone(cnf, job->cnf, job->output, job->output);
+   job->cnf->errs    = cnf->errs;
+   job->cnf->current = cnf->current;
+
+   // adds job to array
+   if (!(ptr = realloc(cnf->jobs, sizeof(ODBCShellJob *) * (cnf->jobs_count+1))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_job_free(cnf, &job);
+      return(-2);
+   };
+   cnf->jobs = ptr;
+   cnf->jobs[cnf->jobs_count] = job;
+   cnf->jobs_count++;
+
+   // reserves connection and starts worker
+   job->id         = ++cnf->jobs_seq;
+   job->conn       = cnf->current;
+   job->conn->job  = job;
+   job->started    = time(NULL);
+   odbcshell_signal_block(&oldset);
+   err = pthread_create(&job->thread, NULL, odbcshell_job_thread, job);
+   odbcshell_signal_restore(&oldset);
+   if ((err))
+   {
+      odbcshell_error(cnf, "unable to start job: %s\n", strerror(err));
+      odbcshell_job_remove(cnf, job);
+      odbcshell_job_free(cnf, &job);
+      return(-1);
+   };
+   job->joinable = 1;
+
+   odbcshell_printf(cnf, "[%lld] started on connection \"%s\"\n", job->id,
+      job->conn->name);
+
+   return(0);
+}
+
+
+/// @brief worker thread for background job
+/// @param ptr      pointer to job struct
+void * odbcshell_job_thread(void * ptr)
+{
+   int            code;
+   ODBCShellJob * job;
+
+   job  = ptr;
+   code = odbcshell_odbc_exec(job->cnf, job->sql);
+   fflush(job->output);
+
+   pthread_mutex_lock(&job->lock);
+   job->code     = code;
+   job->finished = time(NULL);
+   job->done     = 1;
+   pthread_mutex_unlock(&job->lock);
+
+   return(NULL);
+}
+
+
+/// @brief waits for a background job to complete
+/// @param cnf      pointer to configuration struct
+/// @param id       job number to wait on, or zero for all jobs
+int odbcshell_job_wait(ODBCShell * cnf, long long id)
+{
+   int            code;
+   long long      l;
+   ODBCShellJob * job;
+
+   code = 0;
+
+   for(l = 0; l < cnf->jobs_count; l++)
+   {
+      job = cnf->jobs[l];
+      if ( ((id)) && (job->id != id) )
+         continue;
+      pthread_join(job->thread, NULL);
+      job->joinable = 0;
+      if ((job->code))
+         code = -1;
+      odbcshell_job_report(cnf, job);
+      odbcshell_job_remove(cnf, job);
+      odbcshell_job_free(cnf, &job);
+      if ((id))
+         return(code);
+      l--;
+   };
+
+   if ((id))
+   {
+      odbcshell_error(cnf, "unknown job %lld\n", id);
+      return(-1);
+   };
+
+   return(code);
+}
+
+/* end of source */
@@ -47,11 +47,20 @@
 
 #include "odbcshell.h"
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "odbcshell-batch.h"
+#include "odbcshell-group.h"
+#include "odbcshell-jobs.h"
+#include "odbcshell-parallel.h"
+#include "odbcshell-pool.h"
 #include "odbcshell-print.h"
+#include "odbcshell-retry.h"
+#include "odbcshell-signal.h"
+#include "odbcshell-tune.h"
 
 
 /////////////////
@@ -70,21 +79,38 @@
 int odbcshell_odbc_array_add(ODBCShell * cnf, ODBCShellConn * conn)
 {
    void      * ptr;
-   size_t      conns_size;
+   size_t      size;
+   size_t      slot;
 
    odbcshell_verbose(cnf, "adding \"%s\" connection to list...\n", conn->name);
 
-   conns_size  = sizeof(ODBCShellConn *);
-   conns_size *= (cnf->conns_count + 1);
+   // grows list geometrically so adds are amortized constant time
+   if ((size_t)cnf->conns_count >= cnf->conns_size)
+   {
+      size = (cnf->conns_size) ? (cnf->conns_size * 2) : ODBCSHELL_CONNS_SIZE;
+      if (!(ptr = realloc(cnf->conns, sizeof(ODBCShellConn *) * size)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+      cnf->conns      = ptr;
+      cnf->conns_size = size;
+   };
 
-   if (!(ptr = realloc(cnf->conns, conns_size)))
+   // keeps hash table at most half full
+   if (((size_t)cnf->conns_count * 2) >= cnf->conns_hash_size)
    {
-      odbcshell_fatal(cnf, "out of virtual memory\n");
-      return(-2);
+      size = (cnf->conns_hash_size) ? (cnf->conns_hash_size * 2) : (ODBCSHELL_CONNS_SIZE * 2);
+      if ((odbcshell_odbc_array_rehash(cnf, size)))
+         return(-2);
    };
-   cnf->conns = ptr;
+
+   slot = odbcshell_odbc_array_hash(conn->name) & (cnf->conns_hash_size - 1);
+   while((cnf->conns_hash[slot]))
+      slot = (slot + 1) & (cnf->conns_hash_size - 1);
 
    cnf->conns[cnf->conns_count] = conn;
+   cnf->conns_hash[slot]        = cnf->conns_count + 1;
 
    cnf->conns_count++;
 
@@ -97,13 +123,59 @@ int odbcshell_odbc_array_add(ODBCShell * cnf, ODBCShellConn * conn)
 /// @param name     internal name of connection
 int odbcshell_odbc_array_findindex(ODBCShell * cnf, const char * name)
 {
-   int i;
-   if (!(cnf->conns))
+   long long slot;
+   if (((slot = odbcshell_odbc_array_slot(cnf, name))) == -1)
       return(-1);
-   for(i = 0; i < (int)cnf->conns_count; i++)
-      if (!(strcasecmp(cnf->conns[i]->name, name)))
-         return(i);
-   return(-1);
+   return((int)(cnf->conns_hash[slot] - 1));
+}
+
+
+/// @brief calculates case insensitive hash of connection name
+/// @param name     internal name of connection
+uint32_t odbcshell_odbc_array_hash(const char * name)
+{
+   uint32_t hash;
+
+   // FNV-1a
+   hash = 2166136261U;
+   for(; ((*name)); name++)
+   {
+      hash ^= (uint32_t)tolower((unsigned char)*name);
+      hash *= 16777619U;
+   };
+
+   return(hash);
+}
+
+
+/// @brief rebuilds hash table of connection names
+/// @param cnf      pointer to configuration struct
+/// @param size     number of slots in table (power of two)
+int odbcshell_odbc_array_rehash(ODBCShell * cnf, size_t size)
+{
+   long long * hash;
+   long long   l;
+   size_t      slot;
+
+   if (!(hash = calloc(size, sizeof(long long))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+
+   for(l = 0; l < cnf->conns_count; l++)
+   {
+      slot = odbcshell_odbc_array_hash(cnf->conns[l]->name) & (size - 1);
+      while((hash[slot]))
+         slot = (slot + 1) & (size - 1);
+      hash[slot] = l + 1;
+   };
+
+   free(cnf->conns_hash);
+   cnf->conns_hash      = hash;
+   cnf->conns_hash_size = size;
+
+   return(0);
 }
 
 
@@ -112,17 +184,43 @@ int odbcshell_odbc_array_findindex(ODBCShell * cnf, const char * name)
 /// @param name     internal name of connection
 int odbcshell_odbc_array_rm(ODBCShell * cnf, const char * name)
 {
-   int i;
-   int conn_index;
-
-   if (((conn_index = odbcshell_odbc_array_findindex(cnf, name))) == -1)
+   long long   slot;
+   long long   last;
+   long long   conn_index;
+   size_t      mask;
+   size_t      next;
+   size_t      home;
+
+   if (((slot = odbcshell_odbc_array_slot(cnf, name))) == -1)
       return(0);
+   conn_index = cnf->conns_hash[slot] - 1;
+   mask       = cnf->conns_hash_size - 1;
 
    odbcshell_verbose(cnf, "removing \"%s\" connection from list...\n",
       cnf->conns[conn_index]->name);
 
-   for(i = (conn_index+1); i < (int)cnf->conns_count; i++)
-      cnf->conns[i-1] = cnf->conns[i];
+   // empties slot, then shifts back any entries which probed past it
+   next = (size_t)slot;
+   while ((cnf->conns_hash[next = ((next + 1) & mask)]))
+   {
+      home = odbcshell_odbc_array_hash(cnf->conns[cnf->conns_hash[next]-1]->name) & mask;
+      if (((next - home) & mask) >= ((next - (size_t)slot) & mask))
+      {
+         cnf->conns_hash[slot] = cnf->conns_hash[next];
+         slot = (long long)next;
+      };
+   };
+   cnf->conns_hash[slot] = 0;
+
+   // moves last connection into the vacated position
+   last = cnf->conns_count - 1;
+   if (conn_index != last)
+   {
+      slot = odbcshell_odbc_array_slot(cnf, cnf->conns[last]->name);
+      cnf->conns_hash[slot]   = conn_index + 1;
+      cnf->conns[conn_index] = cnf->conns[last];
+   };
+   cnf->conns[last] = NULL;
 
    cnf->conns_count--;
 
@@ -130,17 +228,138 @@ int odbcshell_odbc_array_rm(ODBCShell * cnf, const char * name)
 }
 
 
+/// @brief locates hash table slot of a connection
+/// @param cnf      pointer to configuration struct
+/// @param name     internal name of connection
+long long odbcshell_odbc_array_slot(ODBCShell * cnf, const char * name)
+{
+   size_t mask;
+   size_t slot;
+
+   if (!(cnf->conns_hash))
+      return(-1);
+
+   mask = cnf->conns_hash_size - 1;
+   slot = odbcshell_odbc_array_hash(name) & mask;
+   while((cnf->conns_hash[slot]))
+   {
+      if (!(strcasecmp(cnf->conns[cnf->conns_hash[slot]-1]->name, name)))
+         return((long long)slot);
+      slot = (slot + 1) & mask;
+   };
+
+   return(-1);
+}
+
+
+/// @brief binds buffers for retrieving several rows with each fetch
+/// @param cnf      pointer to configuration struct
+/// @param stmt     pointer to statement struct
+int odbcshell_odbc_bind(ODBCShell * cnf, ODBCShellStmt * stmt)
+{
+   SQLULEN       size;
+   SQLULEN       max;
+   SQLRETURN     sts;
+   SQLUSMALLINT  col;
+
+   stmt->rowset_size = 0;
+   if ( (!(stmt->conn)) || (stmt->conn->tune.fetchsize < 2) || (stmt->col_count < 1) )
+      return(0);
+
+   // limits memory bound for wide result sets
+   size = (SQLULEN)stmt->conn->tune.fetchsize;
+   max  = ODBCSHELL_FETCH_BYTES / ((SQLULEN)stmt->col_count * ODBCSHELL_FETCH_WIDTH);
+   if (size > max)
+      size = max;
+   if (size < 2)
+      return(0);
+
+   if (!(stmt->rowset = malloc((size_t)(size * (SQLULEN)stmt->col_count * ODBCSHELL_FETCH_WIDTH))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   if (!(stmt->rowset_ind = malloc(sizeof(SQLLEN) * (size_t)(size * (SQLULEN)stmt->col_count))))
+   {
+      odbcshell_odbc_unbind(stmt);
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+
+   // falls back to fetching one row at a time if the driver objects
+   sts = SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_ROW_BIND_TYPE,
+      (SQLPOINTER)SQL_BIND_BY_COLUMN, SQL_IS_UINTEGER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_ROW_ARRAY_SIZE,
+         (SQLPOINTER)size, SQL_IS_UINTEGER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_ROWS_FETCHED_PTR,
+         &stmt->rowset_count, 0);
+   for(col = 0; ((col < stmt->col_count) && (SQL_SUCCEEDED(sts))); col++)
+      sts = SQLBindCol(stmt->hstmt, col+1, SQL_C_CHAR,
+         &stmt->rowset[col * size * ODBCSHELL_FETCH_WIDTH], ODBCSHELL_FETCH_WIDTH,
+         &stmt->rowset_ind[col * size]);
+   if (!(SQL_SUCCEEDED(sts)))
+   {
+      odbcshell_verbose(cnf, "block fetch unavailable, fetching one row at a time\n");
+      stmt->rowset_size = size;
+      odbcshell_odbc_unbind(stmt);
+      return(0);
+   };
+
+   odbcshell_verbose(cnf, "binding %lu rows per fetch...\n", (unsigned long)size);
+   stmt->rowset_size  = size;
+   stmt->rowset_count = 0;
+   stmt->rowset_next  = 0;
+
+   return(0);
+}
+
+
+/// @brief binds buffers for block fetches only if no value can be truncated
+/// @param cnf      pointer to configuration struct
+/// @param stmt     pointer to statement struct
+int odbcshell_odbc_bind_exact(ODBCShell * cnf, ODBCShellStmt * stmt)
+{
+   SQLSMALLINT col;
+
+   // columns of unknown or large size are retrieved with SQLGetData()
+   for(col = 0; col < stmt->col_count; col++)
+   {
+      if ( (!(stmt->cols[col].precision)) ||
+           ((stmt->cols[col].precision * 4) >= ODBCSHELL_FETCH_WIDTH) )
+      {
+         odbcshell_verbose(cnf, "column \"%s\" may exceed %i bytes, fetching one row at a time\n",
+            (char *)stmt->cols[col].name, ODBCSHELL_FETCH_WIDTH - 1);
+         stmt->rowset_size = 0;
+         return(0);
+      };
+   };
+
+   return(odbcshell_odbc_bind(cnf, stmt));
+}
+
+
 /// @brief closes all ODBC connections
 /// @param cnf      pointer to configuration struct
 int odbcshell_odbc_close(ODBCShell * cnf)
 {
    int i;
 
+   odbcshell_job_close(cnf);
+   odbcshell_batch_free(cnf);
+   odbcshell_parallel_free(cnf);
+   odbcshell_pool_close(cnf);
+
    for(i = 0;i < (int)cnf->conns_count; i++)
       odbcshell_odbc_free(cnf, &cnf->conns[i]);
    free(cnf->conns);
    cnf->conns = NULL;
    cnf->conns_count = 0;
+   cnf->conns_size  = 0;
+   free(cnf->conns_hash);
+   cnf->conns_hash = NULL;
+   cnf->conns_hash_size = 0;
 
    if (cnf->hdbc)
    {
@@ -149,6 +368,10 @@ int odbcshell_odbc_close(ODBCShell * cnf)
    };
    cnf->hdbc = NULL;
 
+   if (cnf->henv_pool)
+      SQLFreeHandle(SQL_HANDLE_ENV, cnf->henv_pool);
+   cnf->henv_pool = NULL;
+
    if (cnf->henv)
       SQLFreeHandle(SQL_HANDLE_ENV, cnf->henv);
    cnf->henv = NULL;
@@ -164,9 +387,7 @@ int odbcshell_odbc_close(ODBCShell * cnf)
 int odbcshell_odbc_connect(ODBCShell * cnf, const char * dsn,
    const char * name)
 {
-   SQLTCHAR         dsnOut[512];
-   short            buflen;
-   SQLRETURN        sts;
+   int              err;
    ODBCShellConn  * conn;
 
    if (!(name))
@@ -180,61 +401,8 @@ int odbcshell_odbc_connect(ODBCShell * cnf, const char * dsn,
       return(-1);
    };
 
-   odbcshell_verbose(cnf, "connecting to datasource...\n");
-
-   // allocates memory for storing internal connection information
-   if (!(conn = malloc(sizeof(ODBCShellConn))))
-   {
-      odbcshell_fatal(cnf, "out of virtual memory\n");
-      return(-2);
-   };
-   memset(conn, 0, sizeof(ODBCShellConn));
-   if (!(conn->name = strdup(name)))
-   {
-      odbcshell_fatal(cnf, "out of virtual memory\n");
-      return(-2);
-   };
-   if (!(conn->dsn = (char *)strdup(dsn)))
-   {
-      odbcshell_fatal(cnf, "out of virtual memory\n");
-      return(-2);
-   };
-
-   // allocates iODBC handle for connection
-   if (SQLAllocHandle(SQL_HANDLE_DBC, cnf->henv, &conn->hdbc) != SQL_SUCCESS)
-   {
-      odbcshell_odbc_errors("SQLAllocHandle", cnf, conn);
-      odbcshell_odbc_free(cnf, &conn);
-      return(-1);
-   };
-#ifdef SQL_APPLICATION_NAME
-   SQLSetConnectOption(conn->hdbc, SQL_APPLICATION_NAME, (SQLULEN)PROGRAM_NAME);
-#endif
-
-   // connects to data source
-   if (cnf->odbcprompt)
-   {
-      sts = SQLDriverConnect(conn->hdbc, 0, (SQLTCHAR *)conn->dsn, SQL_NTS,
-            dsnOut, strlen(conn->dsn), &buflen, SQL_DRIVER_COMPLETE);
-   } else {
-      sts = SQLDriverConnect(conn->hdbc, 0, (SQLTCHAR *)conn->dsn, SQL_NTS,
-            dsnOut, strlen(conn->dsn), &buflen, SQL_DRIVER_NOPROMPT);
-   };
-   if ((sts != SQL_SUCCESS) && (sts != SQL_SUCCESS_WITH_INFO))
-   {
-      odbcshell_odbc_errors("SQLDriverConnect", cnf, conn);
-      odbcshell_odbc_free(cnf, &conn);
-      return(-1);
-   };
-
-   // allocates statement handle
-   sts = SQLAllocHandle(SQL_HANDLE_STMT, conn->hdbc, &conn->hstmt);
-   if (sts != SQL_SUCCESS)
-   {
-      odbcshell_odbc_errors("SQLAllocHandle", cnf, conn);
-      odbcshell_odbc_free(cnf, &conn);
-      return(-1);
-   };
+   if ((err = odbcshell_odbc_open(cnf, dsn, name, &conn)))
+      return(err);
 
    // adds connection to array
    if ((odbcshell_odbc_array_add(cnf, conn)))
@@ -269,18 +437,23 @@ int odbcshell_odbc_disconnect(ODBCShell * cnf, const char * name)
       name = cnf->current->name;
    };
 
-   if (cnf->current)
-      if (!(strcasecmp(name, cnf->current->name)))
-         cnf->current = NULL;
-
    if (((conn_index = odbcshell_odbc_array_findindex(cnf, name))) == -1)
    {
       odbcshell_error(cnf, "unknown connection \"%s\"\n", name);
       return(-1);
    };
    conn = cnf->conns[conn_index];
+   if ((conn->job))
+   {
+      odbcshell_error(cnf, "connection \"%s\" is in use by job %lld\n",
+         conn->name, conn->job->id);
+      return(-1);
+   };
+
+   if (cnf->current == conn)
+      cnf->current = NULL;
    odbcshell_odbc_array_rm(cnf, name);
-   odbcshell_odbc_free(cnf, &conn);
+   odbcshell_pool_put(cnf, &conn);
 
    odbcshell_odbc_update_current(cnf, NULL);
 
@@ -291,22 +464,19 @@ int odbcshell_odbc_disconnect(ODBCShell * cnf, const char * name)
 /// @brief displays iODBC errors
 /// @param s        descriptive string
 /// @param cnf      pointer to configuration struct
-/// @param conn     pointer to connection struct
-void odbcshell_odbc_errors(const char * s, ODBCShell * cnf,
-   ODBCShellConn  * conn)
+/// @param hdbc     connection handle
+/// @param hstmt    statement handle
+void odbcshell_odbc_diag(const char * s, ODBCShell * cnf, HDBC hdbc,
+   HSTMT hstmt)
 {
    int        i;
    HENV       henv;
-   HDBC       hdbc;
-   HSTMT      hstmt;
    SQLTCHAR   buff[512];
    SQLTCHAR   sqlstate[15];
    SQLINTEGER native_error;
    SQLRETURN  sts;
 
    henv         = cnf->henv;
-   hdbc         = conn ? conn->hdbc  : cnf->hdbc;
-   hstmt        = conn ? conn->hstmt : NULL;
    native_error = 0;
 
    // display statement errors
@@ -347,120 +517,476 @@ void odbcshell_odbc_errors(const char * s, ODBCShell * cnf,
 }
 
 
-/// @brief execute SQL statement
+/// @brief establishes a connection which was deferred by lazyconnect
 /// @param cnf      pointer to configuration struct
-/// @param sql      SQL string to execute
-int odbcshell_odbc_exec(ODBCShell * cnf, char * sql)
+/// @param conn     pointer to connection struct
+int odbcshell_odbc_dial(ODBCShell * cnf, ODBCShellConn * conn)
 {
-   int err;
+   SQLTCHAR         dsnOut[512];
+   short            buflen;
+   SQLRETURN        sts;
 
-   if (!(cnf->current))
+   odbcshell_verbose(cnf, "connecting \"%s\" to datasource...\n", conn->name);
+
+   if (cnf->odbcprompt)
    {
-      odbcshell_error(cnf, "not connected to a database\n");
-      return(-1);
+      sts = SQLDriverConnect(conn->hdbc, 0, (SQLTCHAR *)conn->dsn, SQL_NTS,
+            dsnOut, strlen(conn->dsn), &buflen, SQL_DRIVER_COMPLETE);
+   } else {
+      sts = SQLDriverConnect(conn->hdbc, 0, (SQLTCHAR *)conn->dsn, SQL_NTS,
+            dsnOut, strlen(conn->dsn), &buflen, SQL_DRIVER_NOPROMPT);
    };
-
-   // prepare SQL statement
-   odbcshell_verbose(cnf, "preparing SQL statement...\n");
-   err = SQLPrepare(cnf->current->hstmt, (SQLTCHAR *)sql, SQL_NTS);
-   if (err != SQL_SUCCESS)
+   if ((sts != SQL_SUCCESS) && (sts != SQL_SUCCESS_WITH_INFO))
    {
-      odbcshell_odbc_errors("SQLPrepare", cnf, cnf->current);
+      odbcshell_odbc_errors("SQLDriverConnect", cnf, conn);
       return(-1);
    };
 
-   // execute SQL statement
-   odbcshell_verbose(cnf, "executing SQL statement...\n");
-   err = SQLExecute(cnf->current->hstmt);
-   if (err != SQL_SUCCESS)
+   // allocates statement handle
+   if ((odbcshell_odbc_stmt_alloc(cnf, conn, &conn->stmt)))
    {
-      odbcshell_odbc_errors("SQLExecute", cnf, cnf->current);
-      if (err == SQL_SUCCESS_WITH_INFO)
-         return(0);
+      SQLDisconnect(conn->hdbc);
       return(-1);
    };
 
-   return(odbcshell_odbc_result(cnf));
+   conn->deferred = 0;
+
+   return(odbcshell_tune_apply(cnf, conn));
 }
 
 
-/// @brief frees resources from an iODBC connection
+/// @brief selects environment in which new connections are allocated
 /// @param cnf      pointer to configuration struct
-/// @param connp    pointer to pointer to connection struct
-void odbcshell_odbc_free(ODBCShell * cnf, ODBCShellConn  ** connp)
+HENV odbcshell_odbc_env(ODBCShell * cnf)
 {
-   if (!(connp))
-      return;
-
-   if (cnf)
-      if (cnf->current == (*connp))
-         cnf->current = NULL;
-
-   odbcshell_verbose(cnf, "disconnecting \"%s\"...\n", (*connp)->name);
-
-   if ((*connp)->cols)
-      free((*connp)->cols);
-   (*connp)->cols      = NULL;
-   (*connp)->col_count = 0;
-
-   if ((*connp)->hstmt)
-   {
-      SQLCloseCursor((*connp)->hstmt);
-      SQLFreeHandle(SQL_HANDLE_STMT, (*connp)->hstmt);
-   };
-   (*connp)->hstmt = NULL;
-
-   if ((*connp)->hdbc)
+   if (cnf->poolsize < 1)
+      return(cnf->henv);
+   if ((cnf->henv_pool))
+      return(cnf->henv_pool);
+
+   // driver manager pools sessions released by SQLDisconnect() only in an
+   // environment allocated once pooling was requested
+   SQLSetEnvAttr(NULL, SQL_ATTR_CONNECTION_POOLING,
+      (SQLPOINTER)SQL_CP_ONE_PER_HENV, SQL_IS_UINTEGER);
+   if (SQLAllocHandle((SQLSMALLINT)SQL_HANDLE_ENV, NULL, &cnf->henv_pool) != SQL_SUCCESS)
    {
-      SQLDisconnect((*connp)->hdbc);
-      SQLFreeHandle(SQL_HANDLE_DBC, (*connp)->hdbc);
+      odbcshell_verbose(cnf, "driver manager pooling unavailable\n");
+      cnf->henv_pool = NULL;
+      return(cnf->henv);
    };
-   (*connp)->hdbc = NULL;
-
-   if ((*connp)->name)
-      free((*connp)->name);
-   (*connp)->name = NULL;
+   SQLSetEnvAttr(cnf->henv_pool, SQL_ATTR_CP_MATCH, (SQLPOINTER)SQL_CP_RELAXED_MATCH,
+                  SQL_IS_UINTEGER);
+   SQLSetEnvAttr(cnf->henv_pool, SQL_ATTR_ODBC_VERSION, (SQLPOINTER) SQL_OV_ODBC3,
+                  SQL_IS_UINTEGER);
 
-   if ((*connp)->dsn)
-      free((*connp)->dsn);
-   (*connp)->dsn = NULL;
+   return(cnf->henv_pool);
+}
 
-   free(*connp);
-   (*connp) = NULL;
 
+/// @brief displays iODBC errors
+/// @param s        descriptive string
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+void odbcshell_odbc_errors(const char * s, ODBCShell * cnf,
+   ODBCShellConn  * conn)
+{
+   if (!(conn))
+      odbcshell_odbc_diag(s, cnf, cnf->hdbc, NULL);
+   else if (!(conn->stmt))
+      odbcshell_odbc_diag(s, cnf, conn->hdbc, NULL);
+   else
+      odbcshell_odbc_diag(s, cnf, conn->hdbc, conn->stmt->hstmt);
    return;
 }
 
 
-/// @brief initializes ODBC library
+/// @brief execute SQL statement
 /// @param cnf      pointer to configuration struct
-int odbcshell_odbc_initialize(ODBCShell * cnf)
+/// @param sql      SQL string to execute
+int odbcshell_odbc_exec(ODBCShell * cnf, char * sql)
 {
-   if (SQLAllocHandle((SQLSMALLINT)SQL_HANDLE_ENV, NULL, &cnf->henv) != SQL_SUCCESS)
-      return(-1);
+   int             err;
+   int             lost;
+   int             replays;
+   const char    * func;
+   ODBCShellConn * conn;
+   ODBCShellStmt * stmt;
 
-   SQLSetEnvAttr(cnf->henv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER) SQL_OV_ODBC3,
-                  SQL_IS_UINTEGER);
+   // statements sent to a group are routed to one of its members
+   if ((cnf->group))
+      if ((odbcshell_group_route(cnf, sql)))
+         return(-1);
 
-   if (SQLAllocHandle(SQL_HANDLE_DBC, cnf->henv, &cnf->hdbc) != SQL_SUCCESS)
+   if ((odbcshell_odbc_ready(cnf)))
       return(-1);
 
-#ifdef SQL_APPLICATION_NAME
-   SQLSetConnectOption(cnf->hdbc, SQL_APPLICATION_NAME, (SQLULEN)PROGRAM_NAME);
-#endif
+   // replaces a session the driver already knows to be dead
+   if ( (cnf->autoreconnect > 0) && ((odbcshell_retry_lost(cnf->current, NULL))) )
+      if ((odbcshell_retry_reconnect(cnf, cnf->current)))
+         return(-1);
 
-   return(0);
-}
+   for(replays = 0; ; replays++)
+   {
+      if ((odbcshell_odbc_ready(cnf)))
+         return(-1);
+      conn = cnf->current;
+      stmt = conn->stmt;
 
+      // reuses a statement prepared earlier on this connection
+      if (conn->tune.stmtcache > 0)
+      {
+         if ((err = odbcshell_odbc_stmt_cache(cnf, conn, sql, &stmt)))
+            return(err);
+         if (!(conn->job))
+            odbcshell_signal_stmt(stmt->hstmt);
+      };
 
-/// @brief reconnects a session
-/// @param cnf      pointer to configuration struct
+      // prepare SQL statement
+      func = "SQLPrepare";
+      err  = odbcshell_odbc_prepare(cnf, conn, stmt, sql);
+      if (err == SQL_SUCCESS)
+      {
+         // execute SQL statement
+         odbcshell_verbose(cnf, "executing SQL statement...\n");
+         func = "SQLExecute";
+         err = SQLExecute(stmt->hstmt);
+         if (err == SQL_SUCCESS)
+            return(odbcshell_odbc_result(cnf, stmt));
+         if (err == SQL_SUCCESS_WITH_INFO)
+         {
+            odbcshell_odbc_stmt_errors("SQLExecute", cnf, stmt);
+            return(0);
+         };
+      };
+
+      // only a lost session is worth another attempt
+      lost = 0;
+      if ( (cnf->autoreconnect > 0) && (replays == 0) )
+         lost = odbcshell_retry_lost(conn, stmt->hstmt);
+      odbcshell_odbc_stmt_errors(func, cnf, stmt);
+      if (!(lost))
+         return(-1);
+
+      // statements prepared on the lost session are prepared again
+      if ((odbcshell_retry_reconnect(cnf, conn)))
+         return(-1);
+
+      // statements which may have changed data are never sent twice
+      if ( (!(cnf->retryreads)) || (!(odbcshell_retry_idempotent(sql))) )
+      {
+         odbcshell_error(cnf, "connection re-established, statement was not retried\n");
+         return(-1);
+      };
+      odbcshell_verbose(cnf, "retrying statement...\n");
+   };
+}
+
+
+/// @brief advances to the next row of the pending result set
+/// @param cnf      pointer to configuration struct
+/// @param stmt     pointer to statement struct
+SQLRETURN odbcshell_odbc_fetch(ODBCShell * cnf, ODBCShellStmt * stmt)
+{
+   SQLRETURN sts;
+
+   if (!(stmt->rowset_size))
+      return(SQLFetchScroll(stmt->hstmt, SQL_FETCH_NEXT, 1));
+
+   // serves rows already held in bound buffers
+   stmt->rowset_next++;
+   if (stmt->rowset_next < stmt->rowset_count)
+      return(SQL_SUCCESS);
+
+   odbcshell_verbose(cnf, "fetching up to %lu rows...\n", (unsigned long)stmt->rowset_size);
+   stmt->rowset_next  = 0;
+   stmt->rowset_count = 0;
+   sts = SQLFetchScroll(stmt->hstmt, SQL_FETCH_NEXT, 0);
+
+   // values longer than the bound buffers are truncated like SQLGetData()
+   if (sts == SQL_SUCCESS_WITH_INFO)
+      sts = SQL_SUCCESS;
+   if ( (sts == SQL_SUCCESS) && (!(stmt->rowset_count)) )
+      sts = SQL_NO_DATA_FOUND;
+
+   return(sts);
+}
+
+
+/// @brief frees resources from an iODBC connection
+/// @param cnf      pointer to configuration struct
+/// @param connp    pointer to pointer to connection struct
+void odbcshell_odbc_free(ODBCShell * cnf, ODBCShellConn  ** connp)
+{
+   if (!(connp))
+      return;
+
+   if (cnf)
+      if (cnf->current == (*connp))
+         cnf->current = NULL;
+
+   odbcshell_verbose(cnf, "disconnecting \"%s\"...\n", (*connp)->name);
+
+   odbcshell_odbc_stmt_close(cnf, (*connp));
+
+   if ((*connp)->hdbc)
+   {
+      SQLDisconnect((*connp)->hdbc);
+      SQLFreeHandle(SQL_HANDLE_DBC, (*connp)->hdbc);
+   };
+   (*connp)->hdbc = NULL;
+
+   if ((*connp)->name)
+      free((*connp)->name);
+   (*connp)->name = NULL;
+
+   if ((*connp)->dsn)
+      free((*connp)->dsn);
+   (*connp)->dsn = NULL;
+
+   free(*connp);
+   (*connp) = NULL;
+
+   return;
+}
+
+
+/// @brief initializes ODBC library
+/// @param cnf      pointer to configuration struct
+int odbcshell_odbc_initialize(ODBCShell * cnf)
+{
+   if (SQLAllocHandle((SQLSMALLINT)SQL_HANDLE_ENV, NULL, &cnf->henv) != SQL_SUCCESS)
+      return(-1);
+
+   SQLSetEnvAttr(cnf->henv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER) SQL_OV_ODBC3,
+                  SQL_IS_UINTEGER);
+
+   if (SQLAllocHandle(SQL_HANDLE_DBC, cnf->henv, &cnf->hdbc) != SQL_SUCCESS)
+      return(-1);
+
+#ifdef SQL_APPLICATION_NAME
+   SQLSetConnectOption(cnf->hdbc, SQL_APPLICATION_NAME, (SQLULEN)PROGRAM_NAME);
+#endif
+
+   return(0);
+}
+
+
+/// @brief opens a connection without adding it to the list of connections
+/// @param cnf      pointer to configuration struct
+/// @param dsn      data source to connect
 /// @param name     internal name of connect
-int odbcshell_odbc_reconnect(ODBCShell * cnf, const char * name)
+/// @param connp    pointer to pointer to connection struct
+int odbcshell_odbc_open(ODBCShell * cnf, const char * dsn, const char * name,
+   ODBCShellConn ** connp)
 {
-   SQLTCHAR        dsnOut[512];
-   short           buflen;
+   int              err;
+   ODBCShellConn  * conn;
+
+   // reuses an idle connection to the same data source
+   if ((err = odbcshell_pool_take(cnf, dsn, name, connp)))
+      return(err);
+   if ((*connp))
+      return(0);
+
+   // allocates memory for storing internal connection information
+   if (!(conn = malloc(sizeof(ODBCShellConn))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   memset(conn, 0, sizeof(ODBCShellConn));
+   conn->batch_support  = -1;
+   conn->max_activities = -1;
+   if (!(conn->name = strdup(name)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_odbc_free(cnf, &conn);
+      return(-2);
+   };
+   if (!(conn->dsn = (char *)strdup(dsn)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      odbcshell_odbc_free(cnf, &conn);
+      return(-2);
+   };
+
+   // allocates iODBC handle for connection
+   if (SQLAllocHandle(SQL_HANDLE_DBC, odbcshell_odbc_env(cnf), &conn->hdbc) != SQL_SUCCESS)
+   {
+      odbcshell_odbc_errors("SQLAllocHandle", cnf, conn);
+      odbcshell_odbc_free(cnf, &conn);
+      return(-1);
+   };
+#ifdef SQL_APPLICATION_NAME
+   SQLSetConnectOption(conn->hdbc, SQL_APPLICATION_NAME, (SQLULEN)PROGRAM_NAME);
+#endif
+   odbcshell_tune_lookup(cnf, conn);
+
+   // waits for the first statement before connecting to data source
+   if ((cnf->lazyconnect))
+   {
+      odbcshell_verbose(cnf, "deferring connection of \"%s\"...\n", conn->name);
+      conn->deferred = 1;
+      (*connp)       = conn;
+      return(0);
+   };
+
+   if ((odbcshell_odbc_dial(cnf, conn)))
+   {
+      odbcshell_odbc_free(cnf, &conn);
+      return(-1);
+   };
+
+   (*connp) = conn;
+
+   return(0);
+}
+
+
+/// @brief executes a prepared statement once for each row of bound parameter arrays
+/// @param cnf          pointer to configuration struct
+/// @param stmt         pointer to statement struct
+/// @param rows         number of rows bound
+/// @param[out] donep   number of rows accepted by the driver
+/// @param[out] failedp index of first row which was not accepted
+int odbcshell_odbc_params_exec(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLULEN rows, SQLULEN * donep, SQLULEN * failedp)
+{
+   int             code;
+   SQLULEN         row;
+   SQLULEN         processed;
    SQLRETURN       sts;
+   SQLUSMALLINT  * status;
+
+   (*donep)   = 0;
+   (*failedp) = 0;
+
+   if (!(status = malloc(sizeof(SQLUSMALLINT) * rows)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   for(row = 0; row < rows; row++)
+      status[row] = SQL_PARAM_UNUSED;
+   processed = 0;
+
+   sts = SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_PARAMSET_SIZE,
+      (SQLPOINTER)rows, SQL_IS_UINTEGER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_PARAM_STATUS_PTR, status, SQL_IS_POINTER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &processed, SQL_IS_POINTER);
+   if ((SQL_SUCCEEDED(sts)))
+      sts = SQLExecute(stmt->hstmt);
+
+   // a driver which does not report rows accepted all of them if it succeeded
+   if ( ((SQL_SUCCEEDED(sts))) && (!(processed)) )
+      for(row = 0; row < rows; row++)
+         status[row] = SQL_PARAM_SUCCESS;
+
+   // drivers may reject some rows and continue with the others
+   for(row = rows; row > 0; row--)
+   {
+      if ( (status[row-1] == SQL_PARAM_SUCCESS) ||
+           (status[row-1] == SQL_PARAM_SUCCESS_WITH_INFO) )
+         (*donep)++;
+      else
+         (*failedp) = row - 1;
+   };
+
+   // a failure not attributed to any row leaves none of them counted
+   if ( (!(SQL_SUCCEEDED(sts))) && ((*donep) == rows) )
+      (*donep) = 0;
+
+   code = 0;
+   if ( (!(SQL_SUCCEEDED(sts))) || ((*donep) < rows) )
+   {
+      odbcshell_odbc_stmt_errors("SQLExecute", cnf, stmt);
+      if ( ((*donep)) && ((*donep) < rows) )
+         odbcshell_error(cnf, "%lu of %lu rows were not accepted\n",
+            (unsigned long)(rows - (*donep)), (unsigned long)rows);
+      code = -1;
+   };
+
+   // buffers are not referenced once the rows are counted
+   SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_PARAM_STATUS_PTR, NULL, SQL_IS_POINTER);
+   SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, NULL, SQL_IS_POINTER);
+   free(status);
+
+   return(code);
+}
+
+
+/// @brief prepares SQL statement with the settings of its connection
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+/// @param stmt     pointer to statement struct
+/// @param sql      SQL string to prepare
+SQLRETURN odbcshell_odbc_prepare(ODBCShell * cnf, ODBCShellConn * conn,
+   ODBCShellStmt * stmt, char * sql)
+{
+   SQLRETURN sts;
+
+   odbcshell_odbc_stmt_timeout(cnf, conn, stmt);
+
+   // statements held by the cache are prepared once
+   if ((stmt->prepared))
+      return(SQL_SUCCESS);
+
+   if (conn->tune.cursortype != -1)
+      if (!(SQL_SUCCEEDED(SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_CURSOR_TYPE,
+         (SQLPOINTER)(SQLULEN)conn->tune.cursortype, SQL_IS_UINTEGER))))
+         odbcshell_odbc_stmt_errors("SQLSetStmtAttr", cnf, stmt);
+   odbcshell_verbose(cnf, "preparing SQL statement...\n");
+   sts = SQLPrepare(stmt->hstmt, (SQLTCHAR *)sql, SQL_NTS);
+   if ( (sts == SQL_SUCCESS) && ((stmt->sql)) )
+      stmt->prepared = 1;
+
+   return(sts);
+}
+
+
+/// @brief verifies the current connection is available for statements
+/// @param cnf      pointer to configuration struct
+int odbcshell_odbc_ready(ODBCShell * cnf)
+{
+   if (!(cnf->current))
+   {
+      odbcshell_error(cnf, "not connected to a database\n");
+      return(-1);
+   };
+
+   // background jobs have exclusive use of their connection
+   if ( ((cnf->current->job)) && (cnf->current->job->cnf != cnf) )
+   {
+      odbcshell_error(cnf, "connection \"%s\" is in use by job %lld\n",
+         cnf->current->name, cnf->current->job->id);
+      return(-1);
+   };
+
+   if ((cnf->current->deferred))
+      if ((odbcshell_odbc_dial(cnf, cnf->current)))
+         return(-1);
+
+   if (!(cnf->current->stmt))
+   {
+      odbcshell_error(cnf, "connection \"%s\" is not open\n", cnf->current->name);
+      return(-1);
+   };
+
+   // statements run by the shell itself may be cancelled with Ctrl-C
+   if (!(cnf->current->job))
+      odbcshell_signal_stmt(cnf->current->stmt->hstmt);
+
+   return(0);
+}
+
+
+/// @brief reconnects a session
+/// @param cnf      pointer to configuration struct
+/// @param name     internal name of connect
+int odbcshell_odbc_reconnect(ODBCShell * cnf, const char * name)
+{
    int             conn_index;
    ODBCShellConn * conn;
 
@@ -477,11 +1003,32 @@ int odbcshell_odbc_reconnect(ODBCShell * cnf, const char * name)
       return(0);
 
    conn = cnf->conns[conn_index];
+   if ( ((conn->job)) && (conn->job->cnf != cnf) )
+   {
+      odbcshell_error(cnf, "connection \"%s\" is in use by job %lld\n",
+         conn->name, conn->job->id);
+      return(-1);
+   };
+
+   // a deferred connection has no session to replace
+   if ((conn->deferred))
+      return(0);
+
+   return(odbcshell_odbc_redial(cnf, conn));
+}
+
+
+/// @brief replaces the session of a connection with a new one
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+int odbcshell_odbc_redial(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   SQLTCHAR        dsnOut[512];
+   short           buflen;
+   SQLRETURN       sts;
 
    odbcshell_verbose(cnf, "disconnecting \"%s\"...\n", conn->name);
-   SQLCloseCursor(conn->hstmt);
-   SQLFreeHandle(SQL_HANDLE_STMT, conn->hstmt);
-   conn->hstmt = NULL;
+   odbcshell_odbc_stmt_close(cnf, conn);
    SQLDisconnect(conn->hdbc);
 
    odbcshell_verbose(cnf, "connecting to datasource...\n");
@@ -493,176 +1040,179 @@ int odbcshell_odbc_reconnect(ODBCShell * cnf, const char * name)
       return(-1);
    }; 
 
-   sts = SQLAllocHandle(SQL_HANDLE_STMT, conn->hdbc, &conn->hstmt);
-   if (sts != SQL_SUCCESS)
-   {
-      odbcshell_odbc_errors("SQLAllocHandle", cnf, conn);
+   if ((odbcshell_odbc_stmt_alloc(cnf, conn, &conn->stmt)))
       return(-1);
-   };
 
-   return(0);
+   return(odbcshell_tune_apply(cnf, conn));
 }
 
 
-/// @brief displays result from ODBC operation
+/// @brief retrieves description of columns in the pending result set
 /// @param cnf      pointer to configuration struct
-int odbcshell_odbc_result(ODBCShell * cnf)
+/// @param stmt     pointer to statement struct
+int odbcshell_odbc_describe(ODBCShell * cnf, ODBCShellStmt * stmt)
 {
    int             err;
-   SQLRETURN       sts;
    SQLSMALLINT     col_index;
-   SQLLEN          row_count;
-   unsigned long   set_count;
    ODBCShellColumn * col;
 
-   set_count = 1;
-
-   odbcshell_verbose(cnf, "preparing SQL results...\n");
+   // retrieve number of columns
+   col_index = 0;
+   err = SQLNumResultCols(stmt->hstmt, &col_index);
+   if (err != SQL_SUCCESS)
+   {
+      odbcshell_odbc_stmt_errors("SQLNumResultCols", cnf, stmt);
+      return(-1);
+   };
+   stmt->col_count = (unsigned long) col_index;
+   if (stmt->col_count == 0)
+      return(0);
 
-   if (cnf->format == ODBCSHELL_FORMAT_XML)
+   // allocates memory for array of column information
+   if (stmt->cols)
+      free(stmt->cols);
+   if (!(stmt->cols = malloc(sizeof(ODBCShellColumn) * stmt->col_count)))
    {
-      odbcshell_fprintf(cnf, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n");
-      odbcshell_fprintf(cnf, "<result>\n");
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
    };
+   memset(stmt->cols, 0, (sizeof(ODBCShellColumn) * stmt->col_count));
 
-   sts = SQL_SUCCESS;
-   while (sts == SQL_SUCCESS)
+   // retrieve name of column
+   for(col_index = 0; col_index < stmt->col_count; col_index++)
    {
-      // retrieve number of columns
-      col_index = 0;
-      err = SQLNumResultCols(cnf->current->hstmt, &col_index);
+      col = &stmt->cols[col_index];
+      err = SQLDescribeCol(stmt->hstmt, col_index+1, col->name,
+                           sizeof(col->name), NULL, &col->type, &col->precision,
+                           &col->scale, &col->nullable);
       if (err != SQL_SUCCESS)
       {
-         odbcshell_odbc_errors("SQLNumResultCols", cnf, cnf->current);
-         SQLCloseCursor(cnf->current->hstmt);
+         odbcshell_odbc_stmt_errors("SQLDescribeCol", cnf, stmt);
          return(-1);
       };
-      cnf->current->col_count = (unsigned long) col_index;
-      if (cnf->current->col_count == 0)
+      switch(col->type)
       {
-         row_count = 0;
-         SQLRowCount(cnf->current->hstmt, &row_count);
-         odbcshell_printf(cnf, "Statement executed. %ld rows affected.\n", row_count);
-         SQLCloseCursor(cnf->current->hstmt);
-         return(0);
-      };
+         case SQL_VARCHAR:
+         case SQL_CHAR:
+         case SQL_WVARCHAR:
+         case SQL_WCHAR:
+         case SQL_GUID:
+            col->width = col->precision;
+            break;
 
-      // allocates memory for array of column information
-      if (cnf->current->cols)
-         free(cnf->current->cols);
-      if (!(cnf->current->cols = malloc(sizeof(ODBCShellColumn) * cnf->current->col_count)))
-      {
-         odbcshell_fatal(cnf, "out of virtual memory\n");
-         return(-2);
-      };
-      memset(cnf->current->cols, 0, (sizeof(ODBCShellColumn) * cnf->current->col_count));
+         case SQL_BINARY:
+            col->width = col->precision * 2;
+            break;
 
-      // retrieve name of column
-      for(col_index = 0; col_index < cnf->current->col_count; col_index++)
-      {
-         col = &cnf->current->cols[col_index];
-         err = SQLDescribeCol(cnf->current->hstmt, col_index+1, col->name,
-                              sizeof(col->name), NULL, &col->type, &col->precision,
-                              &col->scale, &col->nullable);
-         if (err != SQL_SUCCESS)
-         {
-            odbcshell_odbc_errors("SQLDescribeCol", cnf, cnf->current);
-            SQLCloseCursor(cnf->current->hstmt);
-            return(-1);
-         };
-         switch(col->type)
-         {
-            case SQL_VARCHAR:
-            case SQL_CHAR:
-            case SQL_WVARCHAR:
-            case SQL_WCHAR:
-            case SQL_GUID:
-               col->width = col->precision;
-               break;
-
-            case SQL_BINARY:
-               col->width = col->precision * 2;
-               break;
-
-            case SQL_LONGVARCHAR:
-            case SQL_WLONGVARCHAR:
-            case SQL_LONGVARBINARY:
-               col->width = 30;	/* show only first 30 */
-               break;
-
-            case SQL_BIT:
-               col->width = 1;
-               break;
-
-            case SQL_TINYINT:
-            case SQL_SMALLINT:
-            case SQL_INTEGER:
-            case SQL_BIGINT:
-               col->width = col->precision + 1;	/* sign */
-               break;
-
-            case SQL_DOUBLE:
-            case SQL_DECIMAL:
-            case SQL_NUMERIC:
-            case SQL_FLOAT:
-            case SQL_REAL:
-               col->width = col->precision + 2;	/* sign, comma */
+         case SQL_LONGVARCHAR:
+         case SQL_WLONGVARCHAR:
+         case SQL_LONGVARBINARY:
+            col->width = 30;	/* show only first 30 */
+            break;
+
+         case SQL_BIT:
+            col->width = 1;
             break;
 
+         case SQL_TINYINT:
+         case SQL_SMALLINT:
+         case SQL_INTEGER:
+         case SQL_BIGINT:
+            col->width = col->precision + 1;	/* sign */
+            break;
+
+         case SQL_DOUBLE:
+         case SQL_DECIMAL:
+         case SQL_NUMERIC:
+         case SQL_FLOAT:
+         case SQL_REAL:
+            col->width = col->precision + 2;	/* sign, comma */
+         break;
+
 #ifdef SQL_TYPE_DATE
-            case SQL_TYPE_DATE:
+         case SQL_TYPE_DATE:
 #endif
-            case SQL_DATE:
-               col->width = 10;
-               break;
+         case SQL_DATE:
+            col->width = 10;
+            break;
 
 #ifdef SQL_TYPE_TIME
-            case SQL_TYPE_TIME:
+         case SQL_TYPE_TIME:
 #endif
-            case SQL_TIME:
-               col->width = 8;
-               break;
+         case SQL_TIME:
+            col->width = 8;
+            break;
 
 #ifdef SQL_TYPE_TIMESTAMP
-            case SQL_TYPE_TIMESTAMP:
+         case SQL_TYPE_TIMESTAMP:
 #endif
-            case SQL_TIMESTAMP:
-               col->width = 19;
-               if (col->scale > 0)
-                  col->width = col->width + col->scale + 1;
-               break;
-
-            default:
-               col->width = 0;	/* skip other data types */
-               continue;
-         };
+         case SQL_TIMESTAMP:
+            col->width = 19;
+            if (col->scale > 0)
+               col->width = col->width + col->scale + 1;
+            break;
 
-         if (col->width < strlen((char *)col->name))
-            col->width = strlen((char *)col->name);
-         if (col->width > 1023)
-            col->width = 1023;
+         default:
+            col->width = 0;	/* skip other data types */
+            continue;
       };
 
-      // processes result as CSV output
-      row_count = 0;
-      switch(cnf->format)
+      if (col->width < strlen((char *)col->name))
+         col->width = strlen((char *)col->name);
+      if (col->width > 1023)
+         col->width = 1023;
+   };
+
+   return(0);
+}
+
+
+/// @brief displays result from ODBC operation
+/// @param cnf      pointer to configuration struct
+/// @param stmt     pointer to statement struct
+int odbcshell_odbc_result(ODBCShell * cnf, ODBCShellStmt * stmt)
+{
+   int             err;
+   SQLRETURN       sts;
+   SQLLEN          row_count;
+   unsigned long   set_count;
+
+   set_count = 1;
+
+   odbcshell_verbose(cnf, "preparing SQL results...\n");
+
+   if (cnf->format == ODBCSHELL_FORMAT_XML)
+   {
+      odbcshell_fprintf(cnf, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n");
+      odbcshell_fprintf(cnf, "<result>\n");
+   };
+
+   sts = SQL_SUCCESS;
+   while (sts == SQL_SUCCESS)
+   {
+      // retrieve description of columns
+      if ((err = odbcshell_odbc_describe(cnf, stmt)))
       {
-         case ODBCSHELL_FORMAT_FIXED:
-            err = odbcshell_odbc_result_fixedwidth(cnf, &row_count);
-            break;
-         case ODBCSHELL_FORMAT_CSV:
-            err = odbcshell_odbc_result_csv(cnf, &row_count);
-            break;
-         case ODBCSHELL_FORMAT_XML:
-            err = odbcshell_odbc_result_xml(cnf, &row_count);
-            break;
-         default:
-            err = 0;
-            break;
+         SQLCloseCursor(stmt->hstmt);
+         return(err);
       };
+      if (stmt->col_count == 0)
+      {
+         row_count = 0;
+         SQLRowCount(stmt->hstmt, &row_count);
+         odbcshell_printf(cnf, "Statement executed. %ld rows affected.\n", row_count);
+         SQLCloseCursor(stmt->hstmt);
+         return(0);
+      };
+
+      // processes result
+      row_count = 0;
+      if (!(err = odbcshell_odbc_bind(cnf, stmt)))
+         err = odbcshell_odbc_rows(cnf, stmt, 0, &row_count);
+      odbcshell_odbc_unbind(stmt);
       if ((err))
       {
-         SQLCloseCursor(cnf->current->hstmt);
+         SQLCloseCursor(stmt->hstmt);
          return(err);
       };
 
@@ -672,7 +1222,7 @@ int odbcshell_odbc_result(ODBCShell * cnf)
             set_count, row_count);
 
       // retrieves next set of results
-      sts = SQLMoreResults(cnf->current->hstmt);
+      sts = SQLMoreResults(stmt->hstmt);
       set_count++;
    };
 
@@ -681,12 +1231,12 @@ int odbcshell_odbc_result(ODBCShell * cnf)
 
    if (sts == SQL_ERROR)
    {
-      odbcshell_odbc_errors("SQLMoreResults", cnf, cnf->current);
-      SQLCloseCursor(cnf->current->hstmt);
+      odbcshell_odbc_stmt_errors("SQLMoreResults", cnf, stmt);
+      SQLCloseCursor(stmt->hstmt);
       return(-1);
    };
 
-   SQLCloseCursor(cnf->current->hstmt);
+   SQLCloseCursor(stmt->hstmt);
 
    return(0);
 }
@@ -694,8 +1244,11 @@ int odbcshell_odbc_result(ODBCShell * cnf)
 
 /// @brief displays result from ODBC operation as CSV output
 /// @param cnf        pointer to configuration struct
+/// @param stmt       pointer to statement struct
+/// @param max        maximum number of rows to display (0 for all rows)
 /// @param row_countp pointer to number of row being processed
-int odbcshell_odbc_result_csv(ODBCShell * cnf, SQLLEN * row_countp)
+int odbcshell_odbc_result_csv(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * row_countp)
 {
    short           col_index;
    SQLLEN          indicator;
@@ -704,43 +1257,39 @@ int odbcshell_odbc_result_csv(ODBCShell * cnf, SQLLEN * row_countp)
 
    *row_countp = 0;
 
-   // displays name of columns
-   for(col_index = 0; col_index < cnf->current->col_count; col_index++)
-   {
-      odbcshell_fprintf(cnf, "\"%s\"", cnf->current->cols[col_index].name);
-      if (col_index < (cnf->current->col_count-1))
-         odbcshell_fprintf(cnf, ",");
-   };
-   odbcshell_fprintf(cnf, "\n");
+   if (!(cnf->noheader))
+      odbcshell_odbc_result_header(cnf, stmt);
 
    // loops through results
-   while(1)
+   while ( (!(max)) || ((*row_countp) < max) )
    {
       // fetches next record
-      sts = SQLFetchScroll(cnf->current->hstmt, SQL_FETCH_NEXT, 1);
+      sts = odbcshell_odbc_fetch(cnf, stmt);
       if (sts == SQL_NO_DATA_FOUND)
          return(0);
       if (sts != SQL_SUCCESS)
       {
-         odbcshell_odbc_errors("SQLFetchScroll", cnf, cnf->current);
+         odbcshell_odbc_stmt_errors("SQLFetchScroll", cnf, stmt);
          return(-1);
       };
 
       // displays record
-      for(col_index = 0; col_index < cnf->current->col_count; col_index++)
+      if ((cnf->label))
+         odbcshell_fprintf(cnf, "\"%s\",", cnf->label);
+      for(col_index = 0; col_index < stmt->col_count; col_index++)
       {
-         sts = SQLGetData(cnf->current->hstmt, col_index+1, SQL_C_CHAR,
-                          buff, sizeof(buff), &indicator);
+         sts = odbcshell_odbc_value(stmt, col_index+1, buff,
+                          sizeof(buff), &indicator);
          if ((sts != SQL_SUCCESS_WITH_INFO) && (sts != SQL_SUCCESS))
          {
-            odbcshell_odbc_errors("SQLGetData", cnf, cnf->current);
-            SQLCloseCursor(cnf->current->hstmt);
+            odbcshell_odbc_stmt_errors("SQLGetData", cnf, stmt);
+            SQLCloseCursor(stmt->hstmt);
             return(-1);
          };
          if (indicator == SQL_NULL_DATA)
             buff[0] = '\0';
          odbcshell_fprintf(cnf, "\"%s\"", buff);
-         if (col_index < (cnf->current->col_count-1))
+         if (col_index < (stmt->col_count-1))
             odbcshell_fprintf(cnf, ",");
       };
       odbcshell_fprintf(cnf, "\n");
@@ -751,95 +1300,146 @@ int odbcshell_odbc_result_csv(ODBCShell * cnf, SQLLEN * row_countp)
 }
 
 
-/// @brief displays result from ODBC operation as CSV output
+/// @brief displays result from ODBC operation as CSV output
+/// @param cnf        pointer to configuration struct
+/// @param stmt       pointer to statement struct
+/// @param max        maximum number of rows to display (0 for all rows)
+/// @param row_countp pointer to number of row being processed
+int odbcshell_odbc_result_fixedwidth(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * row_countp)
+{
+   short           col_index;
+   SQLLEN          indicator;
+   SQLTCHAR        buff[1024];
+   SQLRETURN       sts;
+
+   *row_countp = 0;
+
+   if (!(cnf->noheader))
+      odbcshell_odbc_result_header(cnf, stmt);
+
+   // loops through results
+   while ( (!(max)) || ((*row_countp) < max) )
+   {
+      // fetches next record
+      sts = odbcshell_odbc_fetch(cnf, stmt);
+      if (sts == SQL_NO_DATA_FOUND)
+         return(0);
+      if (sts != SQL_SUCCESS)
+      {
+         odbcshell_odbc_stmt_errors("SQLFetchScroll", cnf, stmt);
+         return(-1);
+      };
+
+      // displays record
+      if ((cnf->label))
+         odbcshell_fprintf(cnf, "%-*.*s|", (int)cnf->label_width,
+            (int)cnf->label_width, cnf->label);
+      for(col_index = 0; col_index < stmt->col_count; col_index++)
+      {
+         sts = odbcshell_odbc_value(stmt, col_index+1, buff,
+                          sizeof(buff), &indicator);
+         if ((sts != SQL_SUCCESS_WITH_INFO) && (sts != SQL_SUCCESS))
+         {
+            odbcshell_odbc_stmt_errors("SQLGetData", cnf, stmt);
+            SQLCloseCursor(stmt->hstmt);
+            return(-1);
+         };
+         if (indicator == SQL_NULL_DATA)
+            buff[0] = '\0';
+         odbcshell_fprintf(cnf, "%-*.*s", (int)stmt->cols[col_index].width,
+            (int)stmt->cols[col_index].width,
+            buff);
+         if (col_index < (stmt->col_count-1))
+            odbcshell_fprintf(cnf, "|");
+      };
+      odbcshell_fprintf(cnf, "\n");
+      (*row_countp)++;
+   };
+
+   return(0);
+}
+
+
+/// @brief displays names of columns in the pending result set
 /// @param cnf        pointer to configuration struct
-/// @param row_countp pointer to number of row being processed
-int odbcshell_odbc_result_fixedwidth(ODBCShell * cnf, SQLLEN * row_countp)
+/// @param stmt       pointer to statement struct
+void odbcshell_odbc_result_header(ODBCShell * cnf, ODBCShellStmt * stmt)
 {
    unsigned        x;
    unsigned        y;
    short           col_index;
-   SQLLEN          indicator;
-   SQLTCHAR        buff[1024];
-   SQLRETURN       sts;
 
-   *row_countp = 0;
+   switch(cnf->format)
+   {
+      case ODBCSHELL_FORMAT_CSV:
+         if ((cnf->label))
+            odbcshell_fprintf(cnf, "\"connection\",");
+         for(col_index = 0; col_index < stmt->col_count; col_index++)
+         {
+            odbcshell_fprintf(cnf, "\"%s\"", stmt->cols[col_index].name);
+            if (col_index < (stmt->col_count-1))
+               odbcshell_fprintf(cnf, ",");
+         };
+         odbcshell_fprintf(cnf, "\n");
+         return;
+
+      case ODBCSHELL_FORMAT_FIXED:
+         break;
+
+      default:
+         return;
+   };
 
    // display deivider between header and content
-   for(x = 0; x < cnf->current->col_count; x++)
+   for(y = 0; ((cnf->label) && (y <= cnf->label_width)); y++)
+      odbcshell_fprintf(cnf, (y < cnf->label_width) ? "-" : "+");
+   for(x = 0; x < stmt->col_count; x++)
    {
-      for(y = 0; y < cnf->current->cols[x].width; y++)
+      for(y = 0; y < stmt->cols[x].width; y++)
          odbcshell_fprintf(cnf, "-");
-      if (x < (cnf->current->col_count-1))
+      if (x < (stmt->col_count-1))
          odbcshell_fprintf(cnf, "+");
    };
    odbcshell_fprintf(cnf, "\n");
 
    // displays name of columns
-   for(col_index = 0; col_index < cnf->current->col_count; col_index++)
+   if ((cnf->label))
+      odbcshell_fprintf(cnf, "%-*.*s|", (int)cnf->label_width,
+         (int)cnf->label_width, "connection");
+   for(col_index = 0; col_index < stmt->col_count; col_index++)
    {
-      odbcshell_fprintf(cnf, "%-*.*s", (int)cnf->current->cols[col_index].width,
-          (int)cnf->current->cols[col_index].width,
-          cnf->current->cols[col_index].name);
-      if (col_index < (cnf->current->col_count-1))
+      odbcshell_fprintf(cnf, "%-*.*s", (int)stmt->cols[col_index].width,
+          (int)stmt->cols[col_index].width,
+          stmt->cols[col_index].name);
+      if (col_index < (stmt->col_count-1))
          odbcshell_fprintf(cnf, "|");
    };
    odbcshell_fprintf(cnf, "\n");
 
    // display deivider between header and content
-   for(x = 0; x < cnf->current->col_count; x++)
+   for(y = 0; ((cnf->label) && (y <= cnf->label_width)); y++)
+      odbcshell_fprintf(cnf, (y < cnf->label_width) ? "-" : "+");
+   for(x = 0; x < stmt->col_count; x++)
    {
-      for(y = 0; y < cnf->current->cols[x].width; y++)
+      for(y = 0; y < stmt->cols[x].width; y++)
          odbcshell_fprintf(cnf, "-");
-      if (x < (cnf->current->col_count-1))
+      if (x < (stmt->col_count-1))
          odbcshell_fprintf(cnf, "+");
    };
    odbcshell_fprintf(cnf, "\n");
 
-   // loops through results
-   while(1)
-   {
-      // fetches next record
-      sts = SQLFetchScroll(cnf->current->hstmt, SQL_FETCH_NEXT, 1);
-      if (sts == SQL_NO_DATA_FOUND)
-         return(0);
-      if (sts != SQL_SUCCESS)
-      {
-         odbcshell_odbc_errors("SQLFetchScroll", cnf, cnf->current);
-         return(-1);
-      };
-
-      // displays record
-      for(col_index = 0; col_index < cnf->current->col_count; col_index++)
-      {
-         sts = SQLGetData(cnf->current->hstmt, col_index+1, SQL_C_CHAR,
-                          buff, sizeof(buff), &indicator);
-         if ((sts != SQL_SUCCESS_WITH_INFO) && (sts != SQL_SUCCESS))
-         {
-            odbcshell_odbc_errors("SQLGetData", cnf, cnf->current);
-            SQLCloseCursor(cnf->current->hstmt);
-            return(-1);
-         };
-         if (indicator == SQL_NULL_DATA)
-            buff[0] = '\0';
-         odbcshell_fprintf(cnf, "%-*.*s", (int)cnf->current->cols[col_index].width,
-            (int)cnf->current->cols[col_index].width,
-            buff);
-         if (col_index < (cnf->current->col_count-1))
-            odbcshell_fprintf(cnf, "|");
-      };
-      odbcshell_fprintf(cnf, "\n");
-      (*row_countp)++;
-   };
-
-   return(0);
+   return;
 }
 
 
 /// @brief displays result from ODBC operation as XML output
 /// @param cnf        pointer to configuration struct
+/// @param stmt       pointer to statement struct
+/// @param max        maximum number of rows to display (0 for all rows)
 /// @param row_countp pointer to number of row being processed
-int odbcshell_odbc_result_xml(ODBCShell * cnf, SQLLEN * row_countp)
+int odbcshell_odbc_result_xml(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * row_countp)
 {
    short           col_index;
    SQLLEN          indicator;
@@ -849,36 +1449,38 @@ int odbcshell_odbc_result_xml(ODBCShell * cnf, SQLLEN * row_countp)
    *row_countp = 0;
 
    // loops through results
-   while(1)
+   while ( (!(max)) || ((*row_countp) < max) )
    {
       // fetches next record
-      sts = SQLFetchScroll(cnf->current->hstmt, SQL_FETCH_NEXT, 1);
+      sts = odbcshell_odbc_fetch(cnf, stmt);
       if (sts == SQL_NO_DATA_FOUND)
          return(0);
       if (sts != SQL_SUCCESS)
       {
-         odbcshell_odbc_errors("SQLFetchScroll", cnf, cnf->current);
+         odbcshell_odbc_stmt_errors("SQLFetchScroll", cnf, stmt);
          return(-1);
       };
 
       odbcshell_fprintf(cnf, "\t<row>\n");
+      if ((cnf->label))
+         odbcshell_fprintf(cnf, "\t\t<connection>%s</connection>\n", cnf->label);
 
       // displays record
-      for(col_index = 0; col_index < cnf->current->col_count; col_index++)
+      for(col_index = 0; col_index < stmt->col_count; col_index++)
       {
-         sts = SQLGetData(cnf->current->hstmt, col_index+1, SQL_C_CHAR,
-                          buff, sizeof(buff), &indicator);
+         sts = odbcshell_odbc_value(stmt, col_index+1, buff,
+                          sizeof(buff), &indicator);
          if ((sts != SQL_SUCCESS_WITH_INFO) && (sts != SQL_SUCCESS))
          {
-            odbcshell_odbc_errors("SQLGetData", cnf, cnf->current);
-            SQLCloseCursor(cnf->current->hstmt);
+            odbcshell_odbc_stmt_errors("SQLGetData", cnf, stmt);
+            SQLCloseCursor(stmt->hstmt);
             return(-1);
          };
          if (indicator == SQL_NULL_DATA)
             buff[0] = '\0';
          odbcshell_fprintf(cnf, "\t\t<%s>%s</%s>\n",
-            cnf->current->cols[col_index].name, buff,
-            cnf->current->cols[col_index].name);
+            stmt->cols[col_index].name, buff,
+            stmt->cols[col_index].name);
       };
       odbcshell_fprintf(cnf, "\t</row>\n");
       (*row_countp)++;
@@ -888,28 +1490,48 @@ int odbcshell_odbc_result_xml(ODBCShell * cnf, SQLLEN * row_countp)
 }
 
 
+/// @brief displays rows from the pending result set in the output format
+/// @param cnf        pointer to configuration struct
+/// @param stmt       pointer to statement struct
+/// @param max        maximum number of rows to display (0 for all rows)
+/// @param row_countp pointer to number of row being processed
+int odbcshell_odbc_rows(ODBCShell * cnf, ODBCShellStmt * stmt, SQLLEN max,
+   SQLLEN * row_countp)
+{
+   switch(cnf->format)
+   {
+      case ODBCSHELL_FORMAT_FIXED:
+         return(odbcshell_odbc_result_fixedwidth(cnf, stmt, max, row_countp));
+      case ODBCSHELL_FORMAT_CSV:
+         return(odbcshell_odbc_result_csv(cnf, stmt, max, row_countp));
+      case ODBCSHELL_FORMAT_XML:
+         return(odbcshell_odbc_result_xml(cnf, stmt, max, row_countp));
+      default:
+         break;
+   };
+   return(0);
+}
+
+
 /// @brief displays list of ODBC datatypes
 /// @param cnf      pointer to configuration struct
 int odbcshell_odbc_show_datatypes(ODBCShell * cnf)
 {
    SQLRETURN       sts;
 
-   if (!(cnf->current))
-   {
-      odbcshell_error(cnf, "not connected to a database\n");
+   if ((odbcshell_odbc_ready(cnf)))
       return(-1);
-   };
 
    odbcshell_verbose(cnf, "sending request...\n");
 
-   sts = SQLGetTypeInfo(cnf->current->hstmt, 0);
+   sts = SQLGetTypeInfo(cnf->current->stmt->hstmt, 0);
    if (sts != SQL_SUCCESS)
    {
       odbcshell_odbc_errors("SQLGetTypeInfo", cnf, cnf->current);
       return(-1);
    };
 
-   return(odbcshell_odbc_result(cnf));
+   return(odbcshell_odbc_result(cnf, cnf->current->stmt));
 }
 
 
@@ -954,22 +1576,19 @@ int odbcshell_odbc_show_owners(ODBCShell * cnf)
 
    strncpy((char *)strwild,  "%", 2);
 
-   if (!(cnf->current))
-   {
-      odbcshell_error(cnf, "not connected to a database\n");
+   if ((odbcshell_odbc_ready(cnf)))
       return(-1);
-   };
 
    odbcshell_verbose(cnf, "sending request...\n");
 
-   sts = SQLTables(cnf->current->hstmt, NULL, 0, strwild, SQL_NTS, NULL, 0, NULL, 0);
+   sts = SQLTables(cnf->current->stmt->hstmt, NULL, 0, strwild, SQL_NTS, NULL, 0, NULL, 0);
    if (sts != SQL_SUCCESS)
    {
       odbcshell_odbc_errors("SQLGetTypeInfo", cnf, cnf->current);
       return(-1);
    };
 
-   return(odbcshell_odbc_result(cnf));
+   return(odbcshell_odbc_result(cnf, cnf->current->stmt));
 }
 
 
@@ -979,22 +1598,19 @@ int odbcshell_odbc_show_tables(ODBCShell * cnf)
 {
    SQLRETURN       sts;
 
-   if (!(cnf->current))
-   {
-      odbcshell_error(cnf, "not connected to a database\n");
+   if ((odbcshell_odbc_ready(cnf)))
       return(-1);
-   };
 
    odbcshell_verbose(cnf, "sending request...\n");
 
-   sts = SQLTables(cnf->current->hstmt, NULL, 0, NULL, 0, NULL, 0, NULL, 0);
+   sts = SQLTables(cnf->current->stmt->hstmt, NULL, 0, NULL, 0, NULL, 0, NULL, 0);
    if (sts != SQL_SUCCESS)
    {
       odbcshell_odbc_errors("SQLMoreResults", cnf, cnf->current);
       return(-1);
    };
 
-   return(odbcshell_odbc_result(cnf));
+   return(odbcshell_odbc_result(cnf, cnf->current->stmt));
 }
 
 
@@ -1007,22 +1623,19 @@ int odbcshell_odbc_show_types(ODBCShell * cnf)
 
    strncpy((char *)strwild,  "%", 2);
 
-   if (!(cnf->current))
-   {
-      odbcshell_error(cnf, "not connected to a database\n");
+   if ((odbcshell_odbc_ready(cnf)))
       return(-1);
-   };
 
    odbcshell_verbose(cnf, "sending request...\n");
 
-   sts = SQLTables(cnf->current->hstmt, NULL, 0, NULL, 0, NULL, 0, strwild, SQL_NTS);
+   sts = SQLTables(cnf->current->stmt->hstmt, NULL, 0, NULL, 0, NULL, 0, strwild, SQL_NTS);
    if (sts != SQL_SUCCESS)
    {
       odbcshell_odbc_errors("SQLGetTypeInfo", cnf, cnf->current);
       return(-1);
    };
 
-   return(odbcshell_odbc_result(cnf));
+   return(odbcshell_odbc_result(cnf, cnf->current->stmt));
 }
 
 
@@ -1035,22 +1648,312 @@ int odbcshell_odbc_show_qualifiers(ODBCShell * cnf)
 
    strncpy((char *)strwild,  "%", 2);
 
-   if (!(cnf->current))
-   {
-      odbcshell_error(cnf, "not connected to a database\n");
+   if ((odbcshell_odbc_ready(cnf)))
       return(-1);
-   };
 
    odbcshell_verbose(cnf, "sending request...\n");
 
-   sts = SQLTables(cnf->current->hstmt, strwild, SQL_NTS, NULL, 0, NULL, 0, NULL, 0);
+   sts = SQLTables(cnf->current->stmt->hstmt, strwild, SQL_NTS, NULL, 0, NULL, 0, NULL, 0);
    if (sts != SQL_SUCCESS)
    {
       odbcshell_odbc_errors("SQLMoreResults", cnf, cnf->current);
       return(-1);
    };
 
-   return(odbcshell_odbc_result(cnf));
+   return(odbcshell_odbc_result(cnf, cnf->current->stmt));
+}
+
+
+/// @brief allocates statement handle, reusing an idle handle when available
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+/// @param stmtp    pointer to pointer to statement struct
+int odbcshell_odbc_stmt_alloc(ODBCShell * cnf, ODBCShellConn * conn,
+   ODBCShellStmt ** stmtp)
+{
+   SQLRETURN       sts;
+   ODBCShellStmt * stmt;
+
+   // reuses idle statement from free list
+   if ((conn->stmts_free))
+   {
+      stmt             = conn->stmts_free;
+      conn->stmts_free = stmt->next;
+      conn->stmts_idle--;
+      stmt->next       = NULL;
+      (*stmtp)         = stmt;
+      return(0);
+   };
+
+   if (!(stmt = malloc(sizeof(ODBCShellStmt))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   memset(stmt, 0, sizeof(ODBCShellStmt));
+   stmt->conn = conn;
+
+   sts = SQLAllocHandle(SQL_HANDLE_STMT, conn->hdbc, &stmt->hstmt);
+   if (sts != SQL_SUCCESS)
+   {
+      odbcshell_odbc_diag("SQLAllocHandle", cnf, conn->hdbc, NULL);
+      free(stmt);
+      return(-1);
+   };
+
+   (*stmtp) = stmt;
+
+   return(0);
+}
+
+
+/// @brief finds the statement prepared for SQL, allocating one if not cached
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+/// @param sql      SQL string to prepare
+/// @param stmtp    pointer to pointer to statement struct
+int odbcshell_odbc_stmt_cache(ODBCShell * cnf, ODBCShellConn * conn,
+   const char * sql, ODBCShellStmt ** stmtp)
+{
+   int             err;
+   long long       i;
+   void          * ptr;
+   ODBCShellStmt * stmt;
+
+   // moves statement to the most recently used end of the cache
+   for(i = conn->cache_count - 1; i >= 0; i--)
+   {
+      if (!(strcmp(conn->cache[i]->sql, sql)))
+      {
+         stmt = conn->cache[i];
+         memmove(&conn->cache[i], &conn->cache[i+1],
+            sizeof(ODBCShellStmt *) * (size_t)(conn->cache_count - i - 1));
+         conn->cache[conn->cache_count-1] = stmt;
+         odbcshell_verbose(cnf, "reusing prepared statement...\n");
+         (*stmtp) = stmt;
+         return(0);
+      };
+   };
+
+   // discards the statement used least recently
+   if (conn->cache_count >= conn->tune.stmtcache)
+   {
+      odbcshell_odbc_stmt_free(&conn->cache[0]);
+      conn->cache_count--;
+      memmove(&conn->cache[0], &conn->cache[1], sizeof(ODBCShellStmt *) * (size_t)conn->cache_count);
+   };
+
+   if (!(ptr = realloc(conn->cache, sizeof(ODBCShellStmt *) * (size_t)(conn->cache_count+1))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   conn->cache = ptr;
+
+   stmt = NULL;
+   if ((err = odbcshell_odbc_stmt_alloc(cnf, conn, &stmt)))
+      return(err);
+   if (!(stmt->sql = strdup(sql)))
+   {
+      odbcshell_odbc_stmt_free(&stmt);
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   conn->cache[conn->cache_count] = stmt;
+   conn->cache_count++;
+
+   (*stmtp) = stmt;
+
+   return(0);
+}
+
+
+/// @brief frees all statements allocated by a connection
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+void odbcshell_odbc_stmt_close(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   ODBCShellStmt * stmt;
+
+   if ((conn->cursors_count))
+      odbcshell_verbose(cnf, "closing %lli cursors on \"%s\"...\n",
+         conn->cursors_count, conn->name);
+   while (conn->cursors_count > 0)
+   {
+      conn->cursors_count--;
+      odbcshell_odbc_stmt_free(&conn->cursors[conn->cursors_count]);
+   };
+   if ((conn->cursors))
+      free(conn->cursors);
+   conn->cursors = NULL;
+
+   while (conn->cache_count > 0)
+   {
+      conn->cache_count--;
+      odbcshell_odbc_stmt_free(&conn->cache[conn->cache_count]);
+   };
+   if ((conn->cache))
+      free(conn->cache);
+   conn->cache = NULL;
+
+   odbcshell_odbc_stmt_free(&conn->stmt);
+
+   while ((stmt = conn->stmts_free))
+   {
+      conn->stmts_free = stmt->next;
+      odbcshell_odbc_stmt_free(&stmt);
+   };
+   conn->stmts_idle = 0;
+
+   return;
+}
+
+
+/// @brief frees resources from a statement
+/// @param stmtp    pointer to pointer to statement struct
+void odbcshell_odbc_stmt_free(ODBCShellStmt ** stmtp)
+{
+   if (!(*stmtp))
+      return;
+
+   if ((*stmtp)->hstmt)
+   {
+      SQLCloseCursor((*stmtp)->hstmt);
+      SQLFreeHandle(SQL_HANDLE_STMT, (*stmtp)->hstmt);
+   };
+   (*stmtp)->hstmt = NULL;
+
+   if ((*stmtp)->cols)
+      free((*stmtp)->cols);
+   (*stmtp)->cols = NULL;
+
+   if ((*stmtp)->name)
+      free((*stmtp)->name);
+   (*stmtp)->name = NULL;
+
+   if ((*stmtp)->sql)
+      free((*stmtp)->sql);
+   (*stmtp)->sql = NULL;
+
+   if ((*stmtp)->rowset)
+      free((*stmtp)->rowset);
+   (*stmtp)->rowset = NULL;
+
+   if ((*stmtp)->rowset_ind)
+      free((*stmtp)->rowset_ind);
+   (*stmtp)->rowset_ind = NULL;
+
+   free(*stmtp);
+   (*stmtp) = NULL;
+
+   return;
+}
+
+
+/// @brief displays iODBC errors for a statement
+/// @param s        descriptive string
+/// @param cnf      pointer to configuration struct
+/// @param stmt     pointer to statement struct
+void odbcshell_odbc_stmt_errors(const char * s, ODBCShell * cnf,
+   ODBCShellStmt * stmt)
+{
+   odbcshell_odbc_diag(s, cnf, stmt->conn->hdbc, stmt->hstmt);
+   return;
+}
+
+
+/// @brief resets a statement and returns it to the connection's free list
+/// @param cnf      pointer to configuration struct
+/// @param stmtp    pointer to pointer to statement struct
+void odbcshell_odbc_stmt_release(ODBCShell * cnf, ODBCShellStmt ** stmtp)
+{
+   ODBCShellConn * conn;
+
+   if (!(*stmtp))
+      return;
+   conn = (*stmtp)->conn;
+
+   // discards state left by previous statement
+   SQLFreeStmt((*stmtp)->hstmt, SQL_CLOSE);
+   SQLFreeStmt((*stmtp)->hstmt, SQL_UNBIND);
+   SQLFreeStmt((*stmtp)->hstmt, SQL_RESET_PARAMS);
+
+   // statements held by the cache remain prepared for reuse
+   if (((*stmtp)->sql))
+   {
+      (*stmtp) = NULL;
+      return;
+   };
+
+   if ( (!(conn)) || (conn->stmts_idle >= ODBCSHELL_STMT_IDLE_MAX) )
+   {
+      odbcshell_odbc_stmt_free(stmtp);
+      return;
+   };
+
+   if ((*stmtp)->cols)
+      free((*stmtp)->cols);
+   (*stmtp)->cols      = NULL;
+   (*stmtp)->col_count = 0;
+   (*stmtp)->row_count = 0;
+
+   if ((*stmtp)->name)
+      free((*stmtp)->name);
+   (*stmtp)->name = NULL;
+
+   odbcshell_verbose(cnf, "returning statement to \"%s\" pool...\n", conn->name);
+   (*stmtp)->next   = conn->stmts_free;
+   conn->stmts_free = (*stmtp);
+   conn->stmts_idle++;
+   (*stmtp)         = NULL;
+
+   return;
+}
+
+
+/// @brief applies the statement timeout of a connection to a statement
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+/// @param stmt     pointer to statement struct
+void odbcshell_odbc_stmt_timeout(ODBCShell * cnf, ODBCShellConn * conn,
+   ODBCShellStmt * stmt)
+{
+   SQLULEN timeout;
+
+   // per-DSN setting overrides the shell setting
+   timeout = (SQLULEN)cnf->querytimeout;
+   if (conn->tune.querytimeout != -1)
+      timeout = (SQLULEN)conn->tune.querytimeout;
+   if (!(SQL_SUCCEEDED(SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_QUERY_TIMEOUT,
+      (SQLPOINTER)timeout, SQL_IS_UINTEGER))))
+      odbcshell_odbc_stmt_errors("SQLSetStmtAttr", cnf, stmt);
+   return;
+}
+
+
+/// @brief releases buffers bound for block fetches
+/// @param stmt     pointer to statement struct
+void odbcshell_odbc_unbind(ODBCShellStmt * stmt)
+{
+   if ((stmt->rowset_size))
+   {
+      SQLFreeStmt(stmt->hstmt, SQL_UNBIND);
+      SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, SQL_IS_UINTEGER);
+      SQLSetStmtAttr(stmt->hstmt, SQL_ATTR_ROWS_FETCHED_PTR, NULL, 0);
+   };
+   stmt->rowset_size  = 0;
+   stmt->rowset_count = 0;
+   stmt->rowset_next  = 0;
+
+   if ((stmt->rowset))
+      free(stmt->rowset);
+   stmt->rowset = NULL;
+
+   if ((stmt->rowset_ind))
+      free(stmt->rowset_ind);
+   stmt->rowset_ind = NULL;
+
+   return;
 }
 
 
@@ -1065,8 +1968,11 @@ int odbcshell_odbc_update_current(ODBCShell * cnf, ODBCShellConn  * conn)
    if ( (!(conn)) && (!(cnf->conns_count)) )
       return(0);
 
+   // statements keep being routed to the group if a member was disconnected
    if (!(conn))
       conn = cnf->conns[cnf->conns_count-1];
+   else
+      cnf->group = NULL;
 
    cnf->current = conn;
    odbcshell_printf(cnf, "using connection \"%s\"\n", cnf->current->name);
@@ -1095,18 +2001,128 @@ int odbcshell_odbc_use(ODBCShell * cnf, const char * name)
       return(0);
    };
 
-   for(i = 0; i < (int)cnf->conns_count; i++)
+   if (((i = odbcshell_odbc_array_findindex(cnf, name))) != -1)
+   {
+      odbcshell_odbc_update_current(cnf, cnf->conns[i]);
+      return(0);
+   };
+
+   return(odbcshell_group_use(cnf, name));
+}
+
+
+/// @brief retrieves a column of the current row as a string
+/// @param stmt     pointer to statement struct
+/// @param col      number of column (starting at 1)
+/// @param buff     buffer receiving value
+/// @param size     size of buffer
+/// @param indp     pointer to length or null indicator of value
+SQLRETURN odbcshell_odbc_value(ODBCShellStmt * stmt, SQLUSMALLINT col,
+   SQLTCHAR * buff, SQLLEN size, SQLLEN * indp)
+{
+   size_t       len;
+   const char * ptr;
+
+   if (!(stmt->rowset_size))
+      return(SQLGetData(stmt->hstmt, col, SQL_C_CHAR, buff, size, indp));
+
+   // copies value out of the bound buffers of the current row
+   (*indp) = stmt->rowset_ind[(col-1) * stmt->rowset_size + stmt->rowset_next];
+   buff[0] = '\0';
+   if ((*indp) == SQL_NULL_DATA)
+      return(SQL_SUCCESS);
+   ptr = &stmt->rowset[((col-1) * stmt->rowset_size + stmt->rowset_next) * ODBCSHELL_FETCH_WIDTH];
+   len = strnlen(ptr, ODBCSHELL_FETCH_WIDTH - 1);
+   if (len >= (size_t)size)
+      len = (size_t)size - 1;
+   memcpy(buff, ptr, len);
+   buff[len] = '\0';
+
+   return(SQL_SUCCESS);
+}
+
+
+/// @brief retrieves a column of the current row without truncating it
+/// @param cnf      pointer to configuration struct
+/// @param stmt     pointer to statement struct
+/// @param col      number of column (starting at 1)
+/// @param buffp    pointer to buffer receiving value, enlarged as needed
+/// @param sizep    pointer to allocated size of buffer
+/// @param indp     pointer to length or null indicator of value
+int odbcshell_odbc_value_full(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLUSMALLINT col, char ** buffp, size_t * sizep, SQLLEN * indp)
+{
+   size_t      len;
+   size_t      avail;
+   void      * ptr;
+   SQLLEN      ind;
+   SQLRETURN   sts;
+
+   if ((*sizep) < ODBCSHELL_FETCH_WIDTH)
    {
-      if (!(strcasecmp(name, cnf->conns[i]->name)))
+      if (!(ptr = realloc((*buffp), ODBCSHELL_FETCH_WIDTH)))
       {
-         odbcshell_odbc_update_current(cnf, cnf->conns[i]);
-         return(0);
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
       };
+      (*buffp) = ptr;
+      (*sizep) = ODBCSHELL_FETCH_WIDTH;
    };
 
-   odbcshell_error(cnf, "use: unknown connection handle\n");
+   // bound buffers cannot be completed once the block has been fetched
+   if ((stmt->rowset_size))
+   {
+      ind = stmt->rowset_ind[(col-1) * stmt->rowset_size + stmt->rowset_next];
+      if ( (ind == SQL_NO_TOTAL) || (ind >= ODBCSHELL_FETCH_WIDTH) )
+      {
+         odbcshell_error(cnf, "value of column %u exceeds %i bytes\n",
+            (unsigned)col, ODBCSHELL_FETCH_WIDTH - 1);
+         return(-1);
+      };
+      odbcshell_odbc_value(stmt, col, (SQLTCHAR *)(*buffp), (SQLLEN)(*sizep), indp);
+      return(0);
+   };
 
-   return(-1);
+   // reads value in pieces until the driver reports no more data
+   len = 0;
+   while(1)
+   {
+      if (((*sizep) - len) < 2)
+      {
+         if (!(ptr = realloc((*buffp), (*sizep) * 2)))
+         {
+            odbcshell_fatal(cnf, "out of virtual memory\n");
+            return(-2);
+         };
+         (*buffp)  = ptr;
+         (*sizep) *= 2;
+      };
+      avail = (*sizep) - len;
+      sts   = SQLGetData(stmt->hstmt, col, SQL_C_CHAR, &(*buffp)[len], (SQLLEN)avail, &ind);
+      if ( (sts == SQL_NO_DATA) && ((len)) )
+         break;
+      if (!(SQL_SUCCEEDED(sts)))
+      {
+         odbcshell_odbc_stmt_errors("SQLGetData", cnf, stmt);
+         return(-1);
+      };
+      if (ind == SQL_NULL_DATA)
+      {
+         (*buffp)[0] = '\0';
+         (*indp)     = SQL_NULL_DATA;
+         return(0);
+      };
+      if ( (ind != SQL_NO_TOTAL) && ((size_t)ind < avail) )
+      {
+         len += (size_t)ind;
+         break;
+      };
+      len += avail - 1;
+   };
+   (*buffp)[len] = '\0';
+   (*indp)       = (SQLLEN)len;
+
+   return(0);
 }
 
 
@@ -65,9 +65,24 @@ int odbcshell_odbc_array_add(ODBCShell * cnf, ODBCShellConn * conn);
 // retrieves an ODBC connection from the list
 int odbcshell_odbc_array_findindex(ODBCShell * cnf, const char * name);
 
+// calculates case insensitive hash of connection name
+uint32_t odbcshell_odbc_array_hash(const char * name);
+
+// rebuilds hash table of connection names
+int odbcshell_odbc_array_rehash(ODBCShell * cnf, size_t size);
+
 // removes an ODBC connection from the list
 int odbcshell_odbc_array_rm(ODBCShell * cnf, const char * name);
 
+// locates hash table slot of a connection
+long long odbcshell_odbc_array_slot(ODBCShell * cnf, const char * name);
+
+// binds buffers for retrieving several rows with each fetch
+int odbcshell_odbc_bind(ODBCShell * cnf, ODBCShellStmt * stmt);
+
+// binds buffers for block fetches only if no value can be truncated
+int odbcshell_odbc_bind_exact(ODBCShell * cnf, ODBCShellStmt * stmt);
+
 // closes all ODBC connections
 int odbcshell_odbc_close(ODBCShell * cnf);
 
@@ -75,9 +90,22 @@ int odbcshell_odbc_close(ODBCShell * cnf);
 int odbcshell_odbc_connect(ODBCShell * cnf, const char * dsn,
    const char * name);
 
+// retrieves description of columns in the pending result set
+int odbcshell_odbc_describe(ODBCShell * cnf, ODBCShellStmt * stmt);
+
+// displays iODBC errors for connection and statement handles
+void odbcshell_odbc_diag(const char * s, ODBCShell * cnf, HDBC hdbc,
+   HSTMT hstmt);
+
 // disconnects a session
 int odbcshell_odbc_disconnect(ODBCShell * cnf, const char * name);
 
+// establishes a connection which was deferred by lazyconnect
+int odbcshell_odbc_dial(ODBCShell * cnf, ODBCShellConn * conn);
+
+// selects environment in which new connections are allocated
+HENV odbcshell_odbc_env(ODBCShell * cnf);
+
 // displays iODBC errors
 void odbcshell_odbc_errors(const char * s, ODBCShell * cnf,
    ODBCShellConn  * conn);
@@ -85,26 +113,57 @@ void odbcshell_odbc_errors(const char * s, ODBCShell * cnf,
 // execute SQL statement
 int odbcshell_odbc_exec(ODBCShell * cnf, char * sql);
 
+// advances to the next row of the pending result set
+SQLRETURN odbcshell_odbc_fetch(ODBCShell * cnf, ODBCShellStmt * stmt);
+
 // frees resources from an iODBC connection
 void odbcshell_odbc_free(ODBCShell * cnf, ODBCShellConn  ** connp);
 
 // initializes ODBC library
 int odbcshell_odbc_initialize(ODBCShell * cnf);
 
+// opens a connection without adding it to the list of connections
+int odbcshell_odbc_open(ODBCShell * cnf, const char * dsn, const char * name,
+   ODBCShellConn ** connp);
+
+// executes a prepared statement once for each row of bound parameter arrays
+int odbcshell_odbc_params_exec(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLULEN rows, SQLULEN * donep, SQLULEN * failedp);
+
+// prepares SQL statement with the settings of its connection
+SQLRETURN odbcshell_odbc_prepare(ODBCShell * cnf, ODBCShellConn * conn,
+   ODBCShellStmt * stmt, char * sql);
+
+// verifies the current connection is available for statements
+int odbcshell_odbc_ready(ODBCShell * cnf);
+
 // reconnects a session
 int odbcshell_odbc_reconnect(ODBCShell * cnf, const char * name);
 
+// replaces the session of a connection with a new one
+int odbcshell_odbc_redial(ODBCShell * cnf, ODBCShellConn * conn);
+
 // displays result from ODBC operation
-int odbcshell_odbc_result(ODBCShell * cnf);
+int odbcshell_odbc_result(ODBCShell * cnf, ODBCShellStmt * stmt);
 
 // displays result from ODBC operation as CSV output
-int odbcshell_odbc_result_csv(ODBCShell * cnf, SQLLEN * row_countp);
+int odbcshell_odbc_result_csv(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * row_countp);
 
 // displays result from ODBC operation as Fixed Width output
-int odbcshell_odbc_result_fixedwidth(ODBCShell * cnf, SQLLEN * row_countp);
+int odbcshell_odbc_result_fixedwidth(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * row_countp);
+
+// displays names of columns in the pending result set
+void odbcshell_odbc_result_header(ODBCShell * cnf, ODBCShellStmt * stmt);
 
 // displays result from ODBC operation as XML output
-int odbcshell_odbc_result_xml(ODBCShell * cnf, SQLLEN * row_countp);
+int odbcshell_odbc_result_xml(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLLEN max, SQLLEN * row_countp);
+
+// displays rows from the pending result set in the output format
+int odbcshell_odbc_rows(ODBCShell * cnf, ODBCShellStmt * stmt, SQLLEN max,
+   SQLLEN * row_countp);
 
 // displays list of ODBC datatypes
 int odbcshell_odbc_show_datatypes(ODBCShell * cnf);
@@ -124,12 +183,48 @@ int odbcshell_odbc_show_types(ODBCShell * cnf);
 // displays list of ODBC qualifiers
 int odbcshell_odbc_show_qualifiers(ODBCShell * cnf);
 
+// allocates statement handle, reusing an idle handle when available
+int odbcshell_odbc_stmt_alloc(ODBCShell * cnf, ODBCShellConn * conn,
+   ODBCShellStmt ** stmtp);
+
+// finds the statement prepared for SQL, allocating one if not cached
+int odbcshell_odbc_stmt_cache(ODBCShell * cnf, ODBCShellConn * conn,
+   const char * sql, ODBCShellStmt ** stmtp);
+
+// frees all statements allocated by a connection
+void odbcshell_odbc_stmt_close(ODBCShell * cnf, ODBCShellConn * conn);
+
+// displays iODBC errors for a statement
+void odbcshell_odbc_stmt_errors(const char * s, ODBCShell * cnf,
+   ODBCShellStmt * stmt);
+
+// frees resources from a statement
+void odbcshell_odbc_stmt_free(ODBCShellStmt ** stmtp);
+
+// resets a statement and returns it to the connection's free list
+void odbcshell_odbc_stmt_release(ODBCShell * cnf, ODBCShellStmt ** stmtp);
+
+// applies the statement timeout of a connection to a statement
+void odbcshell_odbc_stmt_timeout(ODBCShell * cnf, ODBCShellConn * conn,
+   ODBCShellStmt * stmt);
+
+// releases buffers bound for block fetches
+void odbcshell_odbc_unbind(ODBCShellStmt * stmt);
+
 // updates current connection
 int odbcshell_odbc_update_current(ODBCShell * cnf, ODBCShellConn  * conn);
 
 // switches active connection
 int odbcshell_odbc_use(ODBCShell * cnf, const char * name);
 
+// retrieves a column of the current row as a string
+SQLRETURN odbcshell_odbc_value(ODBCShellStmt * stmt, SQLUSMALLINT col,
+   SQLTCHAR * buff, SQLLEN size, SQLLEN * indp);
+
+// retrieves a column of the current row without truncating it
+int odbcshell_odbc_value_full(ODBCShell * cnf, ODBCShellStmt * stmt,
+   SQLUSMALLINT col, char ** buffp, size_t * sizep, SQLLEN * indp);
+
 // displays ODBC version
 int odbcshell_odbc_version(ODBCShell * cnf);
 
@@ -51,9 +51,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "odbcshell-group.h"
 #include "odbcshell-odbc.h"
+#include "odbcshell-pool.h"
 #include "odbcshell-signal.h"
 #include "odbcshell-print.h"
+#include "odbcshell-tune.h"
 
 
 /////////////////
@@ -66,6 +69,50 @@
 #pragma mark Functions
 #endif
 
+/// @brief copies configuration for use by a worker thread
+/// @param cnf      pointer to configuration struct being copied
+/// @param copy     pointer to configuration struct receiving copy
+/// @param output   stream receiving results of worker
+/// @param errs     stream receiving messages and errors of worker
+void odbcshell_clone(ODBCShell * cnf, ODBCShell * copy, FILE * output,
+   FILE * errs)
+{
+   // worker shares settings, but never the connections, pool, jobs, or
+   // queued statements owned by the shell, so that each worker's results
+   // and messages can be reported together once it finishes
+   memcpy(copy, cnf, sizeof(ODBCShell));
+   copy->output          = output;
+   copy->msgs            = errs;
+   copy->errs            = errs;
+   copy->label           = NULL;
+   copy->lazyconnect     = 0;
+   copy->active_cmd      = NULL;
+   copy->current         = NULL;
+   copy->conns           = NULL;
+   copy->conns_count     = 0;
+   copy->conns_size      = 0;
+   copy->conns_hash      = NULL;
+   copy->conns_hash_size = 0;
+   copy->pool            = NULL;
+   copy->pool_count      = 0;
+   copy->poolsize        = 0;
+   copy->jobs            = NULL;
+   copy->jobs_count      = 0;
+   copy->script          = NULL;
+   copy->batch           = NULL;
+   copy->batch_len       = 0;
+   copy->batch_count     = 0;
+   copy->batch_lines     = NULL;
+   copy->batch_conn      = NULL;
+   copy->group           = NULL;
+   copy->parallel        = NULL;
+   copy->parallel_count  = 0;
+   copy->parallel_max    = 0;
+
+   return;
+}
+
+
 /// @brief frees resources
 /// @param cnf      pointer to configuration struct
 void odbcshell_free(ODBCShell * cnf)
@@ -74,6 +121,8 @@ void odbcshell_free(ODBCShell * cnf)
       return;
 
    odbcshell_odbc_close(cnf);
+   odbcshell_tune_free(cnf);
+   odbcshell_group_free(cnf);
 
    if (cnf->conffile)
       free(cnf->conffile);
@@ -87,10 +136,23 @@ void odbcshell_free(ODBCShell * cnf)
       free(cnf->prompt);
    cnf->prompt = NULL;
 
+   if (cnf->poolcheck)
+      free(cnf->poolcheck);
+   cnf->poolcheck = NULL;
+
    if (cnf->exec_strs)
       free(cnf->exec_strs);
    cnf->exec_strs = NULL;
 
+   if (cnf->exec_indeps)
+      free(cnf->exec_indeps);
+   cnf->exec_indeps = NULL;
+
+   if (cnf->dflt_dsns)
+      free(cnf->dflt_dsns);
+   cnf->dflt_dsns = NULL;
+   cnf->dflt_dsns_count = 0;
+
    odbcshell_fclose(cnf);
 
    free(cnf);
@@ -107,6 +169,12 @@ int odbcshell_get_option(ODBCShell * cnf, int opt, void * ptr)
 {
    switch(opt)
    {
+      case ODBCSHELL_OPT_AUTORECONNECT:
+         *((int *)ptr) = (int)cnf->autoreconnect;
+         break;
+      case ODBCSHELL_OPT_CONCURRENCY:
+         *((int *)ptr) = (int)cnf->concurrency;
+         break;
       case ODBCSHELL_OPT_CONFFILE:
          *((char **)ptr) = NULL;
          if (!(cnf->conffile))
@@ -119,15 +187,36 @@ int odbcshell_get_option(ODBCShell * cnf, int opt, void * ptr)
             return(0);
          *((char **)ptr) = cnf->histfile;
          break;
+      case ODBCSHELL_OPT_LAZYCONNECT:
+         *((int *)ptr) = (int)cnf->lazyconnect;
+         break;
       case ODBCSHELL_OPT_ODBCPROMPT:
          *((int *)ptr) = (int)cnf->odbcprompt;
          break;
+      case ODBCSHELL_OPT_QUERYTIMEOUT:
+         *((int *)ptr) = (int)cnf->querytimeout;
+         break;
+      case ODBCSHELL_OPT_BATCHSTATEMENTS:
+         *((int *)ptr) = (int)cnf->batchstatements;
+         break;
       case ODBCSHELL_OPT_PROMPT:
          *((char **)ptr) = NULL;
          if (!(cnf->prompt))
             return(0);
          *((char **)ptr) = cnf->prompt;
          break;
+      case ODBCSHELL_OPT_POOLCHECK:
+         *((char **)ptr) = cnf->poolcheck;
+         break;
+      case ODBCSHELL_OPT_POOLSIZE:
+         *((int *)ptr) = (int)cnf->poolsize;
+         break;
+      case ODBCSHELL_OPT_POOLTTL:
+         *((int *)ptr) = (int)cnf->poolttl;
+         break;
+      case ODBCSHELL_OPT_RETRYREADS:
+         *((int *)ptr) = (int)cnf->retryreads;
+         break;
       case ODBCSHELL_OPT_SILENT:
          *((int *)ptr) = (int)cnf->silent;
          break;
@@ -177,13 +266,25 @@ int odbcshell_initialize(ODBCShell ** cnfp)
 int odbcshell_set_defaults(ODBCShell * cnf)
 {
    odbcshell_odbc_close(cnf);
+   odbcshell_tune_free(cnf);
+   odbcshell_group_free(cnf);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_AUTORECONNECT, NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_BATCHSTATEMENTS, NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_CONCURRENCY, NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_CONFFILE, NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_CONTINUE, NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_HISTFILE, NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_HISTORY,  NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_LAZYCONNECT, NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_NOSHELL,  NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_ODBCPROMPT,NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_POOLCHECK, NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_POOLSIZE, NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_POOLTTL,  NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_PROMPT,   NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_QUERYTIMEOUT, NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_RETRYREADS, NULL)) return(-1);
+   if (odbcshell_set_option(cnf, ODBCSHELL_OPT_ROUTING,  NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_SILENT,   NULL)) return(-1);
    if (odbcshell_set_option(cnf, ODBCSHELL_OPT_VERBOSE,  NULL)) return(-1);
    return(0);
@@ -199,6 +300,30 @@ int odbcshell_set_option(ODBCShell * cnf, int opt, const void * ptr)
    char   buff[2048];
    switch(opt)
    {
+      case ODBCSHELL_OPT_AUTORECONNECT:
+         cnf->autoreconnect = 0;
+         if (!(ptr))
+            return(0);
+         if ( *((const int *)ptr) < 0 )
+         {
+            odbcshell_error(cnf, "invalid value for option \"autoreconnect\"\n");
+            return(-1);
+         };
+         cnf->autoreconnect = *((const int *)ptr);
+         break;
+
+      case ODBCSHELL_OPT_CONCURRENCY:
+         cnf->concurrency = ODBCSHELL_CONCURRENCY;
+         if (!(ptr))
+            return(0);
+         if ( *((const int *)ptr) < 1 )
+         {
+            odbcshell_error(cnf, "invalid value for option \"concurrency\"\n");
+            return(-1);
+         };
+         cnf->concurrency = *((const int *)ptr);
+         break;
+
       case ODBCSHELL_OPT_CONFFILE:
          if (cnf->conffile)
             free(cnf->conffile);
@@ -261,6 +386,13 @@ int odbcshell_set_option(ODBCShell * cnf, int opt, const void * ptr)
             cnf->history = *((const int *)ptr);
          return(0);
 
+      case ODBCSHELL_OPT_LAZYCONNECT:
+         if (!(ptr))
+            cnf->lazyconnect = 0;
+         else
+            cnf->lazyconnect = *((const int *)ptr);
+         break;
+
       case ODBCSHELL_OPT_NOSHELL:
          if (!(ptr))
             return(0);
@@ -287,6 +419,93 @@ int odbcshell_set_option(ODBCShell * cnf, int opt, const void * ptr)
          };
          break;
 
+      case ODBCSHELL_OPT_POOLCHECK:
+         if (cnf->poolcheck)
+            free(cnf->poolcheck);
+         cnf->poolcheck = NULL;
+         if (!(ptr))
+            return(0);
+         if (!(((const char *)ptr)[0]))
+            return(0);
+         if (!(cnf->poolcheck = strdup((const char *)ptr)))
+         {
+            odbcshell_fatal(cnf, "out of virtual memory\n");
+            return(-2);
+         };
+         break;
+
+      case ODBCSHELL_OPT_POOLSIZE:
+         cnf->poolsize = ODBCSHELL_POOL_SIZE;
+         if (!(ptr))
+            return(0);
+         if ( *((const int *)ptr) < 0 )
+         {
+            odbcshell_error(cnf, "invalid value for option \"poolsize\"\n");
+            return(-1);
+         };
+         cnf->poolsize = *((const int *)ptr);
+         odbcshell_pool_trim(cnf);
+         break;
+
+      case ODBCSHELL_OPT_POOLTTL:
+         cnf->poolttl = ODBCSHELL_POOL_TTL;
+         if (!(ptr))
+            return(0);
+         if ( *((const int *)ptr) < 0 )
+         {
+            odbcshell_error(cnf, "invalid value for option \"poolttl\"\n");
+            return(-1);
+         };
+         cnf->poolttl = *((const int *)ptr);
+         odbcshell_pool_trim(cnf);
+         break;
+
+      case ODBCSHELL_OPT_BATCHSTATEMENTS:
+         cnf->batchstatements = 0;
+         if (!(ptr))
+            return(0);
+         if ( *((const int *)ptr) < 0 )
+         {
+            odbcshell_error(cnf, "invalid value for option \"batchstatements\"\n");
+            return(-1);
+         };
+         cnf->batchstatements = *((const int *)ptr);
+         break;
+
+      case ODBCSHELL_OPT_QUERYTIMEOUT:
+         cnf->querytimeout = 0;
+         if (!(ptr))
+            return(0);
+         if ( *((const int *)ptr) < 0 )
+         {
+            odbcshell_error(cnf, "invalid value for option \"querytimeout\"\n");
+            return(-1);
+         };
+         cnf->querytimeout = *((const int *)ptr);
+         break;
+
+      case ODBCSHELL_OPT_RETRYREADS:
+         if (!(ptr))
+            cnf->retryreads = 0;
+         else
+            cnf->retryreads = *((const int *)ptr);
+         break;
+
+      case ODBCSHELL_OPT_ROUTING:
+         cnf->routing = ODBCSHELL_ROUTING_LATENCY;
+         if (!(ptr))
+            return(0);
+         if (!(strcasecmp("latency", ((const char *)ptr))))
+            cnf->routing = ODBCSHELL_ROUTING_LATENCY;
+         else if (!(strcasecmp("roundrobin", ((const char *)ptr))))
+            cnf->routing = ODBCSHELL_ROUTING_ROUNDROBIN;
+         else
+         {
+            odbcshell_error(cnf, "invalid value for option \"routing\"\n");
+            return(-1);
+         }
+         break;
+
       case ODBCSHELL_OPT_SILENT:
          if (!(ptr))
             cnf->silent = 0;
@@ -316,6 +535,14 @@ int odbcshell_show_option(ODBCShell * cnf, int opt)
 {
    switch(opt)
    {
+      case ODBCSHELL_OPT_AUTORECONNECT:
+         printf("%-15s %lld\n", "autoreconnect", cnf->autoreconnect);
+         break;
+
+      case ODBCSHELL_OPT_CONCURRENCY:
+         printf("%-15s %lld\n", "concurrency", cnf->concurrency);
+         break;
+
       case ODBCSHELL_OPT_CONFFILE:
          printf("%-15s %s\n", "conffile", cnf->conffile  ? cnf->conffile : "");
          break;
@@ -348,6 +575,10 @@ int odbcshell_show_option(ODBCShell * cnf, int opt)
          printf("%-15s %s\n", "history", cnf->history ? "yes" : "no");
          break;
 
+      case ODBCSHELL_OPT_LAZYCONNECT:
+         printf("%-15s %s\n", "lazyconnect", cnf->lazyconnect ? "yes" : "no");
+         break;
+
       case ODBCSHELL_OPT_NOSHELL:
          printf("%-15s %s\n", "noshell", cnf->noshell ? "yes" : "no");
          break;
@@ -360,6 +591,34 @@ int odbcshell_show_option(ODBCShell * cnf, int opt)
          printf("%-15s \"%s\"\n", "prompt", cnf->prompt);
          break;
 
+      case ODBCSHELL_OPT_QUERYTIMEOUT:
+         printf("%-15s %lld\n", "querytimeout", cnf->querytimeout);
+         break;
+      case ODBCSHELL_OPT_BATCHSTATEMENTS:
+         printf("%-15s %lld\n", "batchstatements", cnf->batchstatements);
+         break;
+
+      case ODBCSHELL_OPT_POOLCHECK:
+         printf("%-15s \"%s\"\n", "poolcheck", cnf->poolcheck ? cnf->poolcheck : "");
+         break;
+
+      case ODBCSHELL_OPT_POOLSIZE:
+         printf("%-15s %lld\n", "poolsize", cnf->poolsize);
+         break;
+
+      case ODBCSHELL_OPT_POOLTTL:
+         printf("%-15s %lld\n", "poolttl", cnf->poolttl);
+         break;
+
+      case ODBCSHELL_OPT_RETRYREADS:
+         printf("%-15s %s\n", "retryreads", cnf->retryreads ? "yes" : "no");
+         break;
+
+      case ODBCSHELL_OPT_ROUTING:
+         printf("%-15s %s\n", "routing",
+            (cnf->routing == ODBCSHELL_ROUTING_ROUNDROBIN) ? "roundrobin" : "latency");
+         break;
+
       case ODBCSHELL_OPT_SILENT:
          printf("%-15s %s\n", "silent", cnf->silent ? "yes" : "no");
          break;
@@ -59,6 +59,10 @@
 #pragma mark Prototypes
 #endif
 
+// copies configuration for use by a worker thread
+void odbcshell_clone(ODBCShell * cnf, ODBCShell * copy, FILE * output,
+   FILE * errs);
+
 // frees resources
 void odbcshell_free(ODBCShell * cnf);
 
@@ -0,0 +1,404 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-parallel.c ODBC Shell runs statements of a block at once
+ */
+#include "odbcshell-parallel.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-pool.h"
+#include "odbcshell-print.h"
+#include "odbcshell-signal.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief queues a statement within the open parallel block
+/// @param cnf      pointer to configuration struct
+/// @param cmd      command being interpreted
+/// @param str      unparsed statement
+int odbcshell_parallel_add(ODBCShell * cnf, ODBCShellOption * cmd,
+   const char * str)
+{
+   void                  * ptr;
+   ODBCShellParallelStmt * stmt;
+
+   // commands of the shell would depend on the order statements finish
+   if (cmd->val != ODBCSHELL_CMD_ODBC)
+   {
+      odbcshell_error(cnf, "%s: only SQL statements may appear within a parallel block\n", cmd->name);
+      return(-1);
+   };
+
+   if (!(ptr = realloc(cnf->parallel, sizeof(ODBCShellParallelStmt) * (size_t)(cnf->parallel_count+1))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   cnf->parallel = ptr;
+
+   stmt = &cnf->parallel[cnf->parallel_count];
+   memset(stmt, 0, sizeof(ODBCShellParallelStmt));
+   if (!(stmt->sql = strdup(str)))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(-2);
+   };
+   stmt->line = cnf->script_line;
+   cnf->parallel_count++;
+
+   return(0);
+}
+
+
+/// @brief opens a block of statements which are run at once
+/// @param cnf      pointer to configuration struct
+/// @param max      most statements run at once
+int odbcshell_parallel_begin(ODBCShell * cnf, long long max)
+{
+   if ((cnf->parallel_max))
+   {
+      odbcshell_error(cnf, "parallel block has already begun\n");
+      return(-1);
+   };
+   odbcshell_verbose(cnf, "queuing statements of parallel block...\n");
+   cnf->parallel_max = max;
+   return(0);
+}
+
+
+/// @brief runs statements of the open block and waits for all to finish
+/// @param cnf      pointer to configuration struct
+int odbcshell_parallel_end(ODBCShell * cnf)
+{
+   int                       err;
+   int                       code;
+   long long                 l;
+   long long                 threads;
+   long long                 started;
+   long long                 failed;
+   long long                 msecs;
+   sigset_t                  oldset;
+   pthread_t               * tids;
+   struct timespec           start;
+   struct timespec           end;
+   ODBCShellParallel         block;
+   ODBCShellParallelStmt   * stmt;
+   ODBCShellParallelWorker * workers;
+   ODBCShellParallelWorker * worker;
+   char                      name[64];
+
+   if (!(cnf->parallel_max))
+   {
+      odbcshell_error(cnf, "no parallel block to end\n");
+      return(-1);
+   };
+
+   // block is closed whether or not its statements succeed
+   memset(&block, 0, sizeof(ODBCShellParallel));
+   block.stmts         = cnf->parallel;
+   block.count         = cnf->parallel_count;
+   threads             = (block.count < cnf->parallel_max) ? block.count : cnf->parallel_max;
+   cnf->parallel       = NULL;
+   cnf->parallel_count = 0;
+   cnf->parallel_max   = 0;
+
+   if (!(block.count))
+      return(0);
+   if ((err = odbcshell_odbc_ready(cnf)))
+   {
+      cnf->parallel       = block.stmts;
+      cnf->parallel_count = block.count;
+      odbcshell_parallel_free(cnf);
+      return(err);
+   };
+   block.dsn = cnf->current->dsn;
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   code    = 0;
+   workers = calloc((size_t)threads, sizeof(ODBCShellParallelWorker));
+   tids    = calloc((size_t)threads, sizeof(pthread_t));
+   if ( (!(workers)) || (!(tids)) )
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      code = -2;
+   };
+
+   for(l = 0; ( (!(code)) && (l < block.count) ); l++)
+   {
+      stmt         = &block.stmts[l];
+      stmt->output = open_memstream(&stmt->buff, &stmt->bufflen);
+      stmt->msgs   = open_memstream(&stmt->msg,  &stmt->msglen);
+      stmt->errs   = open_memstream(&stmt->err,  &stmt->errlen);
+      if ( (!(stmt->output)) || (!(stmt->msgs)) || (!(stmt->errs)) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+      };
+   };
+
+   for(l = 0; ( (!(code)) && (l < threads) ); l++)
+   {
+      worker        = &workers[l];
+      worker->id    = l + 1;
+      worker->block = &block;
+      if (!(worker->errs = open_memstream(&worker->err, &worker->errlen)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         code = -2;
+         break;
+      };
+
+      // idle connections to the data source are handed to workers
+      snprintf(name, sizeof(name), "parallel-%lld", worker->id);
+      if ((code = odbcshell_pool_take(cnf, block.dsn, name, &worker->conn)))
+         break;
+
+      // results of each statement are kept apart until the block finishes
+      odbcshell_clone(cnf, &worker->cnf, worker->errs, worker->errs);
+   };
+
+   // statements are executed by a bounded set of workers and the block
+   // finishes only once every statement has finished
+   if (!(code))
+   {
+      odbcshell_verbose(cnf, "running %lld statements on %lld connections...\n",
+         block.count, threads);
+      pthread_mutex_init(&block.lock, NULL);
+      odbcshell_signal_block(&oldset);
+      for(started = 0; started < threads; started++)
+         if ((pthread_create(&tids[started], NULL, odbcshell_parallel_thread, &workers[started])))
+            break;
+      odbcshell_signal_restore(&oldset);
+      if (!(started))
+         odbcshell_parallel_thread(&workers[0]);
+      for(l = 0; l < started; l++)
+         pthread_join(tids[l], NULL);
+      pthread_mutex_destroy(&block.lock);
+   };
+
+   // results are displayed in the order statements appear in the block
+   failed = 0;
+   for(l = 0; l < block.count; l++)
+   {
+      stmt = &block.stmts[l];
+      if ((stmt->output))
+         fclose(stmt->output);
+      if ((stmt->msgs))
+         fclose(stmt->msgs);
+      if ((stmt->errs))
+         fclose(stmt->errs);
+      stmt->output = NULL;
+      stmt->msgs   = NULL;
+      stmt->errs   = NULL;
+      if ((code))
+         continue;
+      if ( (l >= block.next) || ((stmt->code)) )
+      {
+         failed++;
+         if ((cnf->script))
+            odbcshell_error(cnf, "%s:%lld: statement %s\n", cnf->script, stmt->line,
+               (l >= block.next) ? "was not executed" : "failed");
+      };
+      if ((stmt->bufflen))
+         fwrite(stmt->buff, 1, stmt->bufflen, ((cnf->output)) ? cnf->output : stdout);
+      if ((stmt->msglen))
+         fwrite(stmt->msg, 1, stmt->msglen, ((cnf->msgs)) ? cnf->msgs : stdout);
+      if ((stmt->errlen))
+         fwrite(stmt->err, 1, stmt->errlen, ((cnf->errs)) ? cnf->errs : stderr);
+      if ( (stmt->code == -2) && (code != -2) )
+         code = -2;
+   };
+
+   // reports errors of each worker and releases connections
+   for(l = 0; ( ((workers)) && (l < threads) ); l++)
+   {
+      worker = &workers[l];
+      if ((worker->errs))
+         fclose(worker->errs);
+      worker->errs = NULL;
+      if ((worker->errlen))
+         fwrite(worker->err, 1, worker->errlen, ((cnf->errs)) ? cnf->errs : stderr);
+      free(worker->err);
+      if ((worker->conn))
+      {
+         if ((worker->code))
+            odbcshell_odbc_free(cnf, &worker->conn);
+         else
+            odbcshell_pool_put(cnf, &worker->conn);
+      };
+   };
+   free(workers);
+   free(tids);
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   odbcshell_verbose(cnf, "parallel block finished in %lld ms\n", msecs);
+
+   if ( (!(code)) && ((failed)) )
+   {
+      odbcshell_error(cnf, "%lld of %lld statements in parallel block failed\n", failed, block.count);
+      code = -1;
+   };
+
+   cnf->parallel       = block.stmts;
+   cnf->parallel_count = block.count;
+   odbcshell_parallel_free(cnf);
+
+   return(code);
+}
+
+
+/// @brief discards statements queued within the open block
+/// @param cnf      pointer to configuration struct
+void odbcshell_parallel_free(ODBCShell * cnf)
+{
+   long long l;
+
+   for(l = 0; l < cnf->parallel_count; l++)
+   {
+      free(cnf->parallel[l].sql);
+      free(cnf->parallel[l].buff);
+      free(cnf->parallel[l].msg);
+      free(cnf->parallel[l].err);
+   };
+   free(cnf->parallel);
+   cnf->parallel       = NULL;
+   cnf->parallel_count = 0;
+   cnf->parallel_max   = 0;
+
+   return;
+}
+
+
+/// @brief worker thread executing statements of a parallel block
+/// @param ptr      pointer to worker
+void * odbcshell_parallel_thread(void * ptr)
+{
+   ODBCShellParallelWorker * worker;
+
+   worker       = ptr;
+   worker->code = odbcshell_parallel_worker(worker);
+   fflush(worker->errs);
+
+   return(NULL);
+}
+
+
+/// @brief executes statements of a block until none remain
+/// @param worker   pointer to worker
+int odbcshell_parallel_worker(ODBCShellParallelWorker * worker)
+{
+   int                     err;
+   long long               l;
+   struct timespec         start;
+   struct timespec         end;
+   ODBCShell             * cnf;
+   ODBCShellParallel     * block;
+   ODBCShellParallelStmt * stmt;
+   char                    name[64];
+
+   cnf   = &worker->cnf;
+   block = worker->block;
+
+   if (!(worker->conn))
+   {
+      snprintf(name, sizeof(name), "parallel-%lld", worker->id);
+      if ((err = odbcshell_odbc_open(cnf, block->dsn, name, &worker->conn)))
+         return(err);
+   };
+   cnf->current = worker->conn;
+
+   while(1)
+   {
+      pthread_mutex_lock(&block->lock);
+      l = block->next++;
+      pthread_mutex_unlock(&block->lock);
+
+      if (l >= block->count)
+         break;
+
+      // statements are executed the same way as outside of the block
+      stmt             = &block->stmts[l];
+      cnf->output      = stmt->output;
+      cnf->msgs        = stmt->msgs;
+      cnf->errs        = stmt->errs;
+      cnf->script_line = stmt->line;
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      stmt->code  = odbcshell_odbc_exec(cnf, stmt->sql);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      stmt->msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+                  + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+      odbcshell_verbose(cnf, "statement finished in %lld ms on \"%s\"\n", stmt->msecs,
+         worker->conn->name);
+      fflush(stmt->output);
+      fflush(stmt->msgs);
+      fflush(stmt->errs);
+   };
+
+   cnf->output = worker->errs;
+   cnf->msgs   = worker->errs;
+   cnf->errs   = worker->errs;
+
+   return(0);
+}
+
+/* end of source */
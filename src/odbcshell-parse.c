@@ -51,8 +51,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "odbcshell-batch.h"
 #include "odbcshell-commands.h"
+#include "odbcshell-parallel.h"
 #include "odbcshell-print.h"
+#include "odbcshell-signal.h"
 #include "odbcshell-variables.h"
 
 
@@ -169,7 +172,10 @@ int odbcshell_interpret_buffer(ODBCShell * cnf, char * buff, size_t len,
    char       ** argv;
    char          delim;
    size_t        pos;
+   size_t        start;
    ssize_t       offset;
+   long long     line;
+   long long     joined;
 
    argc     = 0;
    argv     = NULL;
@@ -181,17 +187,29 @@ int odbcshell_interpret_buffer(ODBCShell * cnf, char * buff, size_t len,
    while(pos < len)
    {
       // extracts next line in buffer
+      line = cnf->script_line;
       if (odbcshell_parse_line(cnf, &buff[pos], &argc, &argv, &offset))
          return(-1);
+      joined           = cnf->script_line - line;
+      cnf->script_line = line;
       if ((offset == -1))
          return(2);
       if (!(argc))
       {
+         for(start = pos; start <= (pos + (size_t)offset); start++)
+            if (buff[start] == '\n')
+               cnf->script_line++;
+         cnf->script_line += joined;
          pos              += offset+1;
          *offsetp         += offset;
          continue;
       };
 
+      // statement is numbered by the line on which it starts
+      for(start = pos; ((strchr(" \t\r\n", buff[start]))) && (start < (pos + (size_t)offset)); start++)
+         if (buff[start] == '\n')
+            cnf->script_line++;
+
       // replaces line delimiter with '\0'
       delim             = buff[offset+pos];
       buff[offset+pos]  = '\0';
@@ -209,6 +227,7 @@ int odbcshell_interpret_buffer(ODBCShell * cnf, char * buff, size_t len,
             buff[offset+pos] = delim;
             if ( (!(code)) || (!(cnf->continues)) )
                return(code);
+            break;
 
          // indicates that a fatal error was encountered
          case -2:
@@ -220,6 +239,11 @@ int odbcshell_interpret_buffer(ODBCShell * cnf, char * buff, size_t len,
             break;
       };
 
+      // counts line breaks within quoted strings and continued lines too
+      for(; start <= (pos + (size_t)offset); start++)
+         if (buff[start] == '\n')
+            cnf->script_line++;
+      cnf->script_line += joined;
       pos += offset+1;
    };
    return(0);
@@ -266,18 +290,44 @@ int odbcshell_interpret_line(ODBCShell * cnf, char * str, int argc,
       return(-1);
    };
 
+   // statements within a parallel block are run once the block ends
+   if ( ((cnf->parallel_max)) && (cmd->val != ODBCSHELL_CMD_PARALLEL) )
+      return(odbcshell_parallel_add(cnf, cmd, str));
+
+   // queues statements from scripts to be sent as a batch
+   if ((odbcshell_batch_accepts(cnf, cmd, str)))
+      return(odbcshell_batch_add(cnf, str));
+
+   // sends queued statements before running any other command
+   if ((code = odbcshell_batch_flush(cnf)))
+      if ( (code == -2) || (!(cnf->continues)) )
+         return(code);
+
    // executes command
    cnf->active_cmd = cmd;
    switch(cmd->val)
    {
+      case ODBCSHELL_CMD_BENCH:      code = odbcshell_cmd_bench(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_CHUNKED:    code = odbcshell_cmd_chunked(cnf, argc, argv, str); break;
       case ODBCSHELL_CMD_CLEAR:      code = odbcshell_cmd_clear(); break;
       case ODBCSHELL_CMD_CLOSE:      code = odbcshell_cmd_close(cnf); break;
+      case ODBCSHELL_CMD_COMPARE:    code = odbcshell_cmd_compare(cnf, argc, argv); break;
       case ODBCSHELL_CMD_CONNECT:    code = odbcshell_cmd_connect(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_COPY:       code = odbcshell_cmd_copy(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_CURSOR:     code = odbcshell_cmd_cursor(cnf, argc, argv, str); break;
       case ODBCSHELL_CMD_DISCONNECT: code = odbcshell_cmd_disconnect(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_DUMP:       code = odbcshell_cmd_dump(cnf, argc, argv); break;
       case ODBCSHELL_CMD_ECHO:       code = odbcshell_cmd_echo(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_EXPORT:     code = odbcshell_cmd_export(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_GENERATE:   code = odbcshell_cmd_generate(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_GROUP:      code = odbcshell_cmd_group(cnf, argc, argv); break;
       case ODBCSHELL_CMD_HELP:       code = odbcshell_cmd_help(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_IMPORT:     code = odbcshell_cmd_import(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_JOBS:       code = odbcshell_cmd_jobs(cnf); break;
       case ODBCSHELL_CMD_ODBC:       code = odbcshell_cmd_exec(cnf, str, 0); break;
+      case ODBCSHELL_CMD_ON:         code = odbcshell_cmd_on(cnf, argc, argv, str); break;
       case ODBCSHELL_CMD_OPEN:       code = odbcshell_cmd_open(cnf, argc, argv); break;
+      case ODBCSHELL_CMD_PARALLEL:   code = odbcshell_cmd_parallel(cnf, argc, argv); break;
       case ODBCSHELL_CMD_QUIT:       code = odbcshell_cmd_quit(cnf); break;
       case ODBCSHELL_CMD_RECONNECT:  code = odbcshell_cmd_reconnect(cnf, argc, argv); break;
       case ODBCSHELL_CMD_RESET:      code = odbcshell_cmd_reset(cnf); break;
@@ -286,13 +336,16 @@ int odbcshell_interpret_line(ODBCShell * cnf, char * str, int argc,
       case ODBCSHELL_CMD_SETENV:     code = odbcshell_cmd_setenv(cnf, argc, argv); break;
       case ODBCSHELL_CMD_SHOW:       code = odbcshell_cmd_show(cnf, argv[1]); break;
       case ODBCSHELL_CMD_SOURCE:     code = odbcshell_cmd_source(cnf, argv[1]); break;
+      case ODBCSHELL_CMD_TUNE:       code = odbcshell_cmd_tune(cnf, argc, argv); break;
       case ODBCSHELL_CMD_UNSET:      code = odbcshell_cmd_unset(cnf, argv); break;
       case ODBCSHELL_CMD_UNSETENV:   code = odbcshell_cmd_unsetenv(argc, argv); break;
       case ODBCSHELL_CMD_USE:        code = odbcshell_cmd_use(cnf, argc, argv); break;
       case ODBCSHELL_CMD_VERSION:    code = odbcshell_cmd_version(cnf); break;
+      case ODBCSHELL_CMD_WAIT:       code = odbcshell_cmd_wait(cnf, argc, argv); break;
       default:                       code = odbcshell_cmd_incomplete(cnf, argc, argv); break;
    };
    cnf->active_cmd = NULL;
+   odbcshell_signal_stmt(NULL);
 
    return(code);
 }
@@ -349,7 +402,10 @@ int odbcshell_parse_line(ODBCShell * cnf, char * line, int * argcp,
             if ((line[pos+1] != '\n') && (line[pos+1] != '\0'))
                continue;
             if (line[pos+1] == '\n')
+            {
                line[pos+1] = ' ';
+               cnf->script_line++;
+            };
             if (line[pos+1] == '\0')
                return(0);
             break;
@@ -367,7 +423,7 @@ int odbcshell_parse_line(ODBCShell * cnf, char * line, int * argcp,
          case '#':
             while((line[pos] != '\n') && (line[pos] != '\r') && (pos < len))
                pos++;
-            if (pos >= len)
+            if ( (pos >= len) || (line[pos] == '\n') )
             {
                *eolp = pos;
                return(0);
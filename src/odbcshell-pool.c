@@ -0,0 +1,255 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-pool.c ODBC Shell connection pool
+ */
+#include "odbcshell-pool.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-print.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief verifies an established connection is still usable
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+int odbcshell_pool_check(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   SQLRETURN       sts;
+#ifdef SQL_ATTR_CONNECTION_DEAD
+   SQLUINTEGER     dead;
+#endif
+
+   if ( (!(conn->hdbc)) || (!(conn->stmt)) )
+      return(-1);
+
+#ifdef SQL_ATTR_CONNECTION_DEAD
+   // asks driver for the state of the connection
+   dead = SQL_CD_FALSE;
+   sts  = SQLGetConnectAttr(conn->hdbc, SQL_ATTR_CONNECTION_DEAD, &dead,
+      SQL_IS_UINTEGER, NULL);
+   if ( (SQL_SUCCEEDED(sts)) && (dead == SQL_CD_TRUE) )
+      return(-1);
+#endif
+
+   if (!(cnf->poolcheck))
+      return(0);
+
+   // sends validation query
+   sts = SQLExecDirect(conn->stmt->hstmt, (SQLTCHAR *)cnf->poolcheck, SQL_NTS);
+   SQLFreeStmt(conn->stmt->hstmt, SQL_CLOSE);
+   if (!(SQL_SUCCEEDED(sts)))
+      return(-1);
+
+   return(0);
+}
+
+
+/// @brief disconnects all idle connections
+/// @param cnf      pointer to configuration struct
+void odbcshell_pool_close(ODBCShell * cnf)
+{
+   while (cnf->pool_count > 0)
+   {
+      cnf->pool_count--;
+      odbcshell_odbc_free(cnf, &cnf->pool[cnf->pool_count]);
+   };
+   if ((cnf->pool))
+      free(cnf->pool);
+   cnf->pool = NULL;
+   return;
+}
+
+
+/// @brief returns a connection to the pool or disconnects it
+/// @param cnf      pointer to configuration struct
+/// @param connp    pointer to pointer to connection struct
+void odbcshell_pool_put(ODBCShell * cnf, ODBCShellConn ** connp)
+{
+   void * ptr;
+
+   if (cnf->current == (*connp))
+      cnf->current = NULL;
+
+   if ( (cnf->poolsize < 1) || ((odbcshell_pool_reset(cnf, (*connp)))) )
+   {
+      odbcshell_odbc_free(cnf, connp);
+      return;
+   };
+
+   // makes room by disconnecting the connection idle the longest
+   if (cnf->pool_count >= cnf->poolsize)
+   {
+      odbcshell_odbc_free(cnf, &cnf->pool[0]);
+      cnf->pool_count--;
+      memmove(&cnf->pool[0], &cnf->pool[1], sizeof(ODBCShellConn *) * (size_t)cnf->pool_count);
+   };
+
+   if (!(ptr = realloc(cnf->pool, sizeof(ODBCShellConn *) * (size_t)(cnf->pool_count+1))))
+   {
+      odbcshell_odbc_free(cnf, connp);
+      return;
+   };
+   cnf->pool = ptr;
+
+   odbcshell_verbose(cnf, "keeping \"%s\" in connection pool...\n", (*connp)->name);
+   (*connp)->idle_since = time(NULL);
+   cnf->pool[cnf->pool_count] = (*connp);
+   cnf->pool_count++;
+   (*connp) = NULL;
+
+   return;
+}
+
+
+/// @brief discards state left on a connection by its previous user
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+int odbcshell_pool_reset(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   if ( ((conn->job)) || (!(conn->hdbc)) || (!(conn->stmt)) )
+      return(-1);
+
+   // drops cursors and uncommitted work while keeping statement handles
+   while (conn->cursors_count > 0)
+   {
+      conn->cursors_count--;
+      odbcshell_odbc_stmt_release(cnf, &conn->cursors[conn->cursors_count]);
+   };
+   SQLFreeStmt(conn->stmt->hstmt, SQL_CLOSE);
+   SQLEndTran(SQL_HANDLE_DBC, conn->hdbc, SQL_ROLLBACK);
+
+   return(0);
+}
+
+
+/// @brief retrieves an idle connection to a data source
+/// @param cnf      pointer to configuration struct
+/// @param dsn      data source of connection
+/// @param name     internal name of connect
+/// @param connp    pointer to pointer to connection struct
+int odbcshell_pool_take(ODBCShell * cnf, const char * dsn, const char * name,
+   ODBCShellConn ** connp)
+{
+   long long       l;
+   char          * str;
+   ODBCShellConn * conn;
+
+   (*connp) = NULL;
+
+   odbcshell_pool_trim(cnf);
+
+   // searches most recently used connections first
+   for(l = cnf->pool_count - 1; l >= 0; l--)
+   {
+      if ((strcmp(cnf->pool[l]->dsn, dsn)))
+         continue;
+
+      conn = cnf->pool[l];
+      cnf->pool_count--;
+      memmove(&cnf->pool[l], &cnf->pool[l+1], sizeof(ODBCShellConn *) * (size_t)(cnf->pool_count - l));
+
+      if ((odbcshell_pool_check(cnf, conn)))
+      {
+         odbcshell_verbose(cnf, "discarding pooled connection which failed validation...\n");
+         odbcshell_odbc_free(cnf, &conn);
+         continue;
+      };
+
+      if (!(str = strdup(name)))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         odbcshell_odbc_free(cnf, &conn);
+         return(-2);
+      };
+      free(conn->name);
+      conn->name = str;
+
+      odbcshell_verbose(cnf, "reusing pooled connection...\n");
+      (*connp) = conn;
+      return(0);
+   };
+
+   return(0);
+}
+
+
+/// @brief disconnects idle connections which are expired or exceed the pool size
+/// @param cnf      pointer to configuration struct
+void odbcshell_pool_trim(ODBCShell * cnf)
+{
+   long long l;
+   time_t    now;
+
+   now = time(NULL);
+
+   for(l = 0; l < cnf->pool_count; l++)
+   {
+      if ( ((now - cnf->pool[l]->idle_since) < cnf->poolttl) &&
+           ((cnf->pool_count - l) <= cnf->poolsize) )
+         continue;
+      odbcshell_odbc_free(cnf, &cnf->pool[l]);
+      cnf->pool_count--;
+      memmove(&cnf->pool[l], &cnf->pool[l+1], sizeof(ODBCShellConn *) * (size_t)(cnf->pool_count - l));
+      l--;
+   };
+
+   return;
+}
+
+/* end of source */
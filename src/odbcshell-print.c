@@ -70,16 +70,19 @@
 /// @param ...      variable arguments for string format
 void odbcshell_error(ODBCShell * cnf, const char * format, ...)
 {
-   va_list ap;
+   FILE    * fs;
+   va_list   ap;
 
    if ((cnf->silent))
       return;
 
-   fprintf(stderr, "%s: ", PROGRAM_NAME);
+   fs = cnf->errs ? cnf->errs : stderr;
+
+   fprintf(fs, "%s: ", PROGRAM_NAME);
    if (cnf->active_cmd)
-      fprintf(stderr, "%s: ", cnf->active_cmd->name);
+      fprintf(fs, "%s: ", cnf->active_cmd->name);
    va_start(ap, format);
-      vfprintf(stderr, format, ap);
+      vfprintf(fs, format, ap);
    va_end(ap);
 
    return;
@@ -92,13 +95,16 @@ void odbcshell_error(ODBCShell * cnf, const char * format, ...)
 /// @param ...      variable arguments for string format
 void odbcshell_fatal(ODBCShell * cnf, const char * format, ...)
 {
-   va_list ap;
+   FILE    * fs;
+   va_list   ap;
 
-   fprintf(stderr, "%s: ", PROGRAM_NAME);
+   fs = cnf->errs ? cnf->errs : stderr;
+
+   fprintf(fs, "%s: ", PROGRAM_NAME);
    if (cnf->active_cmd)
-      fprintf(stderr, "%s: ", cnf->active_cmd->name);
+      fprintf(fs, "%s: ", cnf->active_cmd->name);
    va_start(ap, format);
-      vfprintf(stderr, format, ap);
+      vfprintf(fs, format, ap);
    va_end(ap);
 
    return;
@@ -171,7 +177,7 @@ void odbcshell_printf(ODBCShell * cnf, const char * format, ...)
       return;
 
    va_start(ap, format);
-      vprintf(format, ap);
+      vfprintf(cnf->msgs ? cnf->msgs : stdout, format, ap);
    va_end(ap);
 
    return;
@@ -190,7 +196,7 @@ void odbcshell_verbose(ODBCShell * cnf, const char * format, ...)
       return;
 
    va_start(ap, format);
-      vprintf(format, ap);
+      vfprintf(cnf->msgs ? cnf->msgs : stdout, format, ap);
    va_end(ap);
 
    return;
@@ -0,0 +1,225 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-retry.c ODBC Shell recovery of lost connections
+ */
+#include "odbcshell-retry.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "odbcshell-odbc.h"
+#include "odbcshell-print.h"
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Variables
+#endif
+
+/// @brief statements which only read data
+static const char * odbcshell_retry_verbs[] =
+{
+   "DESC",
+   "DESCRIBE",
+   "EXPLAIN",
+   "SELECT",
+   "SHOW",
+   "VALUES",
+   "WITH",
+   NULL
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief determines if a statement only reads data and may safely be sent again
+/// @param sql      SQL string
+int odbcshell_retry_idempotent(const char * sql)
+{
+   int          i;
+   size_t       len;
+   const char * ptr;
+
+   while ( (isspace((unsigned char)sql[0])) || (sql[0] == '(') )
+      sql++;
+   for(len = 0; (isalpha((unsigned char)sql[len])); len++);
+
+   for(i = 0; ((odbcshell_retry_verbs[i])); i++)
+      if ( (strlen(odbcshell_retry_verbs[i]) == len) &&
+           (!(strncasecmp(odbcshell_retry_verbs[i], sql, len))) )
+         break;
+   if (!(odbcshell_retry_verbs[i]))
+      return(0);
+
+   // SELECT ... INTO and data modifying CTEs write to the database
+   for(ptr = sql + len; ((ptr[0])); ptr++)
+   {
+      if ( (isalnum((unsigned char)ptr[-1])) || (ptr[-1] == '_') )
+         continue;
+      if ( (!(strncasecmp(ptr, "INTO", 4))) && (!(isalnum((unsigned char)ptr[4]))) && (ptr[4] != '_') )
+         return(0);
+      if ( (!(strncasecmp(ptr, "UPDATE", 6))) && (!(isalnum((unsigned char)ptr[6]))) && (ptr[6] != '_') )
+         return(0);
+      if ( (!(strncasecmp(ptr, "DELETE", 6))) && (!(isalnum((unsigned char)ptr[6]))) && (ptr[6] != '_') )
+         return(0);
+   };
+
+   return(1);
+}
+
+
+/// @brief determines if the session of a connection has been lost
+/// @param conn     pointer to connection struct
+/// @param hstmt    statement which failed (NULL to only query the driver)
+int odbcshell_retry_lost(ODBCShellConn * conn, SQLHSTMT hstmt)
+{
+   SQLTCHAR    state[6];
+   SQLINTEGER  native;
+   SQLSMALLINT len;
+   SQLSMALLINT rec;
+#ifdef SQL_ATTR_CONNECTION_DEAD
+   SQLUINTEGER dead;
+#endif
+
+   if (!(conn->hdbc))
+      return(0);
+
+   // SQLSTATE class 08 and HYT01 report a broken or timed out link
+   for(rec = 1; ((hstmt)); rec++)
+   {
+      if (!(SQL_SUCCEEDED(SQLGetDiagRec(SQL_HANDLE_STMT, hstmt, rec, state,
+         &native, NULL, 0, &len))))
+         break;
+      if ( (!(strncmp((char *)state, "08", 2))) || (!(strcmp((char *)state, "HYT01"))) )
+         return(1);
+   };
+   for(rec = 1; ((hstmt)); rec++)
+   {
+      if (!(SQL_SUCCEEDED(SQLGetDiagRec(SQL_HANDLE_DBC, conn->hdbc, rec, state,
+         &native, NULL, 0, &len))))
+         break;
+      if ( (!(strncmp((char *)state, "08", 2))) || (!(strcmp((char *)state, "HYT01"))) )
+         return(1);
+   };
+
+#ifdef SQL_ATTR_CONNECTION_DEAD
+   // asks driver for the state of the connection
+   dead = SQL_CD_FALSE;
+   if ((SQL_SUCCEEDED(SQLGetConnectAttr(conn->hdbc, SQL_ATTR_CONNECTION_DEAD,
+      &dead, SQL_IS_UINTEGER, NULL))))
+      if (dead == SQL_CD_TRUE)
+         return(1);
+#endif
+
+   return(0);
+}
+
+
+/// @brief re-establishes a lost session, backing off between attempts
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+int odbcshell_retry_reconnect(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   long long         attempt;
+   long long         delay;
+   long long         pause;
+   unsigned int      seed;
+   struct timespec   ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   seed = (unsigned int)ts.tv_nsec ^ (unsigned int)getpid() ^ (unsigned int)(uintptr_t)conn;
+   delay = ODBCSHELL_RECONNECT_DELAY;
+
+   for(attempt = 1; attempt <= cnf->autoreconnect; attempt++)
+   {
+      // sleeps between half and all of the current delay so that shells
+      // which lost the same server do not reconnect in lockstep
+      pause = (delay / 2) + (rand_r(&seed) % ((delay / 2) + 1));
+      odbcshell_printf(cnf, "connection \"%s\" lost, reconnecting in %lld ms (attempt %lld of %lld)...\n",
+         conn->name, pause, attempt, cnf->autoreconnect);
+      ts.tv_sec  = pause / 1000;
+      ts.tv_nsec = (pause % 1000) * 1000000L;
+      if (nanosleep(&ts, NULL) == -1)
+      {
+         odbcshell_error(cnf, "reconnect of \"%s\" interrupted\n", conn->name);
+         return(-1);
+      };
+
+      if (!(odbcshell_odbc_redial(cnf, conn)))
+      {
+         odbcshell_printf(cnf, "reconnected \"%s\"\n", conn->name);
+         return(0);
+      };
+
+      delay *= 2;
+      if (delay > ODBCSHELL_RECONNECT_MAXDELAY)
+         delay = ODBCSHELL_RECONNECT_MAXDELAY;
+   };
+
+   odbcshell_error(cnf, "unable to reconnect \"%s\" after %lld attempts\n",
+      conn->name, cnf->autoreconnect);
+   return(-1);
+}
+
+/* end of source */
@@ -49,17 +49,26 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+#include "odbcshell-batch.h"
 #include "odbcshell-commands.h"
+#include "odbcshell-connect.h"
+#include "odbcshell-jobs.h"
 #include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-parallel.h"
 #include "odbcshell-parse.h"
 #include "odbcshell-print.h"
+#include "odbcshell-profile.h"
 #include "odbcshell-variables.h"
 
 
@@ -73,29 +82,260 @@
 #pragma mark Functions
 #endif
 
+/// @brief runs a script in a child process with its own session
+/// @param cnf      pointer to configuration struct
+/// @param run      pointer to script being run
+/// @return exit code of process
+int odbcshell_script_child(ODBCShell * cnf, ODBCShellScriptRun * run)
+{
+   int fd;
+
+   // results and messages are written to files belonging to the script
+   odbcshell_fclose(cnf);
+   if ((fd = open(run->out, O_WRONLY|O_CREAT|O_TRUNC, 0644)) == -1)
+   {
+      odbcshell_error(cnf, "%s: %s\n", run->out, strerror(errno));
+      return(1);
+   };
+   dup2(fd, STDOUT_FILENO);
+   close(fd);
+   if ((fd = open(run->err, O_WRONLY|O_CREAT|O_TRUNC, 0644)) == -1)
+   {
+      odbcshell_error(cnf, "%s: %s\n", run->err, strerror(errno));
+      return(1);
+   };
+   dup2(fd, STDERR_FILENO);
+   close(fd);
+
+   // each process loads the profile and connects on its own
+   if ((odbcshell_odbc_initialize(cnf)))
+      return(1);
+   if ((odbcshell_profile(cnf)))
+      return(1);
+   if ((odbcshell_connect_dflt(cnf)))
+      return(1);
+   if ((odbcshell_script_loop(cnf, run->script)))
+      return(1);
+
+   return(odbcshell_job_wait(cnf, 0));
+}
+
+
 /// @brief master loop for interactive shell
 /// @param cnf      pointer to configuration struct
 /// @param script   name of script to process
 int odbcshell_script_loop(ODBCShell * cnf, const char * script)
 {
-   int       fd;
-   int       code;
-   char      buff[4096];
-   ssize_t    offset;
-   ssize_t    len;
-   ssize_t    pos;
+   int          fd;
+   int          code;
+   long long    prev_line;
+   const char * prev_script;
 
    if (!(cnf))
       return(-1);
 
-   offset = 0;
-
    if ((fd = open(script, O_RDONLY)) == -1)
    {
       odbcshell_error(cnf, "%s: open(%s)\n", script, strerror(errno));
       return(-1);
    };
 
+   // tracks position within script for error messages
+   prev_script      = cnf->script;
+   prev_line        = cnf->script_line;
+   cnf->script      = script;
+   cnf->script_line = 1;
+
+   code = odbcshell_script_read(cnf, script, fd);
+
+   // sends statements still queued at the end of the script
+   if (!(code))
+      code = odbcshell_batch_flush(cnf);
+   odbcshell_batch_free(cnf);
+
+   // statements of a block which was never ended are not run
+   if ((cnf->parallel_max))
+   {
+      odbcshell_error(cnf, "%s: parallel block was not ended\n", script);
+      odbcshell_parallel_free(cnf);
+      if (!(code))
+         code = -1;
+   };
+
+   cnf->script      = prev_script;
+   cnf->script_line = prev_line;
+
+   close(fd);
+
+   return(code);
+}
+
+
+/// @brief runs several scripts at once, each in its own process
+/// @param cnf      pointer to configuration struct
+/// @param count    number of scripts
+/// @param scripts  array of names of scripts
+/// @return exit code of program
+int odbcshell_script_parallel(ODBCShell * cnf, int count, char ** scripts)
+{
+   int                  l;
+   int                  next;
+   int                  running;
+   int                  status;
+   int                  width;
+   long long            failed;
+   long long            msecs;
+   size_t               len;
+   pid_t                pid;
+   char                 state[32];
+   struct timespec      start;
+   struct timespec      end;
+   void              (* prev)(int);
+   ODBCShellScriptRun * runs;
+   ODBCShellScriptRun * run;
+
+   if (!(runs = calloc((size_t)count, sizeof(ODBCShellScriptRun))))
+   {
+      odbcshell_fatal(cnf, "out of virtual memory\n");
+      return(1);
+   };
+
+   // results and messages of each script are kept in files named after it
+   width = (int)strlen("script");
+   for(l = 0; l < count; l++)
+   {
+      run         = &runs[l];
+      run->script = scripts[l];
+      len         = strlen(scripts[l]) + 5;
+      if ( (!(run->out = malloc(len))) || (!(run->err = malloc(len))) )
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         for(; l >= 0; l--)
+         {
+            free(runs[l].out);
+            free(runs[l].err);
+         };
+         free(runs);
+         return(1);
+      };
+      snprintf(run->out, len, "%s.out", scripts[l]);
+      snprintf(run->err, len, "%s.err", scripts[l]);
+      if ((int)strlen(scripts[l]) > width)
+         width = (int)strlen(scripts[l]);
+   };
+
+   // children are reaped here instead of automatically
+   prev = signal(SIGCHLD, SIG_DFL);
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   odbcshell_verbose(cnf, "running %i scripts, %lld at once...\n", count, cnf->scriptjobs);
+
+   next    = 0;
+   running = 0;
+   while ( (next < count) || (running > 0) )
+   {
+      // starts scripts until the limit is reached
+      while ( (next < count) && (running < cnf->scriptjobs) )
+      {
+         run = &runs[next++];
+         fflush(NULL);
+         clock_gettime(CLOCK_MONOTONIC, &run->start);
+         if ((pid = fork()) == -1)
+         {
+            odbcshell_error(cnf, "%s: fork(): %s\n", run->script, strerror(errno));
+            continue;
+         };
+         if (!(pid))
+         {
+            signal(SIGCHLD, prev);
+            status = odbcshell_script_child(cnf, run);
+            odbcshell_free(cnf);
+            exit(status);
+         };
+         odbcshell_verbose(cnf, "started \"%s\" as process %ld...\n", run->script, (long)pid);
+         run->pid     = pid;
+         run->started = 1;
+         running++;
+      };
+      if (!(running))
+         break;
+
+      // records status of the next script to finish
+      if ((pid = waitpid(-1, &status, 0)) == -1)
+      {
+         if (errno == EINTR)
+            continue;
+         odbcshell_error(cnf, "waitpid(): %s\n", strerror(errno));
+         break;
+      };
+      for(l = 0; l < count; l++)
+      {
+         run = &runs[l];
+         if (run->pid != pid)
+            continue;
+         clock_gettime(CLOCK_MONOTONIC, &end);
+         run->msecs  = (long long)(end.tv_sec - run->start.tv_sec) * 1000LL
+                     + (long long)(end.tv_nsec - run->start.tv_nsec) / 1000000LL;
+         run->status = status;
+         run->pid    = 0;
+         running--;
+         odbcshell_verbose(cnf, "\"%s\" finished after %lld ms\n", run->script, run->msecs);
+      };
+   };
+
+   signal(SIGCHLD, prev);
+
+   // summarizes each script in the order given
+   odbcshell_printf(cnf, "\n%-*s %-10s %10s  %s\n", width, "script", "status", "msecs", "output");
+   failed = 0;
+   for(l = 0; l < count; l++)
+   {
+      run = &runs[l];
+      if ( (!(run->started)) || ((run->pid)) )
+         snprintf(state, sizeof(state), "not run");
+      else if ( (WIFEXITED(run->status)) && (!(WEXITSTATUS(run->status))) )
+         snprintf(state, sizeof(state), "ok");
+      else if (WIFEXITED(run->status))
+         snprintf(state, sizeof(state), "exit %i", WEXITSTATUS(run->status));
+      else if (WIFSIGNALED(run->status))
+         snprintf(state, sizeof(state), "signal %i", WTERMSIG(run->status));
+      else
+         snprintf(state, sizeof(state), "failed");
+      if ((strcmp(state, "ok")))
+         failed++;
+      odbcshell_printf(cnf, "%-*s %-10s %10lli  %s\n", width, run->script, state,
+         run->msecs, run->out);
+   };
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   msecs = (long long)(end.tv_sec - start.tv_sec) * 1000LL
+         + (long long)(end.tv_nsec - start.tv_nsec) / 1000000LL;
+   odbcshell_printf(cnf, "\nran %i scripts in %lld ms, %lld failed.\n", count, msecs, failed);
+
+   for(l = 0; l < count; l++)
+   {
+      free(runs[l].out);
+      free(runs[l].err);
+   };
+   free(runs);
+
+   return(((failed)) ? 1 : 0);
+}
+
+
+/// @brief interprets the contents of a script
+/// @param cnf      pointer to configuration struct
+/// @param script   name of script to process
+/// @param fd       file descriptor of open script
+int odbcshell_script_read(ODBCShell * cnf, const char * script, int fd)
+{
+   int       code;
+   char      buff[4096];
+   ssize_t    offset;
+   ssize_t    len;
+   ssize_t    pos;
+
+   offset = 0;
+
    while((len = read(fd, &buff[offset], 4095-offset)) > 0)
    {
       buff[len] = '\0';
@@ -106,10 +346,7 @@ int odbcshell_script_loop(ODBCShell * cnf, const char * script)
             code = 0;
          case -1:
             if ( (!(code)) || (!(cnf->continues)) )
-            {
-               close(fd);
                return(code);
-            };
          case 2:
             continue;
          default:
@@ -125,12 +362,9 @@ int odbcshell_script_loop(ODBCShell * cnf, const char * script)
    if (len == -1)
    {
       odbcshell_error(cnf, "%s: read(): %s\n", script, strerror(errno));
-      close(fd);
       return(-1);
    };
 
-   close(fd);
-
    return(0);
 }
 
@@ -59,9 +59,18 @@
 #pragma mark Prototypes
 #endif
 
+// runs a script in a child process with its own session
+int odbcshell_script_child(ODBCShell * cnf, ODBCShellScriptRun * run);
+
 // master loop for interactive shell
 int odbcshell_script_loop(ODBCShell * cnf, const char * script);
 
+// runs several scripts at once, each in its own process
+int odbcshell_script_parallel(ODBCShell * cnf, int count, char ** scripts);
+
+// interprets the contents of a script
+int odbcshell_script_read(ODBCShell * cnf, const char * script, int fd);
+
 #endif
 /* end of header */
 
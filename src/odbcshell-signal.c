@@ -48,6 +48,50 @@
 #include "odbcshell.h"
 
 #include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <readline/readline.h>
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Variables
+#endif
+
+// statement handle cancelled when an interrupt is received
+static HSTMT volatile odbcshell_signal_hstmt = NULL;
+
+// protects odbcshell_signal_hstmt while SQLCancel() is running
+static pthread_mutex_t odbcshell_signal_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// pipe used to wake the cancel thread from the signal handler
+static int odbcshell_signal_pipe[2] = { -1, -1 };
+
+// toggle indicating the interactive prompt is active
+static volatile sig_atomic_t odbcshell_signal_interactive = 0;
+
+// toggle set by the handler when the line being edited is to be discarded
+static volatile sig_atomic_t odbcshell_signal_discard = 0;
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Prototypes
+#endif
+
+// cancels active statement on behalf of the signal handler
+void * odbcshell_signal_thread(void * ptr);
 
 
 /////////////////
@@ -60,11 +104,43 @@
 #pragma mark Functions
 #endif
 
+/// @brief blocks interrupt signals in threads created by the caller
+/// @param oldset   stores signal mask to restore
+void odbcshell_signal_block(sigset_t * oldset)
+{
+   sigset_t set;
+   sigemptyset(&set);
+   sigaddset(&set, SIGINT);
+   pthread_sigmask(SIG_BLOCK, &set, oldset);
+   return;
+}
+
+
+/// @brief discards the line being edited after an interrupt
+int odbcshell_signal_event(void)
+{
+   // readline functions are not async-signal-safe, so the handler only
+   // raises a flag which readline checks once it has left the handler
+   if (!(odbcshell_signal_discard))
+      return(0);
+   odbcshell_signal_discard = 0;
+   if (write(STDOUT_FILENO, "\n", 1) == -1)
+      return(0);
+   rl_on_new_line();
+   rl_replace_line("", 0);
+   rl_redisplay();
+   return(0);
+}
+
+
 /// @brief sets initial signal handlers
 void odbcshell_signal_init(void)
 {
+   pthread_t          thread;
+   sigset_t           oldset;
+   struct sigaction   sa;
+
    //signal(SIGTERM,   SIG_IGN);
-   //signal(SIGINT,    SIG_IGN);
    //signal(SIGHUP,    SIG_IGN);
    signal(SIGALRM,   SIG_IGN);
    signal(SIGVTALRM, SIG_IGN);
@@ -74,8 +150,112 @@ void odbcshell_signal_init(void)
    signal(SIGUSR2,   SIG_IGN);
    signal(SIGWINCH,  SIG_IGN);
    signal(SIGPROF,   SIG_IGN);
+
+   // SQLCancel() is not async-signal-safe, so the handler hands the
+   // request to a helper thread through a pipe
+   if (odbcshell_signal_pipe[0] != -1)
+      return;
+   if ((pipe(odbcshell_signal_pipe)))
+      return;
+   odbcshell_signal_block(&oldset);
+   if ((pthread_create(&thread, NULL, odbcshell_signal_thread, NULL)))
+   {
+      odbcshell_signal_restore(&oldset);
+      return;
+   };
+   pthread_detach(thread);
+   odbcshell_signal_restore(&oldset);
+
+   memset(&sa, 0, sizeof(sa));
+   sa.sa_handler = odbcshell_signal_sigint;
+   sa.sa_flags   = SA_RESTART;
+   sigemptyset(&sa.sa_mask);
+   sigaction(SIGINT, &sa, NULL);
+
+   return;
+}
+
+
+/// @brief toggles handling of interrupts for the interactive prompt
+/// @param enable   boolean indicating the prompt is active
+void odbcshell_signal_prompt(int enable)
+{
+   odbcshell_signal_discard     = 0;
+   odbcshell_signal_interactive = enable;
+   rl_signal_event_hook         = ((enable)) ? odbcshell_signal_event : NULL;
+   return;
+}
+
+
+/// @brief restores signal mask saved by odbcshell_signal_block()
+/// @param oldset   signal mask to restore
+void odbcshell_signal_restore(const sigset_t * oldset)
+{
+   pthread_sigmask(SIG_SETMASK, oldset, NULL);
    return;
 }
 
 
+/// @brief handles interrupt requests from the terminal
+/// @param sig      signal number
+void odbcshell_signal_sigint(int sig)
+{
+   char c;
+
+   // cancels running statement and returns to the prompt
+   if (odbcshell_signal_hstmt != NULL)
+   {
+      c = (char)sig;
+      if (write(odbcshell_signal_pipe[1], &c, 1) == -1)
+         return;
+      return;
+   };
+
+   // line being edited is discarded by odbcshell_signal_event()
+   if ((odbcshell_signal_interactive))
+   {
+      odbcshell_signal_discard = 1;
+      return;
+   };
+
+   // terminates non-interactive sessions
+   signal(sig, SIG_DFL);
+   raise(sig);
+
+   return;
+}
+
+
+/// @brief sets statement handle cancelled by an interrupt
+/// @param hstmt    statement handle or NULL
+void odbcshell_signal_stmt(HSTMT hstmt)
+{
+   pthread_mutex_lock(&odbcshell_signal_lock);
+   odbcshell_signal_hstmt = hstmt;
+   pthread_mutex_unlock(&odbcshell_signal_lock);
+   return;
+}
+
+
+/// @brief cancels active statement on behalf of the signal handler
+/// @param ptr      unused
+void * odbcshell_signal_thread(void * ptr)
+{
+   char c;
+
+   while(read(odbcshell_signal_pipe[0], &c, 1) != 0)
+   {
+      pthread_mutex_lock(&odbcshell_signal_lock);
+      if (odbcshell_signal_hstmt != NULL)
+      {
+         fprintf(stderr, "\n%s: cancelling statement...\n", PROGRAM_NAME);
+         SQLCancel(odbcshell_signal_hstmt);
+      };
+      pthread_mutex_unlock(&odbcshell_signal_lock);
+   };
+
+   return(ptr);
+}
+
+
 /* end of source */
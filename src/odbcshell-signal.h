@@ -48,6 +48,8 @@
 
 #include "odbcshell.h"
 
+#include <signal.h>
+
 
 //////////////////
 //              //
@@ -59,8 +61,26 @@
 #pragma mark Prototypes
 #endif
 
+// blocks interrupt signals in threads created by the caller
+void odbcshell_signal_block(sigset_t * oldset);
+
+// discards the line being edited after an interrupt
+int odbcshell_signal_event(void);
+
 // sets initial signal handlers
 void odbcshell_signal_init(void);
 
+// toggles handling of interrupts for the interactive prompt
+void odbcshell_signal_prompt(int enable);
+
+// restores signal mask saved by odbcshell_signal_block()
+void odbcshell_signal_restore(const sigset_t * oldset);
+
+// handles interrupt requests from the terminal
+void odbcshell_signal_sigint(int sig);
+
+// sets statement handle cancelled by an interrupt
+void odbcshell_signal_stmt(HSTMT hstmt);
+
 #endif
 /* end of header */
@@ -0,0 +1,312 @@
+/*
+ *  ODBC Shell
+ *  Copyright (C) 2011 Bindle Binaries <syzdek@bindlebinaries.com>.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Bindle Binaries nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BINDLE BINARIES BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @BINDLE_BINARIES_BSD_LICENSE_END@
+ */
+/**
+ *  @file src/odbcshell-tune.c ODBC Shell per data source performance settings
+ */
+#include "odbcshell-tune.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+#ifdef PMARK
+#pragma mark Headers
+#endif
+
+#include "odbcshell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "odbcshell-connect.h"
+#include "odbcshell-odbc.h"
+#include "odbcshell-options.h"
+#include "odbcshell-print.h"
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+#ifdef PMARK
+#pragma mark -
+#pragma mark Functions
+#endif
+
+/// @brief applies session settings once a connection is established
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+int odbcshell_tune_apply(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   SQLRETURN sts;
+
+   if (conn->tune.isolation != -1)
+   {
+      sts = SQLSetConnectAttr(conn->hdbc, SQL_ATTR_TXN_ISOLATION,
+         (SQLPOINTER)(SQLULEN)conn->tune.isolation, SQL_IS_UINTEGER);
+      if (!(SQL_SUCCEEDED(sts)))
+         odbcshell_odbc_errors("SQLSetConnectAttr", cnf, conn);
+   };
+
+   if (conn->tune.readonly != -1)
+   {
+      sts = SQLSetConnectAttr(conn->hdbc, SQL_ATTR_ACCESS_MODE,
+         (SQLPOINTER)(SQLULEN)(((conn->tune.readonly)) ? SQL_MODE_READ_ONLY : SQL_MODE_READ_WRITE),
+         SQL_IS_UINTEGER);
+      if (!(SQL_SUCCEEDED(sts)))
+         odbcshell_odbc_errors("SQLSetConnectAttr", cnf, conn);
+   };
+
+   return(0);
+}
+
+
+/// @brief frees settings declared for data sources
+/// @param cnf      pointer to configuration struct
+void odbcshell_tune_free(ODBCShell * cnf)
+{
+   while (cnf->tunes_count > 0)
+   {
+      cnf->tunes_count--;
+      free(cnf->tunes[cnf->tunes_count]->dsn);
+      free(cnf->tunes[cnf->tunes_count]);
+   };
+   if ((cnf->tunes))
+      free(cnf->tunes);
+   cnf->tunes = NULL;
+
+   return;
+}
+
+
+/// @brief displays settings declared for data sources
+/// @param cnf      pointer to configuration struct
+/// @param dsn      data source to display (NULL for all)
+int odbcshell_tune_list(ODBCShell * cnf, const char * dsn)
+{
+   long long       i;
+   const char    * str;
+   ODBCShellTune * tune;
+
+   printf("  DSN:       Setting:      Value:\n");
+   for(i = 0; i < cnf->tunes_count; i++)
+   {
+      tune = cnf->tunes[i];
+      if ( ((dsn)) && ((strcasecmp(dsn, tune->dsn))) )
+         continue;
+      if (tune->packetsize != -1)
+         printf("  %-10s %-13s %lli\n", tune->dsn, "packetsize", tune->packetsize);
+      if (tune->fetchsize != -1)
+         printf("  %-10s %-13s %lli\n", tune->dsn, "fetchsize", tune->fetchsize);
+      if (tune->cursortype != -1)
+      {
+         switch(tune->cursortype)
+         {
+            case SQL_CURSOR_STATIC:        str = "static";  break;
+            case SQL_CURSOR_KEYSET_DRIVEN: str = "keyset";  break;
+            case SQL_CURSOR_DYNAMIC:       str = "dynamic"; break;
+            default:                       str = "forward"; break;
+         };
+         printf("  %-10s %-13s %s\n", tune->dsn, "cursortype", str);
+      };
+      if (tune->isolation != -1)
+      {
+         switch(tune->isolation)
+         {
+            case SQL_TXN_READ_UNCOMMITTED: str = "uncommitted";  break;
+            case SQL_TXN_REPEATABLE_READ:  str = "repeatable";   break;
+            case SQL_TXN_SERIALIZABLE:     str = "serializable"; break;
+            default:                       str = "committed";    break;
+         };
+         printf("  %-10s %-13s %s\n", tune->dsn, "isolation", str);
+      };
+      if (tune->readonly != -1)
+         printf("  %-10s %-13s %s\n", tune->dsn, "readonly", tune->readonly ? "yes" : "no");
+      if (tune->querytimeout != -1)
+         printf("  %-10s %-13s %lli\n", tune->dsn, "querytimeout", tune->querytimeout);
+      if (tune->stmtcache != -1)
+         printf("  %-10s %-13s %lli\n", tune->dsn, "stmtcache", tune->stmtcache);
+   };
+
+   return(0);
+}
+
+
+/// @brief copies settings of data source to connection before it is established
+/// @param cnf      pointer to configuration struct
+/// @param conn     pointer to connection struct
+int odbcshell_tune_lookup(ODBCShell * cnf, ODBCShellConn * conn)
+{
+   long long     i;
+   char          buff[256];
+   const char  * dsn;
+   SQLRETURN     sts;
+
+   // marks every setting as unset (-1)
+   memset(&conn->tune, 0xff, sizeof(ODBCShellTune));
+   conn->tune.dsn = NULL;
+
+   // matches the DSN attribute or the entire connection string
+   dsn = odbcshell_connect_name(conn->dsn, 0, buff, sizeof(buff));
+   for(i = 0; i < cnf->tunes_count; i++)
+      if ( (!(strcasecmp(cnf->tunes[i]->dsn, dsn))) ||
+           (!(strcasecmp(cnf->tunes[i]->dsn, conn->dsn))) )
+         break;
+   if (i >= cnf->tunes_count)
+      return(0);
+
+   odbcshell_verbose(cnf, "applying settings of \"%s\" to \"%s\"...\n",
+      cnf->tunes[i]->dsn, conn->name);
+   memcpy(&conn->tune, cnf->tunes[i], sizeof(ODBCShellTune));
+   conn->tune.dsn = NULL;
+
+   // packet size is only honored before connecting
+   if (conn->tune.packetsize != -1)
+   {
+      sts = SQLSetConnectAttr(conn->hdbc, SQL_ATTR_PACKET_SIZE,
+         (SQLPOINTER)(SQLULEN)conn->tune.packetsize, SQL_IS_UINTEGER);
+      if (!(SQL_SUCCEEDED(sts)))
+         odbcshell_odbc_errors("SQLSetConnectAttr", cnf, conn);
+   };
+
+   return(0);
+}
+
+
+/// @brief declares a setting for a data source
+/// @param cnf      pointer to configuration struct
+/// @param dsn      name of data source
+/// @param name     name of setting
+/// @param value    new value of setting ("default" to remove)
+int odbcshell_tune_set(ODBCShell * cnf, const char * dsn, const char * name,
+   const char * value)
+{
+   long long       i;
+   long long       num;
+   long long     * field;
+   char          * end;
+   void          * ptr;
+   ODBCShellTune * tune;
+
+   for(i = 0; i < cnf->tunes_count; i++)
+      if (!(strcasecmp(cnf->tunes[i]->dsn, dsn)))
+         break;
+
+   if (i >= cnf->tunes_count)
+   {
+      if (!(ptr = realloc(cnf->tunes, sizeof(ODBCShellTune *) * (size_t)(cnf->tunes_count+1))))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+      cnf->tunes = ptr;
+      if (!(tune = malloc(sizeof(ODBCShellTune))))
+      {
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+      memset(tune, 0xff, sizeof(ODBCShellTune));
+      tune->dsn = NULL;
+      if (!(tune->dsn = strdup(dsn)))
+      {
+         free(tune);
+         odbcshell_fatal(cnf, "out of virtual memory\n");
+         return(-2);
+      };
+      cnf->tunes[cnf->tunes_count] = tune;
+      cnf->tunes_count++;
+   };
+   tune = cnf->tunes[i];
+
+   if      (!(strcasecmp(name, "cursortype")))   field = &tune->cursortype;
+   else if (!(strcasecmp(name, "fetchsize")))    field = &tune->fetchsize;
+   else if (!(strcasecmp(name, "isolation")))    field = &tune->isolation;
+   else if (!(strcasecmp(name, "packetsize")))   field = &tune->packetsize;
+   else if (!(strcasecmp(name, "querytimeout"))) field = &tune->querytimeout;
+   else if (!(strcasecmp(name, "readonly")))     field = &tune->readonly;
+   else if (!(strcasecmp(name, "stmtcache")))    field = &tune->stmtcache;
+   else
+   {
+      odbcshell_error(cnf, "unknown setting \"%s\"\n", name);
+      return(-1);
+   };
+
+   // restores driver default
+   if (!(strcasecmp(value, "default")))
+   {
+      *field = -1;
+      return(0);
+   };
+
+   if (field == &tune->cursortype)
+   {
+      if      (!(strcasecmp(value, "forward"))) num = SQL_CURSOR_FORWARD_ONLY;
+      else if (!(strcasecmp(value, "static")))  num = SQL_CURSOR_STATIC;
+      else if (!(strcasecmp(value, "keyset")))  num = SQL_CURSOR_KEYSET_DRIVEN;
+      else if (!(strcasecmp(value, "dynamic"))) num = SQL_CURSOR_DYNAMIC;
+      else                                      num = -1;
+   }
+   else if (field == &tune->isolation)
+   {
+      if      (!(strcasecmp(value, "uncommitted")))  num = SQL_TXN_READ_UNCOMMITTED;
+      else if (!(strcasecmp(value, "committed")))    num = SQL_TXN_READ_COMMITTED;
+      else if (!(strcasecmp(value, "repeatable")))   num = SQL_TXN_REPEATABLE_READ;
+      else if (!(strcasecmp(value, "serializable"))) num = SQL_TXN_SERIALIZABLE;
+      else                                           num = -1;
+   }
+   else if (field == &tune->readonly)
+   {
+      num = odbcshell_strtob(value);
+   }
+   else
+   {
+      num = strtoll(value, &end, 10);
+      if ( ((end[0])) || (!(value[0])) )
+         num = -1;
+   };
+
+   if (num < 0)
+   {
+      odbcshell_error(cnf, "invalid value for setting \"%s\"\n", name);
+      return(-1);
+   };
+   *field = num;
+
+   return(0);
+}
+
+/* end of source */
@@ -64,23 +64,36 @@
 ODBCShellOption odbcshell_cmd_strings[] =
 {
    { ODBCSHELL_CMD_ODBC,        1, -1, "ALTER",      "internal SQL command (data definition)",        NULL },
+   { ODBCSHELL_CMD_BENCH,       2, 10, "BENCH",      "replays statements of a script on several sessions to measure latency", (const char *[4]){"bench script", "bench -c sessions -d duration script", "bench -c sessions -d duration -t think_time -o results.json script", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "BEGIN",      "internal SQL command (transaction controls)",   NULL },
+   { ODBCSHELL_CMD_CHUNKED,     5, -1, "CHUNKED",    "executes an update or delete in ranges of keys, committing each range", (const char *[3]){"chunked rows by column SQL_statement", "chunked rows by column pause duration SQL_statement", NULL} },
    { ODBCSHELL_CMD_CLEAR,       1,  1, "CLEAR",      "clears screen",                                 (const char *[2]){"clear", NULL} },
    { ODBCSHELL_CMD_CLOSE,       1,  1, "CLOSE",      "closes output file",                            (const char *[2]){"close", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "COMMIT",     "internal SQL command (transaction controls)",   NULL },
-   { ODBCSHELL_CMD_CONNECT,     2,  3, "CONNECT",    "connects to a database",                        (const char *[3]){"connect \"DSN=My Database;UID=John Doe;PWD=password\"", "connect name \"DSN=My Database;UID=John Doe;PWD=password\"", NULL} },
+   { ODBCSHELL_CMD_COMPARE,     4,  5, "COMPARE",    "compares rows of a table on two connections",   (const char *[3]){"compare name1 name2 table", "compare name1 name2 table key", NULL} },
+   { ODBCSHELL_CMD_CONNECT,     2, -1, "CONNECT",    "connects to a database",                        (const char *[4]){"connect \"DSN=My Database;UID=John Doe;PWD=password\"", "connect name \"DSN=My Database;UID=John Doe;PWD=password\"", "connect -parallel name1 \"DSN=db1\" name2 \"DSN=db2\" ...", NULL} },
+   { ODBCSHELL_CMD_COPY,        7,  9, "COPY",       "copies rows of a query into a table of another connection", (const char *[3]){"copy from name 'SQL_statement' to name table", "copy from name 'SQL_statement' to name table batch rows", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "CREATE",     "internal SQL command (data definition)",         NULL },
+   { ODBCSHELL_CMD_CURSOR,      1, -1, "CURSOR",     "opens, fetches, and closes named cursors",       (const char *[5]){"cursor", "cursor open name SQL_statement", "cursor fetch name [rows]", "cursor close name", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "DELETE",     "internal SQL command (data manipulation)",       NULL },
    { ODBCSHELL_CMD_DISCONNECT,  1,  2, "DISCONNECT", "disconnects from a database",                    (const char *[3]){"disconnect", "disconnect name", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "DROP",       "internal SQL command (data definition)",         NULL },
+   { ODBCSHELL_CMD_DUMP,        3,  7, "DUMP",       "writes each table to its own file over several connections", (const char *[4]){"dump to directory", "dump schema to directory format", "dump schema to directory format -j connections", NULL} },
    { ODBCSHELL_CMD_ECHO,        1, -1, "ECHO",       "prints arguments to screen",                     (const char *[4]){"echo \"string\"", "echo \"string1\" \"string2\"", "echo \"string1\" \"string2\" \"stringN\"", NULL} },
    { ODBCSHELL_CMD_QUIT,        1,  1, "EXIT",       "exits ODBC Shell",                               (const char *[2]){"exit", NULL} },
+   { ODBCSHELL_CMD_EXPORT,      6,  8, "EXPORT",     "exports a query in ranges of keys over several connections", (const char *[3]){"export parallel connections by column 'SQL_statement'", "export parallel connections by column 'SQL_statement' to prefix", NULL} },
+   { ODBCSHELL_CMD_GENERATE,    4, -1, "GENERATE",   "inserts synthetic rows over several connections", (const char *[5]){"generate table rows count", "generate table rows count -j connections -batch rows -seed number", "generate table rows count column=seq column=seq(start,step) column=int(min,max) column=float(min,max)", "generate table rows count column=normal(mean,stddev) column=zipf(items,exponent) column=string(min,max) column=date(YYYY-MM-DD,YYYY-MM-DD) column=pick(a,b,c) column=ref(table.column)", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "GRANT",      "internal SQL command (data control)",            NULL },
+   { ODBCSHELL_CMD_GROUP,       1, -1, "GROUP",      "groups a primary connection with its replicas",  (const char *[5]){"group", "group name", "group name primary replica1 replica2 ...", "group -remove name", NULL} },
    { ODBCSHELL_CMD_HELP,        1,  2, "HELP",       "displays help information",                      (const char *[4]){"help", "help topic", "help topic subtopic", NULL} },
+   { ODBCSHELL_CMD_IMPORT,      4, 13, "IMPORT",     "loads a delimited file in byte ranges over several connections", (const char *[4]){"import file into table", "import file into table -j connections -commit rows", "import file into table -j connections -commit rows -batch rows -delimiter ';' -header", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "INSERT",     "internal SQL command (data manipulation)",       NULL },
+   { ODBCSHELL_CMD_JOBS,        1,  1, "JOBS",       "lists background jobs",                          (const char *[2]){"jobs", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "MERGE",      "internal SQL command (data manipulation)",       NULL },
+   { ODBCSHELL_CMD_ON,          3, -1, "ON",         "executes statement on several connections at once", (const char *[4]){"on all SQL_statement", "on name1,name2 SQL_statement", "on group SQL_statement", NULL} },
    { ODBCSHELL_CMD_OPEN,        1,  2, "OPEN",       "opens file to write results",                    (const char *[3]){"open", "open filename", NULL} },
    { ODBCSHELL_CMD_QUIT,        1,  1, "LOGOUT",     "exits ODBC Shell",                               (const char *[2]){"logout", NULL} },
+   { ODBCSHELL_CMD_PARALLEL,    2,  3, "PARALLEL",   "runs the statements of a block at once",        (const char *[4]){"parallel begin", "parallel begin connections", "parallel end", NULL} },
    { ODBCSHELL_CMD_QUIT,        1,  1, "QUIT",       "exits ODBC Shell",                               (const char *[2]){"quit", NULL} },
    { ODBCSHELL_CMD_RECONNECT,   1,  2, "RECONNECT",  "reconnects to a database",                       (const char *[3]){"reconnect", "reconnect name", NULL} },
    { ODBCSHELL_CMD_RESET,       1,  1, "RESET",      "resets internal configuration",                  (const char *[2]){"reset", NULL} },
@@ -88,7 +101,7 @@ ODBCShellOption odbcshell_cmd_strings[] =
    { ODBCSHELL_CMD_ODBC,        1, -1, "ROLLBACK",   "internal SQL command (transaction controls)",    NULL },
    { ODBCSHELL_CMD_ODBC,        1, -1, "SAVE",       "internal SQL command (transaction controls)",    NULL },
    { ODBCSHELL_CMD_ODBC,        1, -1, "SAVEPOINT",  "internal SQL command (transaction controls)",    NULL },
-   { ODBCSHELL_CMD_SEND,        2, -1, "SEND",       "send statement to ODBC data source",             (const char *[2]){"send SQL_statement", NULL} },
+   { ODBCSHELL_CMD_SEND,        2, -1, "SEND",       "send statement to ODBC data source",             (const char *[3]){"send SQL_statement", "send SQL_statement &", NULL} },
    { ODBCSHELL_CMD_SET,         1,  3, "SET",        "sets configuration option",                      (const char *[4]){"set", "set option", "set option value", NULL} },
    { ODBCSHELL_CMD_SETENV,      1,  3, "SETENV",     "displays and sets environment variables",        (const char *[4]){"setenv", "setenv variable", "setenv variable name", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "SELECT",     "internal SQL command (queries)",                 NULL },
@@ -96,11 +109,13 @@ ODBCShellOption odbcshell_cmd_strings[] =
    { ODBCSHELL_CMD_SOURCE,      2,  2, "SOURCE",     "imports odbc script",                            (const char *[2]){"source filename", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "START",      "internal SQL command (transaction controls)",    NULL },
    { ODBCSHELL_CMD_ODBC,        1, -1, "TRUNCATE",   "internal SQL command (data definition)",         NULL },
+   { ODBCSHELL_CMD_TUNE,        1,  4, "TUNE",       "declares performance settings of data sources",  (const char *[4]){"tune", "tune dsn", "tune dsn setting value", NULL} },
    { ODBCSHELL_CMD_UNSET,       2,  2, "UNSET",      "unsets configuration option",                    (const char *[2]){"unset option", NULL} },
    { ODBCSHELL_CMD_UNSETENV,    1,  2, "UNSETENV",   "unsets environment variables",                   (const char *[2]){"unsetenv variable", NULL} },
    { ODBCSHELL_CMD_ODBC,        1, -1, "UPDATE",     "internal SQL command (data manipulation)",       NULL },
    { ODBCSHELL_CMD_USE,         1,  2, "USE",        "switches active connection",                     (const char *[3]){"use", "use name", NULL} },
    { ODBCSHELL_CMD_VERSION,     1,  1, "VERSION",    "displays version information",                   (const char *[2]){"version", NULL} },
+   { ODBCSHELL_CMD_WAIT,        1,  2, "WAIT",       "waits for background jobs to complete",          (const char *[3]){"wait", "wait job", NULL} },
    { -1, -1, -1, NULL, NULL, NULL }
 };
 
@@ -108,14 +123,24 @@ ODBCShellOption odbcshell_cmd_strings[] =
 /// @brief numeric values for configuration options
 ODBCShellOption odbcshell_opt_strings[] =
 {
+   { ODBCSHELL_OPT_AUTORECONNECT,1, 1, "autoreconnect", "attempts made to re-establish a lost connection (0 to disable)", NULL },
+   { ODBCSHELL_OPT_BATCHSTATEMENTS,1, 1, "batchstatements", "statements from scripts sent in one batch (0 to disable)", NULL },
+   { ODBCSHELL_OPT_CONCURRENCY,1, 1, "concurrency", "data sources queried at once by the on command", NULL },
    { ODBCSHELL_OPT_CONFFILE,  1,  1, "conffile",   "configuration file used to set initial settings", NULL },
    { ODBCSHELL_OPT_CONTINUE,  1,  1, "continue",   "continue if non-fatal errors are encountered", NULL },
    { ODBCSHELL_OPT_FORMAT,    1,  1, "format",     "output format of results (CSV, Fixed)", NULL },
    { ODBCSHELL_OPT_HISTFILE,  1,  1, "histfile",   "file used for saving command history", NULL },
    { ODBCSHELL_OPT_HISTORY,   1,  1, "history",    "enable history file", NULL },
+   { ODBCSHELL_OPT_LAZYCONNECT,1, 1, "lazyconnect", "defer connecting to a data source until it is used", NULL },
    { ODBCSHELL_OPT_NOSHELL,   1,  1, "noshell",    "disable calling external programs/scripts", NULL },
    { ODBCSHELL_OPT_ODBCPROMPT,1,  1, "odbcprompt", "allow ODBC driver to prompt for information", NULL },
+   { ODBCSHELL_OPT_POOLCHECK, 1,  1, "poolcheck",  "query used to validate pooled connections", NULL },
+   { ODBCSHELL_OPT_POOLSIZE,  1,  1, "poolsize",   "idle connections kept for reuse (0 to disable)", NULL },
+   { ODBCSHELL_OPT_POOLTTL,   1,  1, "poolttl",    "seconds an idle connection is kept for reuse", NULL },
    { ODBCSHELL_OPT_PROMPT,    1,  1, "prompt",     "prompt used within ODBC Shell", NULL },
+   { ODBCSHELL_OPT_QUERYTIMEOUT,1, 1, "querytimeout", "seconds to wait for a statement (0 to wait forever)", NULL },
+   { ODBCSHELL_OPT_RETRYREADS,1,  1, "retryreads", "replay read-only statements after reconnecting", NULL },
+   { ODBCSHELL_OPT_ROUTING,   1,  1, "routing",    "replica receiving reads sent to a group (latency, roundrobin)", NULL },
    { ODBCSHELL_OPT_SILENT,    1,  1, "silent",     "do not display non-fatal messages", NULL },
    { ODBCSHELL_OPT_VERBOSE,   1,  1, "verbose",    "display verbose messages", NULL },
    { -1, -1, -1, NULL, NULL, NULL }
@@ -68,7 +68,10 @@
 
 #include "odbcshell-cli.h"
 #include "odbcshell-commands.h"
+#include "odbcshell-connect.h"
+#include "odbcshell-daemon.h"
 #include "odbcshell-exec.h"
+#include "odbcshell-jobs.h"
 #include "odbcshell-options.h"
 #include "odbcshell-odbc.h"
 #include "odbcshell-print.h"
@@ -109,20 +112,29 @@ void odbcshell_usage(void)
 {
    printf(("Usage: %s [OPTIONS]\n"
          "  -c                        continue if error is encoutered\n"
-         "  -D dsn                    connect to DSN\n"
+         "  -D dsn                    connect to DSN (may be repeated)\n"
+         "  --daemon                  serve -e requests on socket using warm connections\n"
          "  -e sql                    execute SQL statement\n"
+         "  -E sql                    execute SQL statement independent of others\n"
          "  -h, --help                print this help and exit\n"
+         "  -I file                   execute -e statements on each DSN listed in file\n"
+         "  -j num                    number of DSNs listed with -I queried at once, or\n"
+         "                            number of script files run at once\n"
          "  -l                        print list of DSN\n"
          "  -N, --noprofile           disables reading .odbcshellrc\n"
          "  -n                        disables prompting by driver\n"
          "  -o file                   file to write output\n"
          "  -q, --quiet, --silent     do not print messages\n"
+         "  -S socket                 socket of connection daemon\n"
          "  -s data                   print database information\n"
          "  -V, --version             print version number and exit\n"
          "  -v, --verbose             print verbose messages\n"
          "\n"
+         "The socket may also be set with ODBCSHELL_SOCKET.  When started as\n"
+         "%s, the program runs as the connection daemon.\n"
+         "\n"
          "Report bugs to <%s>.\n"
-      ), PROGRAM_NAME, PACKAGE_BUGREPORT
+      ), PROGRAM_NAME, ODBCSHELL_DAEMON_NAME, PACKAGE_BUGREPORT
    );
    return;
 }
@@ -153,11 +165,13 @@ int main(int argc, char * argv[])
    int           ival;
    int           sts;
    int           opt_index;
+   const char  * prog;
    ODBCShell   * cnf;
 
-   static char   short_opt[] = "cD:e:hlNno:qs:Vv";
+   static char   short_opt[] = "cD:E:e:hI:j:lNno:qS:s:Vv";
    static struct option long_opt[] =
    {
+      {"daemon",        no_argument, 0, 'd'},
       {"help",          no_argument, 0, 'h'},
       {"noprofile",     no_argument, 0, 'N'},
       {"silent",        no_argument, 0, 'q'},
@@ -176,6 +190,11 @@ int main(int argc, char * argv[])
    if ((odbcshell_initialize(&cnf)))
       return(1);
 
+   // runs as connection daemon when invoked as odbcshelld
+   prog = ((prog = strrchr(argv[0], '/'))) ? (prog + 1) : argv[0];
+   if (!(strcmp(prog, ODBCSHELL_DAEMON_NAME)))
+      cnf->mode = ODBCSHELL_MODE_DAEMON;
+
    // processes command line arguments
    while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
    {
@@ -188,9 +207,20 @@ int main(int argc, char * argv[])
             ival = 1;
             odbcshell_set_option(cnf, ODBCSHELL_OPT_CONTINUE, &ival);
             break;
+         case 'd':
+            if (((cnf->mode)) && (cnf->mode != ODBCSHELL_MODE_DAEMON))
+            {
+               fprintf(stderr, "%s: `--daemon' is incompatible with `-e', `-l' and `-s'\n", PROGRAM_NAME);
+               fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+               return(1);
+            };
+            cnf->mode = ODBCSHELL_MODE_DAEMON;
+            break;
          case 'D':
-            cnf->dflt_dsn = optarg;
+            if ((odbcshell_connect_append(cnf, optarg)))
+               return(1);
             break;
+         case 'E':
          case 'e':
             if (((cnf->mode)) && (cnf->mode != ODBCSHELL_MODE_EXEC))
             {
@@ -199,12 +229,21 @@ int main(int argc, char * argv[])
                return(1);
             };
             cnf->mode = ODBCSHELL_MODE_EXEC;
-            if (odbcshell_exec_append_str(cnf, optarg))
+            if (odbcshell_exec_append_str(cnf, optarg, (c == 'E')))
                return(1);
             break;
          case 'h':
             odbcshell_usage();
             return(0);
+         case 'I':
+            cnf->inventory = optarg;
+            break;
+         case 'j':
+            ival = atoi(optarg);
+            if ((odbcshell_set_option(cnf, ODBCSHELL_OPT_CONCURRENCY, &ival)))
+               return(1);
+            cnf->scriptjobs = ival;
+            break;
          case 'l':
             if (((cnf->mode)) && (cnf->mode != ODBCSHELL_MODE_LISTDSN))
             {
@@ -228,6 +267,9 @@ int main(int argc, char * argv[])
             ival = 1;
             odbcshell_set_option(cnf, ODBCSHELL_OPT_SILENT, &ival);
             break;
+         case 'S':
+            cnf->sockfile = optarg;
+            break;
          case 's':
             if (((cnf->mode)) && (cnf->mode != ODBCSHELL_MODE_SHOW))
             {
@@ -261,6 +303,14 @@ int main(int argc, char * argv[])
    if (cnf->mode == ODBCSHELL_MODE_SHELL)
       if (optind < argc)
          cnf->mode = ODBCSHELL_MODE_SCRIPT;
+   if (!(cnf->sockfile))
+      cnf->sockfile = getenv("ODBCSHELL_SOCKET");
+   if ( ((cnf->inventory)) && (cnf->mode != ODBCSHELL_MODE_EXEC) )
+   {
+      fprintf(stderr, "%s: `-I' requires `-e'\n", PROGRAM_NAME);
+      fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+      return(1);
+   };
 
    // opens default output file
    if ((cnf->dflt_output))
@@ -272,6 +322,26 @@ int main(int argc, char * argv[])
       };
    };
 
+   // hands statements to the connection daemon when one is listening,
+   // skipping the profile and connection handshake
+   if ( (cnf->mode == ODBCSHELL_MODE_EXEC) && (!(cnf->inventory)) )
+   {
+      if (!(odbcshell_daemon_exec(cnf, &sts)))
+      {
+         odbcshell_free(cnf);
+         return(sts);
+      };
+   };
+
+   // scripts run at once are each given their own process, which loads
+   // the profile and connects on its own
+   if ( (cnf->mode == ODBCSHELL_MODE_SCRIPT) && (cnf->scriptjobs > 1) && ((argc - optind) > 1) )
+   {
+      sts = odbcshell_script_parallel(cnf, argc - optind, &argv[optind]);
+      odbcshell_free(cnf);
+      return(sts);
+   };
+
    // initializes iODBC/unixODBC library
    if ((odbcshell_odbc_initialize(cnf)))
    {
@@ -291,12 +361,12 @@ int main(int argc, char * argv[])
    switch(cnf->mode)
    {
       case ODBCSHELL_MODE_SCRIPT:
-         if (cnf->dflt_dsn)
-            if (odbcshell_odbc_connect(cnf, cnf->dflt_dsn, NULL))
-               return(1);
+         if (odbcshell_connect_dflt(cnf))
+            return(1);
          for(c = optind; c < argc; c++)
             if (odbcshell_script_loop(cnf, argv[c]))
                return(1);
+         sts = odbcshell_job_wait(cnf, 0);
          break;
 
       case ODBCSHELL_MODE_EXEC:
@@ -307,10 +377,13 @@ int main(int argc, char * argv[])
          sts = odbcshell_odbc_show_dsn(cnf);
          break;
 
+      case ODBCSHELL_MODE_DAEMON:
+         sts = odbcshell_daemon_loop(cnf);
+         break;
+
       case ODBCSHELL_MODE_SHOW:
-         if (cnf->dflt_dsn)
-            if (odbcshell_odbc_connect(cnf, cnf->dflt_dsn, NULL))
-               return(1);
+         if (odbcshell_connect_dflt(cnf))
+            return(1);
          sts = odbcshell_cmd_show(cnf, cnf->dflt_show);
          break;
 
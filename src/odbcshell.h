@@ -52,7 +52,11 @@
 
 #include <stdio.h>
 #include <inttypes.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <sql.h>
 #include <sqlext.h>
@@ -94,6 +98,7 @@
 #define ODBCSHELL_MODE_EXEC     0x02
 #define ODBCSHELL_MODE_LISTDSN  0x03
 #define ODBCSHELL_MODE_SHOW     0x04
+#define ODBCSHELL_MODE_DAEMON   0x05
 
 // option types
 #define ODBSHELL_OTYPE_MASK       0x0F
@@ -106,6 +111,96 @@
 #define ODBCSHELL_FORMAT_FIXED     0x01
 #define ODBCSHELL_FORMAT_XML       0x02
 
+// routing of read-only statements sent to a connection group
+#define ODBCSHELL_ROUTING_LATENCY    0x00
+#define ODBCSHELL_ROUTING_ROUNDROBIN 0x01
+
+// generators of synthetic values
+#define ODBCSHELL_GENERATE_SEQ     0x01 ///< sequence of integers
+#define ODBCSHELL_GENERATE_INT     0x02 ///< uniformly distributed integers
+#define ODBCSHELL_GENERATE_FLOAT   0x03 ///< uniformly distributed real numbers
+#define ODBCSHELL_GENERATE_NORMAL  0x04 ///< normally distributed real numbers
+#define ODBCSHELL_GENERATE_ZIPF    0x05 ///< Zipf distributed integers
+#define ODBCSHELL_GENERATE_STRING  0x06 ///< alphanumeric strings of random length
+#define ODBCSHELL_GENERATE_DATE    0x07 ///< uniformly distributed dates
+#define ODBCSHELL_GENERATE_PICK    0x08 ///< values chosen from a list
+#define ODBCSHELL_GENERATE_REF     0x09 ///< values chosen from a column of another table
+
+// connection list
+#define ODBCSHELL_CONNS_SIZE       16   ///< initial length of connection list
+
+// parallel connect
+#define ODBCSHELL_CONNECT_THREADS  16   ///< maximum concurrent connection attempts
+#define ODBCSHELL_CONCURRENCY      16   ///< default number of data sources queried at once
+
+// connection daemon
+#define ODBCSHELL_DAEMON_NAME      "odbcshelld" ///< program name which starts daemon
+#define ODBCSHELL_DAEMON_EVENTS    64        ///< events processed per wake up
+#define ODBCSHELL_DAEMON_MAXREQ    16777216  ///< largest request accepted
+#define ODBCSHELL_DAEMON_READ      0x01      ///< client is sending request
+#define ODBCSHELL_DAEMON_RUN       0x02      ///< request is executing
+#define ODBCSHELL_DAEMON_DONE      0x03      ///< request finished executing
+#define ODBCSHELL_DAEMON_WRITE     0x04      ///< reply is being sent
+
+// connection daemon frame types
+#define ODBCSHELL_FRAME_CONTINUE   'C'  ///< continue if error is encountered
+#define ODBCSHELL_FRAME_DSN        'D'  ///< connection string
+#define ODBCSHELL_FRAME_EXEC       'E'  ///< SQL statement
+#define ODBCSHELL_FRAME_INDEP      'I'  ///< SQL statement independent of others
+#define ODBCSHELL_FRAME_SILENT     'Q'  ///< do not print messages
+#define ODBCSHELL_FRAME_SHM        'M'  ///< results are passed in shared memory
+#define ODBCSHELL_FRAME_VERBOSE    'V'  ///< print verbose messages
+#define ODBCSHELL_FRAME_END        '.'  ///< end of request
+#define ODBCSHELL_FRAME_STDOUT     '1'  ///< results and messages
+#define ODBCSHELL_FRAME_STDERR     '2'  ///< errors
+#define ODBCSHELL_FRAME_EXIT       'X'  ///< exit code of request
+
+// statement handles
+#define ODBCSHELL_STMT_IDLE_MAX    8    ///< idle statements kept per connection
+#define ODBCSHELL_CURSOR_ROWS      25   ///< default rows returned by cursor fetch
+#define ODBCSHELL_FETCH_WIDTH      1024 ///< bytes bound for each value of a block fetch
+#define ODBCSHELL_FETCH_BYTES      (8*1024*1024) ///< upper bound of memory bound for a block fetch
+#define ODBCSHELL_COPY_BATCH       1000 ///< default rows passed in each block by copy
+#define ODBCSHELL_COPY_BLOCKS      4    ///< blocks queued between copy reader and writer
+#define ODBCSHELL_COPY_WIDTH       65536 ///< largest value transferred by copy
+#define ODBCSHELL_EXPORT_PARTS     256  ///< most key ranges exported at once
+#define ODBCSHELL_EXPORT_ROWS      1000 ///< rows buffered by each range before writing merged output
+#define ODBCSHELL_COMPARE_CHUNKS   16   ///< chunks a differing range of keys is divided into
+#define ODBCSHELL_COMPARE_ROWS     1000 ///< largest chunk whose rows are compared one by one
+#define ODBCSHELL_COMPARE_DEPTH    16   ///< most times a range of keys is divided
+#define ODBCSHELL_DUMP_ROWS        1000 ///< rows buffered by each table before writing its file
+#define ODBCSHELL_DUMP_JOBS        256  ///< most tables dumped at once
+#define ODBCSHELL_IMPORT_SHARDS    256  ///< most byte ranges of a file loaded at once
+#define ODBCSHELL_IMPORT_BYTES     (1024*1024) ///< smallest byte range of a file loaded on its own connection
+#define ODBCSHELL_IMPORT_WIDTH     4096 ///< largest value loaded by import
+#define ODBCSHELL_IMPORT_PROBE     8    ///< records parsed to confirm where a byte range starts
+#define ODBCSHELL_CHUNKED_REPORT   5    ///< seconds between progress reports of chunked statements
+#define ODBCSHELL_GENERATE_WORKERS 256  ///< most connections inserting generated rows at once
+#define ODBCSHELL_GENERATE_REFS    1000000 ///< most values loaded from a referenced column
+#define ODBCSHELL_GENERATE_WIDTH   1024 ///< largest generated or referenced value
+#define ODBCSHELL_BENCH_SESSIONS   1024 ///< most sessions replaying statements at once
+#define ODBCSHELL_BENCH_SECONDS    10   ///< default length of load test
+#define ODBCSHELL_BENCH_SUBBITS    5    ///< bits of precision kept by latency histograms
+#define ODBCSHELL_BENCH_MAXBITS    36   ///< bits of longest latency recorded (microseconds)
+#define ODBCSHELL_BENCH_BUCKETS    ((ODBCSHELL_BENCH_MAXBITS - ODBCSHELL_BENCH_SUBBITS + 2) << ODBCSHELL_BENCH_SUBBITS)
+
+// 64-bit hash of rows (xxHash64)
+#define ODBCSHELL_HASH_PRIME1      0x9E3779B185EBCA87ULL
+#define ODBCSHELL_HASH_PRIME2      0xC2B2AE3D27D4EB4FULL
+#define ODBCSHELL_HASH_PRIME3      0x165667B19E3779F9ULL
+#define ODBCSHELL_HASH_PRIME4      0x85EBCA77C2B2AE63ULL
+#define ODBCSHELL_HASH_PRIME5      0x27D4EB2F165667C5ULL
+#define ODBCSHELL_HASH_ROTL(x, r)  (((x) << (r)) | ((x) >> (64 - (r))))
+#define ODBCSHELL_HASH_ROUND(acc, val) (ODBCSHELL_HASH_ROTL((acc) + (val) * ODBCSHELL_HASH_PRIME2, 31) * ODBCSHELL_HASH_PRIME1)
+
+// connection pool defaults
+#define ODBCSHELL_POOL_SIZE        0    ///< idle connections kept for reuse (disabled)
+#define ODBCSHELL_POOL_TTL         300  ///< seconds an idle connection is kept
+#define ODBCSHELL_POOL_DAEMON      8    ///< idle connections kept by the daemon at least
+#define ODBCSHELL_RECONNECT_DELAY  250  ///< milliseconds before first reconnect attempt
+#define ODBCSHELL_RECONNECT_MAXDELAY 30000 ///< upper bound of reconnect backoff in milliseconds
+#define ODBCSHELL_RTT_STALE        60   ///< seconds before a group member is measured again
+
 // option IDs
 #define ODBCSHELL_OPT_CONFFILE    (0x010 | ODBSHELL_OTYPE_CHAR)
 #define ODBCSHELL_OPT_CONTINUE    (0x020 | ODBSHELL_OTYPE_BOOL)
@@ -117,6 +212,16 @@
 #define ODBCSHELL_OPT_VERBOSE     (0x080 | ODBSHELL_OTYPE_BOOL)
 #define ODBCSHELL_OPT_ODBCPROMPT  (0x090 | ODBSHELL_OTYPE_BOOL)
 #define ODBCSHELL_OPT_FORMAT      (0x0A0 | ODBSHELL_OTYPE_CHAR)
+#define ODBCSHELL_OPT_QUERYTIMEOUT (0x0B0 | ODBSHELL_OTYPE_INT)
+#define ODBCSHELL_OPT_BATCHSTATEMENTS (0x0C0 | ODBSHELL_OTYPE_INT)
+#define ODBCSHELL_OPT_POOLSIZE    (0x0D0 | ODBSHELL_OTYPE_INT)
+#define ODBCSHELL_OPT_POOLTTL     (0x0E0 | ODBSHELL_OTYPE_INT)
+#define ODBCSHELL_OPT_POOLCHECK   (0x0F0 | ODBSHELL_OTYPE_CHAR)
+#define ODBCSHELL_OPT_AUTORECONNECT (0x100 | ODBSHELL_OTYPE_INT)
+#define ODBCSHELL_OPT_RETRYREADS  (0x110 | ODBSHELL_OTYPE_BOOL)
+#define ODBCSHELL_OPT_LAZYCONNECT (0x120 | ODBSHELL_OTYPE_BOOL)
+#define ODBCSHELL_OPT_CONCURRENCY (0x130 | ODBSHELL_OTYPE_INT)
+#define ODBCSHELL_OPT_ROUTING     (0x140 | ODBSHELL_OTYPE_CHAR)
 
 // command IDs
 #define ODBCSHELL_CMD             0x00
@@ -140,6 +245,21 @@
 #define ODBCSHELL_CMD_UNSETENV    (1L + ODBCSHELL_CMD_UNSET)
 #define ODBCSHELL_CMD_USE         (1L + ODBCSHELL_CMD_UNSETENV)
 #define ODBCSHELL_CMD_VERSION     (1L + ODBCSHELL_CMD_USE)
+#define ODBCSHELL_CMD_JOBS        (1L + ODBCSHELL_CMD_VERSION)
+#define ODBCSHELL_CMD_WAIT        (1L + ODBCSHELL_CMD_JOBS)
+#define ODBCSHELL_CMD_CURSOR      (1L + ODBCSHELL_CMD_WAIT)
+#define ODBCSHELL_CMD_TUNE        (1L + ODBCSHELL_CMD_CURSOR)
+#define ODBCSHELL_CMD_ON          (1L + ODBCSHELL_CMD_TUNE)
+#define ODBCSHELL_CMD_GROUP       (1L + ODBCSHELL_CMD_ON)
+#define ODBCSHELL_CMD_COPY        (1L + ODBCSHELL_CMD_GROUP)
+#define ODBCSHELL_CMD_EXPORT      (1L + ODBCSHELL_CMD_COPY)
+#define ODBCSHELL_CMD_COMPARE     (1L + ODBCSHELL_CMD_EXPORT)
+#define ODBCSHELL_CMD_BENCH       (1L + ODBCSHELL_CMD_COMPARE)
+#define ODBCSHELL_CMD_PARALLEL    (1L + ODBCSHELL_CMD_BENCH)
+#define ODBCSHELL_CMD_DUMP        (1L + ODBCSHELL_CMD_PARALLEL)
+#define ODBCSHELL_CMD_IMPORT      (1L + ODBCSHELL_CMD_DUMP)
+#define ODBCSHELL_CMD_CHUNKED     (1L + ODBCSHELL_CMD_IMPORT)
+#define ODBCSHELL_CMD_GENERATE    (1L + ODBCSHELL_CMD_CHUNKED)
 //#define ODBCSHELL_CMD_ALIAS       0x01
 //#define ODBCSHELL_CMD_LOADCONF    0x04
 //#define ODBCSHELL_CMD_SAVECONF    0x09
@@ -183,16 +303,97 @@ struct odbcshell_column
 };
 
 
-/// @brief ODBC connection information
+/// @brief ODBC statement handle and description of its pending result
+typedef struct odbcshell_job ODBCShellJob;
 typedef struct odbcshell_connection ODBCShellConn;
+typedef struct odbcshell_statement ODBCShellStmt;
+struct odbcshell_statement
+{
+   char             * name;        ///< name of cursor using statement
+   HSTMT              hstmt;
+   long long          col_count;
+   ODBCShellColumn  * cols;
+   long long          row_count;   ///< rows fetched from cursor
+   ODBCShellConn    * conn;        ///< connection owning statement
+   ODBCShellStmt    * next;        ///< next idle statement in free list
+   char             * sql;         ///< statement prepared on a cached handle
+   int                prepared;    ///< toggle set once a cached handle is prepared
+   SQLULEN            rowset_size; ///< rows retrieved by each block fetch (0 if unbound)
+   SQLULEN            rowset_count; ///< rows held in bound buffers
+   SQLULEN            rowset_next; ///< next row of bound buffers to display
+   char             * rowset;      ///< column-wise buffers bound for block fetch
+   SQLLEN           * rowset_ind;  ///< length or null indicator of bound values
+};
+
+
+/// @brief performance settings applied to connections to a data source
+typedef struct odbcshell_tune ODBCShellTune;
+struct odbcshell_tune
+{
+   char             * dsn;          ///< data source settings apply to
+   long long          packetsize;   ///< SQL_ATTR_PACKET_SIZE (-1 for driver default)
+   long long          fetchsize;    ///< rows retrieved by each fetch (-1 for one row)
+   long long          cursortype;   ///< SQL_ATTR_CURSOR_TYPE (-1 for driver default)
+   long long          isolation;    ///< SQL_ATTR_TXN_ISOLATION (-1 for driver default)
+   long long          readonly;     ///< toggle for SQL_MODE_READ_ONLY (-1 for driver default)
+   long long          querytimeout; ///< overrides querytimeout option (-1 to use option)
+   long long          stmtcache;    ///< prepared statements kept per connection (-1 for none)
+};
+
+
+/// @brief ODBC connection information
 struct odbcshell_connection
 {
    char             * name;
    char             * dsn;
    HDBC               hdbc;
-   HSTMT              hstmt;
-   long long          col_count;
-   ODBCShellColumn  * cols;
+   ODBCShellStmt    * stmt;        ///< statement used for shell commands
+   ODBCShellStmt    * stmts_free;  ///< idle statements available for reuse
+   long long          stmts_idle;  ///< number of idle statements
+   long long          cursors_count; ///< number of open cursors
+   ODBCShellStmt   ** cursors;     ///< list of open cursors
+   long long          batch_support; ///< SQL_BATCH_SUPPORT bitmask (-1 if unknown)
+   long long          max_activities; ///< SQL_MAX_CONCURRENT_ACTIVITIES (-1 if unknown)
+   time_t             idle_since;  ///< time connection was returned to the pool
+   ODBCShellJob     * job;         ///< background job using connection
+   int                deferred;    ///< toggle set until a lazy connection is established
+   ODBCShellTune      tune;        ///< settings of data source applied to connection
+   ODBCShellStmt   ** cache;       ///< prepared statements, least recently used first
+   long long          cache_count; ///< number of cached statements
+   long long          rtt;         ///< smoothed round trip of probes in microseconds (0 if unmeasured)
+   time_t             rtt_at;      ///< time rtt was last measured
+};
+
+
+/// @brief connections used under one name, primary first
+typedef struct odbcshell_group ODBCShellGroup;
+struct odbcshell_group
+{
+   char             * name;        ///< name passed to use and on
+   char            ** members;     ///< names of connections (primary first)
+   long long          members_count; ///< number of connections in group
+   long long          next;        ///< next replica used by round-robin routing
+   int                txn;         ///< toggle set while a transaction is open on the primary
+};
+
+
+/// @brief statement queued within a parallel block
+typedef struct odbcshell_parallel_stmt ODBCShellParallelStmt;
+struct odbcshell_parallel_stmt
+{
+   char             * sql;         ///< SQL statement to execute
+   long long          line;        ///< script line of statement
+   int                code;        ///< exit code of statement
+   long long          msecs;       ///< milliseconds spent executing statement
+   char             * buff;        ///< buffered results
+   size_t             bufflen;     ///< length of buffered results
+   FILE             * output;      ///< stream used to buffer results
+   char             * msg;         ///< buffered messages
+   size_t             msglen;      ///< length of buffered messages
+   FILE             * msgs;        ///< stream used to buffer messages
+   char             * err;         ///< buffered errors
+   size_t             errlen;      ///< length of buffered errors
+   FILE             * errs;        ///< stream used to buffer errors
 };
 
 
@@ -209,6 +410,26 @@ struct odbcshell_config_data
    long long          noprofile;   ///< disables loading of profile
    long long          odbcprompt;  ///< instructs ODBC to not prompt for information
    long long          format;      ///< output format of ODBC results
+   long long          querytimeout; ///< seconds to wait for statements to complete
+   long long          batchstatements; ///< maximum statements sent in one batch
+   long long          poolsize;    ///< maximum idle connections kept for reuse
+   long long          poolttl;     ///< seconds an idle connection is kept
+   char             * poolcheck;   ///< query used to validate idle connections
+   long long          autoreconnect; ///< attempts made to re-establish a lost connection
+   long long          retryreads;  ///< replays read-only statements after reconnecting
+   long long          lazyconnect; ///< defers connecting until a connection is used
+   long long          concurrency; ///< maximum data sources queried at once
+   long long          scriptjobs;  ///< scripts run at once in separate processes (0 runs scripts in order)
+   long long          noheader;    ///< toggle which suppresses names of columns
+   const char       * label;       ///< value of leading column identifying data source
+   size_t             label_width; ///< display width of leading column
+   const char       * inventory;   ///< file listing data sources passed with -I
+   long long          routing;     ///< selects replica which receives read-only statements
+   ODBCShellGroup  ** groups;      ///< connection groups
+   long long          groups_count; ///< number of connection groups
+   ODBCShellGroup   * group;       ///< group selected with use (NULL if none)
+   long long          pool_count;  ///< number of idle connections
+   ODBCShellConn   ** pool;        ///< idle connections available for reuse
    long long          conns_count; ///< toggle for verbose mode
    long long          exec_count;  ///< toggle for verbose mode
    FILE             * output;      ///< file to save results
@@ -217,14 +438,595 @@ struct odbcshell_config_data
    char             * histfile;    ///< GNU readline history file
    char             * prompt;      ///< shell prompt
    const char       * dflt_dsn;    ///< default DSN to use for "autoconnect"
+   const char      ** dflt_dsns;   ///< DSNs passed with repeated -D options
+   long long          dflt_dsns_count; ///< number of DSNs passed with -D
    const char       * dflt_output; ///< default DSN to use for "autoconnect"
    const char       * dflt_show;   ///< default DSN to use for show data
+   const char       * sockfile;    ///< UNIX socket of connection daemon
    char            ** exec_strs;   ///< list of strings to execute
+   long long        * exec_indeps; ///< toggles marking strings as independent
+   ODBCShellTune   ** tunes;       ///< settings declared for data sources
+   long long          tunes_count; ///< number of data sources with settings
    ODBCShellOption  * active_cmd;  ///< command being actively executed
    HENV               henv;        ///< iODBC environment state
+   HENV               henv_pool;   ///< environment pooled by the driver manager (NULL until poolsize is set)
    HDBC               hdbc;        ///< iODBC connection state
    ODBCShellConn    * current;     ///< current connection to use for SQL
    ODBCShellConn   ** conns;       ///< list of active connections
+   size_t             conns_size;  ///< allocated length of connection list
+   long long        * conns_hash;  ///< open addressed index of conns (index + 1)
+   size_t             conns_hash_size; ///< number of slots in conns_hash
+   FILE             * msgs;        ///< stream for messages (NULL for stdout)
+   FILE             * errs;        ///< stream for errors (NULL for stderr)
+   long long          jobs_count;  ///< number of background jobs
+   long long          jobs_seq;    ///< number assigned to last background job
+   ODBCShellJob    ** jobs;        ///< list of background jobs
+   const char       * script;      ///< name of script being processed
+   long long          script_line; ///< line number within script
+   char             * batch;       ///< statements waiting to be sent as a batch
+   size_t             batch_len;   ///< length of queued statements
+   long long          batch_count; ///< number of queued statements
+   long long        * batch_lines; ///< script line of each queued statement
+   ODBCShellConn    * batch_conn;  ///< connection batch will be sent to
+   ODBCShellParallelStmt * parallel; ///< statements queued within parallel block
+   long long          parallel_count; ///< number of queued statements
+   long long          parallel_max; ///< most statements of parallel block run at once (0 if no block is open)
+};
+
+
+/// @brief SQL statement executing in the background
+struct odbcshell_job
+{
+   long long          id;          ///< job number displayed to user
+   int                done;        ///< toggle set once statement completes
+   int                code;        ///< exit code of statement
+   int                joinable;    ///< toggle set while thread must be joined
+   char             * sql;         ///< SQL statement being executed
+   char             * buff;        ///< buffered results of statement
+   size_t             bufflen;     ///< length of buffered results
+   FILE             * output;      ///< stream used to buffer results
+   time_t             started;     ///< time job was started
+   time_t             finished;    ///< time job completed
+   pthread_t          thread;      ///< worker thread executing statement
+   pthread_mutex_t    lock;        ///< protects done, code, and finished
+   ODBCShellConn    * conn;        ///< connection reserved by job
+   ODBCShell        * cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief SQL statement executed ahead of the statement being displayed
+typedef struct odbcshell_pipe ODBCShellPipe;
+struct odbcshell_pipe
+{
+   const char       * sql;         ///< SQL statement to execute
+   SQLRETURN          sts;         ///< result of SQLExecute()
+   int                joinable;    ///< toggle set while thread must be joined
+   pthread_t          thread;      ///< worker thread executing statement
+   ODBCShellStmt    * stmt;        ///< statement handle used for execution
+};
+
+
+/// @brief connection being established by a parallel connect
+typedef struct odbcshell_dial ODBCShellDial;
+struct odbcshell_dial
+{
+   char             * name;        ///< internal name of connection
+   const char       * dsn;         ///< connection string
+   int                code;        ///< result of odbcshell_odbc_open()
+   char             * buff;        ///< buffered messages of worker
+   size_t             bufflen;     ///< length of buffered messages
+   FILE             * output;      ///< stream used to buffer messages
+   ODBCShellConn    * conn;        ///< established connection
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief queue of connections shared by parallel connect workers
+typedef struct odbcshell_dialer ODBCShellDialer;
+struct odbcshell_dialer
+{
+   long long          count;       ///< number of connections in queue
+   long long          next;        ///< next connection to be attempted
+   pthread_mutex_t    lock;        ///< protects next
+   ODBCShellDial    * dials;       ///< connections to establish
+};
+
+
+/// @brief data source a statement is sent to by the on command
+typedef struct odbcshell_target ODBCShellTarget;
+struct odbcshell_target
+{
+   char             * name;        ///< name displayed in leading column
+   char             * dsn;         ///< connection string (NULL if connected)
+   int                code;        ///< exit code of statement
+   long long          rows;        ///< rows returned or affected
+   long long          msecs;       ///< milliseconds spent executing statement
+   char             * buff;        ///< buffered rows
+   size_t             bufflen;     ///< length of buffered rows
+   FILE             * output;      ///< stream used to buffer rows
+   char             * head;        ///< buffered names of columns
+   size_t             headlen;     ///< length of buffered names of columns
+   FILE             * heads;       ///< stream used to buffer names of columns
+   char             * err;         ///< buffered messages and errors
+   size_t             errlen;      ///< length of buffered messages and errors
+   FILE             * errs;        ///< stream used to buffer messages and errors
+   ODBCShellConn    * conn;        ///< connection statement is executed on
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief queue of data sources shared by on command workers
+typedef struct odbcshell_fanout ODBCShellFanout;
+struct odbcshell_fanout
+{
+   long long          count;       ///< number of data sources in queue
+   long long          next;        ///< next data source to be queried
+   pthread_mutex_t    lock;        ///< protects next
+   char             * sql;         ///< SQL statement to execute
+   ODBCShellTarget  * targets;     ///< data sources to query
+};
+
+
+/// @brief column transferred by copy
+typedef struct odbcshell_copy_column ODBCShellCopyColumn;
+struct odbcshell_copy_column
+{
+   SQLSMALLINT        sql_type;    ///< SQL data type of column
+   SQLSMALLINT        c_type;      ///< C data type values are bound as
+   SQLSMALLINT        scale;       ///< decimal digits of column
+   SQLSMALLINT        pad;
+   SQLULEN            precision;   ///< size of column
+   SQLLEN             width;       ///< bytes bound for each value
+   size_t             offset;      ///< offset of values within a block
+};
+
+
+/// @brief rows passed from the copy reader to the writer
+typedef struct odbcshell_copy_block ODBCShellCopyBlock;
+struct odbcshell_copy_block
+{
+   SQLULEN            rows;        ///< rows held in block
+   char             * data;        ///< values of each column, column-wise
+   SQLLEN           * ind;         ///< length or null indicator of values
+};
+
+
+/// @brief state shared by copy reader and writer
+typedef struct odbcshell_copy ODBCShellCopy;
+struct odbcshell_copy
+{
+   SQLULEN            batch;       ///< rows held by each block
+   long long          col_count;   ///< number of columns transferred
+   ODBCShellCopyColumn * cols;     ///< columns transferred
+   ODBCShellCopyBlock blocks[ODBCSHELL_COPY_BLOCKS]; ///< ring of blocks
+   long long          head;        ///< number of blocks filled by reader
+   long long          tail;        ///< number of blocks drained by writer
+   int                done;        ///< toggle set once reader finishes
+   int                abort;       ///< toggle set if writer fails
+   int                code;        ///< exit code of reader
+   int                arrays;      ///< toggle set if writer binds arrays of parameters
+   long long          rows;        ///< rows written to destination
+   pthread_mutex_t    lock;        ///< protects head, tail, done, and abort
+   pthread_cond_t     filled;      ///< signaled when reader queues a block
+   pthread_cond_t     drained;     ///< signaled when writer frees a block
+   ODBCShellStmt    * src;         ///< statement reading rows
+   ODBCShellStmt    * dst;         ///< statement inserting rows
+   char             * buff;        ///< buffered messages of reader
+   size_t             bufflen;     ///< length of buffered messages
+   FILE             * output;      ///< stream used to buffer messages
+   ODBCShell          cnf;         ///< private configuration used by reader
+};
+
+
+/// @brief range of keys exported by one worker
+typedef struct odbcshell_export ODBCShellExport;
+typedef struct odbcshell_export_part ODBCShellExportPart;
+struct odbcshell_export_part
+{
+   long long          id;          ///< number of range (starting with 1)
+   char             * where;       ///< condition selecting keys of range (NULL for all)
+   char             * path;        ///< file receiving rows (NULL for merged output)
+   int                code;        ///< exit code of worker
+   long long          rows;        ///< rows exported
+   long long          msecs;       ///< milliseconds spent exporting range
+   char             * buff;        ///< rows not yet written to merged output
+   size_t             bufflen;     ///< length of buffered rows
+   FILE             * output;      ///< stream used to buffer rows or file of range
+   char             * err;         ///< buffered messages and errors
+   size_t             errlen;      ///< length of buffered messages and errors
+   FILE             * errs;        ///< stream used to buffer messages and errors
+   ODBCShellConn    * conn;        ///< connection used by worker
+   ODBCShellExport  * export;      ///< export range belongs to
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief query exported in ranges of keys over several connections
+struct odbcshell_export
+{
+   char             * sql;         ///< SQL statement to export
+   const char       * column;      ///< column partitioning rows
+   const char       * dsn;         ///< connection string opened by workers
+   long long          count;       ///< number of ranges
+   int                noheader;    ///< toggle which suppresses names of columns
+   int                header;      ///< toggle set once names of columns are written
+   FILE             * output;      ///< merged output (NULL when writing files)
+   pthread_mutex_t    lock;        ///< protects header and output
+   ODBCShellExportPart * parts;    ///< ranges of keys
+};
+
+
+/// @brief row kept for comparing a chunk row by row
+typedef struct odbcshell_compare_row ODBCShellCompareRow;
+struct odbcshell_compare_row
+{
+   uint64_t           hash;        ///< hash of values of row
+   char             * text;        ///< values of row formatted as CSV
+};
+
+
+/// @brief rows of a chunk read from one connection
+typedef struct odbcshell_compare_side ODBCShellCompareSide;
+struct odbcshell_compare_side
+{
+   ODBCShellConn    * conn;        ///< connection queried
+   char             * sql;         ///< statement selecting rows of chunk
+   long long          keep;        ///< most rows kept for comparing row by row (-1 for all)
+   int                kept;        ///< toggle set while every row of chunk is kept
+   int                code;        ///< exit code of worker
+   long long          count;       ///< rows in chunk
+   uint64_t           sum;         ///< sum of hashes of rows (independent of order)
+   ODBCShellCompareRow * rows;     ///< rows kept for comparing row by row
+   size_t             rows_count;  ///< number of rows kept
+   size_t             rows_size;   ///< allocated length of rows
+   char             * buff;        ///< buffered messages of worker
+   size_t             bufflen;     ///< length of buffered messages
+   FILE             * output;      ///< stream used to buffer messages
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief table compared between two connections
+typedef struct odbcshell_compare ODBCShellCompare;
+struct odbcshell_compare
+{
+   const char       * table;       ///< table compared
+   const char       * key;         ///< column dividing rows into chunks
+   ODBCShellConn    * conns[2];    ///< connections compared
+   long long          depth;       ///< times current range has been divided
+   long long          chunks;      ///< chunks hashed on both connections
+   long long          rows;        ///< rows read from first connection
+   long long          differ;      ///< rows found on only one connection
+};
+
+
+/// @brief statements of a parallel block being run
+typedef struct odbcshell_parallel ODBCShellParallel;
+struct odbcshell_parallel
+{
+   const char       * dsn;         ///< connection string opened by workers
+   long long          count;       ///< number of statements
+   long long          next;        ///< next statement to be executed
+   pthread_mutex_t    lock;        ///< protects next
+   ODBCShellParallelStmt * stmts;  ///< statements of block
+};
+
+
+/// @brief connection executing statements of a parallel block
+typedef struct odbcshell_parallel_worker ODBCShellParallelWorker;
+struct odbcshell_parallel_worker
+{
+   long long          id;          ///< number of worker (starting with 1)
+   int                code;        ///< exit code of worker
+   ODBCShellConn    * conn;        ///< connection used by worker
+   ODBCShellParallel * block;      ///< block worker belongs to
+   char             * err;         ///< buffered errors of worker
+   size_t             errlen;      ///< length of buffered errors
+   FILE             * errs;        ///< stream used to buffer errors
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief table written to its own file by dump
+typedef struct odbcshell_dump ODBCShellDump;
+typedef struct odbcshell_dump_table ODBCShellDumpTable;
+struct odbcshell_dump_table
+{
+   char             * schema;      ///< schema of table (NULL if none)
+   char             * name;        ///< name of table
+   char             * path;        ///< file receiving rows
+   long long          estimate;    ///< rows reported by driver statistics (-1 if unknown)
+   int                code;        ///< exit code of worker
+   long long          rows;        ///< rows written
+   long long          bytes;       ///< length of file
+   uint32_t           crc;         ///< CRC-32 of file
+   long long          msecs;       ///< milliseconds spent dumping table
+   char             * err;         ///< buffered messages and errors
+   size_t             errlen;      ///< length of buffered messages and errors
+   FILE             * errs;        ///< stream used to buffer messages and errors
+};
+
+
+/// @brief connection dumping tables
+typedef struct odbcshell_dump_worker ODBCShellDumpWorker;
+struct odbcshell_dump_worker
+{
+   long long          id;          ///< number of worker (starting with 1)
+   int                code;        ///< exit code of worker
+   ODBCShellConn    * conn;        ///< connection used by worker
+   ODBCShellDump    * dump;        ///< dump worker belongs to
+   char             * buff;        ///< rows not yet written to file
+   size_t             bufflen;     ///< length of buffered rows
+   FILE             * output;      ///< stream used to buffer rows
+   char             * err;         ///< buffered errors of worker
+   size_t             errlen;      ///< length of buffered errors
+   FILE             * errs;        ///< stream used to buffer errors
+   char             * value;       ///< value of column being written
+   size_t             valuesize;   ///< allocated size of value
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief tables written to a directory over several connections
+struct odbcshell_dump
+{
+   const char       * dir;         ///< directory receiving files
+   const char       * dsn;         ///< connection string opened by workers
+   const char       * ext;         ///< extension of files
+   long long          format;      ///< format of files
+   int                noheader;    ///< toggle which suppresses names of columns
+   char               quote[8];    ///< character quoting identifiers
+   long long          count;       ///< number of tables
+   long long          next;        ///< next table to be dumped
+   pthread_mutex_t    lock;        ///< protects next
+   uint32_t           crcs[256];   ///< lookup table of CRC-32
+   ODBCShellDumpTable * tables;    ///< tables in the order listed by driver
+   ODBCShellDumpTable ** order;    ///< tables in the order they are dumped
+};
+
+
+/// @brief byte range of a file loaded by one connection
+typedef struct odbcshell_import ODBCShellImport;
+typedef struct odbcshell_import_shard ODBCShellImportShard;
+struct odbcshell_import_shard
+{
+   long long          id;          ///< number of range (starting with 1)
+   long long          start;       ///< offset of first record of range
+   long long          end;         ///< offset following last record of range
+   int                code;        ///< exit code of worker
+   int                arrays;      ///< toggle set if driver binds arrays of parameters
+   long long          rows;        ///< rows inserted
+   long long          committed;   ///< rows inserted and committed
+   long long          failed;      ///< offset of record which failed (-1 if none)
+   long long          msecs;       ///< milliseconds spent loading range
+   SQLULEN            count;       ///< records held in block
+   char             * data;        ///< values of block, column-wise
+   SQLLEN           * ind;         ///< length or null indicator of values
+   long long        * offsets;     ///< offset of each record held in block
+   ODBCShellConn    * conn;        ///< connection used by worker
+   ODBCShellStmt    * stmt;        ///< statement inserting rows
+   ODBCShellImport  * import;      ///< import range belongs to
+   char             * err;         ///< buffered messages and errors
+   size_t             errlen;      ///< length of buffered messages and errors
+   FILE             * errs;        ///< stream used to buffer messages and errors
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief delimited file loaded in byte ranges over several connections
+struct odbcshell_import
+{
+   const char       * path;        ///< file being loaded
+   const char       * dsn;         ///< connection string opened by workers
+   char             * insert;      ///< statement inserting one record
+   int                delimiter;   ///< character separating values
+   int                header;      ///< toggle set if first record names columns
+   long long          col_count;   ///< values in each record
+   long long          commit;      ///< rows inserted between commits (0 for once per range)
+   long long          size;        ///< length of file
+   SQLULEN            batch;       ///< records held by each block
+   long long          count;       ///< number of ranges
+   ODBCShellImportShard * shards;  ///< ranges of file
+};
+
+
+/// @brief update or delete executed in ranges of keys
+typedef struct odbcshell_chunked ODBCShellChunked;
+struct odbcshell_chunked
+{
+   const char       * sql;         ///< statement being divided
+   const char       * column;      ///< key column dividing statement
+   char             * target;      ///< table named by statement, including alias
+   size_t             prefix;      ///< length of statement preceding its condition
+   size_t             where;       ///< offset of condition within statement (0 if none)
+   long long          size;        ///< rows wanted in each chunk
+   long long          pause;       ///< milliseconds waited between chunks
+   long long          total;       ///< rows matching statement when started
+   long long          rows;        ///< rows changed by committed chunks
+   long long          chunks;      ///< chunks committed
+   long long          reported;    ///< milliseconds elapsed at last progress report
+   struct timespec    start;       ///< time statement started
+   ODBCShellConn    * conn;        ///< connection executing chunks
+   ODBCShellStmt    * stmt;        ///< statement executing chunks
+};
+
+
+/// @brief column receiving synthetic values
+typedef struct odbcshell_generate_column ODBCShellGenerateColumn;
+struct odbcshell_generate_column
+{
+   char             * name;        ///< name of column
+   int                kind;        ///< generator of values
+   SQLSMALLINT        c_type;      ///< C type of bound values
+   SQLSMALLINT        sql_type;    ///< SQL type of parameter
+   SQLULEN            size;        ///< column size of parameter
+   size_t             width;       ///< bytes bound for each value
+   size_t             offset;      ///< offset of values within block
+   long long          lo;          ///< start, lowest integer, shortest string, or first day
+   long long          hi;          ///< step, highest integer, longest string, or last day
+   double             dlo;         ///< lowest number, mean, or Zipf items
+   double             dhi;         ///< highest number, standard deviation, or Zipf exponent
+   double             zipf_x1;     ///< Zipf integral of first item less one
+   double             zipf_n;      ///< Zipf integral past last item
+   double             zipf_s;      ///< Zipf rejection threshold
+   char             * pool;        ///< values picked or referenced
+   size_t           * values;      ///< offset of each value within pool
+   long long          value_count; ///< number of values picked or referenced
+};
+
+
+/// @brief slice of rows generated and inserted by one connection
+typedef struct odbcshell_generate ODBCShellGenerate;
+typedef struct odbcshell_generate_worker ODBCShellGenerateWorker;
+struct odbcshell_generate_worker
+{
+   long long          id;          ///< number of worker (starting with 1)
+   int                code;        ///< exit code of worker
+   int                arrays;      ///< toggle set if driver binds arrays of parameters
+   long long          first;       ///< number of first row of slice (starting with 0)
+   long long          count;       ///< rows in slice
+   long long          rows;        ///< rows inserted and committed
+   long long          msecs;       ///< milliseconds spent inserting slice
+   uint64_t           state;       ///< state of random number generator
+   SQLULEN            block;       ///< rows held in block
+   char             * data;        ///< values of block, column-wise
+   SQLLEN           * ind;         ///< length or null indicator of values
+   ODBCShellConn    * conn;        ///< connection used by worker
+   ODBCShellStmt    * stmt;        ///< statement inserting rows
+   ODBCShellGenerate * generate;   ///< generate worker belongs to
+   char             * err;         ///< buffered messages and errors
+   size_t             errlen;      ///< length of buffered messages and errors
+   FILE             * errs;        ///< stream used to buffer messages and errors
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief synthetic rows inserted over several connections
+struct odbcshell_generate
+{
+   const char       * table;       ///< table receiving rows
+   const char       * dsn;         ///< connection string opened by workers
+   char             * insert;      ///< statement inserting one row
+   long long          rows;        ///< rows generated
+   uint64_t           seed;        ///< seed of random values
+   SQLULEN            batch;       ///< rows held by each block
+   size_t             bytes;       ///< bytes of each block
+   long long          col_count;   ///< columns receiving values
+   ODBCShellGenerateColumn * cols; ///< columns receiving values
+   long long          count;       ///< number of workers
+   ODBCShellGenerateWorker * workers; ///< workers inserting slices of rows
+};
+
+
+/// @brief latencies of one statement replayed by load test
+typedef struct odbcshell_bench_stat ODBCShellBenchStat;
+struct odbcshell_bench_stat
+{
+   long long          count;       ///< successful executions
+   long long          errors;      ///< failed executions
+   long long          total;       ///< sum of latencies (microseconds)
+   long long          min;         ///< shortest latency (microseconds)
+   long long          max;         ///< longest latency (microseconds)
+   long long          counts[ODBCSHELL_BENCH_BUCKETS]; ///< histogram of latencies
+};
+
+
+/// @brief session replaying statements of a load test
+typedef struct odbcshell_bench ODBCShellBench;
+typedef struct odbcshell_bench_session ODBCShellBenchSession;
+struct odbcshell_bench_session
+{
+   long long          id;          ///< number of session (starting with 1)
+   int                code;        ///< exit code of worker
+   ODBCShellConn    * conn;        ///< connection used by worker
+   ODBCShellBenchStat * stats;     ///< latencies of each statement
+   ODBCShellBench   * bench;       ///< load test session belongs to
+   char             * buff;        ///< buffered messages of worker
+   size_t             bufflen;     ///< length of buffered messages
+   FILE             * output;      ///< stream used to buffer messages
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief statements replayed on several sessions at once
+struct odbcshell_bench
+{
+   char            ** stmts;       ///< statements replayed
+   long long          count;       ///< number of statements
+   const char       * dsn;         ///< connection string opened by sessions
+   long long          sessions;    ///< number of sessions
+   long long          duration;    ///< milliseconds statements are replayed
+   long long          think;       ///< milliseconds paused between statements
+   long long          ready;       ///< sessions finished connecting
+   int                go;          ///< toggle set once sessions may start
+   struct timespec    start;       ///< time sessions started replaying statements
+   struct timespec    stop;        ///< time sessions stop replaying statements
+   long long          msecs;       ///< milliseconds spent replaying statements
+   pthread_mutex_t    lock;        ///< protects ready and go
+   pthread_cond_t     cond;        ///< signals changes of ready and go
+   ODBCShellBenchStat * stats;     ///< latencies of each statement of all sessions
+   ODBCShellBenchSession * list;   ///< sessions
+};
+
+
+/// @brief script run by its own process
+typedef struct odbcshell_script_run ODBCShellScriptRun;
+struct odbcshell_script_run
+{
+   const char       * script;      ///< name of script
+   char             * out;         ///< file receiving results
+   char             * err;         ///< file receiving messages and errors
+   pid_t              pid;         ///< process running script (0 if not running)
+   int                started;     ///< toggle set once process is started
+   int                status;      ///< status of process returned by waitpid()
+   struct timespec    start;       ///< time process was started
+   long long          msecs;       ///< milliseconds spent running script
+};
+
+
+/// @brief client of the connection daemon
+typedef struct odbcshell_client ODBCShellClient;
+typedef struct odbcshell_daemon ODBCShellDaemon;
+struct odbcshell_client
+{
+   int                fd;          ///< socket connected to client
+   int                state;       ///< progress of request
+   int                code;        ///< exit code of request
+   int                joinable;    ///< toggle set while thread must be joined
+   int                watched;     ///< toggle set while socket is registered with epoll
+   int                iov_count;   ///< number of reply segments
+   int                iov_next;    ///< next reply segment to send
+   int                memfd;       ///< shared memory holding results (-1 if unused)
+   char             * req;         ///< buffered request
+   size_t             req_len;     ///< length of buffered request
+   size_t             req_size;    ///< allocated size of request buffer
+   char             * out;         ///< buffered results and messages
+   size_t             out_len;     ///< length of buffered results
+   FILE             * outs;        ///< stream used to buffer results
+   char             * err;         ///< buffered errors
+   size_t             err_len;     ///< length of buffered errors
+   FILE             * errs;        ///< stream used to buffer errors
+   char               hdrs[40];    ///< frame headers of reply
+   struct iovec       iov[5];      ///< reply segments
+   pthread_t          thread;      ///< worker thread executing request
+   ODBCShellDaemon  * daemon;      ///< daemon which accepted client
+   ODBCShell          cnf;         ///< private configuration used by worker
+};
+
+
+/// @brief state of the connection daemon
+struct odbcshell_daemon
+{
+   int                sock;        ///< listening socket
+   int                epfd;        ///< epoll instance (-1 when using poll())
+   int                wake[2];     ///< pipe used to wake the event loop
+   long long          clients_count; ///< number of connected clients
+   ODBCShellClient ** clients;     ///< connected clients
+   size_t             pfds_size;   ///< allocated length of pfds and pmap
+   struct pollfd    * pfds;        ///< descriptors passed to poll()
+   void            ** pmap;        ///< owner of each descriptor passed to poll()
+   pthread_mutex_t    lock;        ///< protects connection pool and client state
+   ODBCShell        * cnf;         ///< configuration of daemon
 };
 
 